@@ -103,8 +103,13 @@ DEFINE_FLOAT_GLOBAL_FLAG(DefaultFloatAttribute, 0.0)
 DEFINE_STRING_GLOBAL_FLAG(DefaultStringAttribute, "")
 DEFINE_STRING_GLOBAL_FLAG(Tracker, "/tmp/graphlearn/")
 DEFINE_STRING_GLOBAL_FLAG(ServerHosts, "")
+DEFINE_STRING_GLOBAL_FLAG(SnapshotDir, "")  // Empty means no snapshot
 DEFINE_INT32_GLOBAL_FLAG(NegativeSamplingRetryTimes, 5)
 DEFINE_INT32_GLOBAL_FLAG(IgnoreInvalid, 1) // 1 is True, 0 is False.
+// Sample the batches of at least so many ids in parallel, 0 means never.
+DEFINE_INT32_GLOBAL_FLAG(ParallelSamplingThreshold, 1024)
+// No more nodes in a cluster built with the storage mode 1024.
+DEFINE_INT32_GLOBAL_FLAG(MaxClusterSize, 256)
 
 
 // Define the setters
@@ -135,8 +140,11 @@ DEFINE_SET_FLOAT_GLOBAL_FLAG(DefaultFloatAttribute)
 DEFINE_SET_STRING_GLOBAL_FLAG(DefaultStringAttribute)
 DEFINE_SET_STRING_GLOBAL_FLAG(Tracker)
 DEFINE_SET_STRING_GLOBAL_FLAG(ServerHosts)
+DEFINE_SET_STRING_GLOBAL_FLAG(SnapshotDir)
 DEFINE_SET_INT32_GLOBAL_FLAG(NegativeSamplingRetryTimes)
 DEFINE_SET_INT32_GLOBAL_FLAG(IgnoreInvalid)
+DEFINE_SET_INT32_GLOBAL_FLAG(ParallelSamplingThreshold)
+DEFINE_SET_INT32_GLOBAL_FLAG(MaxClusterSize)
 
 // Define the getters
 DEFINE_GET_INT32_GLOBAL_FLAG(TrackerMode)
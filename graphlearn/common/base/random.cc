@@ -0,0 +1,49 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "graphlearn/common/base/random.h"
+
+#include <random>
+
+namespace graphlearn {
+
+namespace {
+
+// The finalizer of SplitMix64, which spreads consecutive counters.
+uint64_t Mix(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+uint64_t NewThreadBase() {
+  std::random_device rd;
+  return (static_cast<uint64_t>(rd()) << 32) | rd();
+}
+
+}  // anonymous namespace
+
+uint64_t NewRandomSeed() {
+  thread_local static uint64_t base = NewThreadBase();
+  thread_local static uint64_t count = 0;
+  return Mix(base + 0x9E3779B97F4A7C15ULL * ++count);
+}
+
+PhiloxRandom* ThreadLocalRandom() {
+  thread_local static PhiloxRandom rng(NewRandomSeed());
+  return &rng;
+}
+
+}  // namespace graphlearn
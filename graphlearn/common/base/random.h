@@ -0,0 +1,160 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef GRAPHLEARN_COMMON_BASE_RANDOM_H_
+#define GRAPHLEARN_COMMON_BASE_RANDOM_H_
+
+#include <cstdint>
+#include <limits>
+
+namespace graphlearn {
+
+/// Philox4x32-10, a counter-based generator. Each block of 4 numbers is a
+/// pure function of (seed, stream, block index), so that the generators of
+/// the same seed and stream give the same numbers on whichever thread, and
+/// the state is only 48 bytes. It works as an UniformRandomBitGenerator.
+class PhiloxRandom {
+public:
+  typedef uint32_t result_type;
+
+  /// The stream distinguishes the generators of the same seed, such as one
+  /// for each source id of a request.
+  explicit PhiloxRandom(uint64_t seed, uint64_t stream = 0)
+      : cursor_(kBlockSize) {
+    key_[0] = static_cast<uint32_t>(seed);
+    key_[1] = static_cast<uint32_t>(seed >> 32);
+    counter_[0] = 0;
+    counter_[1] = 0;
+    counter_[2] = static_cast<uint32_t>(stream);
+    counter_[3] = static_cast<uint32_t>(stream >> 32);
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+  result_type operator()() { return Next(); }
+
+  uint32_t Next() {
+    if (cursor_ == kBlockSize) {
+      Generate();
+    }
+    return block_[cursor_++];
+  }
+
+  uint64_t Next64() {
+    uint64_t high = Next();
+    return (high << 32) | Next();
+  }
+
+  /// Uniform in [0, n), by multiplying and shifting, with rejection for an
+  /// unbiased result, instead of the modulo. n must be positive.
+  uint32_t Uniform(uint32_t n) {
+    uint64_t m = static_cast<uint64_t>(Next()) * n;
+    uint32_t low = static_cast<uint32_t>(m);
+    if (low < n) {
+      uint32_t threshold = -n % n;
+      while (low < threshold) {
+        m = static_cast<uint64_t>(Next()) * n;
+        low = static_cast<uint32_t>(m);
+      }
+    }
+    return static_cast<uint32_t>(m >> 32);
+  }
+
+  uint64_t Uniform64(uint64_t n) {
+    if (n <= std::numeric_limits<uint32_t>::max()) {
+      return Uniform(static_cast<uint32_t>(n));
+    }
+    __uint128_t m = static_cast<__uint128_t>(Next64()) * n;
+    uint64_t low = static_cast<uint64_t>(m);
+    if (low < n) {
+      uint64_t threshold = -n % n;
+      while (low < threshold) {
+        m = static_cast<__uint128_t>(Next64()) * n;
+        low = static_cast<uint64_t>(m);
+      }
+    }
+    return static_cast<uint64_t>(m >> 64);
+  }
+
+  /// Fill `size` numbers uniform in [0, n).
+  void Uniform(uint32_t n, int32_t size, int32_t* ret) {
+    for (int32_t i = 0; i < size; ++i) {
+      ret[i] = Uniform(n);
+    }
+  }
+
+  /// Uniform in [0, 1), with 24 random bits.
+  float UniformFloat() {
+    return (Next() >> 8) * (1.0f / (1 << 24));
+  }
+
+  /// Uniform in [0, 1), with 53 random bits.
+  double UniformDouble() {
+    uint64_t high = Next() >> 5;
+    uint64_t low = Next() >> 6;
+    return (high * 67108864.0 + low) * (1.0 / 9007199254740992.0);
+  }
+
+private:
+  void Generate() {
+    uint32_t key[2] = {key_[0], key_[1]};
+    uint32_t c[4] = {counter_[0], counter_[1], counter_[2], counter_[3]};
+    for (int32_t round = 0; round < 10; ++round) {
+      uint64_t p0 = static_cast<uint64_t>(kMul0) * c[0];
+      uint64_t p1 = static_cast<uint64_t>(kMul1) * c[2];
+      uint32_t hi0 = static_cast<uint32_t>(p0 >> 32);
+      uint32_t hi1 = static_cast<uint32_t>(p1 >> 32);
+      c[0] = hi1 ^ c[1] ^ key[0];
+      c[1] = static_cast<uint32_t>(p1);
+      c[2] = hi0 ^ c[3] ^ key[1];
+      c[3] = static_cast<uint32_t>(p0);
+      key[0] += kWeyl0;
+      key[1] += kWeyl1;
+    }
+    for (int32_t i = 0; i < kBlockSize; ++i) {
+      block_[i] = c[i];
+    }
+    cursor_ = 0;
+    // The block index is the low 64 bits of the counter.
+    if (++counter_[0] == 0) {
+      ++counter_[1];
+    }
+  }
+
+private:
+  static const int32_t kBlockSize = 4;
+  static const uint32_t kMul0 = 0xD2511F53;
+  static const uint32_t kMul1 = 0xCD9E8D57;
+  static const uint32_t kWeyl0 = 0x9E3779B9;
+  static const uint32_t kWeyl1 = 0xBB67AE85;
+
+  uint32_t key_[2];
+  uint32_t counter_[4];
+  uint32_t block_[kBlockSize];
+  int32_t  cursor_;
+};
+
+/// A seed for a generator with no seed given, from a random base of each
+/// thread and a counter, so that the generators seldom share a seed.
+uint64_t NewRandomSeed();
+
+/// The generator of the current thread, seeded by NewRandomSeed().
+PhiloxRandom* ThreadLocalRandom();
+
+}  // namespace graphlearn
+
+#endif  // GRAPHLEARN_COMMON_BASE_RANDOM_H_
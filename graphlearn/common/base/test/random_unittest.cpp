@@ -0,0 +1,82 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <vector>
+#include "graphlearn/common/base/random.h"
+#include "gtest/gtest.h"
+
+using namespace graphlearn;  // NOLINT [build/namespaces]
+
+TEST(RandomTest, KnownAnswer) {
+  // The known answer of Philox4x32-10 with zero counter and key
+  PhiloxRandom rng(0, 0);
+  EXPECT_EQ(rng.Next(), 0x6627e8d5u);
+  EXPECT_EQ(rng.Next(), 0xe169c58du);
+  EXPECT_EQ(rng.Next(), 0xbc57ac4cu);
+  EXPECT_EQ(rng.Next(), 0x9b00dbd8u);
+}
+
+TEST(RandomTest, Reproducible) {
+  PhiloxRandom a(12345, 7);
+  PhiloxRandom b(12345, 7);
+  PhiloxRandom c(12345, 8);
+  int32_t diff = 0;
+  for (int32_t i = 0; i < 100; ++i) {
+    uint32_t x = a.Next();
+    EXPECT_EQ(x, b.Next());
+    diff += (x != c.Next());
+  }
+  EXPECT_GT(diff, 90);
+  EXPECT_NE(NewRandomSeed(), NewRandomSeed());
+}
+
+TEST(RandomTest, Uniform) {
+  PhiloxRandom rng(42);
+  std::vector<int32_t> counts(10, 0);
+  for (int32_t i = 0; i < 100000; ++i) {
+    uint32_t x = rng.Uniform(10);
+    ASSERT_LT(x, 10u);
+    ++counts[x];
+  }
+  for (int32_t count : counts) {
+    EXPECT_GT(count, 9000);
+    EXPECT_LT(count, 11000);
+  }
+
+  EXPECT_EQ(rng.Uniform(1), 0u);
+  uint64_t big = (1ULL << 40) + 3;
+  for (int32_t i = 0; i < 100; ++i) {
+    EXPECT_LT(rng.Uniform64(big), big);
+    float f = rng.UniformFloat();
+    EXPECT_GE(f, 0.0f);
+    EXPECT_LT(f, 1.0f);
+    double d = rng.UniformDouble();
+    EXPECT_GE(d, 0.0);
+    EXPECT_LT(d, 1.0);
+  }
+
+  int32_t batch[100];
+  rng.Uniform(3, 100, batch);
+  for (int32_t i = 0; i < 100; ++i) {
+    EXPECT_TRUE(batch[i] >= 0 && batch[i] < 3);
+  }
+
+  // Work with the standard algorithms
+  std::vector<int32_t> values = {0, 1, 2, 3, 4};
+  std::shuffle(values.begin(), values.end(), *ThreadLocalRandom());
+  std::sort(values.begin(), values.end());
+  EXPECT_EQ(values, std::vector<int32_t>({0, 1, 2, 3, 4}));
+}
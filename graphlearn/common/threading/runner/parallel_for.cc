@@ -0,0 +1,99 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "graphlearn/common/threading/runner/parallel_for.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>  // NOLINT [build/c++11]
+#include <memory>
+#include <mutex>  // NOLINT [build/c++11]
+
+namespace graphlearn {
+
+namespace {
+
+struct ParallelState {
+  ParallelState(const RangeFunction& f, int64_t s, int64_t b)
+    : func(f), size(s), block_size(b), block_num((s + b - 1) / b),
+      next(0), done(0) {
+  }
+
+  const RangeFunction& func;
+  int64_t size;
+  int64_t block_size;
+  int64_t block_num;
+  std::atomic<int64_t> next;
+  int64_t done;
+  std::mutex mtx;
+  std::condition_variable cv;
+};
+
+// The state is shared because a pool task may start after all the blocks
+// were taken by others and ParallelFor() has returned. Such a task touches
+// nothing but the counters.
+void RunBlocks(std::shared_ptr<ParallelState> state) {
+  int64_t finished = 0;
+  while (true) {
+    int64_t block = state->next.fetch_add(1);
+    if (block >= state->block_num) {
+      break;
+    }
+    int64_t begin = block * state->block_size;
+    int64_t end = std::min(begin + state->block_size, state->size);
+    state->func(begin, end);
+    ++finished;
+  }
+
+  if (finished > 0) {
+    std::unique_lock<std::mutex> lock(state->mtx);
+    state->done += finished;
+    if (state->done == state->block_num) {
+      state->cv.notify_all();
+    }
+  }
+}
+
+}  // anonymous namespace
+
+void ParallelFor(ThreadPool* tp, int64_t size, int64_t grain,
+                 const RangeFunction& func) {
+  if (size <= 0) {
+    return;
+  }
+
+  grain = std::max(grain, int64_t(1));
+  int64_t thread_num = tp == nullptr ? 1 : tp->GetThreadNum();
+  int64_t max_blocks = std::max(thread_num * kBlocksPerThread, int64_t(1));
+  int64_t block_size = std::max(grain, (size + max_blocks - 1) / max_blocks);
+  if (thread_num <= 1 || block_size >= size) {
+    func(0, size);
+    return;
+  }
+
+  auto state = std::make_shared<ParallelState>(func, size, block_size);
+  int64_t helpers = std::min(thread_num, state->block_num - 1);
+  for (int64_t i = 0; i < helpers; ++i) {
+    tp->AddTask(NewClosure(&RunBlocks, state));
+  }
+  RunBlocks(state);
+
+  std::unique_lock<std::mutex> lock(state->mtx);
+  state->cv.wait(lock, [&state] {
+    return state->done == state->block_num;
+  });
+}
+
+}  // namespace graphlearn
@@ -0,0 +1,85 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef GRAPHLEARN_COMMON_THREADING_RUNNER_PARALLEL_FOR_H_
+#define GRAPHLEARN_COMMON_THREADING_RUNNER_PARALLEL_FOR_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "graphlearn/common/threading/runner/threadpool.h"
+
+namespace graphlearn {
+
+typedef std::function<void(int64_t begin, int64_t end)> RangeFunction;
+
+// Blocks per thread, to balance the skewed ones.
+const int64_t kBlocksPerThread = 4;
+
+/// Split [0, size) into blocks of at least `grain` elements and run
+/// func(begin, end) for each block on the thread pool. The calling thread
+/// takes part in the work, so it is safe to be called inside a task of the
+/// same pool. Return after all blocks are done.
+void ParallelFor(ThreadPool* tp, int64_t size, int64_t grain,
+                 const RangeFunction& func);
+
+/// Turn `values` into the exclusive prefix sum of it in parallel, and
+/// return the total sum.
+template <typename T>
+int64_t ParallelPrefixSum(ThreadPool* tp, std::vector<T>* values) {
+  int64_t size = values->size();
+  int64_t thread_num = tp == nullptr ? 1 : tp->GetThreadNum();
+  int64_t block_num = std::min(thread_num * kBlocksPerThread, size / 4096);
+  block_num = std::max(block_num, int64_t(1));
+  int64_t block_size = (size + block_num - 1) / block_num;
+  std::vector<int64_t> block_sums(block_num, 0);
+  T* data = values->data();
+
+  ParallelFor(tp, block_num, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; ++b) {
+      int64_t last = std::min((b + 1) * block_size, size);
+      int64_t sum = 0;
+      for (int64_t i = b * block_size; i < last; ++i) {
+        sum += data[i];
+      }
+      block_sums[b] = sum;
+    }
+  });
+
+  int64_t total = 0;
+  for (auto& sum : block_sums) {
+    int64_t block_sum = sum;
+    sum = total;
+    total += block_sum;
+  }
+
+  ParallelFor(tp, block_num, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; ++b) {
+      int64_t last = std::min((b + 1) * block_size, size);
+      int64_t sum = block_sums[b];
+      for (int64_t i = b * block_size; i < last; ++i) {
+        T value = data[i];
+        data[i] = sum;
+        sum += value;
+      }
+    }
+  });
+  return total;
+}
+
+}  // namespace graphlearn
+
+#endif  // GRAPHLEARN_COMMON_THREADING_RUNNER_PARALLEL_FOR_H_
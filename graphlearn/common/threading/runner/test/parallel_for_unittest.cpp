@@ -0,0 +1,82 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "graphlearn/common/threading/runner/parallel_for.h"
+
+#include <atomic>
+#include <vector>
+#include "gtest/gtest.h"
+
+using namespace graphlearn;  // NOLINT [build/namespaces]
+
+TEST(ParallelForTest, CoverAll) {
+  ThreadPool tp(4);
+  tp.Startup();
+
+  int64_t size = 100003;
+  std::vector<int32_t> visited(size, 0);
+  ParallelFor(&tp, size, 100, [&visited] (int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      ++visited[i];
+    }
+  });
+  for (int64_t i = 0; i < size; ++i) {
+    EXPECT_EQ(visited[i], 1);
+  }
+
+  // Nested calls on the same pool.
+  std::atomic<int64_t> sum(0);
+  ParallelFor(&tp, 16, 1, [&tp, &sum] (int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      ParallelFor(&tp, 1000, 10, [&sum] (int64_t b, int64_t e) {
+        sum += e - b;
+      });
+    }
+  });
+  EXPECT_EQ(sum.load(), 16000);
+
+  // Run inline without a pool.
+  int64_t count = 0;
+  ParallelFor(nullptr, 10, 1, [&count] (int64_t begin, int64_t end) {
+    count += end - begin;
+  });
+  EXPECT_EQ(count, 10);
+
+  tp.Shutdown();
+}
+
+TEST(ParallelForTest, PrefixSum) {
+  ThreadPool tp(4);
+  tp.Startup();
+
+  std::vector<int32_t> values(50001);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = i % 7;
+  }
+  std::vector<int32_t> expected(values.size());
+  int64_t sum = 0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    expected[i] = sum;
+    sum += values[i];
+  }
+
+  EXPECT_EQ(ParallelPrefixSum(&tp, &values), sum);
+  EXPECT_EQ(values, expected);
+
+  std::vector<int64_t> empty;
+  EXPECT_EQ(ParallelPrefixSum(&tp, &empty), 0);
+
+  tp.Shutdown();
+}
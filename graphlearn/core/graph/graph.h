@@ -32,6 +32,10 @@ public:
   virtual Status Build(const IndexOption& option) = 0;
 
   virtual io::GraphStorage* GetLocalStorage() = 0;
+  /// Restore the local storage from a snapshot, in place of updating and
+  /// building it. UpdateEdges is rejected from then on.
+  virtual Status Restore(const io::SnapshotReader* reader,
+                         const std::string& prefix) = 0;
 
 #define DECLARE_METHOD(Name)                         \
   virtual Status Name(const Name##Request* request,  \
@@ -15,11 +15,20 @@ limitations under the License.
 
 #include "graphlearn/core/graph/graph_store.h"
 
+#include <dirent.h>
+#include <sys/stat.h>
+#include <algorithm>
 #include <memory>
+#include <sstream>
+#include <string>
 #include "graphlearn/common/base/errors.h"
 #include "graphlearn/common/base/log.h"
 #include "graphlearn/common/base/progress.h"
+#include "graphlearn/common/threading/runner/parallel_for.h"
 #include "graphlearn/common/threading/sync/cond.h"
+#include "graphlearn/core/graph/storage/graph_storage.h"
+#include "graphlearn/core/graph/storage/node_storage.h"
+#include "graphlearn/core/graph/storage/snapshot.h"
 #include "graphlearn/core/io/element_value.h"
 #include "graphlearn/core/io/edge_loader.h"
 #include "graphlearn/core/io/node_loader.h"
@@ -161,6 +170,67 @@ private:
   ProgressType progress_;
 };
 
+std::string SnapshotPath() {
+  std::string dir = GLOBAL_FLAG(SnapshotDir);
+  if (!dir.empty() && dir.back() != '/') {
+    dir += '/';
+  }
+  return dir + "graph_" + std::to_string(GLOBAL_FLAG(ServerId)) + ".snapshot";
+}
+
+// Describe a data source by its options and, for a local path, by the
+// size and modification time of each file, so that the snapshot built
+// from other data is not taken for this one.
+std::string Fingerprint(const std::string& description,
+                        const std::string& path) {
+  std::vector<std::string> files;
+  struct stat st;
+  if (::stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+    DIR* dir = ::opendir(path.c_str());
+    if (dir != nullptr) {
+      struct dirent* entry = nullptr;
+      while ((entry = ::readdir(dir)) != nullptr) {
+        files.push_back(path + "/" + entry->d_name);
+      }
+      ::closedir(dir);
+    }
+    std::sort(files.begin(), files.end());
+  } else {
+    files.push_back(path);
+  }
+
+  std::stringstream ss;
+  ss << description;
+  for (const auto& file : files) {
+    if (::stat(file.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+      ss << " file:" << file << "," << st.st_size << ","
+         << st.st_mtim.tv_sec << "." << st.st_mtim.tv_nsec;
+    }
+  }
+  return ss.str();
+}
+
+std::vector<std::string> Fingerprints(
+    const std::vector<io::EdgeSource>& edges,
+    const std::vector<io::NodeSource>& nodes) {
+  std::vector<std::string> ret;
+  for (const auto& e : edges) {
+    ret.push_back(Fingerprint(e.ToString(), e.path));
+  }
+  for (const auto& n : nodes) {
+    ret.push_back(Fingerprint(n.ToString(), n.path));
+  }
+  return ret;
+}
+
+std::string EdgePrefix(const std::string& edge_type) {
+  return "edge/" + edge_type;
+}
+
+std::string NodePrefix(const std::string& node_type) {
+  return "node/" + node_type;
+}
+
 }  // anonymous namespace
 
 GraphStore::GraphStore(Env* env)
@@ -232,26 +302,169 @@ Status GraphStore::Load(
 Status GraphStore::Build(
     const std::vector<io::EdgeSource>& edges,
     const std::vector<io::NodeSource>& nodes) {
+  // Each graph or noder is built by a task, which may fan out again over
+  // the same thread pool.
+  int64_t edge_num = edges.size();
+  int64_t node_num = nodes.size();
+  std::vector<Graph*> graphs(edge_num);
+  std::vector<Noder*> noders(node_num);
+  for (int64_t i = 0; i < edge_num; ++i) {
+    graphs[i] = graphs_->LookupOrCreate(edges[i].edge_type);
+  }
+  for (int64_t i = 0; i < node_num; ++i) {
+    noders[i] = noders_->LookupOrCreate(nodes[i].id_type);
+  }
+
+  std::vector<Status> status(edge_num + node_num);
+  ParallelFor(env_->IntraThreadPool(), edge_num + node_num, 1,
+    [&] (int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        if (i < edge_num) {
+          status[i] = graphs[i]->Build(edges[i].option);
+        } else {
+          status[i] = noders[i - edge_num]->Build(
+            nodes[i - edge_num].option);
+        }
+      }
+    });
+
+  for (int64_t i = 0; i < edge_num + node_num; ++i) {
+    if (!status[i].ok()) {
+      const std::string& type = i < edge_num ?
+        edges[i].edge_type : nodes[i - edge_num].id_type;
+      LOG(ERROR) << "Graph build failed: " << type
+                 << ", details:" << status[i].ToString();
+      return status[i];
+    }
+  }
+  LOG(INFO) << "GraphStore build OK.";
+  return Status();
+}
+
+Status GraphStore::Save(
+    const std::vector<io::EdgeSource>& edges,
+    const std::vector<io::NodeSource>& nodes) {
+  if (GLOBAL_FLAG(SnapshotDir).empty()) {
+    return error::FailedPrecondition("Snapshot dir is not set.");
+  }
+
+  std::string path = SnapshotPath();
+  io::SnapshotWriter writer;
+  RETURN_IF_ERROR(writer.Open(path));
+  int32_t mode = GLOBAL_FLAG(StorageMode);
+  int32_t server_count = GLOBAL_FLAG(ServerCount);
+  std::vector<std::string> sources = Fingerprints(edges, nodes);
+  RETURN_IF_ERROR(writer.Write("storage_mode", mode));
+  RETURN_IF_ERROR(writer.Write("server_count", server_count));
+  RETURN_IF_ERROR(writer.WriteStrings("sources",
+                                      sources.data(), sources.size()));
+  for (const auto& e : edges) {
+    io::GraphStorage* storage =
+      graphs_->LookupOrCreate(e.edge_type)->GetLocalStorage();
+    RETURN_IF_ERROR(storage->Save(&writer, EdgePrefix(e.edge_type)));
+  }
+  for (const auto& n : nodes) {
+    io::NodeStorage* storage =
+      noders_->LookupOrCreate(n.id_type)->GetLocalStorage();
+    RETURN_IF_ERROR(storage->Save(&writer, NodePrefix(n.id_type)));
+  }
+  RETURN_IF_ERROR(writer.Close());
+  LOG(INFO) << "GraphStore saved to " << path;
+  return Status::OK();
+}
+
+Status GraphStore::OpenSnapshot(
+    const std::vector<io::EdgeSource>& edges,
+    const std::vector<io::NodeSource>& nodes,
+    std::unique_ptr<io::SnapshotReader>* snapshot) {
+  if (GLOBAL_FLAG(SnapshotDir).empty()) {
+    return error::NotFound("Snapshot dir is not set.");
+  }
+
+  // Only the sorted storages are kept in the snapshot.
+  for (const auto& n : nodes) {
+    if (!n.option.name.empty() && n.option.name != "sort") {
+      return error::NotFound("No snapshot for node index " + n.option.name);
+    }
+  }
+
+  std::string path = SnapshotPath();
+  std::unique_ptr<io::SnapshotReader> reader(new io::SnapshotReader);
+  Status s = reader->Open(path);
+  if (!s.ok()) {
+    LOG(WARNING) << "Open snapshot failed: " << s.ToString();
+    return error::NotFound("No usable snapshot at " + path);
+  }
+
+  int32_t mode = -1;
+  if (!reader->Read("storage_mode", &mode).ok() ||
+      mode != GLOBAL_FLAG(StorageMode)) {
+    return error::NotFound("Snapshot with another storage mode: " + path);
+  }
+  // The partition of this server and the data it is built from.
+  int32_t server_count = -1;
+  if (!reader->Read("server_count", &server_count).ok() ||
+      server_count != GLOBAL_FLAG(ServerCount)) {
+    return error::NotFound("Snapshot with another server count: " + path);
+  }
+  std::vector<std::string> sources;
+  if (!reader->ReadStrings("sources", &sources).ok() ||
+      sources != Fingerprints(edges, nodes)) {
+    return error::NotFound("Snapshot of other data sources: " + path);
+  }
+  for (const auto& e : edges) {
+    if (!reader->Has(EdgePrefix(e.edge_type) + ".edges.side_info")) {
+      return error::NotFound("No snapshot for edge type " + e.edge_type);
+    }
+  }
+  for (const auto& n : nodes) {
+    if (!reader->Has(NodePrefix(n.id_type) + ".side_info")) {
+      return error::NotFound("No snapshot for node type " + n.id_type);
+    }
+  }
+
+  *snapshot = std::move(reader);
+  return Status::OK();
+}
+
+Status GraphStore::Restore(
+    const std::vector<io::EdgeSource>& edges,
+    const std::vector<io::NodeSource>& nodes) {
+  std::unique_ptr<io::SnapshotReader> snapshot;
+  Status s = OpenSnapshot(edges, nodes, &snapshot);
+  if (!s.ok()) {
+    return s;
+  }
+  return Restore(edges, nodes, std::move(snapshot));
+}
+
+Status GraphStore::Restore(
+    const std::vector<io::EdgeSource>& edges,
+    const std::vector<io::NodeSource>& nodes,
+    std::unique_ptr<io::SnapshotReader> snapshot) {
+  // Past here the storages are partly restored and may refer to the
+  // mapping, which must not be taken as no snapshot.
+  Init(edges, nodes);
+  snapshot_ = std::move(snapshot);
+  Status s;
   for (const auto& e : edges) {
-    Graph* graph = graphs_->LookupOrCreate(e.edge_type);
-    Status s = graph->Build(e.option);
+    s = graphs_->LookupOrCreate(e.edge_type)->Restore(
+      snapshot_.get(), EdgePrefix(e.edge_type));
     if (!s.ok()) {
-      LOG(ERROR) << "Graph build failed: " << e.edge_type
-                 << ", details:" << s.ToString();
-      return s;
+      return error::DataLoss("Restore edge type " + e.edge_type +
+                             " failed: " + s.ToString());
     }
   }
   for (const auto& n : nodes) {
-    Noder* noder = noders_->LookupOrCreate(n.id_type);
-    Status s = noder->Build(n.option);
+    s = noders_->LookupOrCreate(n.id_type)->Restore(
+      snapshot_.get(), NodePrefix(n.id_type));
     if (!s.ok()) {
-      LOG(ERROR) << "Graph build failed: " << n.id_type
-                 << ", details:" << s.ToString();
-      return s;
+      return error::DataLoss("Restore node type " + n.id_type +
+                             " failed: " + s.ToString());
     }
   }
-  LOG(INFO) << "GraphStore build OK.";
-  return Status();
+  LOG(INFO) << "GraphStore restored from " << SnapshotPath();
+  return Status::OK();
 }
 
 Graph* GraphStore::GetGraph(const std::string& edge_type) {
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef GRAPHLEARN_CORE_GRAPH_GRAPH_STORE_H_
 #define GRAPHLEARN_CORE_GRAPH_GRAPH_STORE_H_
 
+#include <memory>
 #include <vector>
 #include <string>
 #include "graphlearn/core/graph/graph.h"
@@ -29,6 +30,10 @@ namespace graphlearn {
 
 class Env;
 
+namespace io {
+class SnapshotReader;
+}  // namespace io
+
 class GraphStore {
 public:
   explicit GraphStore(Env* env);
@@ -43,6 +48,29 @@ public:
   Status Build(const std::vector<io::EdgeSource>& edges,
                const std::vector<io::NodeSource>& nodes);
 
+  /// Dump the built graphs to the snapshot of this server under
+  /// GLOBAL_FLAG(SnapshotDir).
+  Status Save(const std::vector<io::EdgeSource>& edges,
+              const std::vector<io::NodeSource>& nodes);
+  /// Open the snapshot of this server and check that it is usable for the
+  /// data sources, without touching any graph. Return NotFound if there is
+  /// no usable snapshot, such as one of another storage mode, server count
+  /// or data sources, and the caller should fall back to Load() and
+  /// Build().
+  Status OpenSnapshot(const std::vector<io::EdgeSource>& edges,
+                      const std::vector<io::NodeSource>& nodes,
+                      std::unique_ptr<io::SnapshotReader>* snapshot);
+  /// Restore the graphs from an opened snapshot, in place of Load() and
+  /// Build(). The restored graphs reject updates. Any error leaves the
+  /// graphs partly restored. In a cluster, all the servers must restore
+  /// or none of them, since a loading server sends updates to the others.
+  Status Restore(const std::vector<io::EdgeSource>& edges,
+                 const std::vector<io::NodeSource>& nodes,
+                 std::unique_ptr<io::SnapshotReader> snapshot);
+  /// OpenSnapshot() and Restore() for a single server.
+  Status Restore(const std::vector<io::EdgeSource>& edges,
+                 const std::vector<io::NodeSource>& nodes);
+
   Graph* GetGraph(const std::string& edge_type);
   Noder* GetNoder(const std::string& node_type);
 
@@ -53,6 +81,8 @@ private:
   HeterDispatcher<Graph>* graphs_;
   HeterDispatcher<Noder>* noders_;
   Topology topo_;
+  // Restored storages may refer to the mapping.
+  std::unique_ptr<io::SnapshotReader> snapshot_;
 };
 
 }  // namespace graphlearn
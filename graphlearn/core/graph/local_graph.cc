@@ -15,7 +15,12 @@ limitations under the License.
 
 #include "graphlearn/core/graph/graph.h"
 
+#include <atomic>
+#include <mutex>  // NOLINT [build/c++11]
+#include <string>
+#include <vector>
 #include "graphlearn/common/base/errors.h"
+#include "graphlearn/core/graph/staging_buffer.h"
 #include "graphlearn/core/graph/storage/graph_storage.h"
 #include "graphlearn/core/graph/storage_creator.h"
 #include "graphlearn/include/config.h"
@@ -24,7 +29,7 @@ namespace graphlearn {
 
 class LocalGraph : public Graph {
 public:
-  LocalGraph() {
+  LocalGraph() : restored_(false) {
     storage_ = CreateGraphStorage();
   }
 
@@ -33,6 +38,8 @@ public:
   }
 
   Status Build(const IndexOption& option) override {
+    Flush();
+    staging_.Shrink();
     if (option.name == "sort") {
       storage_->Build();
     } else {
@@ -42,22 +49,35 @@ public:
   }
 
   io::GraphStorage* GetLocalStorage() override {
+    Flush();
     return storage_;
   }
 
+  Status Restore(const io::SnapshotReader* reader,
+                 const std::string& prefix) override {
+    // Set first, since a failed load may leave the storage partly restored.
+    restored_ = true;
+    return storage_->Load(reader, prefix);
+  }
+
   Status UpdateEdges(const UpdateEdgesRequest* req,
                      UpdateEdgesResponse* res) override {
-    storage_->Lock();
-
-    storage_->SetSideInfo(req->GetSideInfo());
-
-    io::EdgeValue value;
+    if (restored_) {
+      return error::FailedPrecondition(
+        "Can not update the edges restored from a snapshot.");
+    }
     UpdateEdgesRequest* request = const_cast<UpdateEdgesRequest*>(req);
-    while (request->Next(&value)) {
-      storage_->Add(&value);
+    staging_.Stage(request);
+
+    // Only one thread drains the staged edges into storage at a time,
+    // the others go back to parsing.
+    std::unique_lock<std::mutex> lock(drain_mtx_, std::try_to_lock);
+    if (lock.owns_lock()) {
+      storage_->Lock();
+      storage_->SetSideInfo(req->GetSideInfo());
+      storage_->Unlock();
+      Drain();
     }
-
-    storage_->Unlock();
     return Status::OK();
   }
 
@@ -69,14 +89,29 @@ public:
 
   Status LookupEdges(const LookupEdgesRequest* req,
                      LookupEdgesResponse* res) override {
-    int64_t edge_id = 0;
-    int64_t src_id = 0;
-    LookupEdgesRequest* request = const_cast<LookupEdgesRequest*>(req);
-    res->SetSideInfo(storage_->GetSideInfo(), req->Size());
-    while (request->Next(&edge_id, &src_id)) {
-      res->AppendWeight(storage_->GetEdgeWeight(edge_id));
-      res->AppendLabel(storage_->GetEdgeLabel(edge_id));
-      res->AppendAttribute(storage_->GetEdgeAttribute(edge_id).get());
+    Flush();
+    const io::SideInfo* info = storage_->GetSideInfo();
+    const int64_t* edge_ids = req->EdgeIds();
+    int32_t size = req->Size();
+    res->SetSideInfo(info, size);
+    if (info->IsWeighted()) {
+      storage_->GatherEdgeWeights(edge_ids, size, res->MutableWeights());
+    }
+    if (info->IsLabeled()) {
+      storage_->GatherEdgeLabels(edge_ids, size, res->MutableLabels());
+    }
+    if (info->IsAttributed()) {
+      if (info->i_num > 0) {
+        storage_->GatherEdgeInts(edge_ids, size, res->MutableIntAttrs());
+      }
+      if (info->f_num > 0) {
+        storage_->GatherEdgeFloats(edge_ids, size, res->MutableFloatAttrs());
+      }
+      if (info->s_num > 0) {
+        std::vector<const std::string*> strings(size * info->s_num);
+        storage_->GatherEdgeStrings(edge_ids, size, strings.data());
+        res->AppendStringAttrs(strings.data(), strings.size());
+      }
     }
     return Status::OK();
   }
@@ -87,8 +122,28 @@ public:
     return error::Unimplemented("Remote LookupEdges not implemented");
   }
 
+private:
+  void Drain() {
+    storage_->Lock();
+    staging_.Drain([this] (io::EdgeValue* value) {
+      storage_->Add(value);
+    });
+    storage_->Unlock();
+  }
+
+  /// Make all the staged edges visible.
+  void Flush() {
+    if (!staging_.Empty()) {
+      std::lock_guard<std::mutex> lock(drain_mtx_);
+      Drain();
+    }
+  }
+
 private:
   io::GraphStorage* storage_;
+  StagingBuffer<io::EdgeValue> staging_;
+  std::mutex drain_mtx_;
+  std::atomic<bool> restored_;
 };
 
 Graph* CreateLocalGraph() {
@@ -15,11 +15,16 @@ limitations under the License.
 
 #include "graphlearn/core/graph/noder.h"
 
+#include <atomic>
+#include <mutex>  // NOLINT [build/c++11]
+#include <string>
+#include <vector>
 #include "graphlearn/common/base/errors.h"
 #include "graphlearn/common/base/log.h"
 #ifdef OPEN_KNN
 #include "graphlearn/contrib/knn/builder.h"
 #endif
+#include "graphlearn/core/graph/staging_buffer.h"
 #include "graphlearn/core/graph/storage/node_storage.h"
 #include "graphlearn/core/graph/storage_creator.h"
 #include "graphlearn/include/config.h"
@@ -28,7 +33,7 @@ namespace graphlearn {
 
 class LocalNoder : public Noder {
 public:
-  LocalNoder() {
+  LocalNoder() : restored_(false) {
     storage_ = CreateNodeStorage();
   }
 
@@ -37,6 +42,8 @@ public:
   }
 
   Status Build(const IndexOption& option) override {
+    Flush();
+    staging_.Shrink();
     if (option.name == "sort") {
       storage_->Build();
     } else if (option.name == "knn") {
@@ -55,22 +62,35 @@ public:
   }
 
   io::NodeStorage* GetLocalStorage() override {
+    Flush();
     return storage_;
   }
 
+  Status Restore(const io::SnapshotReader* reader,
+                 const std::string& prefix) override {
+    // Set first, since a failed load may leave the storage partly restored.
+    restored_ = true;
+    return storage_->Load(reader, prefix);
+  }
+
   Status UpdateNodes(const UpdateNodesRequest* req,
                      UpdateNodesResponse* res) override {
-    storage_->Lock();
-
-    storage_->SetSideInfo(req->GetSideInfo());
-
-    io::NodeValue value;
+    if (restored_) {
+      return error::FailedPrecondition(
+        "Can not update the nodes restored from a snapshot.");
+    }
     UpdateNodesRequest* request = const_cast<UpdateNodesRequest*>(req);
-    while (request->Next(&value)) {
-      storage_->Add(&value);
+    staging_.Stage(request);
+
+    // Only one thread drains the staged nodes into storage at a time,
+    // the others go back to parsing.
+    std::unique_lock<std::mutex> lock(drain_mtx_, std::try_to_lock);
+    if (lock.owns_lock()) {
+      storage_->Lock();
+      storage_->SetSideInfo(req->GetSideInfo());
+      storage_->Unlock();
+      Drain();
     }
-
-    storage_->Unlock();
     return Status::OK();
   }
 
@@ -82,13 +102,29 @@ public:
 
   Status LookupNodes(const LookupNodesRequest* req,
                      LookupNodesResponse* res) override {
-    int64_t node_id = 0;
-    LookupNodesRequest* request = const_cast<LookupNodesRequest*>(req);
-    res->SetSideInfo(storage_->GetSideInfo(), req->Size());
-    while (request->Next(&node_id)) {
-      res->AppendWeight(storage_->GetWeight(node_id));
-      res->AppendLabel(storage_->GetLabel(node_id));
-      res->AppendAttribute(storage_->GetAttribute(node_id).get());
+    Flush();
+    const io::SideInfo* info = storage_->GetSideInfo();
+    const int64_t* node_ids = req->NodeIds();
+    int32_t size = req->Size();
+    res->SetSideInfo(info, size);
+    if (info->IsWeighted()) {
+      storage_->GatherWeights(node_ids, size, res->MutableWeights());
+    }
+    if (info->IsLabeled()) {
+      storage_->GatherLabels(node_ids, size, res->MutableLabels());
+    }
+    if (info->IsAttributed()) {
+      if (info->i_num > 0) {
+        storage_->GatherInts(node_ids, size, res->MutableIntAttrs());
+      }
+      if (info->f_num > 0) {
+        storage_->GatherFloats(node_ids, size, res->MutableFloatAttrs());
+      }
+      if (info->s_num > 0) {
+        std::vector<const std::string*> strings(size * info->s_num);
+        storage_->GatherStrings(node_ids, size, strings.data());
+        res->AppendStringAttrs(strings.data(), strings.size());
+      }
     }
     return Status::OK();
   }
@@ -99,8 +135,28 @@ public:
     return error::Unimplemented("Remote LookupNodes not implemented");
   }
 
+private:
+  void Drain() {
+    storage_->Lock();
+    staging_.Drain([this] (io::NodeValue* value) {
+      storage_->Add(value);
+    });
+    storage_->Unlock();
+  }
+
+  /// Make all the staged nodes visible.
+  void Flush() {
+    if (!staging_.Empty()) {
+      std::lock_guard<std::mutex> lock(drain_mtx_);
+      Drain();
+    }
+  }
+
 private:
   io::NodeStorage* storage_;
+  StagingBuffer<io::NodeValue> staging_;
+  std::mutex drain_mtx_;
+  std::atomic<bool> restored_;
 };
 
 Noder* CreateLocalNoder() {
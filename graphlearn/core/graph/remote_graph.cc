@@ -39,6 +39,11 @@ public:
     return local_->GetLocalStorage();
   }
 
+  Status Restore(const io::SnapshotReader* reader,
+                 const std::string& prefix) override {
+    return local_->Restore(reader, prefix);
+  }
+
   Status UpdateEdges(const UpdateEdgesRequest* req,
                      UpdateEdgesResponse* res) override {
     return local_->UpdateEdges(req, res);
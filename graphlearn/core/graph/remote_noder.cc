@@ -39,6 +39,11 @@ public:
     return local_->GetLocalStorage();
   }
 
+  Status Restore(const io::SnapshotReader* reader,
+                 const std::string& prefix) override {
+    return local_->Restore(reader, prefix);
+  }
+
   Status UpdateNodes(const UpdateNodesRequest* req,
                      UpdateNodesResponse* res) override {
     return local_->UpdateNodes(req, res);
@@ -0,0 +1,143 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef GRAPHLEARN_CORE_GRAPH_STAGING_BUFFER_H_
+#define GRAPHLEARN_CORE_GRAPH_STAGING_BUFFER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <mutex>  // NOLINT [build/c++11]
+#include <vector>
+#include "graphlearn/include/config.h"
+
+namespace graphlearn {
+
+/// Values of the update requests from concurrent loaders are parsed into
+/// per-thread shards, without touching the shared storage. Whoever holds
+/// the storage drains the shards later in one pass, so that the loaders
+/// never wait for each other on the storage lock.
+///
+/// Value objects are recycled within a shard to avoid allocation for each
+/// element. Stage() and Drain() are thread-safe.
+template <class Value>
+class StagingBuffer {
+public:
+  StagingBuffer()
+      : shards_(std::max(GLOBAL_FLAG(InterThreadNum), 1)),
+        size_(0) {
+  }
+
+  ~StagingBuffer() = default;
+
+  /// Parse all the values of the request into the shard of current thread.
+  template <class Request>
+  void Stage(Request* req) {
+    Shard& shard = shards_[ShardIndex() % shards_.size()];
+    size_t n = req->Size();
+
+    ValueList values;
+    {
+      std::lock_guard<std::mutex> lock(shard.mtx);
+      size_t reuse = std::min(n, shard.pool.size());
+      values.reserve(n);
+      std::move(shard.pool.end() - reuse, shard.pool.end(),
+                std::back_inserter(values));
+      shard.pool.resize(shard.pool.size() - reuse);
+    }
+    while (values.size() < n) {
+      values.emplace_back(new Value);
+    }
+
+    size_t parsed = 0;
+    while (parsed < n && req->Next(values[parsed].get())) {
+      ++parsed;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(shard.mtx);
+      shard.staged.insert(shard.staged.end(),
+                          std::make_move_iterator(values.begin()),
+                          std::make_move_iterator(values.begin() + parsed));
+    }
+    size_ += parsed;
+  }
+
+  /// Call add(Value*) for each of the staged values, in the staged order
+  /// of each shard. The caller must serialize the calls of Drain().
+  template <class Func>
+  void Drain(Func add) {
+    ValueList batch;
+    for (auto& shard : shards_) {
+      {
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        batch.swap(shard.staged);
+      }
+      if (batch.empty()) {
+        continue;
+      }
+
+      for (auto& value : batch) {
+        add(value.get());
+      }
+      size_ -= batch.size();
+
+      std::lock_guard<std::mutex> lock(shard.mtx);
+      shard.pool.insert(shard.pool.end(),
+                        std::make_move_iterator(batch.begin()),
+                        std::make_move_iterator(batch.end()));
+      batch.clear();
+    }
+  }
+
+  /// Release the recycled values, which is called after loading done.
+  void Shrink() {
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mtx);
+      ValueList().swap(shard.pool);
+      if (shard.staged.empty()) {
+        ValueList().swap(shard.staged);
+      }
+    }
+  }
+
+  bool Empty() const {
+    return size_.load() == 0;
+  }
+
+private:
+  typedef std::vector<std::unique_ptr<Value>> ValueList;
+
+  struct Shard {
+    std::mutex mtx;
+    ValueList  staged;
+    ValueList  pool;
+  };
+
+  static size_t ShardIndex() {
+    static std::atomic<size_t> next(0);
+    static thread_local size_t index = next++;
+    return index;
+  }
+
+private:
+  std::vector<Shard>   shards_;
+  std::atomic<int64_t> size_;
+};
+
+}  // namespace graphlearn
+
+#endif  // GRAPHLEARN_CORE_GRAPH_STAGING_BUFFER_H_
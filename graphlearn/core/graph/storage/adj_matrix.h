@@ -17,9 +17,11 @@ limitations under the License.
 #define GRAPHLEARN_CORE_GRAPH_STORAGE_ADJ_MATRIX_H_
 
 #include <cstdint>
+#include <string>
 #include <vector>
 #include "graphlearn/core/graph/storage/auto_indexing.h"
 #include "graphlearn/core/graph/storage/edge_storage.h"
+#include "graphlearn/core/graph/storage/snapshot.h"
 #include "graphlearn/core/graph/storage/types.h"
 
 namespace graphlearn {
@@ -43,10 +45,27 @@ public:
 
   /// Get all the neighbor edge ids of a given id.
   virtual Array<IdType> GetOutEdges(IdType src_id) const = 0;
+
+  /// Get the neighbor count of a given id, without reading the neighbors.
+  virtual IndexType GetRowSize(IdType src_id) const = 0;
+
+  /// Dump the built data into a snapshot, with section names under `prefix`.
+  virtual Status Save(SnapshotWriter* writer,
+                      const std::string& prefix) const = 0;
+  /// Restore the built data from a snapshot, instead of adding and building.
+  /// Large arrays may be served from the mapping, so the reader must live
+  /// longer than the storage.
+  virtual Status Load(const SnapshotReader* reader,
+                      const std::string& prefix) = 0;
 };
 
 AdjMatrix* NewMemoryAdjMatrix(AutoIndex* indexing);
 AdjMatrix* NewCompressedMemoryAdjMatrix(AutoIndex* indexing);
+AdjMatrix* NewPackedMemoryAdjMatrix(AutoIndex* indexing);
+/// A compressed matrix indexed by the destination ids, which holds the
+/// source ids and the edge ids of the in-edges. It must be added and built
+/// after the edge ids are fixed, and it never re-arranges the edges.
+AdjMatrix* NewReversedMemoryAdjMatrix(AutoIndex* indexing);
 
 }  // namespace io
 }  // namespace graphlearn
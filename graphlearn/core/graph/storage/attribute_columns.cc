@@ -0,0 +1,252 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "graphlearn/core/graph/storage/attribute_columns.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "graphlearn/common/base/errors.h"
+#include "graphlearn/common/threading/runner/parallel_for.h"
+#include "graphlearn/core/graph/storage/float_codec.h"
+#include "graphlearn/core/graph/storage/storage_mode.h"
+
+namespace graphlearn {
+namespace io {
+
+namespace {
+
+/// Permute the rows of a row-major column with `num` values per row.
+template <class T>
+void PermuteRows(const IdList& order, int32_t num, ThreadPool* tp,
+                 std::vector<T>* values) {
+  if (num <= 0 || values->empty()) {
+    return;
+  }
+
+  std::vector<T> permuted(order.size() * num);
+  ParallelFor(tp, order.size(), 4096,
+    [&order, num, values, &permuted] (int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        T* src = values->data() + order[i] * num;
+        T* dst = permuted.data() + i * num;
+        for (int32_t j = 0; j < num; ++j) {
+          dst[j] = std::move(src[j]);
+        }
+      }
+    });
+  values->swap(permuted);
+}
+
+}  // anonymous namespace
+
+AttributeColumns::AttributeColumns(const SideInfo* info)
+    : info_(info), rows_(0), dict_(nullptr) {
+  if (IsSharedStringDictEnabled()) {
+    dict_ = StringDict::Shared();
+  } else if (IsStringDictEnabled()) {
+    own_dict_.reset(new StringDict);
+    dict_ = own_dict_.get();
+  }
+}
+
+void AttributeColumns::Add(const AttributeValue* value) {
+  auto ints = value->GetInts(nullptr);
+  ints_.values.insert(ints_.values.end(), ints, ints + info_->i_num);
+
+  auto floats = value->GetFloats(nullptr);
+  int32_t f_num = info_->f_num;
+  switch (info_->float_format) {
+  case kFp16:
+    for (int32_t i = 0; i < f_num; ++i) {
+      halfs_.values.push_back(FloatToHalf(floats[i]));
+    }
+    break;
+  case kBf16:
+    for (int32_t i = 0; i < f_num; ++i) {
+      halfs_.values.push_back(FloatToBf16(floats[i]));
+    }
+    break;
+  case kInt8:
+    quants_.values.resize(quants_.values.size() + f_num);
+    scales_.values.push_back(QuantizeInt8(
+      floats, f_num, quants_.values.data() + rows_ * f_num));
+    break;
+  default:
+    floats_.values.insert(floats_.values.end(), floats, floats + f_num);
+    break;
+  }
+
+  auto ss = value->GetStrings(nullptr);
+  for (int32_t i = 0; i < info_->s_num; ++i) {
+    if (dict_) {
+      codes_.push_back(dict_->Encode(ss[i]));
+    } else {
+      strings_.push_back(ss[i]);
+    }
+  }
+  ++rows_;
+}
+
+void AttributeColumns::Shrink() {
+  ints_.values.shrink_to_fit();
+  floats_.values.shrink_to_fit();
+  halfs_.values.shrink_to_fit();
+  quants_.values.shrink_to_fit();
+  scales_.values.shrink_to_fit();
+  strings_.shrink_to_fit();
+  codes_.shrink_to_fit();
+}
+
+void AttributeColumns::Reorder(const IdList& order, ThreadPool* tp) {
+  PermuteRows(order, info_->i_num, tp, &ints_.values);
+  PermuteRows(order, info_->f_num, tp, &floats_.values);
+  PermuteRows(order, info_->f_num, tp, &halfs_.values);
+  PermuteRows(order, info_->f_num, tp, &quants_.values);
+  PermuteRows(order, 1, tp, &scales_.values);
+  PermuteRows(order, info_->s_num, tp, &strings_);
+  PermuteRows(order, info_->s_num, tp, &codes_);
+}
+
+void AttributeColumns::Get(int64_t row, AttributeValue* value) const {
+  int32_t f_num = info_->f_num;
+  if (info_->i_num > 0) {
+    value->Add(ints_.Data() + row * info_->i_num, info_->i_num);
+  }
+  if (f_num > 0 && info_->float_format == kFp32) {
+    value->Add(floats_.Data() + row * f_num, f_num);
+  } else if (f_num > 0) {
+    DecodeFloats(row, value->MutableFloats(f_num));
+  }
+  for (int32_t i = 0; i < info_->s_num; ++i) {
+    const std::string& s = String(row * info_->s_num + i);
+    value->Add(s.c_str(), s.length());
+  }
+}
+
+void AttributeColumns::DecodeFloats(int64_t row, float* out) const {
+  int32_t f_num = info_->f_num;
+  switch (info_->float_format) {
+  case kFp16:
+    DecodeHalfs(halfs_.Data() + row * f_num, f_num, out);
+    break;
+  case kBf16:
+    DecodeBf16s(halfs_.Data() + row * f_num, f_num, out);
+    break;
+  case kInt8:
+    DequantizeInt8(quants_.Data() + row * f_num, f_num,
+                   scales_.Data()[row], out);
+    break;
+  default:
+    std::copy(floats_.Data() + row * f_num,
+              floats_.Data() + (row + 1) * f_num, out);
+    break;
+  }
+}
+
+Status AttributeColumns::Save(SnapshotWriter* writer,
+                              const std::string& prefix) const {
+  int64_t ints = rows_ * info_->i_num;
+  int64_t floats = rows_ * info_->f_num;
+  RETURN_IF_ERROR(writer->Write(prefix + ".ints", ints_.Data(),
+    ints * sizeof(int64_t)));
+  switch (info_->float_format) {
+  case kFp16:
+  case kBf16:
+    RETURN_IF_ERROR(writer->Write(prefix + ".halfs", halfs_.Data(),
+      floats * sizeof(uint16_t)));
+    break;
+  case kInt8:
+    RETURN_IF_ERROR(writer->Write(prefix + ".quants", quants_.Data(),
+      floats * sizeof(int8_t)));
+    RETURN_IF_ERROR(writer->Write(prefix + ".scales", scales_.Data(),
+      rows_ * sizeof(float)));
+    break;
+  default:
+    RETURN_IF_ERROR(writer->Write(prefix + ".floats", floats_.Data(),
+      floats * sizeof(float)));
+    break;
+  }
+
+  if (dict_) {
+    RETURN_IF_ERROR(dict_->Save(writer, prefix + ".string_dict"));
+    return writer->Write(prefix + ".string_codes", codes_);
+  } else {
+    return writer->WriteStrings(prefix + ".strings",
+                                strings_.data(), strings_.size());
+  }
+}
+
+Status AttributeColumns::Load(const SnapshotReader* reader,
+                              const std::string& prefix,
+                              int64_t rows) {
+  ints_ = Column<int64_t>();
+  floats_ = Column<float>();
+  halfs_ = Column<uint16_t>();
+  quants_ = Column<int8_t>();
+  scales_ = Column<float>();
+  strings_.clear();
+  codes_.clear();
+  rows_ = rows;
+
+  int64_t ints = 0;
+  int64_t floats = 0;
+  int64_t scales = rows;
+  RETURN_IF_ERROR(reader->View(prefix + ".ints", &ints_.mapped, &ints));
+  switch (info_->float_format) {
+  case kFp16:
+  case kBf16:
+    RETURN_IF_ERROR(reader->View(prefix + ".halfs", &halfs_.mapped, &floats));
+    break;
+  case kInt8:
+    RETURN_IF_ERROR(reader->View(prefix + ".quants", &quants_.mapped,
+                                 &floats));
+    RETURN_IF_ERROR(reader->View(prefix + ".scales", &scales_.mapped,
+                                 &scales));
+    break;
+  default:
+    RETURN_IF_ERROR(reader->View(prefix + ".floats", &floats_.mapped,
+                                 &floats));
+    break;
+  }
+
+  int64_t strings = 0;
+  if (dict_) {
+    std::vector<int32_t> remap;
+    RETURN_IF_ERROR(dict_->Load(reader, prefix + ".string_dict", &remap));
+    RETURN_IF_ERROR(reader->Read(prefix + ".string_codes", &codes_));
+    for (auto& code : codes_) {
+      if (code < 0 || code >= static_cast<int32_t>(remap.size())) {
+        return error::DataLoss("Invalid string codes in snapshot: " + prefix);
+      }
+      code = remap[code];
+    }
+    strings = codes_.size();
+  } else {
+    RETURN_IF_ERROR(reader->ReadStrings(prefix + ".strings", &strings_));
+    strings = strings_.size();
+  }
+
+  if (ints != rows * info_->i_num ||
+      floats != rows * info_->f_num ||
+      scales != rows ||
+      strings != rows * info_->s_num) {
+    return error::DataLoss("Invalid attributes in snapshot: " + prefix);
+  }
+  return Status::OK();
+}
+
+}  // namespace io
+}  // namespace graphlearn
@@ -0,0 +1,199 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef GRAPHLEARN_CORE_GRAPH_STORAGE_ATTRIBUTE_COLUMNS_H_
+#define GRAPHLEARN_CORE_GRAPH_STORAGE_ATTRIBUTE_COLUMNS_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "graphlearn/common/threading/runner/threadpool.h"
+#include "graphlearn/core/graph/storage/snapshot.h"
+#include "graphlearn/core/graph/storage/string_dict.h"
+#include "graphlearn/core/graph/storage/types.h"
+#include "graphlearn/include/status.h"
+
+namespace graphlearn {
+namespace io {
+
+/// The attributes of a storage in column mode. Each kind of attributes is
+/// held as one row-major column, with i_num, f_num or s_num values per row.
+/// Strings are held as dictionary codes if IsStringDictEnabled(), and floats
+/// are held in the float_format of the side info, which are decoded back to
+/// fp32 when read.
+class AttributeColumns {
+public:
+  explicit AttributeColumns(const SideInfo* info);
+  ~AttributeColumns() = default;
+
+  /// Append a row, which must match the side info.
+  void Add(const AttributeValue* value);
+  void Shrink();
+
+  /// Re-arrange the rows so that the one at order[i] comes to row i.
+  void Reorder(const IdList& order, ThreadPool* tp);
+
+  /// Refer `value`, which is a data-ref attribute value, to the row.
+  void Get(int64_t row, AttributeValue* value) const;
+
+  /// Gather the rows at `indices` into `out`, which holds `size` rows of
+  /// values. An index out of the rows gets the default values.
+  template <class Index>
+  void GatherInts(const Index* indices, int32_t size, int64_t* out) const;
+  template <class Index>
+  void GatherFloats(const Index* indices, int32_t size, float* out) const;
+  template <class Index>
+  void GatherStrings(const Index* indices, int32_t size,
+                     const std::string** out) const;
+  /// -1 for the default values, or for all without a string dictionary.
+  template <class Index>
+  void GatherStringCodes(const Index* indices, int32_t size,
+                         int32_t* out) const;
+
+  const StringDict* GetStringDict() const {
+    return dict_;
+  }
+
+  /// The int and float columns are served from the mapping after Load().
+  Status Save(SnapshotWriter* writer, const std::string& prefix) const;
+  Status Load(const SnapshotReader* reader, const std::string& prefix,
+              int64_t rows);
+
+private:
+  /// A column held in memory, or viewed from a snapshot after Load().
+  template <class T>
+  struct Column {
+    std::vector<T> values;
+    const T*       mapped = nullptr;
+
+    const T* Data() const {
+      return mapped ? mapped : values.data();
+    }
+  };
+
+  int64_t Rows() const {
+    return rows_;
+  }
+
+  const std::string& String(int64_t pos) const {
+    return dict_ ? dict_->Decode(codes_[pos]) : strings_[pos];
+  }
+
+  /// Decode the f_num floats of the row from a reduced precision column.
+  void DecodeFloats(int64_t row, float* out) const;
+
+private:
+  const SideInfo* info_;
+  int64_t         rows_;
+
+  Column<int64_t>          ints_;
+  Column<float>            floats_;
+  // Floats in kFp16 or kBf16, instead of floats_.
+  Column<uint16_t>         halfs_;
+  // Floats in kInt8 with a scale per row, instead of floats_.
+  Column<int8_t>           quants_;
+  Column<float>            scales_;
+  std::vector<std::string> strings_;
+  // Dictionary codes of the strings, instead of strings_.
+  std::vector<int32_t>     codes_;
+  StringDict*                 dict_;
+  std::unique_ptr<StringDict> own_dict_;
+};
+
+template <class Index>
+void AttributeColumns::GatherInts(const Index* indices, int32_t size,
+                                  int64_t* out) const {
+  if (info_->i_num > 0) {
+    GatherRows(ints_.Data(), Rows(), info_->i_num, indices, size,
+               AttributeValue::Default(info_)->GetInts(nullptr), out);
+  }
+}
+
+template <class Index>
+void AttributeColumns::GatherFloats(const Index* indices, int32_t size,
+                                    float* out) const {
+  int32_t num = info_->f_num;
+  if (num <= 0) {
+    return;
+  }
+
+  const float* defaults = AttributeValue::Default(info_)->GetFloats(nullptr);
+  if (info_->float_format == kFp32) {
+    GatherRows(floats_.Data(), Rows(), num, indices, size, defaults, out);
+    return;
+  }
+
+  for (int32_t i = 0; i < size; ++i, out += num) {
+    Index index = indices[i];
+    if (index >= 0 && index < Rows()) {
+      DecodeFloats(index, out);
+    } else {
+      std::copy(defaults, defaults + num, out);
+    }
+  }
+}
+
+template <class Index>
+void AttributeColumns::GatherStrings(const Index* indices, int32_t size,
+                                     const std::string** out) const {
+  int32_t num = info_->s_num;
+  if (num <= 0) {
+    return;
+  }
+
+  const std::string* defaults =
+    AttributeValue::Default(info_)->GetStrings(nullptr);
+  if (!dict_) {
+    GatherRows(strings_.data(), Rows(), num, indices, size, defaults, out);
+    return;
+  }
+
+  for (int32_t i = 0; i < size; ++i, out += num) {
+    Index index = indices[i];
+    if (index >= 0 && index < Rows()) {
+      const int32_t* codes = codes_.data() + index * num;
+      for (int32_t j = 0; j < num; ++j) {
+        out[j] = &(dict_->Decode(codes[j]));
+      }
+    } else {
+      for (int32_t j = 0; j < num; ++j) {
+        out[j] = defaults + j;
+      }
+    }
+  }
+}
+
+template <class Index>
+void AttributeColumns::GatherStringCodes(const Index* indices, int32_t size,
+                                         int32_t* out) const {
+  int32_t num = info_->s_num;
+  if (num <= 0) {
+    return;
+  }
+
+  if (!dict_) {
+    std::fill(out, out + size * num, -1);
+    return;
+  }
+  std::vector<int32_t> defaults(num, -1);
+  GatherRows(codes_.data(), Rows(), num, indices, size, defaults.data(), out);
+}
+
+}  // namespace io
+}  // namespace graphlearn
+
+#endif  // GRAPHLEARN_CORE_GRAPH_STORAGE_ATTRIBUTE_COLUMNS_H_
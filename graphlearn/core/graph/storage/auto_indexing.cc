@@ -15,21 +15,136 @@ limitations under the License.
 
 #include "graphlearn/core/graph/storage/auto_indexing.h"
 
+#include <algorithm>
+#include <limits>
+#include "graphlearn/common/base/errors.h"
+
 namespace graphlearn {
 namespace io {
 
-void AutoIndex::Add(IdType id) {
-  IndexType index = converter_.size();
-  converter_.insert({id, index});
+AutoIndex::AutoIndex() : mode_(kHashed), base_(0), size_(0) {
+}
+
+bool AutoIndex::Add(IdType id) {
+  if (mode_ != kHashed) {
+    if (Get(id) != -1) {
+      return false;
+    }
+    // Rarely happens, adding after Build().
+    ToHashed();
+  }
+
+  if (!converter_.Insert(id, size_)) {
+    return false;
+  }
+  ++size_;
+  return true;
+}
+
+void AutoIndex::GetBatch(const IdType* ids, int32_t size,
+                         IndexType* indices) const {
+  if (mode_ == kHashed) {
+    converter_.FindBatch(ids, size, indices);
+  } else {
+    for (int32_t i = 0; i < size; ++i) {
+      indices[i] = Get(ids[i]);
+    }
+  }
 }
 
-IndexType AutoIndex::Get(IdType id) {
-  auto it = converter_.find(id);
-  if (it == converter_.end()) {
-    return -1;
+void AutoIndex::GetIds(IdList* ids) const {
+  ids->resize(size_);
+  if (mode_ == kIdentity) {
+    for (IndexType i = 0; i < size_; ++i) {
+      (*ids)[i] = base_ + i;
+    }
+  } else if (mode_ == kDense) {
+    for (IndexType i = 0; i < size_; ++i) {
+      (*ids)[dense_[i]] = base_ + i;
+    }
   } else {
-    return it->second;
+    converter_.ForEach([ids] (IdType id, IndexType index) {
+      (*ids)[index] = id;
+    });
+  }
+}
+
+void AutoIndex::Reserve(int64_t size) {
+  if (mode_ == kHashed) {
+    converter_.Reserve(size);
+  }
+}
+
+void AutoIndex::Build() {
+  if (mode_ != kHashed || size_ == 0) {
+    return;
+  }
+
+  IdType min_id = std::numeric_limits<IdType>::max();
+  IdType max_id = std::numeric_limits<IdType>::min();
+  converter_.ForEach([&min_id, &max_id] (IdType id, IndexType index) {
+    min_id = std::min(min_id, id);
+    max_id = std::max(max_id, id);
+  });
+  uint64_t span = static_cast<uint64_t>(max_id) - static_cast<uint64_t>(min_id);
+  if (span != static_cast<uint64_t>(size_ - 1)) {
+    converter_.Shrink();
+    return;
+  }
+
+  IndexList dense(size_);
+  bool identity = true;
+  converter_.ForEach([&dense, &identity, min_id] (IdType id, IndexType index) {
+    dense[id - min_id] = index;
+    identity = identity && (id - min_id == index);
+  });
+
+  base_ = min_id;
+  if (identity) {
+    mode_ = kIdentity;
+  } else {
+    mode_ = kDense;
+    dense_.swap(dense);
+  }
+  converter_.Clear();
+}
+
+Status AutoIndex::Save(SnapshotWriter* writer,
+                       const std::string& prefix) const {
+  int32_t mode = mode_;
+  RETURN_IF_ERROR(writer->Write(prefix + ".mode", mode));
+  RETURN_IF_ERROR(writer->Write(prefix + ".base", base_));
+  RETURN_IF_ERROR(writer->Write(prefix + ".size", size_));
+  if (mode_ == kDense) {
+    return writer->Write(prefix + ".dense", dense_);
+  } else if (mode_ == kHashed) {
+    return converter_.Save(writer, prefix + ".hash");
+  }
+  return Status::OK();
+}
+
+Status AutoIndex::Load(const SnapshotReader* reader,
+                       const std::string& prefix) {
+  int32_t mode = kHashed;
+  RETURN_IF_ERROR(reader->Read(prefix + ".mode", &mode));
+  RETURN_IF_ERROR(reader->Read(prefix + ".base", &base_));
+  RETURN_IF_ERROR(reader->Read(prefix + ".size", &size_));
+  mode_ = static_cast<Mode>(mode);
+  if (mode_ == kDense) {
+    return reader->Read(prefix + ".dense", &dense_);
+  } else if (mode_ == kHashed) {
+    return converter_.Load(reader, prefix + ".hash");
+  }
+  return Status::OK();
+}
+
+void AutoIndex::ToHashed() {
+  converter_.Reserve(size_);
+  for (IndexType i = 0; i < size_; ++i) {
+    converter_.Insert(base_ + i, mode_ == kDense ? dense_[i] : i);
   }
+  IndexList().swap(dense_);
+  mode_ = kHashed;
 }
 
 }  // namespace io
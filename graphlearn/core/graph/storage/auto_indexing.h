@@ -17,22 +17,81 @@ limitations under the License.
 #define GRAPHLEARN_CORE_GRAPH_STORAGE_AUTO_INDEXING_H_
 
 #include <cstdint>
+#include <string>
 #include <vector>
+#include "graphlearn/core/graph/storage/id_hash_map.h"
+#include "graphlearn/core/graph/storage/snapshot.h"
 #include "graphlearn/core/graph/storage/types.h"
 
 namespace graphlearn {
 namespace io {
 
+/// Assign each distinct id with an auto-increment index from 0.
+///
+/// Ids are hashed while adding. When Build(), if the ids turn out to be
+/// dense, that is exactly [min_id, min_id + size), the hash map is freed
+/// and an id is located by direct array indexing with bounds check. If the
+/// ids were also added in ascending order, which is common for graphs whose
+/// ids are remapped before loading, no array is needed at all.
 class AutoIndex {
 public:
-  AutoIndex() = default;
+  AutoIndex();
   ~AutoIndex() = default;
 
-  void Add(IdType id);
-  IndexType Get(IdType);
+  /// Return false if the id has been added before.
+  bool Add(IdType id);
+
+  /// Return -1 if the id not found.
+  IndexType Get(IdType id) const {
+    if (mode_ == kHashed) {
+      return converter_.Find(id);
+    }
+    uint64_t offset =
+      static_cast<uint64_t>(id) - static_cast<uint64_t>(base_);
+    if (offset >= static_cast<uint64_t>(size_)) {
+      return -1;
+    }
+    return mode_ == kIdentity ? offset : dense_[offset];
+  }
+
+  /// Get the indices of a batch of ids, -1 for the not found ones.
+  void GetBatch(const IdType* ids, int32_t size, IndexType* indices) const;
+
+  /// Get the id of each index, which is the inverse of Get().
+  void GetIds(IdList* ids) const;
+
+  void Reserve(int64_t size);
+
+  /// Called after data fixed. Switch to direct indexing if the ids are
+  /// dense, otherwise shrink the hash map to fit.
+  void Build();
+
+  Status Save(SnapshotWriter* writer, const std::string& prefix) const;
+  Status Load(const SnapshotReader* reader, const std::string& prefix);
+
+  bool IsDense() const {
+    return mode_ != kHashed;
+  }
+
+  IndexType Size() const {
+    return size_;
+  }
+
+private:
+  enum Mode {
+    kHashed,
+    kDense,     // index = dense_[id - base_]
+    kIdentity   // index = id - base_
+  };
+
+  void ToHashed();
 
 private:
-  MAP converter_;
+  Mode      mode_;
+  IdType    base_;
+  IndexType size_;
+  IdHashMap converter_;
+  IndexList dense_;
 };
 
 }  // namespace io
@@ -13,33 +13,32 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <vector>
+#include "graphlearn/common/base/errors.h"
 #include "graphlearn/common/base/log.h"
+#include "graphlearn/core/graph/storage/attribute_columns.h"
 #include "graphlearn/core/graph/storage/edge_storage.h"
 #include "graphlearn/include/config.h"
+#include "graphlearn/platform/env.h"
 
 namespace graphlearn {
 namespace io {
 
 class CompressedMemoryEdgeStorage : public EdgeStorage {
 public:
-  CompressedMemoryEdgeStorage()
-      : attributes_(nullptr) {
+  CompressedMemoryEdgeStorage() : attributes_(&side_info_) {
     int64_t estimate_size = GLOBAL_FLAG(AverageEdgeCount);
     src_ids_.reserve(estimate_size);
     dst_ids_.reserve(estimate_size);
   }
 
   virtual ~CompressedMemoryEdgeStorage() {
-    delete attributes_;
   }
 
   void SetSideInfo(const SideInfo* info) override {
     if (!side_info_.IsInitialized()) {
       side_info_.CopyFrom(*info);
-      if (side_info_.IsAttributed()) {
-        attributes_ = NewDataHeldAttributeValue();
-      }
     }
   }
 
@@ -52,8 +51,23 @@ public:
     dst_ids_.shrink_to_fit();
     labels_.shrink_to_fit();
     weights_.shrink_to_fit();
-    if (attributes_) {
-      attributes_->Shrink();
+    attributes_.Shrink();
+  }
+
+  void Reorder(const IdList& order, bool keep_ids) override {
+    ThreadPool* tp = Env::Default()->IntraThreadPool();
+    Permute(order, &src_ids_, tp);
+    Permute(order, &dst_ids_, tp);
+    Permute(order, &weights_, tp);
+    Permute(order, &labels_, tp);
+
+    attributes_.Reorder(order, tp);
+
+    if (keep_ids) {
+      id_remap_.resize(order.size());
+      for (size_t i = 0; i < order.size(); ++i) {
+        id_remap_[order[i]] = i;
+      }
     }
   }
 
@@ -61,6 +75,36 @@ public:
     return src_ids_.size();
   }
 
+  Status Save(SnapshotWriter* writer,
+              const std::string& prefix) const override {
+    RETURN_IF_ERROR(SaveSideInfo(writer, prefix, side_info_));
+    RETURN_IF_ERROR(writer->Write(prefix + ".src_ids", src_ids_));
+    RETURN_IF_ERROR(writer->Write(prefix + ".dst_ids", dst_ids_));
+    RETURN_IF_ERROR(writer->Write(prefix + ".weights", weights_));
+    RETURN_IF_ERROR(writer->Write(prefix + ".labels", labels_));
+    RETURN_IF_ERROR(writer->Write(prefix + ".id_remap", id_remap_));
+    if (side_info_.IsAttributed()) {
+      RETURN_IF_ERROR(attributes_.Save(writer, prefix + ".attributes"));
+    }
+    return Status::OK();
+  }
+
+  /// The int and float attributes are served from the mapping.
+  Status Load(const SnapshotReader* reader,
+              const std::string& prefix) override {
+    RETURN_IF_ERROR(LoadSideInfo(reader, prefix, &side_info_));
+    RETURN_IF_ERROR(reader->Read(prefix + ".src_ids", &src_ids_));
+    RETURN_IF_ERROR(reader->Read(prefix + ".dst_ids", &dst_ids_));
+    RETURN_IF_ERROR(reader->Read(prefix + ".weights", &weights_));
+    RETURN_IF_ERROR(reader->Read(prefix + ".labels", &labels_));
+    RETURN_IF_ERROR(reader->Read(prefix + ".id_remap", &id_remap_));
+    if (side_info_.IsAttributed()) {
+      RETURN_IF_ERROR(attributes_.Load(reader, prefix + ".attributes",
+                                       Size()));
+    }
+    return Status::OK();
+  }
+
   IdType Add(EdgeValue* value) override {
     if (!Validate(value)) {
       LOG(WARNING) << "Ignore an invalid edge value";
@@ -79,49 +123,42 @@ public:
       labels_.push_back(value->label);
     }
     if (side_info_.IsAttributed()) {
-      auto ints = value->attrs->GetInts(nullptr);
-      for (int32_t i = 0; i < side_info_.i_num; ++i) {
-        attributes_->Add(ints[i]);
-      }
-      auto floats = value->attrs->GetFloats(nullptr);
-      for (int32_t i = 0; i < side_info_.f_num; ++i) {
-        attributes_->Add(floats[i]);
-      }
-      auto ss = value->attrs->GetStrings(nullptr);
-      for (int32_t i = 0; i < side_info_.s_num; ++i) {
-        attributes_->Add(ss[i]);
-      }
+      attributes_.Add(value->attrs);
     }
     return edge_id;
   }
 
   IdType GetSrcId(IdType edge_id) const override {
-    if (edge_id < Size()) {
-      return src_ids_[edge_id];
+    IdType index = Locate(edge_id);
+    if (index < Size()) {
+      return src_ids_[index];
     } else {
       return -1;
     }
   }
 
   IdType GetDstId(IdType edge_id) const override {
-    if (edge_id < Size()) {
-      return dst_ids_[edge_id];
+    IdType index = Locate(edge_id);
+    if (index < Size()) {
+      return dst_ids_[index];
     } else {
       return -1;
     }
   }
 
   float GetWeight(IdType edge_id) const override {
-    if (edge_id < weights_.size()) {
-      return weights_[edge_id];
+    IdType index = Locate(edge_id);
+    if (index < weights_.size()) {
+      return weights_[index];
     } else {
       return 0.0;
     }
   }
 
   int32_t GetLabel(IdType edge_id) const override {
-    if (edge_id < labels_.size()) {
-      return labels_[edge_id];
+    IdType index = Locate(edge_id);
+    if (index < labels_.size()) {
+      return labels_[index];
     } else {
       return -1;
     }
@@ -131,29 +168,68 @@ public:
     if (!side_info_.IsAttributed()) {
       return Attribute();
     }
-    if (edge_id < Size()) {
+
+    IdType index = Locate(edge_id);
+    if (index < Size()) {
       auto value = NewDataRefAttributeValue();
-      if (side_info_.i_num > 0) {
-        int64_t offset = edge_id * side_info_.i_num;
-        value->Add(attributes_->GetInts(nullptr) + offset, side_info_.i_num);
-      }
-      if (side_info_.f_num > 0) {
-        int64_t offset = edge_id * side_info_.f_num;
-        value->Add(attributes_->GetFloats(nullptr) + offset, side_info_.f_num);
-      }
-      if (side_info_.s_num > 0) {
-        int64_t offset = edge_id * side_info_.s_num;
-        auto ss = attributes_->GetStrings(nullptr) + offset;
-        for (int32_t i = 0; i < side_info_.s_num; ++i) {
-          value->Add(ss[i].c_str(), ss[i].length());
-        }
-      }
+      attributes_.Get(index, value);
       return Attribute(value, true);
     } else {
       return Attribute(AttributeValue::Default(&side_info_), false);
     }
   }
 
+  void GatherWeights(const IdType* edge_ids, int32_t size,
+                     float* out) const override {
+    const float kDefault = 0.0;
+    Gather(edge_ids, size, weights_.data(), weights_.size(), 1,
+           &kDefault, out);
+  }
+
+  void GatherLabels(const IdType* edge_ids, int32_t size,
+                    int32_t* out) const override {
+    const int32_t kDefault = -1;
+    Gather(edge_ids, size, labels_.data(), labels_.size(), 1,
+           &kDefault, out);
+  }
+
+  void GatherInts(const IdType* edge_ids, int32_t size,
+                  int64_t* out) const override {
+    ForEachChunk(edge_ids, size,
+      [this, out] (const IdType* indices, int32_t n, int32_t begin) {
+        attributes_.GatherInts(indices, n, out + begin * side_info_.i_num);
+      });
+  }
+
+  void GatherFloats(const IdType* edge_ids, int32_t size,
+                    float* out) const override {
+    ForEachChunk(edge_ids, size,
+      [this, out] (const IdType* indices, int32_t n, int32_t begin) {
+        attributes_.GatherFloats(indices, n, out + begin * side_info_.f_num);
+      });
+  }
+
+  void GatherStrings(const IdType* edge_ids, int32_t size,
+                     const std::string** out) const override {
+    ForEachChunk(edge_ids, size,
+      [this, out] (const IdType* indices, int32_t n, int32_t begin) {
+        attributes_.GatherStrings(indices, n, out + begin * side_info_.s_num);
+      });
+  }
+
+  const StringDict* GetStringDict() const override {
+    return attributes_.GetStringDict();
+  }
+
+  void GatherStringCodes(const IdType* edge_ids, int32_t size,
+                         int32_t* out) const override {
+    ForEachChunk(edge_ids, size,
+      [this, out] (const IdType* indices, int32_t n, int32_t begin) {
+        attributes_.GatherStringCodes(indices, n,
+                                      out + begin * side_info_.s_num);
+      });
+  }
+
   const IdList* GetSrcIds() const override {
     return &src_ids_;
   }
@@ -199,13 +275,52 @@ private:
     return true;
   }
 
+  /// Locate the edge ids chunk by chunk, and call func(indices, n, begin)
+  /// for the n ids from `begin`.
+  template <class Func>
+  void ForEachChunk(const IdType* edge_ids, int32_t size, Func func) const {
+    IdType indices[kGatherChunkSize];
+    for (int32_t begin = 0; begin < size; begin += kGatherChunkSize) {
+      int32_t n = std::min(size - begin, kGatherChunkSize);
+      for (int32_t i = 0; i < n; ++i) {
+        indices[i] = Locate(edge_ids[begin + i]);
+      }
+      func(indices, n, begin);
+    }
+  }
+
+  template <class T>
+  void Gather(const IdType* edge_ids, int32_t size,
+              const T* column, int64_t rows, int32_t num,
+              const T* defaults, T* out) const {
+    ForEachChunk(edge_ids, size,
+      [=] (const IdType* indices, int32_t n, int32_t begin) {
+        GatherRows(column, rows, num, indices, n, defaults,
+                   out + begin * num);
+      });
+  }
+
+  /// Size() for an invalid edge id.
+  IdType Locate(IdType edge_id) const {
+    if (edge_id < 0) {
+      return Size();
+    } else if (id_remap_.empty()) {
+      return edge_id;
+    } else if (edge_id < static_cast<IdType>(id_remap_.size())) {
+      return id_remap_[edge_id];
+    } else {
+      return Size();
+    }
+  }
+
 private:
   IdList     src_ids_;
   IdList     dst_ids_;
   std::vector<float>   weights_;
   std::vector<int32_t> labels_;
-  AttributeValue*      attributes_;
+  AttributeColumns     attributes_;
   SideInfo             side_info_;
+  IdList               id_remap_;
 };
 
 EdgeStorage* NewCompressedMemoryEdgeStorage() {
@@ -13,8 +13,13 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <atomic>
 #include <mutex>   // NOLINT [build/c++11]
+#include "graphlearn/common/base/errors.h"
 #include "graphlearn/common/base/log.h"
+#include "graphlearn/core/graph/storage/attribute_columns.h"
+#include "graphlearn/core/graph/storage/auto_indexing.h"
 #include "graphlearn/core/graph/storage/node_storage.h"
 #include "graphlearn/include/config.h"
 
@@ -24,14 +29,13 @@ namespace io {
 class CompressedMemoryNodeStorage : public NodeStorage {
 public:
   CompressedMemoryNodeStorage()
-      : attributes_(nullptr) {
+      : attributes_(&side_info_), version_(NewStorageVersion()) {
     int64_t estimate_size = GLOBAL_FLAG(AverageNodeCount);
-    id_to_index_.rehash(estimate_size);
+    id_to_index_.Reserve(estimate_size);
     ids_.reserve(estimate_size);
   }
 
   virtual ~CompressedMemoryNodeStorage() {
-    delete attributes_;
   }
 
   void Lock() override {
@@ -45,9 +49,6 @@ public:
   void SetSideInfo(const SideInfo* info) override {
     if (!side_info_.IsInitialized()) {
       side_info_.CopyFrom(*info);
-      if (side_info_.IsAttributed()) {
-        attributes_ = NewDataHeldAttributeValue();
-      }
     }
   }
 
@@ -56,12 +57,48 @@ public:
   }
 
   void Build() override {
+    version_ = NewStorageVersion();
+    id_to_index_.Build();
     ids_.shrink_to_fit();
     labels_.shrink_to_fit();
     weights_.shrink_to_fit();
-    if (attributes_) {
-      attributes_->Shrink();
+    attributes_.Shrink();
+  }
+
+  Status Save(SnapshotWriter* writer,
+              const std::string& prefix) const override {
+    RETURN_IF_ERROR(SaveSideInfo(writer, prefix, side_info_));
+    RETURN_IF_ERROR(id_to_index_.Save(writer, prefix + ".index"));
+    RETURN_IF_ERROR(writer->Write(prefix + ".ids", ids_));
+    RETURN_IF_ERROR(writer->Write(prefix + ".weights", weights_));
+    RETURN_IF_ERROR(writer->Write(prefix + ".labels", labels_));
+    if (side_info_.IsAttributed()) {
+      RETURN_IF_ERROR(attributes_.Save(writer, prefix + ".attributes"));
+    }
+    return Status::OK();
+  }
+
+  /// The int and float attributes are served from the mapping.
+  Status Load(const SnapshotReader* reader,
+              const std::string& prefix) override {
+    version_ = NewStorageVersion();
+    RETURN_IF_ERROR(LoadSideInfo(reader, prefix, &side_info_));
+    RETURN_IF_ERROR(id_to_index_.Load(reader, prefix + ".index"));
+    RETURN_IF_ERROR(reader->Read(prefix + ".ids", &ids_));
+    RETURN_IF_ERROR(reader->Read(prefix + ".weights", &weights_));
+    RETURN_IF_ERROR(reader->Read(prefix + ".labels", &labels_));
+    if (side_info_.IsAttributed()) {
+      RETURN_IF_ERROR(attributes_.Load(reader, prefix + ".attributes",
+                                       Size()));
+    }
+    if (id_to_index_.Size() != Size()) {
+      return error::DataLoss("Invalid node index in snapshot: " + prefix);
     }
+    return Status::OK();
+  }
+
+  int64_t GetVersion() const override {
+    return version_;
   }
 
   IdType Size() const override {
@@ -74,8 +111,7 @@ public:
       return;
     }
 
-    auto ret = id_to_index_.insert({value->id, ids_.size()});
-    if (!ret.second) {
+    if (!id_to_index_.Add(value->id)) {
       return;
     }
 
@@ -88,18 +124,7 @@ public:
       labels_.push_back(value->label);
     }
     if (side_info_.IsAttributed()) {
-      auto ints = value->attrs->GetInts(nullptr);
-      for (int32_t i = 0; i < side_info_.i_num; ++i) {
-        attributes_->Add(ints[i]);
-      }
-      auto floats = value->attrs->GetFloats(nullptr);
-      for (int32_t i = 0; i < side_info_.f_num; ++i) {
-        attributes_->Add(floats[i]);
-      }
-      auto ss = value->attrs->GetStrings(nullptr);
-      for (int32_t i = 0; i < side_info_.s_num; ++i) {
-        attributes_->Add(ss[i]);
-      }
+      attributes_.Add(value->attrs);
     }
   }
 
@@ -108,11 +133,11 @@ public:
       return 0.0;
     }
 
-    auto it = id_to_index_.find(node_id);
-    if (it == id_to_index_.end()) {
+    IndexType index = id_to_index_.Get(node_id);
+    if (index == -1) {
       return 0.0;
     } else {
-      return weights_[it->second];
+      return weights_[index];
     }
   }
 
@@ -121,11 +146,11 @@ public:
       return -1;
     }
 
-    auto it = id_to_index_.find(node_id);
-    if (it == id_to_index_.end()) {
+    IndexType index = id_to_index_.Get(node_id);
+    if (index == -1) {
       return -1;
     } else {
-      return labels_[it->second];
+      return labels_[index];
     }
   }
 
@@ -134,30 +159,67 @@ public:
       return Attribute();
     }
 
-    auto it = id_to_index_.find(node_id);
-    if (it == id_to_index_.end()) {
+    IndexType index = id_to_index_.Get(node_id);
+    if (index == -1) {
       return Attribute(AttributeValue::Default(&side_info_), false);
     } else {
       auto value = NewDataRefAttributeValue();
-      if (side_info_.i_num > 0) {
-        int64_t offset = it->second * side_info_.i_num;
-        value->Add(attributes_->GetInts(nullptr) + offset, side_info_.i_num);
-      }
-      if (side_info_.f_num > 0) {
-        int64_t offset = it->second * side_info_.f_num;
-        value->Add(attributes_->GetFloats(nullptr) + offset, side_info_.f_num);
-      }
-      if (side_info_.s_num > 0) {
-        int64_t offset = it->second * side_info_.s_num;
-        auto ss = attributes_->GetStrings(nullptr) + offset;
-        for (int32_t i = 0; i < side_info_.s_num; ++i) {
-          value->Add(ss[i].c_str(), ss[i].length());
-        }
-      }
+      attributes_.Get(index, value);
       return Attribute(value, true);
     }
   }
 
+  void GatherWeights(const IdType* node_ids, int32_t size,
+                     float* out) const override {
+    const float kDefault = 0.0;
+    Gather(node_ids, size, weights_.data(), weights_.size(), 1,
+           &kDefault, out);
+  }
+
+  void GatherLabels(const IdType* node_ids, int32_t size,
+                    int32_t* out) const override {
+    const int32_t kDefault = -1;
+    Gather(node_ids, size, labels_.data(), labels_.size(), 1,
+           &kDefault, out);
+  }
+
+  void GatherInts(const IdType* node_ids, int32_t size,
+                  int64_t* out) const override {
+    ForEachChunk(node_ids, size,
+      [this, out] (const IndexType* indices, int32_t n, int32_t begin) {
+        attributes_.GatherInts(indices, n, out + begin * side_info_.i_num);
+      });
+  }
+
+  void GatherFloats(const IdType* node_ids, int32_t size,
+                    float* out) const override {
+    ForEachChunk(node_ids, size,
+      [this, out] (const IndexType* indices, int32_t n, int32_t begin) {
+        attributes_.GatherFloats(indices, n, out + begin * side_info_.f_num);
+      });
+  }
+
+  void GatherStrings(const IdType* node_ids, int32_t size,
+                     const std::string** out) const override {
+    ForEachChunk(node_ids, size,
+      [this, out] (const IndexType* indices, int32_t n, int32_t begin) {
+        attributes_.GatherStrings(indices, n, out + begin * side_info_.s_num);
+      });
+  }
+
+  const StringDict* GetStringDict() const override {
+    return attributes_.GetStringDict();
+  }
+
+  void GatherStringCodes(const IdType* node_ids, int32_t size,
+                         int32_t* out) const override {
+    ForEachChunk(node_ids, size,
+      [this, out] (const IndexType* indices, int32_t n, int32_t begin) {
+        attributes_.GatherStringCodes(indices, n,
+                                      out + begin * side_info_.s_num);
+      });
+  }
+
   const IdList* GetIds() const override {
     return &ids_;
   }
@@ -175,6 +237,29 @@ public:
   }
 
 private:
+  /// Resolve the node ids to row indices chunk by chunk, and call
+  /// func(indices, n, begin) for the n ids from `begin`.
+  template <class Func>
+  void ForEachChunk(const IdType* node_ids, int32_t size, Func func) const {
+    IndexType indices[kGatherChunkSize];
+    for (int32_t begin = 0; begin < size; begin += kGatherChunkSize) {
+      int32_t n = std::min(size - begin, kGatherChunkSize);
+      id_to_index_.GetBatch(node_ids + begin, n, indices);
+      func(indices, n, begin);
+    }
+  }
+
+  template <class T>
+  void Gather(const IdType* node_ids, int32_t size,
+              const T* column, int64_t rows, int32_t num,
+              const T* defaults, T* out) const {
+    ForEachChunk(node_ids, size,
+      [=] (const IndexType* indices, int32_t n, int32_t begin) {
+        GatherRows(column, rows, num, indices, n, defaults,
+                   out + begin * num);
+      });
+  }
+
   bool Validate(NodeValue* value) {
     if (!side_info_.IsAttributed()) {
       return true;
@@ -201,12 +286,13 @@ private:
 
 private:
   std::mutex mtx_;
-  MAP        id_to_index_;
+  AutoIndex  id_to_index_;
   IdList     ids_;
   std::vector<float>   weights_;
   std::vector<int32_t> labels_;
-  AttributeValue*      attributes_;
+  AttributeColumns     attributes_;
   SideInfo             side_info_;
+  std::atomic<int64_t> version_;
 };
 
 NodeStorage* NewCompressedMemoryNodeStorage() {
@@ -17,7 +17,10 @@ limitations under the License.
 #define GRAPHLEARN_CORE_GRAPH_STORAGE_EDGE_STORAGE_H_
 
 #include <cstdint>
+#include <string>
 #include <vector>
+#include "graphlearn/core/graph/storage/snapshot.h"
+#include "graphlearn/core/graph/storage/string_dict.h"
 #include "graphlearn/core/graph/storage/types.h"
 
 namespace graphlearn {
@@ -33,6 +36,22 @@ public:
   /// Do some re-organization after data fixed.
   virtual void Build() = 0;
 
+  /// Re-arrange the edges after built, so that the edge with id `order[i]`
+  /// comes to position i. It is called by the topology storage to lay out
+  /// edges in the same order with the adjacent matrix. If `keep_ids` is
+  /// false, the position is the new edge id. Otherwise, the original ids
+  /// are still valid by a remap table.
+  virtual void Reorder(const IdList& order, bool keep_ids) = 0;
+
+  /// Dump the built data into a snapshot, with section names under `prefix`.
+  virtual Status Save(SnapshotWriter* writer,
+                      const std::string& prefix) const = 0;
+  /// Restore the built data from a snapshot, instead of adding and building.
+  /// Large arrays may be served from the mapping, so the reader must live
+  /// longer than the storage.
+  virtual Status Load(const SnapshotReader* reader,
+                      const std::string& prefix) = 0;
+
   /// Get the total edge count after data fixed.
   virtual IdType Size() const = 0;
 
@@ -53,6 +72,30 @@ public:
   virtual int32_t GetLabel(IdType edge_id) const = 0;
   virtual Attribute GetAttribute(IdType edge_id) const = 0;
 
+  /// Batched lookups of edge infos into caller-provided columns, which
+  /// should hold `size` values for weights and labels, and `size` rows of
+  /// i_num, f_num and s_num values for the attributes. An edge not existed
+  /// gets the same default values as the single lookups above. The strings
+  /// are referred to, and stay valid as long as the storage.
+  virtual void GatherWeights(const IdType* edge_ids, int32_t size,
+                             float* out) const = 0;
+  virtual void GatherLabels(const IdType* edge_ids, int32_t size,
+                            int32_t* out) const = 0;
+  virtual void GatherInts(const IdType* edge_ids, int32_t size,
+                          int64_t* out) const = 0;
+  virtual void GatherFloats(const IdType* edge_ids, int32_t size,
+                            float* out) const = 0;
+  virtual void GatherStrings(const IdType* edge_ids, int32_t size,
+                             const std::string** out) const = 0;
+
+  /// The dictionary of the string attributes if they are dictionary encoded,
+  /// otherwise nullptr.
+  virtual const StringDict* GetStringDict() const = 0;
+  /// Gather the dictionary codes of the string attributes, -1 for the ones
+  /// with default value. Only works when GetStringDict() is not nullptr.
+  virtual void GatherStringCodes(const IdType* edge_ids, int32_t size,
+                                 int32_t* out) const = 0;
+
   /// For the needs of traversal and sampling, the data distribution is
   /// helpful. The interface should make it convenient to get the global data.
   ///
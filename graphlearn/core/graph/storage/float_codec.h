@@ -0,0 +1,146 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef GRAPHLEARN_CORE_GRAPH_STORAGE_FLOAT_CODEC_H_
+#define GRAPHLEARN_CORE_GRAPH_STORAGE_FLOAT_CODEC_H_
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+namespace graphlearn {
+namespace io {
+
+/// Codecs of the reduced precision float columns. The encoders run once
+/// when building, and the decoders are written as plain loops over bits
+/// which the compiler vectorizes, with F16C instructions if available.
+
+inline uint32_t FloatBits(float value) {
+  uint32_t bits;
+  ::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+inline float BitsFloat(uint32_t bits) {
+  float value;
+  ::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/// IEEE half precision, rounded to nearest even.
+inline uint16_t FloatToHalf(float value) {
+  uint32_t x = FloatBits(value);
+  uint16_t sign = (x >> 16) & 0x8000;
+  x &= 0x7FFFFFFF;
+  if (x >= 0x7F800000) {
+    // Inf or NaN
+    return sign | 0x7C00 | (x > 0x7F800000 ? 0x200 : 0);
+  } else if (x >= 0x477FF000) {
+    // Overflow to Inf
+    return sign | 0x7C00;
+  } else if (x < 0x38800000) {
+    // Subnormal half, in the unit of 2^-24
+    float units = std::nearbyint(BitsFloat(x) * 16777216.0f);
+    return sign | static_cast<uint16_t>(units);
+  }
+  x -= (127 - 15) << 23;
+  x += 0xFFF + ((x >> 13) & 1);
+  return sign | static_cast<uint16_t>(x >> 13);
+}
+
+inline float HalfToFloat(uint16_t value) {
+  const uint32_t kExpMask = 0x7C00 << 13;
+  uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+  uint32_t x = static_cast<uint32_t>(value & 0x7FFF) << 13;
+  uint32_t exp = x & kExpMask;
+  x += (127 - 15) << 23;
+  if (exp == kExpMask) {
+    // Inf or NaN
+    x += (128 - 16) << 23;
+  } else if (exp == 0) {
+    // Zero or subnormal, renormalized by the float unit
+    x = FloatBits(BitsFloat(x + (1 << 23)) - BitsFloat(113 << 23));
+  }
+  return BitsFloat(x | sign);
+}
+
+/// Brain float, the higher half of a float, rounded to nearest even.
+inline uint16_t FloatToBf16(float value) {
+  uint32_t x = FloatBits(value);
+  if ((x & 0x7FFFFFFF) > 0x7F800000) {
+    // Keep NaN quiet
+    return static_cast<uint16_t>((x >> 16) | 0x40);
+  }
+  x += 0x7FFF + ((x >> 16) & 1);
+  return static_cast<uint16_t>(x >> 16);
+}
+
+inline float Bf16ToFloat(uint16_t value) {
+  return BitsFloat(static_cast<uint32_t>(value) << 16);
+}
+
+inline void DecodeHalfs(const uint16_t* values, int32_t size, float* out) {
+  int32_t i = 0;
+#if defined(__F16C__)
+  for (; i + 8 <= size; i += 8) {
+    __m128i halfs = _mm_loadu_si128(
+      reinterpret_cast<const __m128i*>(values + i));
+    _mm256_storeu_ps(out + i, _mm256_cvtph_ps(halfs));
+  }
+#endif
+  for (; i < size; ++i) {
+    out[i] = HalfToFloat(values[i]);
+  }
+}
+
+inline void DecodeBf16s(const uint16_t* values, int32_t size, float* out) {
+  for (int32_t i = 0; i < size; ++i) {
+    out[i] = Bf16ToFloat(values[i]);
+  }
+}
+
+/// Quantize a row symmetrically into [-127, 127] with a scale of the max
+/// absolute value, and return the scale.
+inline float QuantizeInt8(const float* values, int32_t size, int8_t* out) {
+  float max = 0.0;
+  for (int32_t i = 0; i < size; ++i) {
+    max = std::fmax(max, std::fabs(values[i]));
+  }
+  if (!(max > 0.0f)) {
+    ::memset(out, 0, size);
+    return 0.0f;
+  }
+  float scale = max / 127;
+  for (int32_t i = 0; i < size; ++i) {
+    float q = std::nearbyint(values[i] / scale);
+    out[i] = static_cast<int8_t>(std::fmax(-127.0f, std::fmin(127.0f, q)));
+  }
+  return scale;
+}
+
+inline void DequantizeInt8(const int8_t* values, int32_t size, float scale,
+                           float* out) {
+  for (int32_t i = 0; i < size; ++i) {
+    out[i] = values[i] * scale;
+  }
+}
+
+}  // namespace io
+}  // namespace graphlearn
+
+#endif  // GRAPHLEARN_CORE_GRAPH_STORAGE_FLOAT_CODEC_H_
@@ -0,0 +1,209 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "graphlearn/core/graph/storage/graph_clusters.h"
+
+#include <algorithm>
+#include <numeric>
+#include "graphlearn/common/base/errors.h"
+#include "graphlearn/common/base/random.h"
+#include "graphlearn/common/threading/runner/parallel_for.h"
+#include "graphlearn/core/graph/storage/id_hash_map.h"
+#include "graphlearn/platform/env.h"
+
+namespace graphlearn {
+namespace io {
+
+namespace {
+
+// Rows are indexed in parallel, with so many rows per block.
+const int64_t kRowsPerBlock = 1024;
+
+// Stop propagating after so many rounds, even if some labels still move.
+const int32_t kMaxRounds = 10;
+
+// The rows are visited in a shuffled but fixed order, so that the same
+// edges always give the same clusters.
+const uint64_t kOrderSeed = 0x9E3779B97F4A7C15ULL;
+
+// The label most of the neighbors have, among the clusters not full yet.
+// A row only moves for strictly more votes than its current label gets,
+// and a tie goes to the smaller label, so the propagation settles down.
+IndexType VoteLabel(IndexType current,
+                    const std::vector<int32_t>& sizes,
+                    int32_t max_size,
+                    std::vector<IndexType>* votes) {
+  std::sort(votes->begin(), votes->end());
+  IndexType best = current;
+  int32_t best_count = 0;
+  int32_t current_count = 0;
+  for (size_t i = 0; i < votes->size(); ) {
+    IndexType label = (*votes)[i];
+    size_t end = i + 1;
+    while (end < votes->size() && (*votes)[end] == label) {
+      ++end;
+    }
+    int32_t count = end - i;
+    if (label == current) {
+      current_count = count;
+    } else if (count > best_count && sizes[label] < max_size) {
+      best = label;
+      best_count = count;
+    }
+    i = end;
+  }
+  return best_count > current_count ? best : current;
+}
+
+}  // anonymous namespace
+
+GraphClusters::GraphClusters()
+    : cluster_num_(0), offsets_data_(nullptr), ids_data_(nullptr) {
+}
+
+void GraphClusters::Build(const IdList& ids,
+                          const RowFunc& func,
+                          int32_t max_size) {
+  ThreadPool* tp = Env::Default()->IntraThreadPool();
+  int64_t row_num = ids.size();
+
+  IdHashMap index;
+  index.Reserve(row_num);
+  for (int64_t i = 0; i < row_num; ++i) {
+    index.Insert(ids[i], i);
+  }
+
+  // Map the neighbors to the rows, without the self loops and those out
+  // of the rows.
+  auto find_rows = [&index, &func] (int64_t row,
+                                    IdList* buffer,
+                                    IndexList* found) {
+    auto nbrs = func(row);
+    buffer->resize(nbrs.Size());
+    for (int32_t k = 0; k < nbrs.Size(); ++k) {
+      (*buffer)[k] = nbrs[k];
+    }
+    found->resize(nbrs.Size());
+    index.FindBatch(buffer->data(), nbrs.Size(), found->data());
+    found->erase(std::remove_if(found->begin(), found->end(),
+      [row] (IndexType r) { return r < 0 || r == row; }), found->end());
+  };
+
+  std::vector<int64_t> nbr_offsets(row_num + 1, 0);
+  ParallelFor(tp, row_num, kRowsPerBlock,
+    [&find_rows, &nbr_offsets] (int64_t begin, int64_t end) {
+      IdList buffer;
+      IndexList found;
+      for (int64_t i = begin; i < end; ++i) {
+        find_rows(i, &buffer, &found);
+        nbr_offsets[i] = found.size();
+      }
+    });
+  int64_t total = ParallelPrefixSum(tp, &nbr_offsets);
+
+  IndexList nbr_rows(total);
+  ParallelFor(tp, row_num, kRowsPerBlock,
+    [&find_rows, &nbr_offsets, &nbr_rows] (int64_t begin, int64_t end) {
+      IdList buffer;
+      IndexList found;
+      for (int64_t i = begin; i < end; ++i) {
+        find_rows(i, &buffer, &found);
+        std::copy(found.begin(), found.end(),
+                  nbr_rows.begin() + nbr_offsets[i]);
+      }
+    });
+
+  // Each row starts as a cluster of its own, and moves to the cluster of
+  // most of its neighbors. A moved label takes effect for the rows visited
+  // after it in the same round.
+  max_size = std::max(max_size, 1);
+  IndexList labels(row_num);
+  std::iota(labels.begin(), labels.end(), 0);
+  std::vector<int32_t> sizes(row_num, 1);
+  IndexList order(labels);
+  PhiloxRandom rng(kOrderSeed);
+  std::shuffle(order.begin(), order.end(), rng);
+
+  IndexList votes;
+  for (int32_t round = 0; round < kMaxRounds; ++round) {
+    int64_t moved = 0;
+    for (IndexType row : order) {
+      votes.clear();
+      for (int64_t k = nbr_offsets[row]; k < nbr_offsets[row + 1]; ++k) {
+        votes.push_back(labels[nbr_rows[k]]);
+      }
+      IndexType label = VoteLabel(labels[row], sizes, max_size, &votes);
+      if (label != labels[row]) {
+        --sizes[labels[row]];
+        ++sizes[label];
+        labels[row] = label;
+        ++moved;
+      }
+    }
+    if (moved == 0) {
+      break;
+    }
+  }
+
+  // Number the clusters by their first rows, and group the rows.
+  IndexList clusters(row_num, -1);
+  offsets_.assign(1, 0);
+  for (int64_t i = 0; i < row_num; ++i) {
+    IndexType& cluster = clusters[labels[i]];
+    if (cluster < 0) {
+      cluster = offsets_.size() - 1;
+      offsets_.back() = sizes[labels[i]];
+      offsets_.push_back(0);
+    }
+  }
+  cluster_num_ = offsets_.size() - 1;
+  ParallelPrefixSum(tp, &offsets_);
+
+  ids_.resize(row_num);
+  std::vector<int64_t> cursors(offsets_.begin(), offsets_.end() - 1);
+  for (int64_t i = 0; i < row_num; ++i) {
+    ids_[cursors[clusters[labels[i]]]++] = ids[i];
+  }
+
+  offsets_data_ = offsets_.data();
+  ids_data_ = ids_.data();
+}
+
+Status GraphClusters::Save(SnapshotWriter* writer,
+                           const std::string& prefix) const {
+  RETURN_IF_ERROR(writer->Write(prefix + ".offsets", offsets_data_,
+                                (cluster_num_ + 1) * sizeof(int64_t)));
+  return writer->Write(prefix + ".ids", ids_data_,
+                       offsets_data_[cluster_num_] * sizeof(IdType));
+}
+
+Status GraphClusters::Load(const SnapshotReader* reader,
+                           const std::string& prefix) {
+  offsets_.clear();
+  ids_.clear();
+  int64_t offset_num = 0;
+  int64_t total = 0;
+  RETURN_IF_ERROR(reader->View(prefix + ".offsets",
+                               &offsets_data_, &offset_num));
+  RETURN_IF_ERROR(reader->View(prefix + ".ids", &ids_data_, &total));
+  if (offset_num < 1 || offsets_data_[offset_num - 1] != total) {
+    return error::DataLoss("Invalid graph clusters in snapshot: " + prefix);
+  }
+  cluster_num_ = offset_num - 1;
+  return Status::OK();
+}
+
+}  // namespace io
+}  // namespace graphlearn
@@ -0,0 +1,76 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef GRAPHLEARN_CORE_GRAPH_STORAGE_GRAPH_CLUSTERS_H_
+#define GRAPHLEARN_CORE_GRAPH_STORAGE_GRAPH_CLUSTERS_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "graphlearn/core/graph/storage/snapshot.h"
+#include "graphlearn/core/graph/storage/types.h"
+#include "graphlearn/include/status.h"
+
+namespace graphlearn {
+namespace io {
+
+/// Disjoint clusters of the rows of an adjacent matrix, found by label
+/// propagation over the neighbors, and laid out like CSR from a cluster to
+/// the ids of its rows. The nodes of a cluster link to each other densely,
+/// so a batch made up of whole clusters keeps most of its edges.
+class GraphClusters {
+public:
+  /// Return the neighbors of a row, in any order.
+  typedef std::function<Array<IdType>(int64_t row)> RowFunc;
+
+  GraphClusters();
+  ~GraphClusters() = default;
+
+  /// Cluster the rows of `ids`, with no more than `max_size` rows in a
+  /// cluster. The neighbors that are not a row are ignored.
+  void Build(const IdList& ids, const RowFunc& func, int32_t max_size);
+
+  IndexType Size() const {
+    return cluster_num_;
+  }
+
+  /// Empty for a cluster out of range.
+  Array<IdType> GetCluster(IndexType cluster) const {
+    if (cluster < 0 || cluster >= cluster_num_) {
+      return Array<IdType>();
+    }
+    int64_t offset = offsets_data_[cluster];
+    return Array<IdType>(ids_data_ + offset,
+                         offsets_data_[cluster + 1] - offset);
+  }
+
+  /// The clusters are served from the mapping after Load().
+  Status Save(SnapshotWriter* writer, const std::string& prefix) const;
+  Status Load(const SnapshotReader* reader, const std::string& prefix);
+
+private:
+  std::vector<int64_t> offsets_;
+  IdList               ids_;
+  // Point to the arrays above, or to a snapshot mapping.
+  int64_t        cluster_num_;
+  const int64_t* offsets_data_;
+  const IdType*  ids_data_;
+};
+
+}  // namespace io
+}  // namespace graphlearn
+
+#endif  // GRAPHLEARN_CORE_GRAPH_STORAGE_GRAPH_CLUSTERS_H_
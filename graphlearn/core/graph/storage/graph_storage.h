@@ -19,6 +19,8 @@ limitations under the License.
 #include <cstdint>
 #include <string>
 #include <vector>
+#include "graphlearn/core/graph/storage/snapshot.h"
+#include "graphlearn/core/graph/storage/string_dict.h"
 #include "graphlearn/core/graph/storage/types.h"
 
 namespace graphlearn {
@@ -37,6 +39,17 @@ public:
   virtual void Add(EdgeValue* value) = 0;
   virtual void Build() = 0;
 
+  /// Dump the built data into a snapshot, with section names under `prefix`.
+  virtual Status Save(SnapshotWriter* writer,
+                      const std::string& prefix) const = 0;
+  /// Restore the built data from a snapshot, instead of adding and building.
+  /// Large arrays may be served from the mapping, so the reader must live
+  /// longer than the storage.
+  virtual Status Load(const SnapshotReader* reader,
+                      const std::string& prefix) = 0;
+  /// Changed by Build() and Load(), see NewStorageVersion().
+  virtual int64_t GetVersion() const = 0;
+
   virtual IdType GetEdgeCount() const = 0;
   virtual IdType GetSrcId(IdType edge_id) const = 0;
   virtual IdType GetDstId(IdType edge_id) const = 0;
@@ -44,8 +57,34 @@ public:
   virtual int32_t GetEdgeLabel(IdType edge_id) const = 0;
   virtual Attribute GetEdgeAttribute(IdType edge_id) const = 0;
 
+  /// Batched edge lookups, see EdgeStorage::GatherWeights() and the likes.
+  virtual void GatherEdgeWeights(const IdType* edge_ids, int32_t size,
+                                 float* out) const = 0;
+  virtual void GatherEdgeLabels(const IdType* edge_ids, int32_t size,
+                                int32_t* out) const = 0;
+  virtual void GatherEdgeInts(const IdType* edge_ids, int32_t size,
+                              int64_t* out) const = 0;
+  virtual void GatherEdgeFloats(const IdType* edge_ids, int32_t size,
+                                float* out) const = 0;
+  virtual void GatherEdgeStrings(const IdType* edge_ids, int32_t size,
+                                 const std::string** out) const = 0;
+  virtual const StringDict* GetEdgeStringDict() const = 0;
+  virtual void GatherEdgeStringCodes(const IdType* edge_ids, int32_t size,
+                                     int32_t* out) const = 0;
+
   virtual Array<IdType> GetNeighbors(IdType src_id) const = 0;
   virtual Array<IdType> GetOutEdges(IdType src_id) const = 0;
+  /// Only work with IsInEdgeIndexEnabled(), otherwise empty.
+  virtual Array<IdType> GetInNeighbors(IdType dst_id) const = 0;
+  virtual Array<IdType> GetInEdges(IdType dst_id) const = 0;
+  /// Only work with IsSamplingTableEnabled(), otherwise empty.
+  virtual Array<double> GetEdgeWeightTable(IdType src_id) const = 0;
+  virtual Array<double> GetInDegreeTable(IdType src_id) const = 0;
+  /// Only work with IsSortedNeighborEnabled(), otherwise empty.
+  virtual Array<IdType> GetSortedNeighbors(IdType src_id) const = 0;
+  /// Only work with IsGraphClusterEnabled(), otherwise no cluster.
+  virtual IndexType GetClusterCount() const = 0;
+  virtual Array<IdType> GetCluster(IndexType cluster) const = 0;
 
   virtual IndexType GetInDegree(IdType dst_id) const = 0;
   virtual IndexType GetOutDegree(IdType src_id) const = 0;
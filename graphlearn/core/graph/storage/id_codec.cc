@@ -0,0 +1,171 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "graphlearn/core/graph/storage/id_codec.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace graphlearn {
+namespace io {
+
+namespace {
+
+inline uint64_t ZigZag(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^
+         static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t UnZigZag(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/// Deltas are computed in unsigned arithmetic so that they wrap around
+/// instead of overflowing for ids far apart.
+inline uint64_t Delta(IdType current, IdType previous) {
+  return ZigZag(static_cast<int64_t>(
+    static_cast<uint64_t>(current) - static_cast<uint64_t>(previous)));
+}
+
+inline IdType Accumulate(IdType previous, uint64_t delta) {
+  return static_cast<IdType>(
+    static_cast<uint64_t>(previous) + static_cast<uint64_t>(UnZigZag(delta)));
+}
+
+inline uint64_t Load64(const uint8_t* p) {
+  uint64_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline int32_t BitWidth(uint64_t value) {
+  return value == 0 ? 0 : 64 - __builtin_clzll(value);
+}
+
+void Pack(const uint64_t* values, int32_t size, int32_t bits,
+          std::vector<uint8_t>* out) {
+  size_t bytes = (static_cast<size_t>(size) * bits + 7) / 8;
+  size_t base = out->size();
+  out->resize(base + bytes, 0);
+  uint8_t* dst = out->data() + base;
+
+  uint64_t pos = 0;
+  for (int32_t i = 0; i < size; ++i) {
+    uint64_t value = values[i];
+    int32_t left = bits;
+    while (left > 0) {
+      int32_t shift = pos & 7;
+      int32_t take = std::min(8 - shift, left);
+      dst[pos >> 3] |= static_cast<uint8_t>(
+        (value & ((1u << take) - 1)) << shift);
+      value >>= take;
+      left -= take;
+      pos += take;
+    }
+  }
+}
+
+/// Unpack with one unaligned 64-bit load per value. Values wider than 57 bits
+/// may straddle 9 bytes, and the extra byte is fetched only in that case.
+void Unpack(const uint8_t* in, int32_t size, int32_t bits, uint64_t* out) {
+  if (bits == 0) {
+    std::fill(out, out + size, 0);
+    return;
+  }
+
+  const uint64_t mask = bits == 64 ? ~0ULL : ((1ULL << bits) - 1);
+  uint64_t pos = 0;
+  for (int32_t i = 0; i < size; ++i) {
+    const uint8_t* p = in + (pos >> 3);
+    int32_t shift = pos & 7;
+    uint64_t value = Load64(p) >> shift;
+    if (shift + bits > 64) {
+      value |= static_cast<uint64_t>(p[8]) << (64 - shift);
+    }
+    out[i] = value & mask;
+    pos += bits;
+  }
+}
+
+}  // anonymous namespace
+
+void EncodeVarint(uint64_t value, std::vector<uint8_t>* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<uint8_t>(value));
+}
+
+const uint8_t* DecodeVarint(const uint8_t* in, uint64_t* value) {
+  uint64_t result = 0;
+  int32_t shift = 0;
+  while (*in & 0x80) {
+    result |= static_cast<uint64_t>(*in++ & 0x7F) << shift;
+    shift += 7;
+  }
+  result |= static_cast<uint64_t>(*in++) << shift;
+  *value = result;
+  return in;
+}
+
+void EncodeIds(const IdType* ids, int32_t size, std::vector<uint8_t>* out) {
+  if (size <= 0) {
+    return;
+  }
+
+  EncodeVarint(ZigZag(ids[0]), out);
+
+  uint64_t deltas[kPackedBlockSize];
+  for (int32_t begin = 1; begin < size; begin += kPackedBlockSize) {
+    int32_t n = std::min(kPackedBlockSize, size - begin);
+    uint64_t merged = 0;
+    for (int32_t i = 0; i < n; ++i) {
+      deltas[i] = Delta(ids[begin + i], ids[begin + i - 1]);
+      merged |= deltas[i];
+    }
+    int32_t bits = BitWidth(merged);
+    out->push_back(static_cast<uint8_t>(bits));
+    Pack(deltas, n, bits, out);
+  }
+}
+
+const uint8_t* DecodeIds(const uint8_t* in, int32_t size, IdType* out) {
+  if (size <= 0) {
+    return in;
+  }
+
+  uint64_t first = 0;
+  in = DecodeVarint(in, &first);
+  out[0] = UnZigZag(first);
+
+  uint64_t* deltas = reinterpret_cast<uint64_t*>(out);
+  for (int32_t begin = 1; begin < size; begin += kPackedBlockSize) {
+    int32_t n = std::min(kPackedBlockSize, size - begin);
+    int32_t bits = *in++;
+    Unpack(in, n, bits, deltas + begin);
+    in += (static_cast<size_t>(n) * bits + 7) / 8;
+
+    IdType prev = out[begin - 1];
+    for (int32_t i = begin; i < begin + n; ++i) {
+      prev = Accumulate(prev, deltas[i]);
+      out[i] = prev;
+    }
+  }
+  return in;
+}
+
+}  // namespace io
+}  // namespace graphlearn
@@ -0,0 +1,51 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef GRAPHLEARN_CORE_GRAPH_STORAGE_ID_CODEC_H_
+#define GRAPHLEARN_CORE_GRAPH_STORAGE_ID_CODEC_H_
+
+#include <cstdint>
+#include <vector>
+#include "graphlearn/core/graph/storage/types.h"
+
+namespace graphlearn {
+namespace io {
+
+/// Encode a list of ids into a compact byte stream.
+///
+/// The first id is stored as a zigzag varint, and the following ids are
+/// stored as zigzag deltas to their predecessors, bit-packed in blocks of
+/// kPackedBlockSize values that share the same bit width. Sorted ids get
+/// small deltas and thus take only a few bits each.
+///
+/// The encoded bytes are appended to `out`.
+void EncodeIds(const IdType* ids, int32_t size, std::vector<uint8_t>* out);
+
+/// Decode `size` ids from `in` to `out`, and return the position right after
+/// the consumed bytes. The buffer that `in` points to must be readable for
+/// at least kPackedPadding bytes past the encoded data.
+const uint8_t* DecodeIds(const uint8_t* in, int32_t size, IdType* out);
+
+/// Write and read an unsigned varint.
+void EncodeVarint(uint64_t value, std::vector<uint8_t>* out);
+const uint8_t* DecodeVarint(const uint8_t* in, uint64_t* value);
+
+const int32_t kPackedBlockSize = 128;
+const int32_t kPackedPadding = 8;
+
+}  // namespace io
+}  // namespace graphlearn
+
+#endif  // GRAPHLEARN_CORE_GRAPH_STORAGE_ID_CODEC_H_
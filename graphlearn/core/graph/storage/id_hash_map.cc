@@ -0,0 +1,163 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "graphlearn/core/graph/storage/id_hash_map.h"
+
+#include "graphlearn/common/base/errors.h"
+
+namespace graphlearn {
+namespace io {
+
+namespace {
+
+// Keep the load factor no more than 7/8.
+const int64_t kMaxLoadNumerator = 7;
+const int64_t kMaxLoadDenominator = 8;
+
+// How many ids ahead to prefetch in FindBatch().
+const int32_t kPrefetchDistance = 8;
+
+}  // anonymous namespace
+
+const int32_t IdHashMap::kGroupSize;
+const uint8_t IdHashMap::kEmpty;
+
+IdHashMap::IdHashMap() : group_mask_(0), size_(0) {
+}
+
+bool IdHashMap::Insert(IdType id, IndexType index) {
+  if (Find(id) != -1) {
+    return false;
+  }
+
+  int64_t capacity = slots_.size();
+  if ((size_ + 1) * kMaxLoadDenominator > capacity * kMaxLoadNumerator) {
+    Rehash(capacity == 0 ? kGroupSize : capacity * 2);
+  }
+  InsertUnique(id, index);
+  return true;
+}
+
+void IdHashMap::FindBatch(const IdType* ids, int32_t size,
+                          IndexType* indices) const {
+  if (slots_.empty()) {
+    for (int32_t i = 0; i < size; ++i) {
+      indices[i] = -1;
+    }
+    return;
+  }
+
+  for (int32_t i = 0; i < size; ++i) {
+    if (i + kPrefetchDistance < size) {
+      uint64_t group = (Hash(ids[i + kPrefetchDistance]) >> 7) & group_mask_;
+      __builtin_prefetch(ctrl_.data() + group * kGroupSize);
+      __builtin_prefetch(slots_.data() + group * kGroupSize);
+    }
+    indices[i] = Find(ids[i]);
+  }
+}
+
+void IdHashMap::Reserve(int64_t size) {
+  int64_t capacity = CapacityFor(size);
+  if (capacity > static_cast<int64_t>(slots_.size())) {
+    Rehash(capacity);
+  }
+}
+
+void IdHashMap::Shrink() {
+  int64_t capacity = CapacityFor(size_);
+  if (capacity < static_cast<int64_t>(slots_.size())) {
+    Rehash(capacity);
+  }
+}
+
+void IdHashMap::Clear() {
+  std::vector<uint8_t>().swap(ctrl_);
+  std::vector<Slot>().swap(slots_);
+  group_mask_ = 0;
+  size_ = 0;
+}
+
+Status IdHashMap::Save(SnapshotWriter* writer,
+                       const std::string& prefix) const {
+  RETURN_IF_ERROR(writer->Write(prefix + ".size", size_));
+  RETURN_IF_ERROR(writer->Write(prefix + ".ctrl", ctrl_));
+  return writer->Write(prefix + ".slots", slots_);
+}
+
+Status IdHashMap::Load(const SnapshotReader* reader,
+                       const std::string& prefix) {
+  Clear();
+  int64_t size = 0;
+  RETURN_IF_ERROR(reader->Read(prefix + ".size", &size));
+  RETURN_IF_ERROR(reader->Read(prefix + ".ctrl", &ctrl_));
+  RETURN_IF_ERROR(reader->Read(prefix + ".slots", &slots_));
+
+  int64_t capacity = slots_.size();
+  if (static_cast<int64_t>(ctrl_.size()) != capacity ||
+      capacity % kGroupSize != 0 ||
+      ((capacity / kGroupSize) & (capacity / kGroupSize - 1)) != 0) {
+    Clear();
+    return error::DataLoss("Invalid id hash map in snapshot: " + prefix);
+  }
+  group_mask_ = capacity == 0 ? 0 : capacity / kGroupSize - 1;
+  size_ = size;
+  return Status::OK();
+}
+
+int64_t IdHashMap::CapacityFor(int64_t size) const {
+  int64_t capacity = kGroupSize;
+  while (capacity * kMaxLoadNumerator < size * kMaxLoadDenominator) {
+    capacity *= 2;
+  }
+  return capacity;
+}
+
+void IdHashMap::Rehash(int64_t capacity) {
+  std::vector<uint8_t> ctrl(capacity, kEmpty);
+  std::vector<Slot> slots(capacity);
+  ctrl.swap(ctrl_);
+  slots.swap(slots_);
+  group_mask_ = capacity / kGroupSize - 1;
+  size_ = 0;
+
+  for (size_t i = 0; i < ctrl.size(); ++i) {
+    if (ctrl[i] != kEmpty) {
+      InsertUnique(slots[i].key, slots[i].value);
+    }
+  }
+}
+
+void IdHashMap::InsertUnique(IdType id, IndexType index) {
+  uint64_t h = Hash(id);
+  uint64_t group = (h >> 7) & group_mask_;
+  for (uint64_t step = 1; ; ++step) {
+    uint8_t* ctrl = ctrl_.data() + group * kGroupSize;
+    uint32_t empty = Match(ctrl, kEmpty);
+    if (empty) {
+      int32_t pos = __builtin_ctz(empty);
+      ctrl[pos] = h & 0x7F;
+      Slot& slot = slots_[group * kGroupSize + pos];
+      slot.key = id;
+      slot.value = index;
+      break;
+    }
+    group = (group + step) & group_mask_;
+  }
+  ++size_;
+}
+
+}  // namespace io
+}  // namespace graphlearn
@@ -0,0 +1,160 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef GRAPHLEARN_CORE_GRAPH_STORAGE_ID_HASH_MAP_H_
+#define GRAPHLEARN_CORE_GRAPH_STORAGE_ID_HASH_MAP_H_
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "graphlearn/core/graph/storage/snapshot.h"
+#include "graphlearn/core/graph/storage/types.h"
+
+namespace graphlearn {
+namespace io {
+
+/// An open-addressing hash map from id to index, which is much more compact
+/// than std::unordered_map and needs no pointer chasing.
+///
+/// Slots are split into groups of kGroupSize. Each slot has a one-byte
+/// control tag, which is kEmpty or the low 7 bits of the key's hash. A
+/// lookup compares the tags of a whole group at once with SSE2, and only
+/// checks the keys of matched slots. Groups are probed triangularly.
+///
+/// Erasing is not supported, because ids are never removed from storages.
+/// Lookups are thread-safe if no insertion happens at the same time.
+class IdHashMap {
+public:
+  IdHashMap();
+  ~IdHashMap() = default;
+
+  /// Insert an id with its index. Return false if the id existed,
+  /// and the existing index will not be changed.
+  bool Insert(IdType id, IndexType index);
+
+  /// Return -1 if not found.
+  IndexType Find(IdType id) const;
+
+  /// Find a batch of ids. The slots of the following ids are prefetched
+  /// to hide memory latency.
+  void FindBatch(const IdType* ids, int32_t size, IndexType* indices) const;
+
+  /// Make room for at least `size` ids.
+  void Reserve(int64_t size);
+
+  /// Rehash to the smallest capacity that holds the current ids, which is
+  /// suitable for the read-mostly phase after data fixed.
+  void Shrink();
+
+  /// Remove all ids and release the memory.
+  void Clear();
+
+  /// Dump the slots as they are, so that no rehashing when loaded.
+  Status Save(SnapshotWriter* writer, const std::string& prefix) const;
+  Status Load(const SnapshotReader* reader, const std::string& prefix);
+
+  int64_t Size() const {
+    return size_;
+  }
+
+  /// Call visitor(id, index) for each id, in no particular order.
+  template <class Visitor>
+  void ForEach(Visitor visitor) const {
+    for (size_t i = 0; i < ctrl_.size(); ++i) {
+      if (ctrl_[i] != kEmpty) {
+        visitor(slots_[i].key, slots_[i].value);
+      }
+    }
+  }
+
+private:
+  struct Slot {
+    IdType    key;
+    IndexType value;
+  };
+
+  static const int32_t kGroupSize = 16;
+  static const uint8_t kEmpty = 0x80;
+
+  static uint64_t Hash(IdType id) {
+    uint64_t h = static_cast<uint64_t>(id);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  /// Bitmask of the slots in a group whose tag equals `tag`.
+  static uint32_t Match(const uint8_t* ctrl, uint8_t tag) {
+#if defined(__SSE2__)
+    __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+    return _mm_movemask_epi8(
+      _mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(tag))));
+#else
+    uint32_t mask = 0;
+    for (int32_t i = 0; i < kGroupSize; ++i) {
+      mask |= static_cast<uint32_t>(ctrl[i] == tag) << i;
+    }
+    return mask;
+#endif
+  }
+
+  void Rehash(int64_t capacity);
+  void InsertUnique(IdType id, IndexType index);
+  int64_t CapacityFor(int64_t size) const;
+
+private:
+  std::vector<uint8_t> ctrl_;
+  std::vector<Slot>    slots_;
+  uint64_t group_mask_;
+  int64_t  size_;
+};
+
+inline IndexType IdHashMap::Find(IdType id) const {
+  if (slots_.empty()) {
+    return -1;
+  }
+
+  uint64_t h = Hash(id);
+  uint8_t tag = h & 0x7F;
+  uint64_t group = (h >> 7) & group_mask_;
+  for (uint64_t step = 1; ; ++step) {
+    const uint8_t* ctrl = ctrl_.data() + group * kGroupSize;
+    const Slot* slots = slots_.data() + group * kGroupSize;
+    uint32_t match = Match(ctrl, tag);
+    while (match) {
+      const Slot& slot = slots[__builtin_ctz(match)];
+      if (slot.key == id) {
+        return slot.value;
+      }
+      match &= match - 1;
+    }
+    if (Match(ctrl, kEmpty)) {
+      return -1;
+    }
+    group = (group + step) & group_mask_;
+  }
+}
+
+}  // namespace io
+}  // namespace graphlearn
+
+#endif  // GRAPHLEARN_CORE_GRAPH_STORAGE_ID_HASH_MAP_H_
@@ -14,39 +14,121 @@ limitations under the License.
 ==============================================================================*/
 
 #include <algorithm>
-#include <functional>
+#include <memory>
+#include <numeric>
+#include "graphlearn/common/base/errors.h"
+#include "graphlearn/common/threading/runner/parallel_for.h"
 #include "graphlearn/core/graph/storage/adj_matrix.h"
+#include "graphlearn/core/graph/storage/id_codec.h"
+#include "graphlearn/core/graph/storage/storage_mode.h"
+#include "graphlearn/platform/env.h"
 
 namespace graphlearn {
 namespace io {
 
 namespace {
 
-template <typename A, typename B, typename C>
-void zip3(const std::vector<A> &a,
-          const std::vector<B> &b,
-          const std::vector<C> &c,
-          std::vector<std::pair<std::pair<A, B>, C>>* zipped) {
-  for (size_t i = 0; i < a.size(); ++i) {
-    zipped->push_back(std::make_pair(std::make_pair(a[i], b[i]), c[i]));
+// Rows are built in parallel, with at least so many rows per task.
+const int64_t kRowsPerBlock = 1024;
+
+// Rearrange the ids and edge ids of a row in place such that the i-th
+// becomes the order[i]-th of before. The order is reset to identity.
+void PermuteRow(std::vector<int32_t>* order, IdType* ids, IdType* edge_ids) {
+  auto& o = *order;
+  for (int32_t i = 0; i < static_cast<int32_t>(o.size()); ++i) {
+    if (o[i] == i) {
+      continue;
+    }
+    IdType id = ids[i];
+    IdType edge_id = edge_ids[i];
+    int32_t j = i;
+    while (o[j] != i) {
+      int32_t k = o[j];
+      ids[j] = ids[k];
+      edge_ids[j] = edge_ids[k];
+      o[j] = j;
+      j = k;
+    }
+    ids[j] = id;
+    edge_ids[j] = edge_id;
+    o[j] = j;
   }
 }
 
-template <typename A, typename B, typename C>
-void unzip3(const std::vector<std::pair<std::pair<A, B>, C>> &zipped,
-            std::vector<A>* a,
-            std::vector<B>* b,
-            std::vector<C>* c) {
-  for (size_t i = 0; i < a->size(); i++) {
-    (*a)[i] = zipped[i].first.first;
-    (*b)[i] = zipped[i].first.second;
-    (*c)[i] = zipped[i].second;
+// Sort a row in place with the comparator on positions. The order is a
+// buffer reused across rows to avoid allocation.
+template <typename Compare>
+void SortRow(IdList* ids, IdList* edge_ids,
+             std::vector<int32_t>* order, Compare comp) {
+  order->resize(ids->size());
+  std::iota(order->begin(), order->end(), 0);
+  std::sort(order->begin(), order->end(), comp);
+  PermuteRow(order, ids->data(), edge_ids->data());
+}
+
+// Decoded rows of packed matrices are kept in a few buffers of each
+// thread. A buffer is shared by the arrays of its row, and is taken for
+// another row only after all of them are gone. Larger rows are not kept.
+const int32_t kCachedRowNum = 8;
+const int64_t kMaxCachedRowSize = 1 << 16;
+
+class RowCache {
+public:
+  RowCache() : cursor_(0) {
+    rows_.resize(kCachedRowNum);
   }
+
+  /// Get the buffer of the row `key` of the matrix `version`, which is
+  /// already decoded if `hit`, or to be decoded into by the caller.
+  std::shared_ptr<IdList> Get(int64_t version, int64_t key,
+                              int64_t size, bool* hit) {
+    for (auto& row : rows_) {
+      if (row.version == version && row.key == key && row.ids) {
+        *hit = true;
+        return row.ids;
+      }
+    }
+
+    *hit = false;
+    if (size <= kMaxCachedRowSize) {
+      for (int32_t i = 0; i < kCachedRowNum; ++i) {
+        Row& row = rows_[(cursor_ + i) % kCachedRowNum];
+        if (!row.ids || row.ids.use_count() == 1) {
+          cursor_ = (cursor_ + i + 1) % kCachedRowNum;
+          if (!row.ids) {
+            row.ids = std::make_shared<IdList>();
+          }
+          row.version = version;
+          row.key = key;
+          row.ids->resize(size);
+          return row.ids;
+        }
+      }
+    }
+    return std::make_shared<IdList>(size);
+  }
+
+private:
+  struct Row {
+    Row() : version(-1), key(-1) {}
+    int64_t version;
+    int64_t key;
+    std::shared_ptr<IdList> ids;
+  };
+
+  std::vector<Row> rows_;
+  int32_t cursor_;
+};
+
+RowCache* GetRowCache() {
+  thread_local static RowCache cache;
+  return &cache;
 }
 
 }  // anonymous namespace
 
 class CompressedMemoryAdjMatrix;
+class PackedMemoryAdjMatrix;
 
 class MemoryAdjMatrix : public AdjMatrix {
 public:
@@ -90,6 +172,21 @@ public:
     return LookupFrom(src_id, adj_edges_);
   }
 
+  IndexType GetRowSize(IdType src_id) const override {
+    IndexType index = indexing_->Get(src_id);
+    return index == -1 ? 0 : adj_nodes_[index].size();
+  }
+
+  Status Save(SnapshotWriter* writer,
+              const std::string& prefix) const override {
+    return error::Unimplemented("Snapshot needs the column storage mode");
+  }
+
+  Status Load(const SnapshotReader* reader,
+              const std::string& prefix) override {
+    return error::Unimplemented("Snapshot needs the column storage mode");
+  }
+
 private:
   Array<IdType> LookupFrom(IdType src_id, const IdMatrix& from) const {
     IndexType index = indexing_->Get(src_id);
@@ -101,25 +198,26 @@ private:
   }
 
   void Sort(EdgeStorage* edges) {
-    for (IndexType i = 0; i < adj_nodes_.size(); ++i) {
-      auto& dst_ids = adj_nodes_[i];
-      auto& edge_ids = adj_edges_[i];
-
-      std::vector<float> weights;
-      weights.reserve(edge_ids.size());
-      for (auto edge_id : edge_ids) {
-        weights.push_back(edges->GetWeight(edge_id));
-      }
-
-      std::vector<std::pair<std::pair<IdType, IdType>, float>> zipped;
-      zip3(dst_ids, edge_ids, weights, &zipped);
-      std::sort(std::begin(zipped), std::end(zipped),
-          [&](const std::pair<std::pair<IdType, IdType>, float>& a,
-              const std::pair<std::pair<IdType, IdType>, float>& b) {
-              return a.second > b.second;
-          });
-      unzip3(zipped, &dst_ids, &edge_ids, &weights);
-    }
+    ThreadPool* tp = Env::Default()->IntraThreadPool();
+    ParallelFor(tp, adj_nodes_.size(), kRowsPerBlock,
+      [this, edges] (int64_t begin, int64_t end) {
+        std::vector<int32_t> order;
+        std::vector<float> weights;
+        for (int64_t i = begin; i < end; ++i) {
+          auto& edge_ids = adj_edges_[i];
+          weights.resize(edge_ids.size());
+          for (size_t j = 0; j < edge_ids.size(); ++j) {
+            weights[j] = edges->GetWeight(edge_ids[j]);
+          }
+
+          // Descending by weight, ties keep the adding order.
+          SortRow(&adj_nodes_[i], &edge_ids, &order,
+            [&weights] (int32_t a, int32_t b) {
+              return weights[a] > weights[b] ||
+                (weights[a] == weights[b] && a < b);
+            });
+        }
+      });
   }
 
 private:
@@ -128,12 +226,16 @@ private:
   IdMatrix adj_edges_;
 
   friend class CompressedMemoryAdjMatrix;
+  friend class PackedMemoryAdjMatrix;
 };
 
 class CompressedMemoryAdjMatrix : public AdjMatrix {
 public:
-  explicit CompressedMemoryAdjMatrix(AutoIndex* indexing)
-      : naive_adj_(nullptr), indexing_(indexing) {
+  CompressedMemoryAdjMatrix(AutoIndex* indexing, bool reorder_edges)
+      : naive_adj_(nullptr), indexing_(indexing),
+        reorder_edges_(reorder_edges), implicit_edge_ids_(false),
+        row_num_(0), offsets_data_(nullptr),
+        nodes_data_(nullptr), edges_data_(nullptr) {
     naive_adj_.reset(new MemoryAdjMatrix(indexing));
   }
 
@@ -143,27 +245,97 @@ public:
   void Build(EdgeStorage* edges) override {
     naive_adj_->Build(edges);
 
-    offsets_.push_back(0);
+    ThreadPool* tp = Env::Default()->IntraThreadPool();
     auto& node_ids = naive_adj_->adj_nodes_;
     auto& edge_ids = naive_adj_->adj_edges_;
-    for (size_t i = 0; i < node_ids.size(); ++i) {
-      for (size_t j = 0; j < node_ids[i].size(); ++j) {
-        adj_nodes_.push_back(node_ids[i][j]);
-        adj_edges_.push_back(edge_ids[i][j]);
-      }
-      offsets_.push_back(adj_nodes_.size());
-
-      node_ids[i].clear();
-      edge_ids[i].clear();
-    }
+    int64_t row_num = node_ids.size();
+    offsets_.assign(row_num + 1, 0);
+    ParallelFor(tp, row_num, kRowsPerBlock,
+      [this, &node_ids] (int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          offsets_[i] = node_ids[i].size();
+        }
+      });
+    int64_t total = ParallelPrefixSum(tp, &offsets_);
+
+    adj_nodes_.resize(total);
+    adj_edges_.resize(total);
+    ParallelFor(tp, row_num, kRowsPerBlock,
+      [this, &node_ids, &edge_ids] (int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          std::copy(node_ids[i].begin(), node_ids[i].end(),
+                    adj_nodes_.begin() + offsets_[i]);
+          std::copy(edge_ids[i].begin(), edge_ids[i].end(),
+                    adj_edges_.begin() + offsets_[i]);
+          IdList().swap(node_ids[i]);
+          IdList().swap(edge_ids[i]);
+        }
+      });
 
     node_ids.clear();
     edge_ids.clear();
     naive_adj_.reset();
+
+    if (reorder_edges_ && IsCsrOrderedEdgeEnabled()) {
+      bool keep_ids = IsEdgeIdRemapEnabled();
+      edges->Reorder(adj_edges_, keep_ids);
+      if (!keep_ids) {
+        IdList().swap(adj_edges_);
+        implicit_edge_ids_ = true;
+      }
+    }
+
+    row_num_ = row_num;
+    offsets_data_ = offsets_.data();
+    nodes_data_ = adj_nodes_.data();
+    edges_data_ = adj_edges_.data();
   }
 
   IdType Size() const {
-    return offsets_.size() - 1;
+    return row_num_;
+  }
+
+  Status Save(SnapshotWriter* writer,
+              const std::string& prefix) const override {
+    if (offsets_data_ == nullptr) {
+      return error::FailedPrecondition("Snapshot needs a built graph");
+    }
+    int64_t total = offsets_data_[row_num_];
+    int32_t implicit = implicit_edge_ids_;
+    RETURN_IF_ERROR(writer->Write(prefix + ".implicit", implicit));
+    RETURN_IF_ERROR(writer->Write(prefix + ".offsets", offsets_data_,
+                                  (row_num_ + 1) * sizeof(IndexType)));
+    RETURN_IF_ERROR(writer->Write(prefix + ".nodes", nodes_data_,
+                                  total * sizeof(IdType)));
+    if (!implicit_edge_ids_) {
+      RETURN_IF_ERROR(writer->Write(prefix + ".edges", edges_data_,
+                                    total * sizeof(IdType)));
+    }
+    return Status::OK();
+  }
+
+  Status Load(const SnapshotReader* reader,
+              const std::string& prefix) override {
+    naive_adj_.reset();
+    int32_t implicit = 0;
+    int64_t offset_num = 0;
+    int64_t total = 0;
+    int64_t edge_num = 0;
+    RETURN_IF_ERROR(reader->Read(prefix + ".implicit", &implicit));
+    RETURN_IF_ERROR(reader->View(prefix + ".offsets",
+                                 &offsets_data_, &offset_num));
+    RETURN_IF_ERROR(reader->View(prefix + ".nodes", &nodes_data_, &total));
+    implicit_edge_ids_ = implicit;
+    if (!implicit_edge_ids_) {
+      RETURN_IF_ERROR(reader->View(prefix + ".edges",
+                                   &edges_data_, &edge_num));
+    }
+    if (offset_num < 1 || offsets_data_[offset_num - 1] != total ||
+        (!implicit_edge_ids_ && edge_num != total)) {
+      return error::DataLoss("Invalid adjacent matrix in snapshot: " + prefix);
+    }
+    row_num_ = offset_num - 1;
+    return Status::OK();
   }
 
   void Add(IdType edge_id, IdType src_id, IdType dst_id) override {
@@ -171,22 +343,42 @@ public:
   }
 
   Array<IdType> GetNeighbors(IdType src_id) const override {
-    return LookupFrom(src_id, adj_nodes_);
+    return LookupFrom(src_id, nodes_data_);
   }
 
   Array<IdType> GetOutEdges(IdType src_id) const override {
-    return LookupFrom(src_id, adj_edges_);
+    if (!implicit_edge_ids_) {
+      return LookupFrom(src_id, edges_data_);
+    }
+
+    IndexType index = indexing_->Get(src_id);
+    if (index == -1) {
+      return Array<IdType>();
+    } else {
+      IndexType offset = offsets_data_[index];
+      IndexType size = offsets_data_[index + 1] - offset;
+      return Array<IdType>::Range(offset, size);
+    }
+  }
+
+  IndexType GetRowSize(IdType src_id) const override {
+    IndexType index = indexing_->Get(src_id);
+    if (index == -1) {
+      return 0;
+    } else {
+      return offsets_data_[index + 1] - offsets_data_[index];
+    }
   }
 
 private:
-  Array<IdType> LookupFrom(IdType src_id, const IdList& from) const {
+  Array<IdType> LookupFrom(IdType src_id, const IdType* from) const {
     IndexType index = indexing_->Get(src_id);
     if (index == -1) {
       return Array<IdType>();
     } else {
-      IndexType offset = offsets_[index];
-      IndexType size = offsets_[index + 1] - offset;
-      return Array<IdType>(from.data() + offset, size);
+      IndexType offset = offsets_data_[index];
+      IndexType size = offsets_data_[index + 1] - offset;
+      return Array<IdType>(from + offset, size);
     }
   }
 
@@ -196,6 +388,259 @@ private:
   IndexList offsets_;
   IdList adj_nodes_;
   IdList adj_edges_;
+  // Re-arrange the edges in CSR order if IsCsrOrderedEdgeEnabled().
+  bool reorder_edges_;
+  // Edges are laid out in CSR order and the edge ids are just positions.
+  bool implicit_edge_ids_;
+  // Point to the arrays above, or to a snapshot mapping.
+  IdType row_num_;
+  const IndexType* offsets_data_;
+  const IdType* nodes_data_;
+  const IdType* edges_data_;
+};
+
+/// Each row is encoded as
+///   varint(neighbor count) varint(bytes of neighbor ids)
+///   encoded neighbor ids
+///   encoded edge ids, or varint(first edge id) if edge ids are implicit
+/// and only the byte offset of each row is kept in memory. Rows of weighted
+/// edges keep the descending weight order, other rows are sorted by neighbor
+/// id so that the deltas are small.
+class PackedMemoryAdjMatrix : public AdjMatrix {
+public:
+  explicit PackedMemoryAdjMatrix(AutoIndex* indexing)
+      : naive_adj_(nullptr), indexing_(indexing), implicit_edge_ids_(false),
+        row_num_(0), row_offsets_data_(nullptr),
+        data_ptr_(nullptr), data_size_(0), version_(NewStorageVersion()) {
+    naive_adj_.reset(new MemoryAdjMatrix(indexing));
+  }
+
+  virtual ~PackedMemoryAdjMatrix() {
+  }
+
+  void Build(EdgeStorage* edges) override {
+    bool weighted = edges->GetSideInfo()->IsWeighted();
+    bool csr_ordered = IsCsrOrderedEdgeEnabled();
+    bool keep_ids = IsEdgeIdRemapEnabled();
+    implicit_edge_ids_ = csr_ordered && !keep_ids;
+    naive_adj_->Build(edges);
+
+    ThreadPool* tp = Env::Default()->IntraThreadPool();
+    auto& node_ids = naive_adj_->adj_nodes_;
+    auto& edge_ids = naive_adj_->adj_edges_;
+    int64_t row_num = node_ids.size();
+
+    // Position of the first edge of each row in CSR order.
+    std::vector<int64_t> edge_begins(row_num + 1, 0);
+    ParallelFor(tp, row_num, kRowsPerBlock,
+      [&] (int64_t begin, int64_t end) {
+        std::vector<int32_t> order;
+        for (int64_t i = begin; i < end; ++i) {
+          const IdList& nbrs = node_ids[i];
+          const IdList& eids = edge_ids[i];
+          if (!weighted) {
+            SortRow(&node_ids[i], &edge_ids[i], &order,
+              [&nbrs, &eids] (int32_t a, int32_t b) {
+                return nbrs[a] < nbrs[b] ||
+                  (nbrs[a] == nbrs[b] && eids[a] < eids[b]);
+              });
+          }
+          edge_begins[i] = nbrs.size();
+        }
+      });
+    int64_t total = ParallelPrefixSum(tp, &edge_begins);
+
+    IdList csr_order;
+    if (csr_ordered) {
+      csr_order.resize(total);
+      ParallelFor(tp, row_num, kRowsPerBlock,
+        [&] (int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; ++i) {
+            std::copy(edge_ids[i].begin(), edge_ids[i].end(),
+                      csr_order.begin() + edge_begins[i]);
+          }
+        });
+    }
+
+    // Rows are encoded into the buffer of each block, and then the buffers
+    // are concatenated.
+    int64_t block_num = (row_num + kRowsPerBlock - 1) / kRowsPerBlock;
+    std::vector<std::vector<uint8_t>> blocks(block_num);
+    std::vector<int64_t> block_offsets(block_num + 1, 0);
+    row_offsets_.assign(row_num + 1, 0);
+    ParallelFor(tp, block_num, 1, [&] (int64_t begin, int64_t end) {
+      std::vector<uint8_t> encoded_nodes;
+      for (int64_t b = begin; b < end; ++b) {
+        auto& buf = blocks[b];
+        int64_t last = std::min((b + 1) * kRowsPerBlock, row_num);
+        for (int64_t i = b * kRowsPerBlock; i < last; ++i) {
+          int32_t size = node_ids[i].size();
+          encoded_nodes.clear();
+          EncodeIds(node_ids[i].data(), size, &encoded_nodes);
+          EncodeVarint(size, &buf);
+          EncodeVarint(encoded_nodes.size(), &buf);
+          buf.insert(buf.end(), encoded_nodes.begin(), encoded_nodes.end());
+          if (implicit_edge_ids_) {
+            EncodeVarint(edge_begins[i], &buf);
+          } else {
+            EncodeIds(edge_ids[i].data(), size, &buf);
+          }
+          row_offsets_[i + 1] = buf.size();
+
+          IdList().swap(node_ids[i]);
+          IdList().swap(edge_ids[i]);
+        }
+        block_offsets[b] = buf.size();
+      }
+    });
+    total = ParallelPrefixSum(tp, &block_offsets);
+
+    // Decoding may read a few bytes past the last row.
+    data_.assign(total + kPackedPadding, 0);
+    ParallelFor(tp, block_num, 1, [&] (int64_t begin, int64_t end) {
+      for (int64_t b = begin; b < end; ++b) {
+        std::copy(blocks[b].begin(), blocks[b].end(),
+                  data_.begin() + block_offsets[b]);
+        std::vector<uint8_t>().swap(blocks[b]);
+        int64_t last = std::min((b + 1) * kRowsPerBlock, row_num);
+        for (int64_t i = b * kRowsPerBlock; i < last; ++i) {
+          row_offsets_[i + 1] += block_offsets[b];
+        }
+      }
+    });
+
+    node_ids.clear();
+    edge_ids.clear();
+    naive_adj_.reset();
+
+    if (csr_ordered) {
+      edges->Reorder(csr_order, keep_ids);
+    }
+
+    row_num_ = row_num;
+    row_offsets_data_ = row_offsets_.data();
+    data_ptr_ = data_.data();
+    data_size_ = data_.size();
+    version_ = NewStorageVersion();
+  }
+
+  IdType Size() const {
+    return row_num_;
+  }
+
+  Status Save(SnapshotWriter* writer,
+              const std::string& prefix) const override {
+    if (row_offsets_data_ == nullptr) {
+      return error::FailedPrecondition("Snapshot needs a built graph");
+    }
+    int32_t implicit = implicit_edge_ids_;
+    RETURN_IF_ERROR(writer->Write(prefix + ".implicit", implicit));
+    RETURN_IF_ERROR(writer->Write(prefix + ".row_offsets", row_offsets_data_,
+                                  (row_num_ + 1) * sizeof(int64_t)));
+    return writer->Write(prefix + ".data", data_ptr_, data_size_);
+  }
+
+  Status Load(const SnapshotReader* reader,
+              const std::string& prefix) override {
+    naive_adj_.reset();
+    int32_t implicit = 0;
+    int64_t offset_num = 0;
+    RETURN_IF_ERROR(reader->Read(prefix + ".implicit", &implicit));
+    RETURN_IF_ERROR(reader->View(prefix + ".row_offsets",
+                                 &row_offsets_data_, &offset_num));
+    RETURN_IF_ERROR(reader->View(prefix + ".data", &data_ptr_, &data_size_));
+    if (offset_num < 1 ||
+        row_offsets_data_[offset_num - 1] + kPackedPadding != data_size_) {
+      return error::DataLoss("Invalid adjacent matrix in snapshot: " + prefix);
+    }
+    implicit_edge_ids_ = implicit;
+    row_num_ = offset_num - 1;
+    version_ = NewStorageVersion();
+    return Status::OK();
+  }
+
+  void Add(IdType edge_id, IdType src_id, IdType dst_id) override {
+    naive_adj_->Add(edge_id, src_id, dst_id);
+  }
+
+  Array<IdType> GetNeighbors(IdType src_id) const override {
+    const uint8_t* row = nullptr;
+    uint64_t size = 0;
+    uint64_t node_bytes = 0;
+    IndexType index = indexing_->Get(src_id);
+    if (!LocateRow(index, &row, &size, &node_bytes)) {
+      return Array<IdType>();
+    }
+
+    bool hit = false;
+    int64_t key = 2 * static_cast<int64_t>(index);
+    auto ids = GetRowCache()->Get(version_, key, size, &hit);
+    if (!hit) {
+      DecodeIds(row, size, ids->data());
+    }
+    return Array<IdType>(std::move(ids));
+  }
+
+  Array<IdType> GetOutEdges(IdType src_id) const override {
+    const uint8_t* row = nullptr;
+    uint64_t size = 0;
+    uint64_t node_bytes = 0;
+    IndexType index = indexing_->Get(src_id);
+    if (!LocateRow(index, &row, &size, &node_bytes)) {
+      return Array<IdType>();
+    }
+
+    if (implicit_edge_ids_) {
+      uint64_t begin = 0;
+      DecodeVarint(row + node_bytes, &begin);
+      return Array<IdType>::Range(begin, size);
+    }
+
+    bool hit = false;
+    int64_t key = 2 * static_cast<int64_t>(index) + 1;
+    auto ids = GetRowCache()->Get(version_, key, size, &hit);
+    if (!hit) {
+      DecodeIds(row + node_bytes, size, ids->data());
+    }
+    return Array<IdType>(std::move(ids));
+  }
+
+  IndexType GetRowSize(IdType src_id) const override {
+    const uint8_t* row = nullptr;
+    uint64_t size = 0;
+    uint64_t node_bytes = 0;
+    LocateRow(indexing_->Get(src_id), &row, &size, &node_bytes);
+    return size;
+  }
+
+private:
+  bool LocateRow(IndexType index, const uint8_t** row,
+                 uint64_t* size, uint64_t* node_bytes) const {
+    if (index == -1) {
+      return false;
+    }
+
+    const uint8_t* p = data_ptr_ + row_offsets_data_[index];
+    p = DecodeVarint(p, size);
+    p = DecodeVarint(p, node_bytes);
+    *row = p;
+    return *size > 0;
+  }
+
+private:
+  std::unique_ptr<MemoryAdjMatrix> naive_adj_;
+  AutoIndex* indexing_;
+  std::vector<int64_t> row_offsets_;
+  std::vector<uint8_t> data_;
+  bool implicit_edge_ids_;
+  // Point to the arrays above, or to a snapshot mapping.
+  IdType row_num_;
+  const int64_t* row_offsets_data_;
+  const uint8_t* data_ptr_;
+  int64_t data_size_;
+  // Tell the decoded rows cached by the threads from those of other
+  // matrices or of an earlier build.
+  int64_t version_;
 };
 
 AdjMatrix* NewMemoryAdjMatrix(AutoIndex* indexing) {
@@ -203,7 +648,15 @@ AdjMatrix* NewMemoryAdjMatrix(AutoIndex* indexing) {
 }
 
 AdjMatrix* NewCompressedMemoryAdjMatrix(AutoIndex* indexing) {
-  return new CompressedMemoryAdjMatrix(indexing);
+  return new CompressedMemoryAdjMatrix(indexing, true);
+}
+
+AdjMatrix* NewReversedMemoryAdjMatrix(AutoIndex* indexing) {
+  return new CompressedMemoryAdjMatrix(indexing, false);
+}
+
+AdjMatrix* NewPackedMemoryAdjMatrix(AutoIndex* indexing) {
+  return new PackedMemoryAdjMatrix(indexing);
 }
 
 }  // namespace io
@@ -13,9 +13,12 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <vector>
+#include "graphlearn/common/base/errors.h"
 #include "graphlearn/core/graph/storage/edge_storage.h"
 #include "graphlearn/include/config.h"
+#include "graphlearn/platform/env.h"
 
 namespace graphlearn {
 namespace io {
@@ -49,6 +52,32 @@ public:
     attributes_.shrink_to_fit();
   }
 
+  void Reorder(const IdList& order, bool keep_ids) override {
+    ThreadPool* tp = Env::Default()->IntraThreadPool();
+    Permute(order, &src_ids_, tp);
+    Permute(order, &dst_ids_, tp);
+    Permute(order, &labels_, tp);
+    Permute(order, &weights_, tp);
+    Permute(order, &attributes_, tp);
+
+    if (keep_ids) {
+      id_remap_.resize(order.size());
+      for (size_t i = 0; i < order.size(); ++i) {
+        id_remap_[order[i]] = i;
+      }
+    }
+  }
+
+  Status Save(SnapshotWriter* writer,
+              const std::string& prefix) const override {
+    return error::Unimplemented("Snapshot needs the column storage mode");
+  }
+
+  Status Load(const SnapshotReader* reader,
+              const std::string& prefix) override {
+    return error::Unimplemented("Snapshot needs the column storage mode");
+  }
+
   IdType Add(EdgeValue* value) override {
     IdType edge_id = src_ids_.size();
 
@@ -75,32 +104,36 @@ public:
   }
 
   IdType GetSrcId(IdType edge_id) const override {
-    if (edge_id < Size()) {
-      return src_ids_[edge_id];
+    IdType index = Locate(edge_id);
+    if (index < Size()) {
+      return src_ids_[index];
     } else {
       return -1;
     }
   }
 
   IdType GetDstId(IdType edge_id) const override {
-    if (edge_id < Size()) {
-      return dst_ids_[edge_id];
+    IdType index = Locate(edge_id);
+    if (index < Size()) {
+      return dst_ids_[index];
     } else {
       return -1;
     }
   }
 
   float GetWeight(IdType edge_id) const override {
-    if (edge_id < weights_.size()) {
-      return weights_[edge_id];
+    IdType index = Locate(edge_id);
+    if (index < weights_.size()) {
+      return weights_[index];
     } else {
       return 0.0;
     }
   }
 
   int32_t GetLabel(IdType edge_id) const override {
-    if (edge_id < labels_.size()) {
-      return labels_[edge_id];
+    IdType index = Locate(edge_id);
+    if (index < labels_.size()) {
+      return labels_[index];
     } else {
       return -1;
     }
@@ -111,13 +144,58 @@ public:
       return Attribute();
     }
 
-    if (edge_id < attributes_.size()) {
-      return Attribute(attributes_[edge_id].get(), false);
+    IdType index = Locate(edge_id);
+    if (index < attributes_.size()) {
+      return Attribute(attributes_[index].get(), false);
     } else {
       return Attribute(AttributeValue::Default(&side_info_), false);
     }
   }
 
+  void GatherWeights(const IdType* edge_ids, int32_t size,
+                     float* out) const override {
+    const float kDefault = 0.0;
+    Gather(edge_ids, size, weights_.data(), weights_.size(), 1,
+           &kDefault, out);
+  }
+
+  void GatherLabels(const IdType* edge_ids, int32_t size,
+                    int32_t* out) const override {
+    const int32_t kDefault = -1;
+    Gather(edge_ids, size, labels_.data(), labels_.size(), 1,
+           &kDefault, out);
+  }
+
+  void GatherInts(const IdType* edge_ids, int32_t size,
+                  int64_t* out) const override {
+    GatherAttributes(edge_ids, size, side_info_.i_num,
+      [] (const AttributeValue* attr) { return attr->GetInts(nullptr); },
+      out);
+  }
+
+  void GatherFloats(const IdType* edge_ids, int32_t size,
+                    float* out) const override {
+    GatherAttributes(edge_ids, size, side_info_.f_num,
+      [] (const AttributeValue* attr) { return attr->GetFloats(nullptr); },
+      out);
+  }
+
+  void GatherStrings(const IdType* edge_ids, int32_t size,
+                     const std::string** out) const override {
+    GatherAttributes(edge_ids, size, side_info_.s_num,
+      [] (const AttributeValue* attr) { return attr->GetStrings(nullptr); },
+      out);
+  }
+
+  const StringDict* GetStringDict() const override {
+    return nullptr;
+  }
+
+  void GatherStringCodes(const IdType* edge_ids, int32_t size,
+                         int32_t* out) const override {
+    std::fill(out, out + size * side_info_.s_num, -1);
+  }
+
   const IdList* GetSrcIds() const override {
     return &src_ids_;
   }
@@ -138,6 +216,55 @@ public:
     return &attributes_;
   }
 
+private:
+  template <class T, class Out>
+  void Gather(const IdType* edge_ids, int32_t size,
+              const T* column, int64_t rows, int32_t num,
+              const T* defaults, Out* out) const {
+    IdType indices[kGatherChunkSize];
+    for (int32_t begin = 0; begin < size; begin += kGatherChunkSize) {
+      int32_t n = std::min(size - begin, kGatherChunkSize);
+      for (int32_t i = 0; i < n; ++i) {
+        indices[i] = Locate(edge_ids[begin + i]);
+      }
+      GatherRows(column, rows, num, indices, n, defaults, out + begin * num);
+    }
+  }
+
+  /// Each edge holds its own attribute value, `column` picks the values
+  /// of one kind from it.
+  template <class Column, class Out>
+  void GatherAttributes(const IdType* edge_ids, int32_t size, int32_t num,
+                        Column column, Out* out) const {
+    if (num <= 0) {
+      return;
+    }
+
+    auto defaults = column(AttributeValue::Default(&side_info_));
+    IdType rows = attributes_.size();
+    for (int32_t i = 0; i < size; ++i, out += num) {
+      IdType index = Locate(edge_ids[i]);
+      auto row = (index >= 0 && index < rows) ?
+        column(attributes_[index].get()) : defaults;
+      for (int32_t j = 0; j < num; ++j) {
+        GatherValue(row[j], out + j);
+      }
+    }
+  }
+
+  /// Size() for an invalid edge id.
+  IdType Locate(IdType edge_id) const {
+    if (edge_id < 0) {
+      return Size();
+    } else if (id_remap_.empty()) {
+      return edge_id;
+    } else if (edge_id < static_cast<IdType>(id_remap_.size())) {
+      return id_remap_[edge_id];
+    } else {
+      return Size();
+    }
+  }
+
 private:
   IdList     src_ids_;
   IdList     dst_ids_;
@@ -145,6 +272,7 @@ private:
   std::vector<float>     weights_;
   std::vector<Attribute> attributes_;
   SideInfo               side_info_;
+  IdList                 id_remap_;
 };
 
 EdgeStorage* NewMemoryEdgeStorage() {
@@ -14,9 +14,11 @@ limitations under the License.
 ==============================================================================*/
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <mutex>  // NOLINT [build/c++11]
 
+#include "graphlearn/common/base/errors.h"
 #include "graphlearn/common/threading/sync/lock.h"
 #include "graphlearn/core/graph/storage/edge_storage.h"
 #include "graphlearn/core/graph/storage/graph_storage.h"
@@ -28,7 +30,7 @@ namespace io {
 
 class MemoryGraphStorage : public GraphStorage {
 public:
-  MemoryGraphStorage() {
+  MemoryGraphStorage() : version_(NewStorageVersion()) {
     topo_ = NewMemoryTopoStorage();
     edges_ = NewMemoryEdgeStorage();
   }
@@ -57,6 +59,25 @@ public:
     ScopedLocker<std::mutex> _(&mtx_);
     edges_->Build();
     topo_->Build(edges_);
+    version_ = NewStorageVersion();
+  }
+
+  Status Save(SnapshotWriter* writer,
+              const std::string& prefix) const override {
+    RETURN_IF_ERROR(edges_->Save(writer, prefix + ".edges"));
+    return topo_->Save(writer, prefix + ".topo");
+  }
+
+  Status Load(const SnapshotReader* reader,
+              const std::string& prefix) override {
+    ScopedLocker<std::mutex> _(&mtx_);
+    version_ = NewStorageVersion();
+    RETURN_IF_ERROR(edges_->Load(reader, prefix + ".edges"));
+    return topo_->Load(reader, prefix + ".topo");
+  }
+
+  int64_t GetVersion() const override {
+    return version_;
   }
 
   void SetSideInfo(const SideInfo* info) override {
@@ -91,6 +112,40 @@ public:
     return edges_->GetAttribute(edge_id);
   }
 
+  void GatherEdgeWeights(const IdType* edge_ids, int32_t size,
+                         float* out) const override {
+    edges_->GatherWeights(edge_ids, size, out);
+  }
+
+  void GatherEdgeLabels(const IdType* edge_ids, int32_t size,
+                        int32_t* out) const override {
+    edges_->GatherLabels(edge_ids, size, out);
+  }
+
+  void GatherEdgeInts(const IdType* edge_ids, int32_t size,
+                      int64_t* out) const override {
+    edges_->GatherInts(edge_ids, size, out);
+  }
+
+  void GatherEdgeFloats(const IdType* edge_ids, int32_t size,
+                        float* out) const override {
+    edges_->GatherFloats(edge_ids, size, out);
+  }
+
+  void GatherEdgeStrings(const IdType* edge_ids, int32_t size,
+                         const std::string** out) const override {
+    edges_->GatherStrings(edge_ids, size, out);
+  }
+
+  const StringDict* GetEdgeStringDict() const override {
+    return edges_->GetStringDict();
+  }
+
+  void GatherEdgeStringCodes(const IdType* edge_ids, int32_t size,
+                             int32_t* out) const override {
+    edges_->GatherStringCodes(edge_ids, size, out);
+  }
+
   Array<IdType> GetNeighbors(IdType src_id) const override {
     return topo_->GetNeighbors(src_id);
   }
@@ -99,6 +154,34 @@ public:
     return topo_->GetOutEdges(src_id);
   }
 
+  Array<IdType> GetInNeighbors(IdType dst_id) const override {
+    return topo_->GetInNeighbors(dst_id);
+  }
+
+  Array<IdType> GetInEdges(IdType dst_id) const override {
+    return topo_->GetInEdges(dst_id);
+  }
+
+  Array<double> GetEdgeWeightTable(IdType src_id) const override {
+    return topo_->GetEdgeWeightTable(src_id);
+  }
+
+  Array<double> GetInDegreeTable(IdType src_id) const override {
+    return topo_->GetInDegreeTable(src_id);
+  }
+
+  Array<IdType> GetSortedNeighbors(IdType src_id) const override {
+    return topo_->GetSortedNeighbors(src_id);
+  }
+
+  IndexType GetClusterCount() const override {
+    return topo_->GetClusterCount();
+  }
+
+  Array<IdType> GetCluster(IndexType cluster) const override {
+    return topo_->GetCluster(cluster);
+  }
+
   IndexType GetInDegree(IdType dst_id) const override {
     return topo_->GetInDegree(dst_id);
   }
@@ -127,6 +210,7 @@ private:
   std::mutex   mtx_;
   EdgeStorage* edges_;
   TopoStorage* topo_;
+  std::atomic<int64_t> version_;
 };
 
 GraphStorage* NewMemoryGraphStorage() {
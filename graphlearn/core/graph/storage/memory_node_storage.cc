@@ -13,7 +13,11 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <atomic>
 #include <mutex>   // NOLINT [build/c++11]
+#include "graphlearn/common/base/errors.h"
+#include "graphlearn/core/graph/storage/auto_indexing.h"
 #include "graphlearn/core/graph/storage/node_storage.h"
 #include "graphlearn/include/config.h"
 
@@ -22,9 +26,9 @@ namespace io {
 
 class MemoryNodeStorage : public NodeStorage {
 public:
-  MemoryNodeStorage() {
+  MemoryNodeStorage() : version_(NewStorageVersion()) {
     int64_t estimate_size = GLOBAL_FLAG(AverageNodeCount);
-    id_to_index_.rehash(estimate_size);
+    id_to_index_.Reserve(estimate_size);
     ids_.reserve(estimate_size);
   }
 
@@ -50,19 +54,34 @@ public:
   }
 
   void Build() override {
+    version_ = NewStorageVersion();
+    id_to_index_.Build();
     ids_.shrink_to_fit();
     labels_.shrink_to_fit();
     weights_.shrink_to_fit();
     attributes_.shrink_to_fit();
   }
 
+  Status Save(SnapshotWriter* writer,
+              const std::string& prefix) const override {
+    return error::Unimplemented("Snapshot needs the column storage mode");
+  }
+
+  Status Load(const SnapshotReader* reader,
+              const std::string& prefix) override {
+    return error::Unimplemented("Snapshot needs the column storage mode");
+  }
+
+  int64_t GetVersion() const override {
+    return version_;
+  }
+
   IdType Size() const override {
     return ids_.size();
   }
 
   void Add(NodeValue* value) override {
-    auto ret = id_to_index_.insert({value->id, ids_.size()});
-    if (!ret.second) {
+    if (!id_to_index_.Add(value->id)) {
       return;
     }
 
@@ -86,11 +105,11 @@ public:
       return 0.0;
     }
 
-    auto it = id_to_index_.find(node_id);
-    if (it == id_to_index_.end()) {
+    IndexType index = id_to_index_.Get(node_id);
+    if (index == -1) {
       return 0.0;
     } else {
-      return weights_[it->second];
+      return weights_[index];
     }
   }
 
@@ -99,11 +118,11 @@ public:
       return -1;
     }
 
-    auto it = id_to_index_.find(node_id);
-    if (it == id_to_index_.end()) {
+    IndexType index = id_to_index_.Get(node_id);
+    if (index == -1) {
       return -1;
     } else {
-      return labels_[it->second];
+      return labels_[index];
     }
   }
 
@@ -112,14 +131,58 @@ public:
       return Attribute();
     }
 
-    auto it = id_to_index_.find(node_id);
-    if (it == id_to_index_.end()) {
+    IndexType index = id_to_index_.Get(node_id);
+    if (index == -1) {
       return Attribute(AttributeValue::Default(&side_info_), false);
     } else {
-      return Attribute(attributes_[it->second].get(), false);
+      return Attribute(attributes_[index].get(), false);
     }
   }
 
+  void GatherWeights(const IdType* node_ids, int32_t size,
+                     float* out) const override {
+    const float kDefault = 0.0;
+    Gather(node_ids, size, weights_.data(), weights_.size(), 1,
+           &kDefault, out);
+  }
+
+  void GatherLabels(const IdType* node_ids, int32_t size,
+                    int32_t* out) const override {
+    const int32_t kDefault = -1;
+    Gather(node_ids, size, labels_.data(), labels_.size(), 1,
+           &kDefault, out);
+  }
+
+  void GatherInts(const IdType* node_ids, int32_t size,
+                  int64_t* out) const override {
+    GatherAttributes(node_ids, size, side_info_.i_num,
+      [] (const AttributeValue* attr) { return attr->GetInts(nullptr); },
+      out);
+  }
+
+  void GatherFloats(const IdType* node_ids, int32_t size,
+                    float* out) const override {
+    GatherAttributes(node_ids, size, side_info_.f_num,
+      [] (const AttributeValue* attr) { return attr->GetFloats(nullptr); },
+      out);
+  }
+
+  void GatherStrings(const IdType* node_ids, int32_t size,
+                     const std::string** out) const override {
+    GatherAttributes(node_ids, size, side_info_.s_num,
+      [] (const AttributeValue* attr) { return attr->GetStrings(nullptr); },
+      out);
+  }
+
+  const StringDict* GetStringDict() const override {
+    return nullptr;
+  }
+
+  void GatherStringCodes(const IdType* node_ids, int32_t size,
+                         int32_t* out) const override {
+    std::fill(out, out + size * side_info_.s_num, -1);
+  }
+
   const IdList* GetIds() const override {
     return &ids_;
   }
@@ -136,14 +199,54 @@ public:
     return &attributes_;
   }
 
+private:
+  template <class T, class Out>
+  void Gather(const IdType* node_ids, int32_t size,
+              const T* column, int64_t rows, int32_t num,
+              const T* defaults, Out* out) const {
+    IndexType indices[kGatherChunkSize];
+    for (int32_t begin = 0; begin < size; begin += kGatherChunkSize) {
+      int32_t n = std::min(size - begin, kGatherChunkSize);
+      id_to_index_.GetBatch(node_ids + begin, n, indices);
+      GatherRows(column, rows, num, indices, n, defaults, out + begin * num);
+    }
+  }
+
+  /// Each node holds its own attribute value, `column` picks the values
+  /// of one kind from it.
+  template <class Column, class Out>
+  void GatherAttributes(const IdType* node_ids, int32_t size, int32_t num,
+                        Column column, Out* out) const {
+    if (num <= 0) {
+      return;
+    }
+
+    auto defaults = column(AttributeValue::Default(&side_info_));
+    IndexType rows = attributes_.size();
+    IndexType indices[kGatherChunkSize];
+    for (int32_t begin = 0; begin < size; begin += kGatherChunkSize) {
+      int32_t n = std::min(size - begin, kGatherChunkSize);
+      id_to_index_.GetBatch(node_ids + begin, n, indices);
+      for (int32_t i = 0; i < n; ++i, out += num) {
+        IndexType index = indices[i];
+        auto row = (index >= 0 && index < rows) ?
+          column(attributes_[index].get()) : defaults;
+        for (int32_t j = 0; j < num; ++j) {
+          GatherValue(row[j], out + j);
+        }
+      }
+    }
+  }
+
 private:
   std::mutex mtx_;
-  MAP        id_to_index_;
+  AutoIndex  id_to_index_;
   IdList     ids_;
   std::vector<float>     weights_;
   std::vector<int32_t>   labels_;
   std::vector<Attribute> attributes_;
   SideInfo               side_info_;
+  std::atomic<int64_t>   version_;
 };
 
 NodeStorage* NewMemoryNodeStorage() {
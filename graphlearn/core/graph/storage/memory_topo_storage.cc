@@ -13,7 +13,11 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include "graphlearn/common/base/errors.h"
 #include "graphlearn/core/graph/storage/adj_matrix.h"
+#include "graphlearn/core/graph/storage/graph_clusters.h"
+#include "graphlearn/core/graph/storage/sampling_table.h"
+#include "graphlearn/core/graph/storage/sorted_neighbors.h"
 #include "graphlearn/core/graph/storage/storage_mode.h"
 #include "graphlearn/core/graph/storage/topo_statics.h"
 #include "graphlearn/core/graph/storage/topo_storage.h"
@@ -24,15 +28,26 @@ namespace io {
 
 class MemoryTopoStorage : public TopoStorage {
 public:
-  MemoryTopoStorage() : adj_matrix_(nullptr), statics_(nullptr) {
+  MemoryTopoStorage()
+      : adj_matrix_(nullptr), in_adj_matrix_(nullptr), statics_(nullptr),
+        weight_table_(nullptr), in_degree_table_(nullptr),
+        sorted_nbrs_(nullptr), clusters_(nullptr), rows_sorted_(false) {
     if (IsDataDistributionEnabled()) {
       statics_ = new TopoStatics(&src_indexing_, &dst_indexing_);
     }
+    if (IsInEdgeIndexEnabled()) {
+      in_adj_matrix_ = NewReversedMemoryAdjMatrix(&in_indexing_);
+    }
   }
 
   virtual ~MemoryTopoStorage() {
     delete adj_matrix_;
+    delete in_adj_matrix_;
     delete statics_;
+    delete weight_table_;
+    delete in_degree_table_;
+    delete sorted_nbrs_;
+    delete clusters_;
   }
 
   void Add(IdType edge_id, EdgeValue* edge) override {
@@ -45,10 +60,88 @@ public:
   }
 
   void Build(EdgeStorage* edges) override {
+    src_indexing_.Build();
+    dst_indexing_.Build();
     adj_matrix_->Build(edges);
     if (IsDataDistributionEnabled()) {
       statics_->Build();
     }
+    if (in_adj_matrix_) {
+      BuildInEdges(edges);
+    }
+    if (IsSamplingTableEnabled()) {
+      BuildSamplingTables(edges);
+    }
+    if (IsSortedNeighborEnabled()) {
+      BuildSortedNeighbors(edges);
+    }
+    if (IsGraphClusterEnabled()) {
+      BuildClusters();
+    }
+  }
+
+  Status Save(SnapshotWriter* writer,
+              const std::string& prefix) const override {
+    RETURN_IF_ERROR(src_indexing_.Save(writer, prefix + ".src_index"));
+    RETURN_IF_ERROR(adj_matrix_->Save(writer, prefix + ".adj"));
+    if (IsDataDistributionEnabled()) {
+      RETURN_IF_ERROR(dst_indexing_.Save(writer, prefix + ".dst_index"));
+      RETURN_IF_ERROR(statics_->Save(writer, prefix + ".statics"));
+    }
+    if (in_adj_matrix_) {
+      RETURN_IF_ERROR(in_indexing_.Save(writer, prefix + ".in_index"));
+      RETURN_IF_ERROR(in_adj_matrix_->Save(writer, prefix + ".in_adj"));
+    }
+    if (weight_table_) {
+      RETURN_IF_ERROR(weight_table_->Save(writer, prefix + ".weight_table"));
+    }
+    if (in_degree_table_) {
+      RETURN_IF_ERROR(
+        in_degree_table_->Save(writer, prefix + ".in_degree_table"));
+    }
+    if (sorted_nbrs_) {
+      RETURN_IF_ERROR(sorted_nbrs_->Save(writer, prefix + ".sorted_nbrs"));
+    }
+    if (clusters_) {
+      RETURN_IF_ERROR(clusters_->Save(writer, prefix + ".clusters"));
+    }
+    return Status::OK();
+  }
+
+  Status Load(const SnapshotReader* reader,
+              const std::string& prefix) override {
+    RETURN_IF_ERROR(src_indexing_.Load(reader, prefix + ".src_index"));
+    RETURN_IF_ERROR(adj_matrix_->Load(reader, prefix + ".adj"));
+    if (IsDataDistributionEnabled()) {
+      RETURN_IF_ERROR(dst_indexing_.Load(reader, prefix + ".dst_index"));
+      RETURN_IF_ERROR(statics_->Load(reader, prefix + ".statics"));
+    }
+    if (in_adj_matrix_) {
+      RETURN_IF_ERROR(in_indexing_.Load(reader, prefix + ".in_index"));
+      RETURN_IF_ERROR(in_adj_matrix_->Load(reader, prefix + ".in_adj"));
+    }
+    // The tables are only saved for the weighted edges or the available
+    // in-degrees.
+    if (IsSamplingTableEnabled()) {
+      RETURN_IF_ERROR(LoadSamplingTable(
+        reader, prefix + ".weight_table", &weight_table_));
+      RETURN_IF_ERROR(LoadSamplingTable(
+        reader, prefix + ".in_degree_table", &in_degree_table_));
+    }
+    // No copy is saved if the rows are sorted already.
+    if (IsSortedNeighborEnabled()) {
+      if (reader->Has(prefix + ".sorted_nbrs.offsets")) {
+        sorted_nbrs_ = new SortedNeighbors();
+        RETURN_IF_ERROR(sorted_nbrs_->Load(reader, prefix + ".sorted_nbrs"));
+      } else {
+        rows_sorted_ = IsPackedTopologyEnabled();
+      }
+    }
+    if (IsGraphClusterEnabled()) {
+      clusters_ = new GraphClusters();
+      RETURN_IF_ERROR(clusters_->Load(reader, prefix + ".clusters"));
+    }
+    return Status::OK();
   }
 
   Array<IdType> GetNeighbors(IdType src_id) const override {
@@ -59,6 +152,60 @@ public:
     return adj_matrix_->GetOutEdges(src_id);
   }
 
+  Array<IdType> GetInNeighbors(IdType dst_id) const override {
+    if (in_adj_matrix_) {
+      return in_adj_matrix_->GetNeighbors(dst_id);
+    } else {
+      return Array<IdType>();
+    }
+  }
+
+  Array<IdType> GetInEdges(IdType dst_id) const override {
+    if (in_adj_matrix_) {
+      return in_adj_matrix_->GetOutEdges(dst_id);
+    } else {
+      return Array<IdType>();
+    }
+  }
+
+  Array<double> GetEdgeWeightTable(IdType src_id) const override {
+    if (weight_table_) {
+      return weight_table_->GetRow(src_indexing_.Get(src_id));
+    } else {
+      return Array<double>();
+    }
+  }
+
+  Array<double> GetInDegreeTable(IdType src_id) const override {
+    if (in_degree_table_) {
+      return in_degree_table_->GetRow(src_indexing_.Get(src_id));
+    } else {
+      return Array<double>();
+    }
+  }
+
+  Array<IdType> GetSortedNeighbors(IdType src_id) const override {
+    if (sorted_nbrs_) {
+      return sorted_nbrs_->GetRow(src_indexing_.Get(src_id));
+    } else if (rows_sorted_) {
+      return adj_matrix_->GetNeighbors(src_id);
+    } else {
+      return Array<IdType>();
+    }
+  }
+
+  IndexType GetClusterCount() const override {
+    return clusters_ ? clusters_->Size() : 0;
+  }
+
+  Array<IdType> GetCluster(IndexType cluster) const override {
+    if (clusters_) {
+      return clusters_->GetCluster(cluster);
+    } else {
+      return Array<IdType>();
+    }
+  }
+
   IndexType GetOutDegree(IdType src_id) const override {
     if (IsDataDistributionEnabled()) {
       return statics_->GetOutDegree(src_id);
@@ -70,6 +217,9 @@ public:
   IndexType GetInDegree(IdType dst_id) const override {
     if (IsDataDistributionEnabled()) {
       return statics_->GetInDegree(dst_id);
+    } else if (in_adj_matrix_) {
+      // Just the row size in the reverse index
+      return in_adj_matrix_->GetRowSize(dst_id);
     } else {
       return 0;
     }
@@ -107,11 +257,97 @@ public:
     }
   }
 
+private:
+  /// Index the in-edges by scanning the edges, after the out-edges are
+  /// built, which may re-arrange the edge ids. The edge ids are always
+  /// [0, edges->Size()), either the positions or the original ones.
+  void BuildInEdges(EdgeStorage* edges) {
+    IdType edge_count = edges->Size();
+    for (IdType edge_id = 0; edge_id < edge_count; ++edge_id) {
+      IdType dst_id = edges->GetDstId(edge_id);
+      in_indexing_.Add(dst_id);
+      in_adj_matrix_->Add(edge_id, dst_id, edges->GetSrcId(edge_id));
+    }
+    in_indexing_.Build();
+    in_adj_matrix_->Build(edges);
+  }
+
+  /// Accumulate the weights of each row of the adjacent matrix, whose rows
+  /// follow the indices of src_indexing_.
+  void BuildSamplingTables(EdgeStorage* edges) {
+    IdList src_ids;
+    src_indexing_.GetIds(&src_ids);
+    if (edges->GetSideInfo()->IsWeighted()) {
+      weight_table_ = new SamplingTable();
+      weight_table_->Build(src_ids.size(),
+        [this, edges, &src_ids] (int64_t row, std::vector<float>* weights) {
+          auto edge_ids = adj_matrix_->GetOutEdges(src_ids[row]);
+          for (int32_t i = 0; i < edge_ids.Size(); ++i) {
+            weights->push_back(edges->GetWeight(edge_ids[i]));
+          }
+        });
+    }
+    if (statics_ || in_adj_matrix_) {
+      in_degree_table_ = new SamplingTable();
+      in_degree_table_->Build(src_ids.size(),
+        [this, &src_ids] (int64_t row, std::vector<float>* weights) {
+          auto nbr_ids = adj_matrix_->GetNeighbors(src_ids[row]);
+          for (int32_t i = 0; i < nbr_ids.Size(); ++i) {
+            weights->push_back(GetInDegree(nbr_ids[i]));
+          }
+        });
+    }
+  }
+
+  /// The packed rows of unweighted edges are sorted by neighbor id, and
+  /// others keep a sorted copy, whose rows follow src_indexing_.
+  void BuildSortedNeighbors(EdgeStorage* edges) {
+    if (IsPackedTopologyEnabled() && !edges->GetSideInfo()->IsWeighted()) {
+      rows_sorted_ = true;
+      return;
+    }
+    IdList src_ids;
+    src_indexing_.GetIds(&src_ids);
+    sorted_nbrs_ = new SortedNeighbors();
+    sorted_nbrs_->Build(src_ids.size(), [this, &src_ids] (int64_t row) {
+      return adj_matrix_->GetNeighbors(src_ids[row]);
+    });
+  }
+
+  /// Cluster the source ids over the out-edges of the local rows only.
+  void BuildClusters() {
+    IdList src_ids;
+    src_indexing_.GetIds(&src_ids);
+    clusters_ = new GraphClusters();
+    clusters_->Build(src_ids, [this, &src_ids] (int64_t row) {
+      return adj_matrix_->GetNeighbors(src_ids[row]);
+    }, GLOBAL_FLAG(MaxClusterSize));
+  }
+
+  Status LoadSamplingTable(const SnapshotReader* reader,
+                           const std::string& prefix,
+                           SamplingTable** table) {
+    if (!reader->Has(prefix + ".offsets")) {
+      return Status::OK();
+    }
+    *table = new SamplingTable();
+    return (*table)->Load(reader, prefix);
+  }
+
 private:
   AutoIndex src_indexing_;
   AutoIndex dst_indexing_;
+  AutoIndex in_indexing_;
   AdjMatrix* adj_matrix_;
+  // The reverse index of the in-edges, keyed by in_indexing_.
+  AdjMatrix* in_adj_matrix_;
   TopoStatics* statics_;
+  SamplingTable* weight_table_;
+  SamplingTable* in_degree_table_;
+  SortedNeighbors* sorted_nbrs_;
+  GraphClusters* clusters_;
+  // GetNeighbors() of adj_matrix_ is in ascending order already.
+  bool rows_sorted_;
 
   friend TopoStorage* NewMemoryTopoStorage();
   friend TopoStorage* NewCompressedMemoryTopoStorage();
@@ -125,7 +361,11 @@ TopoStorage* NewMemoryTopoStorage() {
 
 TopoStorage* NewCompressedMemoryTopoStorage() {
   MemoryTopoStorage* ret = new MemoryTopoStorage();
-  ret->adj_matrix_ = NewCompressedMemoryAdjMatrix(&(ret->src_indexing_));
+  if (IsPackedTopologyEnabled()) {
+    ret->adj_matrix_ = NewPackedMemoryAdjMatrix(&(ret->src_indexing_));
+  } else {
+    ret->adj_matrix_ = NewCompressedMemoryAdjMatrix(&(ret->src_indexing_));
+  }
   return ret;
 }
 
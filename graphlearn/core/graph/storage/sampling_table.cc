@@ -0,0 +1,109 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "graphlearn/core/graph/storage/sampling_table.h"
+
+#include <algorithm>
+#include "graphlearn/common/base/errors.h"
+#include "graphlearn/common/threading/runner/parallel_for.h"
+#include "graphlearn/platform/env.h"
+
+namespace graphlearn {
+namespace io {
+
+namespace {
+
+// Rows are built in parallel, with so many rows per block.
+const int64_t kRowsPerBlock = 1024;
+
+}  // anonymous namespace
+
+SamplingTable::SamplingTable()
+    : row_num_(0), offsets_data_(nullptr), cdfs_data_(nullptr) {
+}
+
+void SamplingTable::Build(int64_t row_num, const WeightsFunc& func) {
+  ThreadPool* tp = Env::Default()->IntraThreadPool();
+
+  // Rows are accumulated into the buffer of each block, and then the
+  // buffers are concatenated.
+  int64_t block_num = (row_num + kRowsPerBlock - 1) / kRowsPerBlock;
+  std::vector<std::vector<double>> blocks(block_num);
+  std::vector<int64_t> block_offsets(block_num + 1, 0);
+  offsets_.assign(row_num + 1, 0);
+  ParallelFor(tp, block_num, 1, [&] (int64_t begin, int64_t end) {
+    std::vector<float> weights;
+    for (int64_t b = begin; b < end; ++b) {
+      auto& buf = blocks[b];
+      int64_t last = std::min((b + 1) * kRowsPerBlock, row_num);
+      for (int64_t i = b * kRowsPerBlock; i < last; ++i) {
+        weights.clear();
+        func(i, &weights);
+        double sum = 0.0;
+        for (float w : weights) {
+          sum += std::max(w, 0.0f);
+          buf.push_back(sum);
+        }
+        offsets_[i + 1] = buf.size();
+      }
+      block_offsets[b] = buf.size();
+    }
+  });
+  int64_t total = ParallelPrefixSum(tp, &block_offsets);
+
+  cdfs_.resize(total);
+  ParallelFor(tp, block_num, 1, [&] (int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; ++b) {
+      std::copy(blocks[b].begin(), blocks[b].end(),
+                cdfs_.begin() + block_offsets[b]);
+      std::vector<double>().swap(blocks[b]);
+      int64_t last = std::min((b + 1) * kRowsPerBlock, row_num);
+      for (int64_t i = b * kRowsPerBlock; i < last; ++i) {
+        offsets_[i + 1] += block_offsets[b];
+      }
+    }
+  });
+
+  row_num_ = row_num;
+  offsets_data_ = offsets_.data();
+  cdfs_data_ = cdfs_.data();
+}
+
+Status SamplingTable::Save(SnapshotWriter* writer,
+                           const std::string& prefix) const {
+  RETURN_IF_ERROR(writer->Write(prefix + ".offsets", offsets_data_,
+                                (row_num_ + 1) * sizeof(int64_t)));
+  return writer->Write(prefix + ".cdfs", cdfs_data_,
+                       offsets_data_[row_num_] * sizeof(double));
+}
+
+Status SamplingTable::Load(const SnapshotReader* reader,
+                           const std::string& prefix) {
+  offsets_.clear();
+  cdfs_.clear();
+  int64_t offset_num = 0;
+  int64_t total = 0;
+  RETURN_IF_ERROR(reader->View(prefix + ".offsets",
+                               &offsets_data_, &offset_num));
+  RETURN_IF_ERROR(reader->View(prefix + ".cdfs", &cdfs_data_, &total));
+  if (offset_num < 1 || offsets_data_[offset_num - 1] != total) {
+    return error::DataLoss("Invalid sampling table in snapshot: " + prefix);
+  }
+  row_num_ = offset_num - 1;
+  return Status::OK();
+}
+
+}  // namespace io
+}  // namespace graphlearn
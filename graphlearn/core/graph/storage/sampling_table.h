@@ -0,0 +1,74 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef GRAPHLEARN_CORE_GRAPH_STORAGE_SAMPLING_TABLE_H_
+#define GRAPHLEARN_CORE_GRAPH_STORAGE_SAMPLING_TABLE_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "graphlearn/core/graph/storage/snapshot.h"
+#include "graphlearn/core/graph/storage/types.h"
+#include "graphlearn/include/status.h"
+
+namespace graphlearn {
+namespace io {
+
+/// The cumulative weights of the neighbors of each row of an adjacent
+/// matrix, laid out like CSR. A neighbor is drawn by binary searching a
+/// uniform number in [0, row total), which takes O(log d) without any
+/// allocation, instead of building an alias table per request. The sums
+/// are in double, so that a small weight still counts on a hub row whose
+/// total is far beyond the precision of float.
+class SamplingTable {
+public:
+  /// Fill the weights of a row, in the order of the neighbors.
+  typedef std::function<void(int64_t row, std::vector<float>* weights)>
+    WeightsFunc;
+
+  SamplingTable();
+  ~SamplingTable() = default;
+
+  /// Build `row_num` rows in parallel.
+  void Build(int64_t row_num, const WeightsFunc& func);
+
+  /// Empty for a row out of range.
+  Array<double> GetRow(IndexType row) const {
+    if (row < 0 || row >= row_num_) {
+      return Array<double>();
+    }
+    int64_t offset = offsets_data_[row];
+    return Array<double>(cdfs_data_ + offset,
+                        offsets_data_[row + 1] - offset);
+  }
+
+  /// The table is served from the mapping after Load().
+  Status Save(SnapshotWriter* writer, const std::string& prefix) const;
+  Status Load(const SnapshotReader* reader, const std::string& prefix);
+
+private:
+  std::vector<int64_t> offsets_;
+  std::vector<double>  cdfs_;
+  // Point to the arrays above, or to a snapshot mapping.
+  int64_t        row_num_;
+  const int64_t* offsets_data_;
+  const double*  cdfs_data_;
+};
+
+}  // namespace io
+}  // namespace graphlearn
+
+#endif  // GRAPHLEARN_CORE_GRAPH_STORAGE_SAMPLING_TABLE_H_
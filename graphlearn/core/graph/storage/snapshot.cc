@@ -0,0 +1,286 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "graphlearn/core/graph/storage/snapshot.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+#include "graphlearn/common/base/errors.h"
+#include "graphlearn/common/base/log.h"
+
+namespace graphlearn {
+namespace io {
+
+namespace {
+
+struct SnapshotHeader {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t reserved;
+  int64_t  section_count;
+  int64_t  table_offset;
+};
+
+int64_t AlignUp(int64_t offset) {
+  return (offset + kSnapshotAlignment - 1) / kSnapshotAlignment *
+    kSnapshotAlignment;
+}
+
+}  // anonymous namespace
+
+SnapshotWriter::SnapshotWriter() : file_(nullptr), offset_(0) {
+}
+
+SnapshotWriter::~SnapshotWriter() {
+  if (file_) {
+    fclose(file_);
+    ::unlink((path_ + ".tmp").c_str());
+  }
+}
+
+Status SnapshotWriter::Open(const std::string& path) {
+  path_ = path;
+  file_ = fopen((path_ + ".tmp").c_str(), "wb");
+  if (file_ == nullptr) {
+    return error::Internal("Create snapshot failed: " + path_);
+  }
+
+  // Fill the header when closing.
+  char header[kSnapshotAlignment] = {0};
+  return Append(header, kSnapshotAlignment);
+}
+
+Status SnapshotWriter::Write(const std::string& name,
+                             const void* data, int64_t size) {
+  char padding[kSnapshotAlignment] = {0};
+  RETURN_IF_ERROR(Append(padding, AlignUp(offset_) - offset_));
+  sections_.push_back({name, offset_, size});
+  return Append(data, size);
+}
+
+Status SnapshotWriter::WriteStrings(const std::string& name,
+                                    const std::string* values,
+                                    int64_t size) {
+  std::vector<int64_t> offsets(size + 1, 0);
+  for (int64_t i = 0; i < size; ++i) {
+    offsets[i + 1] = offsets[i] + values[i].size();
+  }
+  RETURN_IF_ERROR(Write(name + ".offsets", offsets));
+
+  char padding[kSnapshotAlignment] = {0};
+  RETURN_IF_ERROR(Append(padding, AlignUp(offset_) - offset_));
+  sections_.push_back({name + ".bytes", offset_, offsets[size]});
+  for (int64_t i = 0; i < size; ++i) {
+    RETURN_IF_ERROR(Append(values[i].data(), values[i].size()));
+  }
+  return Status::OK();
+}
+
+Status SnapshotWriter::Close() {
+  if (file_ == nullptr) {
+    return error::FailedPrecondition("Snapshot not opened: " + path_);
+  }
+
+  char padding[kSnapshotAlignment] = {0};
+  RETURN_IF_ERROR(Append(padding, AlignUp(offset_) - offset_));
+  SnapshotHeader header;
+  header.magic = kSnapshotMagic;
+  header.version = kSnapshotVersion;
+  header.reserved = 0;
+  header.section_count = sections_.size();
+  header.table_offset = offset_;
+
+  for (const auto& section : sections_) {
+    int64_t length = section.name.size();
+    RETURN_IF_ERROR(Append(&length, sizeof(length)));
+    RETURN_IF_ERROR(Append(section.name.data(), length));
+    RETURN_IF_ERROR(Append(&section.offset, sizeof(section.offset)));
+    RETURN_IF_ERROR(Append(&section.size, sizeof(section.size)));
+  }
+
+  bool ok = fseek(file_, 0, SEEK_SET) == 0 &&
+    fwrite(&header, sizeof(header), 1, file_) == 1;
+  ok = (fclose(file_) == 0) && ok;
+  file_ = nullptr;
+  std::string tmp = path_ + ".tmp";
+  if (!ok || ::rename(tmp.c_str(), path_.c_str()) != 0) {
+    ::unlink(tmp.c_str());
+    return error::Internal("Write snapshot failed: " + path_);
+  }
+  LOG(INFO) << "Snapshot dumped: " << path_ << ", size: " << offset_;
+  return Status::OK();
+}
+
+Status SnapshotWriter::Append(const void* data, int64_t size) {
+  if (size > 0 && fwrite(data, 1, size, file_) != static_cast<size_t>(size)) {
+    return error::Internal("Write snapshot failed: " + path_);
+  }
+  offset_ += size;
+  return Status::OK();
+}
+
+SnapshotReader::SnapshotReader() : base_(nullptr), length_(0) {
+}
+
+SnapshotReader::~SnapshotReader() {
+  if (base_) {
+    ::munmap(const_cast<char*>(base_), length_);
+  }
+}
+
+Status SnapshotReader::Open(const std::string& path) {
+  path_ = path;
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return error::NotFound("Snapshot not found: " + path);
+  }
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0 ||
+      st.st_size < static_cast<int64_t>(sizeof(SnapshotHeader))) {
+    ::close(fd);
+    return CorruptedError("header");
+  }
+  void* addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED) {
+    return error::Internal("Map snapshot failed: " + path);
+  }
+  base_ = static_cast<const char*>(addr);
+  length_ = st.st_size;
+  if (length_ < static_cast<int64_t>(sizeof(SnapshotHeader))) {
+    return CorruptedError("header");
+  }
+
+  SnapshotHeader header;
+  memcpy(&header, base_, sizeof(header));
+  if (header.magic != kSnapshotMagic) {
+    return CorruptedError("header");
+  }
+  if (header.version != kSnapshotVersion) {
+    return error::FailedPrecondition(
+      "Snapshot version %u mismatches %u", header.version, kSnapshotVersion);
+  }
+  if (header.table_offset < static_cast<int64_t>(sizeof(header)) ||
+      header.table_offset > length_) {
+    return CorruptedError("section table");
+  }
+
+  const char* p = base_ + header.table_offset;
+  const char* end = base_ + length_;
+  for (int64_t i = 0; i < header.section_count; ++i) {
+    int64_t length = 0;
+    Section section;
+    if (end - p < static_cast<int64_t>(sizeof(length))) {
+      return CorruptedError("section table");
+    }
+    memcpy(&length, p, sizeof(length));
+    p += sizeof(length);
+    if (length < 0 || end - p < length + 2 * 8) {
+      return CorruptedError("section table");
+    }
+    std::string name(p, length);
+    p += length;
+    memcpy(&section.offset, p, sizeof(section.offset));
+    p += sizeof(section.offset);
+    memcpy(&section.size, p, sizeof(section.size));
+    p += sizeof(section.size);
+    if (section.offset < 0 || section.size < 0 ||
+        section.offset + section.size > length_) {
+      return CorruptedError(name);
+    }
+    sections_[name] = section;
+  }
+  return Status::OK();
+}
+
+Status SnapshotReader::ReadStrings(const std::string& name,
+                                   std::vector<std::string>* values) const {
+  const int64_t* offsets = nullptr;
+  int64_t size = 0;
+  RETURN_IF_ERROR(View(name + ".offsets", &offsets, &size));
+  const char* bytes = nullptr;
+  int64_t length = 0;
+  RETURN_IF_ERROR(Locate(name + ".bytes", &bytes, &length));
+  if (size < 1 || offsets[0] != 0 || offsets[size - 1] != length) {
+    return CorruptedError(name);
+  }
+  for (int64_t i = 0; i + 1 < size; ++i) {
+    if (offsets[i + 1] < offsets[i]) {
+      return CorruptedError(name);
+    }
+  }
+
+  values->clear();
+  values->reserve(size - 1);
+  for (int64_t i = 0; i + 1 < size; ++i) {
+    values->emplace_back(bytes + offsets[i], offsets[i + 1] - offsets[i]);
+  }
+  return Status::OK();
+}
+
+Status SnapshotReader::Locate(const std::string& name,
+                              const char** data, int64_t* size) const {
+  auto it = sections_.find(name);
+  if (it == sections_.end()) {
+    return error::NotFound("Snapshot section not found: " + name);
+  }
+  *data = base_ + it->second.offset;
+  *size = it->second.size;
+  return Status::OK();
+}
+
+Status SnapshotReader::CorruptedError(const std::string& name) const {
+  return error::DataLoss("Snapshot corrupted: " + path_ + ", " + name);
+}
+
+Status SaveSideInfo(SnapshotWriter* writer, const std::string& prefix,
+                    const SideInfo& info) {
+  int32_t nums[] = {info.i_num, info.f_num, info.s_num, info.format,
+                    static_cast<int32_t>(info.direction),
+                    static_cast<int32_t>(info.float_format)};
+  std::string types[] = {info.type, info.src_type, info.dst_type};
+  RETURN_IF_ERROR(writer->Write(prefix + ".side_info", nums, sizeof(nums)));
+  return writer->WriteStrings(prefix + ".side_info.types", types, 3);
+}
+
+Status LoadSideInfo(const SnapshotReader* reader, const std::string& prefix,
+                    SideInfo* info) {
+  const int32_t* nums = nullptr;
+  int64_t size = 0;
+  std::vector<std::string> types;
+  RETURN_IF_ERROR(reader->View(prefix + ".side_info", &nums, &size));
+  RETURN_IF_ERROR(reader->ReadStrings(prefix + ".side_info.types", &types));
+  if (size != 6 || types.size() != 3) {
+    return error::DataLoss("Invalid side info in snapshot: " + prefix);
+  }
+
+  info->i_num = nums[0];
+  info->f_num = nums[1];
+  info->s_num = nums[2];
+  info->format = nums[3];
+  info->direction = static_cast<Direction>(nums[4]);
+  info->float_format = static_cast<FloatFormat>(nums[5]);
+  info->type = types[0];
+  info->src_type = types[1];
+  info->dst_type = types[2];
+  return Status::OK();
+}
+
+}  // namespace io
+}  // namespace graphlearn
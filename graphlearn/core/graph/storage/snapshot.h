@@ -0,0 +1,165 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef GRAPHLEARN_CORE_GRAPH_STORAGE_SNAPSHOT_H_
+#define GRAPHLEARN_CORE_GRAPH_STORAGE_SNAPSHOT_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "graphlearn/core/io/element_value.h"
+#include "graphlearn/include/status.h"
+
+namespace graphlearn {
+namespace io {
+
+/// A snapshot is a binary file of named sections, which is dumped after
+/// the graph built and memory-mapped back to restore the graph without
+/// loading and building again. The layout is
+///   header: magic, version, section count, offset of the section table
+///   sections: raw bytes, each aligned to kSnapshotAlignment
+///   section table: (name length, name, offset, size) for each section
+/// Sections are plain arrays in native byte order, so a snapshot can only
+/// be restored on the same kind of machine with the same storage mode.
+/// The version must be bumped whenever the sections of any storage change.
+const uint64_t kSnapshotMagic = 0x544F4853504E5347ULL;  // "GSNPSHOT"
+const uint32_t kSnapshotVersion = 3;
+const int64_t kSnapshotAlignment = 64;
+
+class SnapshotWriter {
+public:
+  SnapshotWriter();
+  ~SnapshotWriter();
+
+  /// The data is written to a temporary file, and renamed to `path`
+  /// when Close().
+  Status Open(const std::string& path);
+  Status Close();
+
+  Status Write(const std::string& name, const void* data, int64_t size);
+
+  template <class T>
+  Status Write(const std::string& name, const std::vector<T>& values) {
+    return Write(name, values.data(), values.size() * sizeof(T));
+  }
+
+  template <class T>
+  Status Write(const std::string& name, const T& value) {
+    return Write(name, &value, sizeof(T));
+  }
+
+  /// Strings are written to two sections, name.offsets and name.bytes.
+  Status WriteStrings(const std::string& name,
+                      const std::string* values, int64_t size);
+
+private:
+  struct Section {
+    std::string name;
+    int64_t offset;
+    int64_t size;
+  };
+
+  Status Append(const void* data, int64_t size);
+
+private:
+  std::string path_;
+  FILE* file_;
+  int64_t offset_;
+  std::vector<Section> sections_;
+};
+
+class SnapshotReader {
+public:
+  SnapshotReader();
+  ~SnapshotReader();
+
+  /// Map the whole file read-only. The sections stay valid until the
+  /// reader is destroyed.
+  Status Open(const std::string& path);
+
+  bool Has(const std::string& name) const {
+    return sections_.find(name) != sections_.end();
+  }
+
+  /// Point `data` into the mapping, `size` is the element count.
+  template <class T>
+  Status View(const std::string& name, const T** data, int64_t* size) const {
+    const char* ptr = nullptr;
+    int64_t bytes = 0;
+    Status s = Locate(name, &ptr, &bytes);
+    if (s.ok()) {
+      *data = reinterpret_cast<const T*>(ptr);
+      *size = bytes / sizeof(T);
+    }
+    return s;
+  }
+
+  /// Copy the section out of the mapping.
+  template <class T>
+  Status Read(const std::string& name, std::vector<T>* values) const {
+    const T* data = nullptr;
+    int64_t size = 0;
+    Status s = View(name, &data, &size);
+    if (s.ok()) {
+      values->assign(data, data + size);
+    }
+    return s;
+  }
+
+  template <class T>
+  Status Read(const std::string& name, T* value) const {
+    const char* ptr = nullptr;
+    int64_t bytes = 0;
+    Status s = Locate(name, &ptr, &bytes);
+    if (s.ok()) {
+      if (bytes != sizeof(T)) {
+        return CorruptedError(name);
+      }
+      *value = *reinterpret_cast<const T*>(ptr);
+    }
+    return s;
+  }
+
+  Status ReadStrings(const std::string& name,
+                     std::vector<std::string>* values) const;
+
+private:
+  struct Section {
+    int64_t offset;
+    int64_t size;
+  };
+
+  Status Locate(const std::string& name,
+                const char** data, int64_t* size) const;
+  Status CorruptedError(const std::string& name) const;
+
+private:
+  std::string path_;
+  const char* base_;
+  int64_t length_;
+  std::unordered_map<std::string, Section> sections_;
+};
+
+Status SaveSideInfo(SnapshotWriter* writer, const std::string& prefix,
+                    const SideInfo& info);
+Status LoadSideInfo(const SnapshotReader* reader, const std::string& prefix,
+                    SideInfo* info);
+
+}  // namespace io
+}  // namespace graphlearn
+
+#endif  // GRAPHLEARN_CORE_GRAPH_STORAGE_SNAPSHOT_H_
@@ -0,0 +1,92 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "graphlearn/core/graph/storage/sorted_neighbors.h"
+
+#include <algorithm>
+#include "graphlearn/common/base/errors.h"
+#include "graphlearn/common/threading/runner/parallel_for.h"
+#include "graphlearn/platform/env.h"
+
+namespace graphlearn {
+namespace io {
+
+namespace {
+
+// Rows are built in parallel, with so many rows per block.
+const int64_t kRowsPerBlock = 1024;
+
+}  // anonymous namespace
+
+SortedNeighbors::SortedNeighbors()
+    : row_num_(0), offsets_data_(nullptr), ids_data_(nullptr) {
+}
+
+void SortedNeighbors::Build(int64_t row_num, const RowFunc& func) {
+  ThreadPool* tp = Env::Default()->IntraThreadPool();
+
+  offsets_.assign(row_num + 1, 0);
+  ParallelFor(tp, row_num, kRowsPerBlock,
+    [this, &func] (int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        offsets_[i] = func(i).Size();
+      }
+    });
+  int64_t total = ParallelPrefixSum(tp, &offsets_);
+
+  ids_.resize(total);
+  ParallelFor(tp, row_num, kRowsPerBlock,
+    [this, &func] (int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        auto nbrs = func(i);
+        IdType* row = ids_.data() + offsets_[i];
+        for (int32_t k = 0; k < nbrs.Size(); ++k) {
+          row[k] = nbrs[k];
+        }
+        std::sort(row, row + nbrs.Size());
+      }
+    });
+
+  row_num_ = row_num;
+  offsets_data_ = offsets_.data();
+  ids_data_ = ids_.data();
+}
+
+Status SortedNeighbors::Save(SnapshotWriter* writer,
+                             const std::string& prefix) const {
+  RETURN_IF_ERROR(writer->Write(prefix + ".offsets", offsets_data_,
+                                (row_num_ + 1) * sizeof(int64_t)));
+  return writer->Write(prefix + ".ids", ids_data_,
+                       offsets_data_[row_num_] * sizeof(IdType));
+}
+
+Status SortedNeighbors::Load(const SnapshotReader* reader,
+                             const std::string& prefix) {
+  offsets_.clear();
+  ids_.clear();
+  int64_t offset_num = 0;
+  int64_t total = 0;
+  RETURN_IF_ERROR(reader->View(prefix + ".offsets",
+                               &offsets_data_, &offset_num));
+  RETURN_IF_ERROR(reader->View(prefix + ".ids", &ids_data_, &total));
+  if (offset_num < 1 || offsets_data_[offset_num - 1] != total) {
+    return error::DataLoss("Invalid sorted neighbors in snapshot: " + prefix);
+  }
+  row_num_ = offset_num - 1;
+  return Status::OK();
+}
+
+}  // namespace io
+}  // namespace graphlearn
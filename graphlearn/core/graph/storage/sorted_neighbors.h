@@ -0,0 +1,89 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef GRAPHLEARN_CORE_GRAPH_STORAGE_SORTED_NEIGHBORS_H_
+#define GRAPHLEARN_CORE_GRAPH_STORAGE_SORTED_NEIGHBORS_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "graphlearn/core/graph/storage/snapshot.h"
+#include "graphlearn/core/graph/storage/types.h"
+#include "graphlearn/include/status.h"
+
+namespace graphlearn {
+namespace io {
+
+/// Whether the ascending `ids` contain `id`. The search narrows the range
+/// by a conditional move instead of a branch, which the CPU can not
+/// mispredict, so testing a candidate against a row costs O(log d).
+inline bool ContainsSorted(const Array<IdType>& ids, IdType id) {
+  int32_t n = ids.Size();
+  if (n == 0) {
+    return false;
+  }
+  int32_t base = 0;
+  while (n > 1) {
+    int32_t half = n / 2;
+    base = (ids[base + half] <= id) ? base + half : base;
+    n -= half;
+  }
+  return ids[base] == id;
+}
+
+/// An id-sorted copy of the neighbors of each row of an adjacent matrix,
+/// laid out like CSR. The rows of the matrix keep their own order, such as
+/// the descending weights, while a negative sampler tests whether a
+/// candidate is a neighbor by ContainsSorted() on the copy, without
+/// building a hash set per source node.
+class SortedNeighbors {
+public:
+  /// Return the neighbors of a row, in any order.
+  typedef std::function<Array<IdType>(int64_t row)> RowFunc;
+
+  SortedNeighbors();
+  ~SortedNeighbors() = default;
+
+  /// Build `row_num` rows in parallel.
+  void Build(int64_t row_num, const RowFunc& func);
+
+  /// Empty for a row out of range.
+  Array<IdType> GetRow(IndexType row) const {
+    if (row < 0 || row >= row_num_) {
+      return Array<IdType>();
+    }
+    int64_t offset = offsets_data_[row];
+    return Array<IdType>(ids_data_ + offset,
+                         offsets_data_[row + 1] - offset);
+  }
+
+  /// The rows are served from the mapping after Load().
+  Status Save(SnapshotWriter* writer, const std::string& prefix) const;
+  Status Load(const SnapshotReader* reader, const std::string& prefix);
+
+private:
+  std::vector<int64_t> offsets_;
+  IdList               ids_;
+  // Point to the arrays above, or to a snapshot mapping.
+  int64_t        row_num_;
+  const int64_t* offsets_data_;
+  const IdType*  ids_data_;
+};
+
+}  // namespace io
+}  // namespace graphlearn
+
+#endif  // GRAPHLEARN_CORE_GRAPH_STORAGE_SORTED_NEIGHBORS_H_
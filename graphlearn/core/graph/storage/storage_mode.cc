@@ -22,6 +22,15 @@ namespace io {
 namespace {
   int32_t kCompressedMode = 1;
   int32_t kDataDistributionEnabled = 2;
+  int32_t kPackedTopology = 4;
+  int32_t kCsrOrderedEdge = 8;
+  int32_t kEdgeIdRemap = 16;
+  int32_t kStringDict = 32;
+  int32_t kSharedStringDict = 64;
+  int32_t kInEdgeIndex = 128;
+  int32_t kSamplingTable = 256;
+  int32_t kSortedNeighbor = 512;
+  int32_t kGraphCluster = 1024;
 }  // anonymous namespace
 
 bool IsCompressedStorageEnabled() {
@@ -32,5 +41,46 @@ bool IsDataDistributionEnabled() {
   return GLOBAL_FLAG(StorageMode) & kDataDistributionEnabled;
 }
 
+bool IsPackedTopologyEnabled() {
+  return IsCompressedStorageEnabled() &&
+         (GLOBAL_FLAG(StorageMode) & kPackedTopology);
+}
+
+bool IsCsrOrderedEdgeEnabled() {
+  return IsCompressedStorageEnabled() &&
+         (GLOBAL_FLAG(StorageMode) & kCsrOrderedEdge);
+}
+
+bool IsEdgeIdRemapEnabled() {
+  return IsCsrOrderedEdgeEnabled() &&
+         (GLOBAL_FLAG(StorageMode) & kEdgeIdRemap);
+}
+
+bool IsStringDictEnabled() {
+  return IsCompressedStorageEnabled() &&
+         (GLOBAL_FLAG(StorageMode) & kStringDict);
+}
+
+bool IsSharedStringDictEnabled() {
+  return IsStringDictEnabled() &&
+         (GLOBAL_FLAG(StorageMode) & kSharedStringDict);
+}
+
+bool IsInEdgeIndexEnabled() {
+  return GLOBAL_FLAG(StorageMode) & kInEdgeIndex;
+}
+
+bool IsSamplingTableEnabled() {
+  return GLOBAL_FLAG(StorageMode) & kSamplingTable;
+}
+
+bool IsSortedNeighborEnabled() {
+  return GLOBAL_FLAG(StorageMode) & kSortedNeighbor;
+}
+
+bool IsGraphClusterEnabled() {
+  return GLOBAL_FLAG(StorageMode) & kGraphCluster;
+}
+
 }  // namespace io
 }  // namespace graphlearn
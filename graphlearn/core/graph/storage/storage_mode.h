@@ -23,11 +23,50 @@ namespace io {
 /// 1 --> column mode
 /// 2 --> row mode & data distribution enabled
 /// 3 --> column mode & data distribution enabled
+/// 4 --> bit-packed topology, only works together with column mode,
+///       such as 5 or 7. Neighbor ids of each source node are sorted and
+///       stored as delta encoded and bit-packed blocks.
+/// 8 --> CSR ordered edges, only works together with column mode. After
+///       built, edges are re-arranged in the order of the adjacent matrix,
+///       and the id of an edge is just its position. No edge ids need to be
+///       held by the adjacent matrix any more.
+/// 16 -> Keep the original edge ids when 8 is enabled, by a remap table
+///       from the original id to the new position.
+/// 32 -> Dictionary encoded string attributes, only works together with
+///       column mode. Each storage interns its strings into a dictionary
+///       and holds an int32 code for each value.
+/// 64 -> Share one string dictionary among all the node and edge types,
+///       only works together with 32.
+/// 128 -> Build a reverse CSC index of the in-edges of each destination
+///       node over the same edges, in both row and column mode, so that
+///       neighbors can be sampled along the in-edges without loading the
+///       edges again in kReversed direction.
+/// 256 -> Precompute the cumulative edge weights and the cumulative
+///       neighbor in-degrees of each source node when building, so that
+///       the weighted samplers draw in O(log d) without building an alias
+///       table per request. The in-degree table needs 2 or 128.
+/// 512 -> Keep an id-sorted copy of the neighbors of each source node, so
+///       that the negative samplers test a candidate by a binary search
+///       instead of a hash set per source node. Unweighted rows of 4 are
+///       sorted already and need no copy.
+/// 1024 -> Cluster the source nodes of each edge type by label propagation
+///       over their neighbors when building, with no more than
+///       MaxClusterSize nodes in a cluster, so that the subgraphs can be
+///       sampled as unions of the clusters.
 //
 /// Default is 2, the same behavior like before.
 
 bool IsCompressedStorageEnabled();
 bool IsDataDistributionEnabled();
+bool IsPackedTopologyEnabled();
+bool IsCsrOrderedEdgeEnabled();
+bool IsEdgeIdRemapEnabled();
+bool IsStringDictEnabled();
+bool IsSharedStringDictEnabled();
+bool IsInEdgeIndexEnabled();
+bool IsSamplingTableEnabled();
+bool IsSortedNeighborEnabled();
+bool IsGraphClusterEnabled();
 
 }  // namespace io
 }  // namespace graphlearn
@@ -0,0 +1,75 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "graphlearn/core/graph/storage/string_dict.h"
+
+#include "graphlearn/common/base/errors.h"
+#include "graphlearn/common/threading/sync/lock.h"
+
+namespace graphlearn {
+namespace io {
+
+const int32_t StringDict::kFirstChunkBits;
+const uint32_t StringDict::kFirstChunkSize;
+const int32_t StringDict::kMaxChunkNum;
+
+int32_t StringDict::Encode(const std::string& value) {
+  ScopedLocker<std::mutex> _(&mtx_);
+  int32_t size = size_.load(std::memory_order_relaxed);
+  auto ret = codes_.emplace(value, size);
+  if (ret.second) {
+    int32_t chunk = 0;
+    int32_t offset = 0;
+    Locate(size, &chunk, &offset);
+    if (offset == 0) {
+      chunks_[chunk].reset(new const std::string*[kFirstChunkSize << chunk]);
+    }
+    chunks_[chunk][offset] = &(ret.first->first);
+    size_.store(size + 1, std::memory_order_release);
+  }
+  return ret.first->second;
+}
+
+Status StringDict::Save(SnapshotWriter* writer,
+                        const std::string& prefix) const {
+  int32_t size = Size();
+  std::vector<std::string> values;
+  values.reserve(size);
+  for (int32_t code = 0; code < size; ++code) {
+    values.push_back(Decode(code));
+  }
+  return writer->WriteStrings(prefix, values.data(), values.size());
+}
+
+Status StringDict::Load(const SnapshotReader* reader,
+                        const std::string& prefix,
+                        std::vector<int32_t>* codes) {
+  std::vector<std::string> values;
+  RETURN_IF_ERROR(reader->ReadStrings(prefix, &values));
+  codes->clear();
+  codes->reserve(values.size());
+  for (const auto& value : values) {
+    codes->push_back(Encode(value));
+  }
+  return Status::OK();
+}
+
+StringDict* StringDict::Shared() {
+  static StringDict dict;
+  return &dict;
+}
+
+}  // namespace io
+}  // namespace graphlearn
@@ -0,0 +1,94 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef GRAPHLEARN_CORE_GRAPH_STORAGE_STRING_DICT_H_
+#define GRAPHLEARN_CORE_GRAPH_STORAGE_STRING_DICT_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT [build/c++11]
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "graphlearn/core/graph/storage/snapshot.h"
+#include "graphlearn/include/status.h"
+
+namespace graphlearn {
+namespace io {
+
+/// An interned pool of distinct strings. Each string is encoded as an int32
+/// code in the order of first seen, so that a string column with only a few
+/// distinct values holds 4 bytes per value instead of a std::string.
+///
+/// Encode() is thread-safe. Decode() is lock free and may run together with
+/// encoding, such as a type still loading or updating into the shared
+/// dictionary: the strings are kept in chunks which never move, and a code
+/// is published only after its string.
+class StringDict {
+public:
+  StringDict() : size_(0) {}
+
+  int32_t Encode(const std::string& value);
+
+  const std::string& Decode(int32_t code) const {
+    // Pairs with the release in Encode() for the string of the code.
+    size_.load(std::memory_order_acquire);
+    int32_t chunk = 0;
+    int32_t offset = 0;
+    Locate(code, &chunk, &offset);
+    return *chunks_[chunk][offset];
+  }
+
+  int32_t Size() const {
+    return size_.load(std::memory_order_acquire);
+  }
+
+  Status Save(SnapshotWriter* writer, const std::string& prefix) const;
+  /// Encode the saved strings into this dictionary, which may be not empty,
+  /// such as the shared one. `codes` maps each saved code to the new one.
+  Status Load(const SnapshotReader* reader, const std::string& prefix,
+              std::vector<int32_t>* codes);
+
+  /// The dictionary shared by all the node and edge types.
+  static StringDict* Shared();
+
+private:
+  StringDict(const StringDict&) = delete;
+  StringDict& operator=(const StringDict&) = delete;
+
+  // The i-th chunk holds kFirstChunkSize << i strings.
+  static void Locate(int32_t code, int32_t* chunk, int32_t* offset) {
+    uint32_t index = static_cast<uint32_t>(code) + kFirstChunkSize;
+    *chunk = 31 - __builtin_clz(index) - kFirstChunkBits;
+    *offset = index - (kFirstChunkSize << *chunk);
+  }
+
+private:
+  static const int32_t kFirstChunkBits = 6;
+  static const uint32_t kFirstChunkSize = 1u << kFirstChunkBits;
+  static const int32_t kMaxChunkNum = 32 - kFirstChunkBits;
+
+  std::mutex mtx_;
+  // The keys are stable in the map, and referred to by the chunks.
+  std::unordered_map<std::string, int32_t> codes_;
+  std::unique_ptr<const std::string*[]> chunks_[kMaxChunkNum];
+  std::atomic<int32_t> size_;
+};
+
+}  // namespace io
+}  // namespace graphlearn
+
+#endif  // GRAPHLEARN_CORE_GRAPH_STORAGE_STRING_DICT_H_
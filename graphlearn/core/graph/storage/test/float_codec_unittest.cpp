@@ -0,0 +1,98 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "graphlearn/core/graph/storage/float_codec.h"
+#include "gtest/gtest.h"
+
+using namespace graphlearn::io;  // NOLINT [build/namespaces]
+
+TEST(FloatCodecTest, Half) {
+  // Exactly representable
+  float values[] = {0.0, -0.0, 1.0, -2.5, 65504.0, 6.103515625e-05,
+                    5.9604644775390625e-08, 1023.5};
+  for (float value : values) {
+    float decoded = HalfToFloat(FloatToHalf(value));
+    EXPECT_EQ(decoded, value);
+    EXPECT_EQ(std::signbit(decoded), std::signbit(value));
+  }
+
+  EXPECT_EQ(FloatToHalf(1.0), 0x3C00);
+  // Ties to even
+  EXPECT_EQ(FloatToHalf(1.0 + 1.0 / 2048), 0x3C00);
+  EXPECT_EQ(FloatToHalf(1.0 + 3.0 / 2048), 0x3C02);
+  EXPECT_NEAR(HalfToFloat(FloatToHalf(0.1)), 0.1, 1e-4);
+
+  float inf = std::numeric_limits<float>::infinity();
+  EXPECT_EQ(HalfToFloat(FloatToHalf(1e6)), inf);
+  EXPECT_EQ(HalfToFloat(FloatToHalf(-inf)), -inf);
+  EXPECT_TRUE(std::isnan(HalfToFloat(FloatToHalf(std::nanf("")))));
+  EXPECT_EQ(HalfToFloat(FloatToHalf(1e-9)), 0.0);
+}
+
+TEST(FloatCodecTest, Bf16) {
+  float values[] = {0.0, 1.0, -2.5, 3.0e38, 1.0e-38};
+  for (float value : values) {
+    EXPECT_NEAR(Bf16ToFloat(FloatToBf16(value)), value,
+                std::fabs(value) / 128);
+  }
+  EXPECT_EQ(FloatToBf16(1.0), 0x3F80);
+  // Ties to even
+  EXPECT_EQ(FloatToBf16(1.0 + 1.0 / 256), 0x3F80);
+  EXPECT_EQ(FloatToBf16(1.0 + 3.0 / 256), 0x3F82);
+  EXPECT_TRUE(std::isnan(Bf16ToFloat(FloatToBf16(std::nanf("")))));
+}
+
+TEST(FloatCodecTest, DecodeBatch) {
+  std::vector<float> values;
+  std::vector<uint16_t> halfs;
+  std::vector<uint16_t> bf16s;
+  for (int32_t i = 0; i < 37; ++i) {
+    values.push_back(i * 0.25 - 4);
+    halfs.push_back(FloatToHalf(values.back()));
+    bf16s.push_back(FloatToBf16(values.back()));
+  }
+
+  std::vector<float> out(values.size());
+  DecodeHalfs(halfs.data(), halfs.size(), out.data());
+  EXPECT_EQ(out, values);
+  DecodeBf16s(bf16s.data(), bf16s.size(), out.data());
+  EXPECT_EQ(out, values);
+}
+
+TEST(FloatCodecTest, Int8) {
+  float values[] = {0.5, -1.27, 0.01, 1.0};
+  int8_t quants[4];
+  float scale = QuantizeInt8(values, 4, quants);
+  EXPECT_FLOAT_EQ(scale, 0.01);
+  EXPECT_EQ(quants[0], 50);
+  EXPECT_EQ(quants[1], -127);
+  EXPECT_EQ(quants[2], 1);
+  EXPECT_EQ(quants[3], 100);
+
+  float out[4];
+  DequantizeInt8(quants, 4, scale, out);
+  for (int32_t i = 0; i < 4; ++i) {
+    EXPECT_NEAR(out[i], values[i], scale / 2);
+  }
+
+  float zeros[] = {0.0, 0.0};
+  EXPECT_EQ(QuantizeInt8(zeros, 2, quants), 0.0);
+  EXPECT_EQ(quants[0], 0);
+  DequantizeInt8(quants, 2, 0.0, out);
+  EXPECT_EQ(out[0], 0.0);
+}
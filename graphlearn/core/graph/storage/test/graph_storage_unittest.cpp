@@ -13,8 +13,13 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <vector>
 #include "graphlearn/common/base/log.h"
 #include "graphlearn/core/graph/storage/graph_storage.h"
+#include "graphlearn/core/graph/storage/sampling_table.h"
+#include "graphlearn/core/graph/storage/sorted_neighbors.h"
+#include "graphlearn/core/graph/storage/storage_mode.h"
 #include "graphlearn/include/config.h"
 #include "gtest/gtest.h"
 
@@ -51,11 +56,14 @@ protected:
       storage->Add(&value);
     }
     storage->Unlock();
+    int64_t version = storage->GetVersion();
     storage->Build();
+    EXPECT_GT(storage->GetVersion(), version);
 
     CheckInfo(storage->GetSideInfo());
     CheckEdges(storage, 0);
     CheckNeighbors(storage, 0);
+    CheckGather(storage);
   }
 
   void TestOneNeighbor() {
@@ -70,6 +78,14 @@ protected:
     delete storage;
   }
 
+  void TestOneNeighbor4PackedStorage() {
+    GLOBAL_FLAG(StorageMode) = 7;
+    GraphStorage* storage = NewCompressedMemoryGraphStorage();
+    InternalTestOneNeighbor(storage);
+    delete storage;
+    GLOBAL_FLAG(StorageMode) = 2;
+  }
+
   void InternalTestTwoNeighbors(GraphStorage* storage) {
     storage->Lock();
     storage->SetSideInfo(&info_);
@@ -105,6 +121,51 @@ protected:
     delete storage;
   }
 
+  void TestTwoNeighbors4PackedStorage() {
+    GLOBAL_FLAG(StorageMode) = 7;
+    GraphStorage* storage = NewCompressedMemoryGraphStorage();
+    InternalTestTwoNeighbors(storage);
+    delete storage;
+    GLOBAL_FLAG(StorageMode) = 2;
+  }
+
+  void InternalTestCsrOrderedEdges(int32_t storage_mode) {
+    GLOBAL_FLAG(StorageMode) = storage_mode;
+    GraphStorage* storage = NewCompressedMemoryGraphStorage();
+    storage->SetSideInfo(&info_);
+
+    EdgeValue value;
+    for (int32_t i = 0; i < 100; ++i) {
+      value.attrs->Clear();
+      GenEdgeValue(&value, i, 0);
+      storage->Add(&value);
+    }
+    for (int32_t i = 0; i < 100; ++i) {
+      value.attrs->Clear();
+      GenEdgeValue(&value, i, 100);
+      storage->Add(&value);
+    }
+    storage->Build();
+
+    if (IsEdgeIdRemapEnabled()) {
+      // The original edge ids are still valid
+      CheckEdges(storage, 100);
+      CheckNeighbors(storage, 100);
+    } else {
+      CheckCsrEdges(storage);
+    }
+
+    delete storage;
+    GLOBAL_FLAG(StorageMode) = 2;
+  }
+
+  void TestCsrOrderedEdges() {
+    InternalTestCsrOrderedEdges(11);
+    InternalTestCsrOrderedEdges(15);
+    InternalTestCsrOrderedEdges(27);
+    InternalTestCsrOrderedEdges(31);
+  }
+
   void GenEdgeValue(EdgeValue* value, int32_t index, int32_t dst_offset) {
     int32_t edge_index = index + dst_offset;
 
@@ -183,6 +244,48 @@ protected:
     }
   }
 
+  void CheckGather(GraphStorage* storage) {
+    // Reversed, with some edges not existed
+    IdList edge_ids;
+    for (IdType edge_id = storage->GetEdgeCount() + 2; edge_id >= -1;
+         --edge_id) {
+      edge_ids.push_back(edge_id);
+    }
+    int32_t size = edge_ids.size();
+
+    std::vector<float> weights(size);
+    std::vector<int32_t> labels(size);
+    std::vector<int64_t> ints(size * info_.i_num);
+    std::vector<float> floats(size * info_.f_num);
+    std::vector<const std::string*> strings(size * info_.s_num);
+    storage->GatherEdgeWeights(edge_ids.data(), size, weights.data());
+    storage->GatherEdgeLabels(edge_ids.data(), size, labels.data());
+    storage->GatherEdgeInts(edge_ids.data(), size, ints.data());
+    storage->GatherEdgeFloats(edge_ids.data(), size, floats.data());
+    storage->GatherEdgeStrings(edge_ids.data(), size, strings.data());
+
+    for (int32_t i = 0; i < size; ++i) {
+      IdType edge_id = edge_ids[i];
+      EXPECT_FLOAT_EQ(weights[i], storage->GetEdgeWeight(edge_id));
+      EXPECT_EQ(labels[i], storage->GetEdgeLabel(edge_id));
+      if (!info_.IsAttributed()) {
+        continue;
+      }
+      Attribute attr = storage->GetEdgeAttribute(edge_id);
+      for (int32_t j = 0; j < info_.i_num; ++j) {
+        EXPECT_EQ(ints[i * info_.i_num + j], attr->GetInts(nullptr)[j]);
+      }
+      for (int32_t j = 0; j < info_.f_num; ++j) {
+        EXPECT_FLOAT_EQ(floats[i * info_.f_num + j],
+                        attr->GetFloats(nullptr)[j]);
+      }
+      for (int32_t j = 0; j < info_.s_num; ++j) {
+        EXPECT_EQ(*strings[i * info_.s_num + j],
+                  attr->GetStrings(nullptr)[j]);
+      }
+    }
+  }
+
   void CheckNeighbors(GraphStorage* storage, IdType dst_offset) {
     IdType src_id_count = 100;
     IdType dst_id_count = 100 + dst_offset;
@@ -234,6 +337,46 @@ protected:
     }
   }
 
+  void CheckCsrEdges(GraphStorage* storage) {
+    EXPECT_EQ(storage->GetEdgeCount(), 200);
+
+    IdType next_edge_id = 0;
+    for (IdType src_id = 0; src_id < 100; ++src_id) {
+      auto nbrs = storage->GetNeighbors(src_id);
+      auto edges = storage->GetOutEdges(src_id);
+      EXPECT_EQ(nbrs.Size(), 2);
+      EXPECT_EQ(edges.Size(), 2);
+
+      // Edges of a node are consecutive, and each edge value is generated
+      // from its destination id.
+      for (int32_t j = 0; j < nbrs.Size(); ++j) {
+        IdType edge_id = edges[j];
+        EXPECT_EQ(edge_id, next_edge_id++);
+        EXPECT_EQ(storage->GetSrcId(edge_id), src_id);
+        EXPECT_EQ(storage->GetDstId(edge_id), nbrs[j]);
+        if (info_.IsWeighted()) {
+          EXPECT_FLOAT_EQ(storage->GetEdgeWeight(edge_id), float(nbrs[j]));
+        }
+        if (info_.IsLabeled()) {
+          EXPECT_EQ(storage->GetEdgeLabel(edge_id), nbrs[j]);
+        }
+        if (info_.IsAttributed()) {
+          Attribute attr = storage->GetEdgeAttribute(edge_id);
+          for (int32_t k = 0; k < info_.i_num; ++k) {
+            EXPECT_EQ(attr->GetInts(nullptr)[k], nbrs[j] + k);
+          }
+          for (int32_t k = 0; k < info_.f_num; ++k) {
+            EXPECT_EQ(attr->GetFloats(nullptr)[k], float(nbrs[j] + k));
+          }
+          for (int32_t k = 0; k < info_.s_num; ++k) {
+            EXPECT_EQ(attr->GetStrings(nullptr)[k],
+                      std::to_string(nbrs[j] + k));
+          }
+        }
+      }
+    }
+  }
+
 protected:
   SideInfo info_;
 };
@@ -242,94 +385,555 @@ TEST_F(GraphStorageTest, AddGetDefault) {
   info_.format = kDefault;
   TestOneNeighbor();
   TestOneNeighbor4CompressedStorage();
+  TestOneNeighbor4PackedStorage();
 }
 
 TEST_F(GraphStorageTest, AddGetWeighted) {
   info_.format = kWeighted;
   TestOneNeighbor();
   TestOneNeighbor4CompressedStorage();
+  TestOneNeighbor4PackedStorage();
 }
 
 TEST_F(GraphStorageTest, AddGetLabeled) {
   info_.format = kLabeled;
   TestOneNeighbor();
   TestOneNeighbor4CompressedStorage();
+  TestOneNeighbor4PackedStorage();
+}
+
+TEST_F(GraphStorageTest, AddGetAttributeValues) {
+  // The default attribute values are cached by type
+  info_.type = "edge_type_with_attributes";
+  info_.format = kWeighted | kLabeled | kAttributed;
+  info_.i_num = 2;
+  info_.f_num = 3;
+  info_.s_num = 1;
+  TestOneNeighbor();
+  TestOneNeighbor4CompressedStorage();
+  TestOneNeighbor4PackedStorage();
 }
 
 TEST_F(GraphStorageTest, AddGetAttributed) {
   info_.format = kAttributed;
   TestOneNeighbor();
   TestOneNeighbor4CompressedStorage();
+  TestOneNeighbor4PackedStorage();
 }
 
 TEST_F(GraphStorageTest, AddGetWeightedLabeled) {
   info_.format = kWeighted | kLabeled;
   TestOneNeighbor();
   TestOneNeighbor4CompressedStorage();
+  TestOneNeighbor4PackedStorage();
 }
 
 TEST_F(GraphStorageTest, AddGetWeightedAttributed) {
   info_.format = kWeighted | kAttributed;
   TestOneNeighbor();
   TestOneNeighbor4CompressedStorage();
+  TestOneNeighbor4PackedStorage();
 }
 
 TEST_F(GraphStorageTest, AddGetLabeledAttributed) {
   info_.format = kLabeled | kAttributed;
   TestOneNeighbor();
   TestOneNeighbor4CompressedStorage();
+  TestOneNeighbor4PackedStorage();
 }
 
 TEST_F(GraphStorageTest, AddGetWeightedLabeledAttributed) {
   info_.format = kWeighted | kLabeled | kAttributed;
   TestOneNeighbor();
   TestOneNeighbor4CompressedStorage();
+  TestOneNeighbor4PackedStorage();
 }
 
 TEST_F(GraphStorageTest, AddGetDefaultMultiNeighbors) {
   info_.format = kDefault;
   TestTwoNeighbors();
   TestTwoNeighbors4CompressedStorage();
+  TestTwoNeighbors4PackedStorage();
 }
 
 TEST_F(GraphStorageTest, AddGetWeightedMultiNeighbors) {
   info_.format = kWeighted;
   TestTwoNeighbors();
   TestTwoNeighbors4CompressedStorage();
+  TestTwoNeighbors4PackedStorage();
 }
 
 TEST_F(GraphStorageTest, AddGetLabeledMultiNeighbors) {
   info_.format = kLabeled;
   TestTwoNeighbors();
   TestTwoNeighbors4CompressedStorage();
+  TestTwoNeighbors4PackedStorage();
 }
 
 TEST_F(GraphStorageTest, AddGetAttributedMultiNeighbors) {
   info_.format = kAttributed;
   TestTwoNeighbors();
   TestTwoNeighbors4CompressedStorage();
+  TestTwoNeighbors4PackedStorage();
 }
 
 TEST_F(GraphStorageTest, AddGetWeightedLabeledMultiNeighbors) {
   info_.format = kWeighted | kLabeled;
   TestTwoNeighbors();
   TestTwoNeighbors4CompressedStorage();
+  TestTwoNeighbors4PackedStorage();
 }
 
 TEST_F(GraphStorageTest, AddGetWeightedAttributedMultiNeighbors) {
   info_.format = kWeighted | kAttributed;
   TestTwoNeighbors();
   TestTwoNeighbors4CompressedStorage();
+  TestTwoNeighbors4PackedStorage();
 }
 
 TEST_F(GraphStorageTest, AddGetLabeledAttributedMultiNeighbors) {
   info_.format = kLabeled | kAttributed;
   TestTwoNeighbors();
   TestTwoNeighbors4CompressedStorage();
+  TestTwoNeighbors4PackedStorage();
 }
 
 TEST_F(GraphStorageTest, AddGetWeightedLabeledAttributedMultiNeighbors) {
   info_.format = kWeighted | kLabeled | kAttributed;
   TestTwoNeighbors();
   TestTwoNeighbors4CompressedStorage();
+  TestTwoNeighbors4PackedStorage();
+}
+
+TEST_F(GraphStorageTest, CsrOrderedEdgesDefault) {
+  info_.format = kDefault;
+  TestCsrOrderedEdges();
+}
+
+TEST_F(GraphStorageTest, CsrOrderedEdgesWeightedLabeledAttributed) {
+  info_.format = kWeighted | kLabeled | kAttributed;
+  info_.i_num = 1;
+  info_.f_num = 1;
+  info_.s_num = 1;
+  TestCsrOrderedEdges();
+}
+
+TEST_F(GraphStorageTest, PackedManyNeighbors) {
+  info_.format = kDefault;
+  GLOBAL_FLAG(StorageMode) = 7;
+  GraphStorage* storage = NewCompressedMemoryGraphStorage();
+  storage->SetSideInfo(&info_);
+
+  // Insert 1000 neighbors with scattered ids in a random order,
+  // which cross several packed blocks.
+  int32_t nbr_count = 1000;
+  EdgeValue value;
+  for (int32_t i = 0; i < nbr_count; ++i) {
+    value.src_id = 1;
+    value.dst_id = (int64_t(i) * 7919 % nbr_count) * 1000003 - 5;
+    storage->Add(&value);
+  }
+  storage->Build();
+
+  auto nbrs = storage->GetNeighbors(1);
+  auto edges = storage->GetOutEdges(1);
+  EXPECT_EQ(nbrs.Size(), nbr_count);
+  EXPECT_EQ(edges.Size(), nbr_count);
+  for (int32_t j = 0; j < nbr_count; ++j) {
+    EXPECT_EQ(nbrs[j], int64_t(j) * 1000003 - 5);
+    EXPECT_EQ(storage->GetDstId(edges[j]), nbrs[j]);
+  }
+  EXPECT_FALSE(storage->GetNeighbors(2));
+
+  delete storage;
+  GLOBAL_FLAG(StorageMode) = 2;
+}
+
+TEST_F(GraphStorageTest, PackedRowsHeldTogether) {
+  info_.format = kDefault;
+  GLOBAL_FLAG(StorageMode) = 7;
+  GraphStorage* storage = NewCompressedMemoryGraphStorage();
+  storage->SetSideInfo(&info_);
+
+  // More rows alive at once than the decoded rows cached by a thread.
+  int32_t row_num = 32;
+  EdgeValue value;
+  for (int32_t i = 0; i < row_num; ++i) {
+    for (int32_t j = 0; j <= i; ++j) {
+      value.src_id = i;
+      value.dst_id = i * 100 + j;
+      storage->Add(&value);
+    }
+  }
+  storage->Build();
+
+  std::vector<Array<IdType>> rows;
+  for (int32_t k = 0; k < 3; ++k) {
+    for (int32_t i = 0; i < row_num; ++i) {
+      rows.push_back(storage->GetNeighbors(i));
+    }
+  }
+  for (int32_t k = 0; k < 3; ++k) {
+    for (int32_t i = 0; i < row_num; ++i) {
+      auto& nbrs = rows[k * row_num + i];
+      ASSERT_EQ(nbrs.Size(), i + 1);
+      for (int32_t j = 0; j <= i; ++j) {
+        EXPECT_EQ(nbrs[j], i * 100 + j);
+      }
+    }
+  }
+
+  delete storage;
+  GLOBAL_FLAG(StorageMode) = 2;
+}
+
+TEST_F(GraphStorageTest, ParallelBuildManyRows) {
+  info_.format = kWeighted;
+  // Enough rows to be built by several tasks.
+  int32_t row_num = 10000;
+  int32_t modes[] = {3, 7, 15, 31};
+  for (int32_t k = 0; k < 5; ++k) {
+    GraphStorage* storage = nullptr;
+    if (k == 0) {
+      storage = NewMemoryGraphStorage();
+    } else {
+      GLOBAL_FLAG(StorageMode) = modes[k - 1];
+      storage = NewCompressedMemoryGraphStorage();
+    }
+    storage->SetSideInfo(&info_);
+
+    EdgeValue value;
+    for (int32_t j = 0; j < 4; ++j) {
+      for (int32_t i = 0; i < row_num; ++i) {
+        value.src_id = i;
+        value.dst_id = i * 10 + j;
+        value.weight = (i + j * 3) % 4;
+        storage->Add(&value);
+      }
+    }
+    storage->Build();
+
+    for (int32_t i = 0; i < row_num; ++i) {
+      auto nbrs = storage->GetNeighbors(i);
+      auto edges = storage->GetOutEdges(i);
+      ASSERT_EQ(nbrs.Size(), 4);
+      ASSERT_EQ(edges.Size(), 4);
+      for (int32_t j = 0; j < 4; ++j) {
+        EXPECT_EQ(storage->GetDstId(edges[j]), nbrs[j]);
+        EXPECT_EQ(storage->GetSrcId(edges[j]), i);
+        if (j > 0) {
+          EXPECT_GE(storage->GetEdgeWeight(edges[j - 1]),
+                    storage->GetEdgeWeight(edges[j]));
+        }
+      }
+    }
+
+    delete storage;
+    GLOBAL_FLAG(StorageMode) = 2;
+  }
+}
+
+TEST_F(GraphStorageTest, InEdgeIndex) {
+  info_.format = kWeighted;
+  // Row and column mode, without data distribution, and with CSR ordered
+  // edges which re-arrange the edge ids.
+  int32_t modes[] = {128, 129, 131, 135, 139, 155};
+  for (int32_t mode : modes) {
+    GLOBAL_FLAG(StorageMode) = mode;
+    GraphStorage* storage = nullptr;
+    if (IsCompressedStorageEnabled()) {
+      storage = NewCompressedMemoryGraphStorage();
+    } else {
+      storage = NewMemoryGraphStorage();
+    }
+    storage->SetSideInfo(&info_);
+
+    std::vector<int32_t> in_degrees(20, 0);
+    EdgeValue value;
+    for (int32_t i = 0; i < 50; ++i) {
+      for (int32_t j = 0; j < 4; ++j) {
+        value.src_id = i;
+        value.dst_id = (i * 3 + j) % 20 + 1000;
+        value.weight = (i + j) % 7;
+        storage->Add(&value);
+        ++in_degrees[value.dst_id - 1000];
+      }
+    }
+    storage->Build();
+
+    EXPECT_EQ(storage->GetInDegree(5000), 0);
+    for (int32_t k = 0; k < 20; ++k) {
+      IdType dst_id = k + 1000;
+      auto nbrs = storage->GetInNeighbors(dst_id);
+      auto edges = storage->GetInEdges(dst_id);
+      ASSERT_EQ(nbrs.Size(), in_degrees[k]);
+      ASSERT_EQ(edges.Size(), in_degrees[k]);
+      EXPECT_EQ(storage->GetInDegree(dst_id), in_degrees[k]);
+      for (int32_t j = 0; j < nbrs.Size(); ++j) {
+        EXPECT_EQ(storage->GetDstId(edges[j]), dst_id);
+        EXPECT_EQ(storage->GetSrcId(edges[j]), nbrs[j]);
+        if (j > 0) {
+          EXPECT_GE(storage->GetEdgeWeight(edges[j - 1]),
+                    storage->GetEdgeWeight(edges[j]));
+        }
+      }
+    }
+    // Only the destination ids have in-edges
+    EXPECT_FALSE(storage->GetInNeighbors(0));
+    EXPECT_FALSE(storage->GetInEdges(0));
+
+    delete storage;
+  }
+
+  // Not enabled
+  GLOBAL_FLAG(StorageMode) = 3;
+  GraphStorage* storage = NewCompressedMemoryGraphStorage();
+  storage->SetSideInfo(&info_);
+  EdgeValue value;
+  value.src_id = 1;
+  value.dst_id = 2;
+  storage->Add(&value);
+  storage->Build();
+  EXPECT_FALSE(storage->GetInNeighbors(2));
+  delete storage;
+  GLOBAL_FLAG(StorageMode) = 2;
+}
+
+TEST_F(GraphStorageTest, SamplingTable) {
+  info_.format = kWeighted;
+  // Row and column mode, packed and CSR ordered, and the in-degrees from
+  // the reverse index instead of the data distribution.
+  int32_t modes[] = {258, 259, 263, 267, 384, 256};
+  for (int32_t mode : modes) {
+    GLOBAL_FLAG(StorageMode) = mode;
+    GraphStorage* storage = nullptr;
+    if (IsCompressedStorageEnabled()) {
+      storage = NewCompressedMemoryGraphStorage();
+    } else {
+      storage = NewMemoryGraphStorage();
+    }
+    storage->SetSideInfo(&info_);
+
+    EdgeValue value;
+    for (int32_t i = 0; i < 50; ++i) {
+      for (int32_t j = 0; j < 4; ++j) {
+        value.src_id = i;
+        value.dst_id = (i * 3 + j) % 20 + 1000;
+        value.weight = (i + j) % 7;
+        storage->Add(&value);
+      }
+    }
+    storage->Build();
+
+    bool has_in_degrees = IsDataDistributionEnabled() ||
+                          IsInEdgeIndexEnabled();
+    for (IdType src_id = 0; src_id < 50; ++src_id) {
+      auto nbrs = storage->GetNeighbors(src_id);
+      auto edges = storage->GetOutEdges(src_id);
+      auto weight_table = storage->GetEdgeWeightTable(src_id);
+      ASSERT_EQ(weight_table.Size(), edges.Size());
+      float sum = 0.0;
+      for (int32_t j = 0; j < edges.Size(); ++j) {
+        sum += storage->GetEdgeWeight(edges[j]);
+        EXPECT_FLOAT_EQ(weight_table[j], sum);
+      }
+
+      auto in_degree_table = storage->GetInDegreeTable(src_id);
+      if (!has_in_degrees) {
+        EXPECT_FALSE(in_degree_table);
+        continue;
+      }
+      ASSERT_EQ(in_degree_table.Size(), nbrs.Size());
+      sum = 0.0;
+      for (int32_t j = 0; j < nbrs.Size(); ++j) {
+        sum += storage->GetInDegree(nbrs[j]);
+        EXPECT_FLOAT_EQ(in_degree_table[j], sum);
+      }
+    }
+    EXPECT_FALSE(storage->GetEdgeWeightTable(1000));
+    EXPECT_FALSE(storage->GetInDegreeTable(1000));
+
+    delete storage;
+  }
+
+  // No tables for the unweighted edges
+  GLOBAL_FLAG(StorageMode) = 258;
+  info_.format = kDefault;
+  GraphStorage* storage = NewMemoryGraphStorage();
+  storage->SetSideInfo(&info_);
+  EdgeValue value;
+  value.src_id = 1;
+  value.dst_id = 2;
+  storage->Add(&value);
+  storage->Build();
+  EXPECT_FALSE(storage->GetEdgeWeightTable(1));
+  EXPECT_EQ(storage->GetInDegreeTable(1).Size(), 1);
+  delete storage;
+  GLOBAL_FLAG(StorageMode) = 2;
+}
+
+TEST_F(GraphStorageTest, SamplingTablePrecision) {
+  // A hub row whose total is far beyond the precision of float, where the
+  // unit weights after the heavy one would vanish from float sums.
+  int32_t light_num = 1000;
+  SamplingTable table;
+  table.Build(1, [light_num] (int64_t row, std::vector<float>* weights) {
+    weights->push_back(1e9);
+    weights->resize(light_num + 1, 1.0);
+  });
+
+  auto cdf = table.GetRow(0);
+  ASSERT_EQ(cdf.Size(), light_num + 1);
+  for (int32_t j = 1; j <= light_num; ++j) {
+    EXPECT_DOUBLE_EQ(cdf[j] - cdf[j - 1], 1.0);
+  }
+}
+
+TEST_F(GraphStorageTest, SortedNeighbors) {
+  // Row and column mode, packed and CSR ordered, both weighted and not.
+  int32_t modes[] = {512, 514, 515, 519, 527};
+  int32_t formats[] = {kWeighted, kDefault};
+  for (int32_t format : formats) {
+    for (int32_t mode : modes) {
+      GLOBAL_FLAG(StorageMode) = mode;
+      info_.format = format;
+      GraphStorage* storage = nullptr;
+      if (IsCompressedStorageEnabled()) {
+        storage = NewCompressedMemoryGraphStorage();
+      } else {
+        storage = NewMemoryGraphStorage();
+      }
+      storage->SetSideInfo(&info_);
+
+      EdgeValue value;
+      for (int32_t i = 0; i < 50; ++i) {
+        for (int32_t j = 0; j < 4; ++j) {
+          value.src_id = i;
+          value.dst_id = (i * 7 + j * 13) % 40 + 1000;
+          value.weight = (i + j) % 7;
+          storage->Add(&value);
+        }
+      }
+      storage->Build();
+
+      for (IdType src_id = 0; src_id < 50; ++src_id) {
+        auto nbrs = storage->GetNeighbors(src_id);
+        auto sorted = storage->GetSortedNeighbors(src_id);
+        ASSERT_EQ(sorted.Size(), nbrs.Size());
+        std::vector<IdType> expected;
+        for (int32_t j = 0; j < nbrs.Size(); ++j) {
+          expected.push_back(nbrs[j]);
+        }
+        std::sort(expected.begin(), expected.end());
+        for (int32_t j = 0; j < sorted.Size(); ++j) {
+          EXPECT_EQ(sorted[j], expected[j]);
+        }
+        for (IdType id = 999; id < 1041; ++id) {
+          bool found = std::binary_search(expected.begin(), expected.end(),
+                                          id);
+          EXPECT_EQ(ContainsSorted(sorted, id), found);
+        }
+      }
+      EXPECT_FALSE(storage->GetSortedNeighbors(1000));
+
+      delete storage;
+    }
+  }
+
+  // Not enabled
+  GLOBAL_FLAG(StorageMode) = 3;
+  GraphStorage* storage = NewCompressedMemoryGraphStorage();
+  storage->SetSideInfo(&info_);
+  EdgeValue value;
+  value.src_id = 1;
+  value.dst_id = 2;
+  storage->Add(&value);
+  storage->Build();
+  EXPECT_FALSE(storage->GetSortedNeighbors(1));
+  EXPECT_FALSE(ContainsSorted(IdArray(), 2));
+  delete storage;
+  GLOBAL_FLAG(StorageMode) = 2;
+}
+
+TEST_F(GraphStorageTest, Clusters) {
+  // 8 groups of 20 nodes, linked densely inside and sparsely across, with
+  // some edges to the nodes out of the sources.
+  GLOBAL_FLAG(MaxClusterSize) = 32;
+  int32_t modes[] = {1024, 1026, 1027, 1031};
+  for (int32_t mode : modes) {
+    GLOBAL_FLAG(StorageMode) = mode;
+    GraphStorage* storage = nullptr;
+    if (IsCompressedStorageEnabled()) {
+      storage = NewCompressedMemoryGraphStorage();
+    } else {
+      storage = NewMemoryGraphStorage();
+    }
+    storage->SetSideInfo(&info_);
+
+    EdgeValue value;
+    int32_t edge_count = 0;
+    for (int32_t i = 0; i < 160; ++i) {
+      int32_t group = i / 20;
+      for (int32_t j = 0; j < 6; ++j) {
+        value.src_id = i;
+        value.dst_id = group * 20 + (i + j * 3 + 1) % 20;
+        storage->Add(&value);
+        ++edge_count;
+      }
+      value.src_id = i;
+      value.dst_id = (i * 37) % 160;
+      storage->Add(&value);
+      value.dst_id = 1000 + i;
+      storage->Add(&value);
+    }
+    storage->Build();
+
+    // Each source in exactly one cluster, and no cluster too large.
+    std::vector<IndexType> cluster_of(160, -1);
+    IndexType cluster_count = storage->GetClusterCount();
+    EXPECT_GT(cluster_count, 0);
+    for (IndexType cluster = 0; cluster < cluster_count; ++cluster) {
+      auto ids = storage->GetCluster(cluster);
+      EXPECT_GT(ids.Size(), 0);
+      EXPECT_LE(ids.Size(), 32);
+      for (int32_t i = 0; i < ids.Size(); ++i) {
+        ASSERT_TRUE(ids[i] >= 0 && ids[i] < 160);
+        EXPECT_EQ(cluster_of[ids[i]], -1);
+        cluster_of[ids[i]] = cluster;
+      }
+    }
+    for (int32_t i = 0; i < 160; ++i) {
+      EXPECT_GE(cluster_of[i], 0);
+    }
+    EXPECT_FALSE(storage->GetCluster(-1));
+    EXPECT_FALSE(storage->GetCluster(cluster_count));
+
+    // Most of the edges inside a group stay inside a cluster.
+    int32_t kept = 0;
+    for (int32_t i = 0; i < 160; ++i) {
+      int32_t group = i / 20;
+      for (int32_t j = 0; j < 6; ++j) {
+        int32_t dst_id = group * 20 + (i + j * 3 + 1) % 20;
+        kept += cluster_of[i] == cluster_of[dst_id];
+      }
+    }
+    EXPECT_GT(kept, edge_count * 3 / 4);
+
+    delete storage;
+  }
+
+  // Not enabled
+  GLOBAL_FLAG(StorageMode) = 3;
+  GraphStorage* storage = NewCompressedMemoryGraphStorage();
+  storage->SetSideInfo(&info_);
+  EdgeValue value;
+  value.src_id = 1;
+  value.dst_id = 2;
+  storage->Add(&value);
+  storage->Build();
+  EXPECT_EQ(storage->GetClusterCount(), 0);
+  EXPECT_FALSE(storage->GetCluster(0));
+  delete storage;
+  GLOBAL_FLAG(StorageMode) = 2;
+  GLOBAL_FLAG(MaxClusterSize) = 256;
 }
@@ -0,0 +1,155 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <vector>
+#include "graphlearn/core/graph/storage/auto_indexing.h"
+#include "graphlearn/core/graph/storage/id_hash_map.h"
+#include "gtest/gtest.h"
+
+using namespace graphlearn;  // NOLINT [build/namespaces]
+using namespace graphlearn::io;  // NOLINT [build/namespaces]
+
+TEST(IdHashMapTest, InsertAndFind) {
+  IdHashMap map;
+  EXPECT_EQ(map.Size(), 0);
+  EXPECT_EQ(map.Find(0), -1);
+
+  EXPECT_TRUE(map.Insert(10, 0));
+  EXPECT_TRUE(map.Insert(-10, 1));
+  EXPECT_TRUE(map.Insert(0, 2));
+  EXPECT_FALSE(map.Insert(10, 3));
+  EXPECT_EQ(map.Size(), 3);
+
+  EXPECT_EQ(map.Find(10), 0);
+  EXPECT_EQ(map.Find(-10), 1);
+  EXPECT_EQ(map.Find(0), 2);
+  EXPECT_EQ(map.Find(11), -1);
+}
+
+TEST(IdHashMapTest, ManyIds) {
+  IdHashMap map;
+  int32_t size = 100000;
+  for (int32_t i = 0; i < size; ++i) {
+    EXPECT_TRUE(map.Insert(i * 7919LL, i));
+  }
+  EXPECT_EQ(map.Size(), size);
+
+  for (int32_t i = 0; i < size; ++i) {
+    EXPECT_EQ(map.Find(i * 7919LL), i);
+  }
+  for (int32_t i = 0; i < 100; ++i) {
+    EXPECT_EQ(map.Find(i * 7919LL + 1), -1);
+  }
+
+  map.Shrink();
+  EXPECT_EQ(map.Size(), size);
+  for (int32_t i = 0; i < size; ++i) {
+    EXPECT_EQ(map.Find(i * 7919LL), i);
+  }
+}
+
+TEST(IdHashMapTest, FindBatch) {
+  IdHashMap map;
+  map.Reserve(1000);
+  for (int32_t i = 0; i < 1000; ++i) {
+    map.Insert(i << 20, i);
+  }
+
+  std::vector<IdType> ids;
+  for (int32_t i = 0; i < 1000; ++i) {
+    ids.push_back((999 - i) << 20);
+    ids.push_back(i * 2 + 1);
+  }
+  std::vector<IndexType> indices(ids.size());
+  map.FindBatch(ids.data(), ids.size(), indices.data());
+  for (int32_t i = 0; i < 1000; ++i) {
+    EXPECT_EQ(indices[i * 2], 999 - i);
+    EXPECT_EQ(indices[i * 2 + 1], -1);
+  }
+}
+
+TEST(AutoIndexTest, AddAndGet) {
+  AutoIndex index;
+  EXPECT_TRUE(index.Add(100));
+  EXPECT_TRUE(index.Add(50));
+  EXPECT_FALSE(index.Add(100));
+  EXPECT_TRUE(index.Add(200));
+  index.Build();
+  EXPECT_FALSE(index.IsDense());
+
+  EXPECT_EQ(index.Size(), 3);
+  EXPECT_EQ(index.Get(100), 0);
+  EXPECT_EQ(index.Get(50), 1);
+  EXPECT_EQ(index.Get(200), 2);
+  EXPECT_EQ(index.Get(1), -1);
+
+  IdType ids[] = {200, 1, 50};
+  IndexType indices[3];
+  index.GetBatch(ids, 3, indices);
+  EXPECT_EQ(indices[0], 2);
+  EXPECT_EQ(indices[1], -1);
+  EXPECT_EQ(indices[2], 1);
+}
+
+TEST(AutoIndexTest, DenseIdentity) {
+  AutoIndex index;
+  for (IdType id = 0; id < 100; ++id) {
+    index.Add(id);
+  }
+  index.Build();
+  EXPECT_TRUE(index.IsDense());
+  EXPECT_EQ(index.Size(), 100);
+  for (IdType id = 0; id < 100; ++id) {
+    EXPECT_EQ(index.Get(id), id);
+  }
+  EXPECT_EQ(index.Get(-1), -1);
+  EXPECT_EQ(index.Get(100), -1);
+  EXPECT_FALSE(index.Add(50));
+
+  // Adding a new id after Build() falls back to hashing.
+  EXPECT_TRUE(index.Add(1000));
+  EXPECT_FALSE(index.IsDense());
+  EXPECT_EQ(index.Get(1000), 100);
+  EXPECT_EQ(index.Get(99), 99);
+}
+
+TEST(AutoIndexTest, DenseShuffled) {
+  AutoIndex index;
+  IdType ids[] = {-3, 1, -1, 0, -2};
+  for (int32_t i = 0; i < 5; ++i) {
+    index.Add(ids[i]);
+  }
+  index.Build();
+  EXPECT_TRUE(index.IsDense());
+  for (int32_t i = 0; i < 5; ++i) {
+    EXPECT_EQ(index.Get(ids[i]), i);
+  }
+  EXPECT_EQ(index.Get(-4), -1);
+  EXPECT_EQ(index.Get(2), -1);
+
+  IdType batch[] = {0, 5, -3};
+  IndexType indices[3];
+  index.GetBatch(batch, 3, indices);
+  EXPECT_EQ(indices[0], 3);
+  EXPECT_EQ(indices[1], -1);
+  EXPECT_EQ(indices[2], 0);
+
+  EXPECT_TRUE(index.Add(7));
+  EXPECT_FALSE(index.IsDense());
+  for (int32_t i = 0; i < 5; ++i) {
+    EXPECT_EQ(index.Get(ids[i]), i);
+  }
+  EXPECT_EQ(index.Get(7), 5);
+}
@@ -13,8 +13,11 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <thread>  // NOLINT [build/c++11]
 #include "graphlearn/common/base/log.h"
 #include "graphlearn/core/graph/storage/node_storage.h"
+#include "graphlearn/core/graph/storage/string_dict.h"
+#include "graphlearn/include/config.h"
 #include "gtest/gtest.h"
 
 using namespace graphlearn;  // NOLINT [build/namespaces]
@@ -52,6 +55,7 @@ protected:
 
     CheckInfo(storage->GetSideInfo());
     CheckNodes(storage);
+    CheckGather(storage);
   }
 
   void Test() {
@@ -72,6 +76,64 @@ protected:
     delete storage;
   }
 
+  void Test4StringDict(int32_t storage_mode) {
+    GLOBAL_FLAG(StorageMode) = storage_mode;
+    NodeStorage* storage = NewCompressedMemoryNodeStorage();
+    InternalTest(storage);
+
+    const StringDict* dict = storage->GetStringDict();
+    ASSERT_TRUE(dict != nullptr);
+    // Node i has strings from i to i + s_num - 1.
+    EXPECT_GE(dict->Size(), 100 + info_.s_num - 1);
+
+    IdList node_ids = {0, 99, 100, -1};
+    std::vector<int32_t> codes(node_ids.size() * info_.s_num);
+    storage->GatherStringCodes(node_ids.data(), node_ids.size(), codes.data());
+    for (int32_t j = 0; j < info_.s_num; ++j) {
+      EXPECT_EQ(dict->Decode(codes[j]), std::to_string(j));
+      EXPECT_EQ(dict->Decode(codes[info_.s_num + j]), std::to_string(99 + j));
+      EXPECT_EQ(codes[2 * info_.s_num + j], -1);
+      EXPECT_EQ(codes[3 * info_.s_num + j], -1);
+    }
+    delete storage;
+    GLOBAL_FLAG(StorageMode) = 2;
+  }
+
+  void Test4FloatFormat(FloatFormat format, float tolerance) {
+    info_.float_format = format;
+    NodeStorage* storage = NewCompressedMemoryNodeStorage();
+    storage->SetSideInfo(&info_);
+    NodeValue value;
+    for (int32_t i = 0; i < 100; ++i) {
+      value.attrs->Clear();
+      value.id = i;
+      value.attrs->Add(int64_t(i));
+      for (int32_t j = 0; j < info_.f_num; ++j) {
+        value.attrs->Add(0.01f * i - 0.3f * j);
+      }
+      storage->Add(&value);
+    }
+    storage->Build();
+
+    IdList node_ids = {0, 50, 99, 100};
+    std::vector<float> floats(node_ids.size() * info_.f_num);
+    storage->GatherFloats(node_ids.data(), node_ids.size(), floats.data());
+    for (int32_t i = 0; i < node_ids.size(); ++i) {
+      Attribute attr = storage->GetAttribute(node_ids[i]);
+      if (node_ids[i] < 100) {
+        EXPECT_EQ(attr->GetInts(nullptr)[0], node_ids[i]);
+      }
+      for (int32_t j = 0; j < info_.f_num; ++j) {
+        float expected = node_ids[i] < 100 ? 0.01f * node_ids[i] - 0.3f * j
+                                           : GLOBAL_FLAG(DefaultFloatAttribute);
+        EXPECT_NEAR(floats[i * info_.f_num + j], expected, tolerance);
+        EXPECT_FLOAT_EQ(attr->GetFloats(nullptr)[j],
+                        floats[i * info_.f_num + j]);
+      }
+    }
+    delete storage;
+  }
+
   void GenNodeValue(NodeValue* value, int32_t node_index) {
     value->id = node_index;
     if (info_.IsWeighted()) {
@@ -163,6 +225,47 @@ protected:
     }
   }
 
+  void CheckGather(NodeStorage* storage) {
+    // Reversed, with some nodes not existed
+    IdList node_ids;
+    for (IdType node_id = storage->Size() + 2; node_id >= -1; --node_id) {
+      node_ids.push_back(node_id);
+    }
+    int32_t size = node_ids.size();
+
+    std::vector<float> weights(size);
+    std::vector<int32_t> labels(size);
+    std::vector<int64_t> ints(size * info_.i_num);
+    std::vector<float> floats(size * info_.f_num);
+    std::vector<const std::string*> strings(size * info_.s_num);
+    storage->GatherWeights(node_ids.data(), size, weights.data());
+    storage->GatherLabels(node_ids.data(), size, labels.data());
+    storage->GatherInts(node_ids.data(), size, ints.data());
+    storage->GatherFloats(node_ids.data(), size, floats.data());
+    storage->GatherStrings(node_ids.data(), size, strings.data());
+
+    for (int32_t i = 0; i < size; ++i) {
+      IdType node_id = node_ids[i];
+      EXPECT_FLOAT_EQ(weights[i], storage->GetWeight(node_id));
+      EXPECT_EQ(labels[i], storage->GetLabel(node_id));
+      if (!info_.IsAttributed()) {
+        continue;
+      }
+      Attribute attr = storage->GetAttribute(node_id);
+      for (int32_t j = 0; j < info_.i_num; ++j) {
+        EXPECT_EQ(ints[i * info_.i_num + j], attr->GetInts(nullptr)[j]);
+      }
+      for (int32_t j = 0; j < info_.f_num; ++j) {
+        EXPECT_FLOAT_EQ(floats[i * info_.f_num + j],
+                        attr->GetFloats(nullptr)[j]);
+      }
+      for (int32_t j = 0; j < info_.s_num; ++j) {
+        EXPECT_EQ(*strings[i * info_.s_num + j],
+                  attr->GetStrings(nullptr)[j]);
+      }
+    }
+  }
+
 protected:
   SideInfo info_;
 };
@@ -208,3 +311,65 @@ TEST_F(NodeStorageTest, AddGetWeightedLabeledAttributed) {
   Test();
   Test4CompressedStorage();
 }
+
+TEST_F(NodeStorageTest, AddGetAttributeValues) {
+  // The default attribute values are cached by type
+  info_.type = "node_type_with_attributes";
+  info_.format = kWeighted | kLabeled | kAttributed;
+  info_.i_num = 2;
+  info_.f_num = 3;
+  info_.s_num = 1;
+  Test();
+  Test4CompressedStorage();
+}
+
+TEST_F(NodeStorageTest, AddGetStringDict) {
+  info_.type = "node_type_with_strings";
+  info_.format = kWeighted | kLabeled | kAttributed;
+  info_.i_num = 1;
+  info_.f_num = 1;
+  info_.s_num = 2;
+  Test4StringDict(33);
+  Test4StringDict(97);
+
+  // No dictionary in memory mode
+  NodeStorage* storage = NewMemoryNodeStorage();
+  EXPECT_TRUE(storage->GetStringDict() == nullptr);
+  delete storage;
+}
+
+TEST_F(NodeStorageTest, StringDictDecodeWhileEncoding) {
+  // Decode the published codes while another thread keeps encoding, which
+  // grows the dictionary across many chunks.
+  StringDict dict;
+  int32_t size = 100000;
+  std::thread writer([&dict, size] () {
+    for (int32_t i = 0; i < size; ++i) {
+      dict.Encode(std::to_string(i));
+    }
+  });
+  int32_t checked = 0;
+  int32_t mismatched = 0;
+  while (checked < size) {
+    int32_t published = dict.Size();
+    for (; checked < published; ++checked) {
+      mismatched += dict.Decode(checked) != std::to_string(checked);
+    }
+  }
+  writer.join();
+  EXPECT_EQ(mismatched, 0);
+  EXPECT_EQ(dict.Encode("0"), 0);
+  EXPECT_EQ(dict.Size(), size);
+}
+
+TEST_F(NodeStorageTest, AddGetFloatFormats) {
+  info_.type = "node_type_with_floats";
+  info_.format = kAttributed;
+  info_.i_num = 1;
+  info_.f_num = 4;
+  Test4FloatFormat(kFp32, 0.0);
+  Test4FloatFormat(kFp16, 1e-3);
+  Test4FloatFormat(kBf16, 1e-2);
+  // Half a step, the max absolute value of each row is less than 1.
+  Test4FloatFormat(kInt8, 0.51 / 127);
+}
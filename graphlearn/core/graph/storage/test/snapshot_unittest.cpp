@@ -0,0 +1,419 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "graphlearn/common/base/errors.h"
+#include "graphlearn/common/base/log.h"
+#include "graphlearn/core/graph/storage/graph_storage.h"
+#include "graphlearn/core/graph/storage/node_storage.h"
+#include "graphlearn/core/graph/storage/snapshot.h"
+#include "graphlearn/core/graph/storage/string_dict.h"
+#include "graphlearn/include/config.h"
+#include "gtest/gtest.h"
+
+using namespace graphlearn;  // NOLINT [build/namespaces]
+using namespace graphlearn::io;  // NOLINT [build/namespaces]
+
+class SnapshotTest : public ::testing::Test {
+public:
+  SnapshotTest() {
+    InitGoogleLogging();
+  }
+  ~SnapshotTest() {
+    UninitGoogleLogging();
+  }
+
+protected:
+  void SetUp() override {
+    path_ = "./snapshot_unittest_" + std::to_string(::getpid());
+    info_.type = "edge_type";
+    info_.src_type = "src_type";
+    info_.dst_type = "dst_type";
+    info_.format = kWeighted | kLabeled | kAttributed;
+    info_.i_num = 2;
+    info_.f_num = 3;
+    info_.s_num = 1;
+  }
+
+  void TearDown() override {
+    ::unlink(path_.c_str());
+    GLOBAL_FLAG(StorageMode) = 2;
+  }
+
+  void GenAttributes(AttributeValue* attrs, int32_t index) {
+    attrs->Clear();
+    for (int32_t i = 0; i < info_.i_num; ++i) {
+      attrs->Add(int64_t(index + i));
+    }
+    for (int32_t i = 0; i < info_.f_num; ++i) {
+      attrs->Add(float(index + i));
+    }
+    for (int32_t i = 0; i < info_.s_num; ++i) {
+      attrs->Add(std::to_string(index + i));
+    }
+  }
+
+  void CheckAttribute(const Attribute& lhs, const Attribute& rhs) {
+    for (int32_t i = 0; i < info_.i_num; ++i) {
+      EXPECT_EQ(lhs->GetInts(nullptr)[i], rhs->GetInts(nullptr)[i]);
+    }
+    for (int32_t i = 0; i < info_.f_num; ++i) {
+      EXPECT_FLOAT_EQ(lhs->GetFloats(nullptr)[i], rhs->GetFloats(nullptr)[i]);
+    }
+    for (int32_t i = 0; i < info_.s_num; ++i) {
+      EXPECT_EQ(lhs->GetStrings(nullptr)[i], rhs->GetStrings(nullptr)[i]);
+    }
+  }
+
+  GraphStorage* BuildGraph() {
+    GraphStorage* storage = NewCompressedMemoryGraphStorage();
+    storage->SetSideInfo(&info_);
+    EdgeValue value;
+    // Out of order, with several neighbors for each source.
+    for (int32_t i = 0; i < 300; ++i) {
+      value.src_id = (i * 7) % 100;
+      value.dst_id = i;
+      value.weight = float(i);
+      value.label = i;
+      GenAttributes(value.attrs, i);
+      storage->Add(&value);
+    }
+    storage->Build();
+    return storage;
+  }
+
+  void TestGraph(int32_t storage_mode) {
+    GLOBAL_FLAG(StorageMode) = storage_mode;
+    GraphStorage* expected = BuildGraph();
+
+    SnapshotWriter writer;
+    ASSERT_TRUE(writer.Open(path_).ok());
+    ASSERT_TRUE(expected->Save(&writer, "edge/edge_type").ok());
+    ASSERT_TRUE(writer.Close().ok());
+
+    SnapshotReader reader;
+    ASSERT_TRUE(reader.Open(path_).ok());
+    GraphStorage* actual = NewCompressedMemoryGraphStorage();
+    ASSERT_TRUE(actual->Load(&reader, "edge/edge_type").ok());
+
+    const SideInfo* info = actual->GetSideInfo();
+    EXPECT_EQ(info->type, info_.type);
+    EXPECT_EQ(info->src_type, info_.src_type);
+    EXPECT_EQ(info->dst_type, info_.dst_type);
+    EXPECT_EQ(info->format, info_.format);
+    EXPECT_EQ(info->float_format, info_.float_format);
+
+    ASSERT_EQ(actual->GetEdgeCount(), expected->GetEdgeCount());
+    for (IdType edge_id = 0; edge_id < actual->GetEdgeCount(); ++edge_id) {
+      EXPECT_EQ(actual->GetSrcId(edge_id), expected->GetSrcId(edge_id));
+      EXPECT_EQ(actual->GetDstId(edge_id), expected->GetDstId(edge_id));
+      EXPECT_FLOAT_EQ(actual->GetEdgeWeight(edge_id),
+                      expected->GetEdgeWeight(edge_id));
+      EXPECT_EQ(actual->GetEdgeLabel(edge_id),
+                expected->GetEdgeLabel(edge_id));
+      CheckAttribute(actual->GetEdgeAttribute(edge_id),
+                     expected->GetEdgeAttribute(edge_id));
+    }
+
+    for (IdType src_id = 0; src_id < 101; ++src_id) {
+      auto nbrs = actual->GetNeighbors(src_id);
+      auto edges = actual->GetOutEdges(src_id);
+      auto expected_nbrs = expected->GetNeighbors(src_id);
+      auto expected_edges = expected->GetOutEdges(src_id);
+      ASSERT_EQ(nbrs.Size(), expected_nbrs.Size());
+      ASSERT_EQ(edges.Size(), expected_edges.Size());
+      for (int32_t i = 0; i < nbrs.Size(); ++i) {
+        EXPECT_EQ(nbrs[i], expected_nbrs[i]);
+        EXPECT_EQ(edges[i], expected_edges[i]);
+      }
+      EXPECT_EQ(actual->GetOutDegree(src_id), expected->GetOutDegree(src_id));
+
+      auto weight_table = actual->GetEdgeWeightTable(src_id);
+      auto in_degree_table = actual->GetInDegreeTable(src_id);
+      auto expected_weight_table = expected->GetEdgeWeightTable(src_id);
+      auto expected_in_degree_table = expected->GetInDegreeTable(src_id);
+      ASSERT_EQ(weight_table.Size(), expected_weight_table.Size());
+      ASSERT_EQ(in_degree_table.Size(), expected_in_degree_table.Size());
+      for (int32_t i = 0; i < weight_table.Size(); ++i) {
+        EXPECT_EQ(weight_table[i], expected_weight_table[i]);
+      }
+      for (int32_t i = 0; i < in_degree_table.Size(); ++i) {
+        EXPECT_EQ(in_degree_table[i], expected_in_degree_table[i]);
+      }
+
+      auto sorted_nbrs = actual->GetSortedNeighbors(src_id);
+      auto expected_sorted_nbrs = expected->GetSortedNeighbors(src_id);
+      ASSERT_EQ(sorted_nbrs.Size(), expected_sorted_nbrs.Size());
+      for (int32_t i = 0; i < sorted_nbrs.Size(); ++i) {
+        EXPECT_EQ(sorted_nbrs[i], expected_sorted_nbrs[i]);
+      }
+    }
+
+    for (IdType dst_id = 0; dst_id < 301; ++dst_id) {
+      auto nbrs = actual->GetInNeighbors(dst_id);
+      auto edges = actual->GetInEdges(dst_id);
+      auto expected_nbrs = expected->GetInNeighbors(dst_id);
+      auto expected_edges = expected->GetInEdges(dst_id);
+      ASSERT_EQ(nbrs.Size(), expected_nbrs.Size());
+      ASSERT_EQ(edges.Size(), expected_edges.Size());
+      for (int32_t i = 0; i < nbrs.Size(); ++i) {
+        EXPECT_EQ(nbrs[i], expected_nbrs[i]);
+        EXPECT_EQ(edges[i], expected_edges[i]);
+      }
+    }
+    ASSERT_EQ(actual->GetClusterCount(), expected->GetClusterCount());
+    for (IndexType cluster = 0; cluster < actual->GetClusterCount();
+         ++cluster) {
+      auto ids = actual->GetCluster(cluster);
+      auto expected_ids = expected->GetCluster(cluster);
+      ASSERT_EQ(ids.Size(), expected_ids.Size());
+      for (int32_t i = 0; i < ids.Size(); ++i) {
+        EXPECT_EQ(ids[i], expected_ids[i]);
+      }
+    }
+    EXPECT_EQ(*actual->GetAllSrcIds(), *expected->GetAllSrcIds());
+    EXPECT_EQ(*actual->GetAllInDegrees(), *expected->GetAllInDegrees());
+
+    delete expected;
+    delete actual;
+  }
+
+  void TestNodes(int32_t id_stride) {
+    GLOBAL_FLAG(StorageMode) = 3;
+    NodeStorage* expected = NewCompressedMemoryNodeStorage();
+    info_.type = "node_type";
+    expected->SetSideInfo(&info_);
+    NodeValue value;
+    for (int32_t i = 0; i < 100; ++i) {
+      value.id = i * id_stride;
+      value.weight = float(i);
+      value.label = i;
+      GenAttributes(value.attrs, i);
+      expected->Add(&value);
+    }
+    expected->Build();
+
+    SnapshotWriter writer;
+    ASSERT_TRUE(writer.Open(path_).ok());
+    ASSERT_TRUE(expected->Save(&writer, "node/node_type").ok());
+    ASSERT_TRUE(writer.Close().ok());
+
+    SnapshotReader reader;
+    ASSERT_TRUE(reader.Open(path_).ok());
+    NodeStorage* actual = NewCompressedMemoryNodeStorage();
+    ASSERT_TRUE(actual->Load(&reader, "node/node_type").ok());
+
+    EXPECT_EQ(actual->GetSideInfo()->type, "node_type");
+    ASSERT_EQ(actual->Size(), 100);
+    EXPECT_EQ(*actual->GetIds(), *expected->GetIds());
+    for (int32_t i = 0; i < 100; ++i) {
+      IdType id = i * id_stride;
+      EXPECT_FLOAT_EQ(actual->GetWeight(id), float(i));
+      EXPECT_EQ(actual->GetLabel(id), i);
+      CheckAttribute(actual->GetAttribute(id), expected->GetAttribute(id));
+    }
+    // Not existed
+    EXPECT_EQ(actual->GetLabel(100 * id_stride + 1), -1);
+
+    delete expected;
+    delete actual;
+  }
+
+protected:
+  std::string path_;
+  SideInfo info_;
+};
+
+TEST_F(SnapshotTest, Sections) {
+  std::vector<int64_t> ints = {1, 2, 3, 4, 5};
+  std::string strs[] = {"a", "", "hello"};
+  SnapshotWriter writer;
+  ASSERT_TRUE(writer.Open(path_).ok());
+  EXPECT_TRUE(writer.Write("ints", ints).ok());
+  EXPECT_TRUE(writer.Write("scalar", int32_t(7)).ok());
+  EXPECT_TRUE(writer.WriteStrings("strs", strs, 3).ok());
+  EXPECT_TRUE(writer.Write("empty", std::vector<float>()).ok());
+  ASSERT_TRUE(writer.Close().ok());
+
+  SnapshotReader reader;
+  ASSERT_TRUE(reader.Open(path_).ok());
+  EXPECT_TRUE(reader.Has("ints"));
+  EXPECT_FALSE(reader.Has("floats"));
+
+  const int64_t* data = nullptr;
+  int64_t size = 0;
+  ASSERT_TRUE(reader.View("ints", &data, &size).ok());
+  EXPECT_EQ(size, 5);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(data) % kSnapshotAlignment, 0);
+  for (int64_t i = 0; i < size; ++i) {
+    EXPECT_EQ(data[i], i + 1);
+  }
+
+  int32_t scalar = 0;
+  EXPECT_TRUE(reader.Read("scalar", &scalar).ok());
+  EXPECT_EQ(scalar, 7);
+  int64_t wrong_size = 0;
+  EXPECT_TRUE(error::IsDataLoss(reader.Read("scalar", &wrong_size)));
+
+  std::vector<std::string> values;
+  ASSERT_TRUE(reader.ReadStrings("strs", &values).ok());
+  ASSERT_EQ(values.size(), 3);
+  EXPECT_EQ(values[0], "a");
+  EXPECT_EQ(values[1], "");
+  EXPECT_EQ(values[2], "hello");
+
+  std::vector<float> empty(3);
+  EXPECT_TRUE(reader.Read("empty", &empty).ok());
+  EXPECT_TRUE(empty.empty());
+  EXPECT_TRUE(error::IsNotFound(reader.Read("floats", &empty)));
+}
+
+TEST_F(SnapshotTest, InvalidFile) {
+  SnapshotReader reader;
+  EXPECT_FALSE(reader.Open(path_).ok());
+
+  FILE* f = fopen(path_.c_str(), "wb");
+  fputs("not a snapshot", f);
+  fclose(f);
+  EXPECT_TRUE(error::IsDataLoss(reader.Open(path_)));
+}
+
+TEST_F(SnapshotTest, CorruptedTable) {
+  SnapshotWriter writer;
+  ASSERT_TRUE(writer.Open(path_).ok());
+  EXPECT_TRUE(writer.Write("ints", std::vector<int64_t>(4, 1)).ok());
+  ASSERT_TRUE(writer.Close().ok());
+
+  // Point the section table beyond the end of the file.
+  FILE* f = fopen(path_.c_str(), "r+b");
+  int64_t table_offset = 1 << 20;
+  fseek(f, 24, SEEK_SET);
+  fwrite(&table_offset, sizeof(table_offset), 1, f);
+  fclose(f);
+
+  SnapshotReader reader;
+  EXPECT_TRUE(error::IsDataLoss(reader.Open(path_)));
+}
+
+TEST_F(SnapshotTest, CorruptedStrings) {
+  std::vector<int64_t> decreasing = {0, 5, 2, 6};
+  std::vector<int64_t> negative = {-4, 2, 6};
+  SnapshotWriter writer;
+  ASSERT_TRUE(writer.Open(path_).ok());
+  EXPECT_TRUE(writer.Write("decreasing.offsets", decreasing).ok());
+  EXPECT_TRUE(writer.Write("decreasing.bytes", "abcdef", 6).ok());
+  EXPECT_TRUE(writer.Write("negative.offsets", negative).ok());
+  EXPECT_TRUE(writer.Write("negative.bytes", "abcdef", 6).ok());
+  ASSERT_TRUE(writer.Close().ok());
+
+  SnapshotReader reader;
+  ASSERT_TRUE(reader.Open(path_).ok());
+  std::vector<std::string> values;
+  EXPECT_TRUE(error::IsDataLoss(reader.ReadStrings("decreasing", &values)));
+  EXPECT_TRUE(error::IsDataLoss(reader.ReadStrings("negative", &values)));
+}
+
+TEST_F(SnapshotTest, CompressedGraph) {
+  TestGraph(3);
+}
+
+TEST_F(SnapshotTest, PackedGraph) {
+  TestGraph(7);
+}
+
+TEST_F(SnapshotTest, CsrOrderedGraph) {
+  TestGraph(15);
+  TestGraph(31);
+}
+
+TEST_F(SnapshotTest, InEdgeIndexGraph) {
+  TestGraph(131);
+  TestGraph(143);
+}
+
+TEST_F(SnapshotTest, SamplingTableGraph) {
+  TestGraph(258);
+  TestGraph(263);
+}
+
+TEST_F(SnapshotTest, SortedNeighborGraph) {
+  // A sorted copy of the compressed rows, and the packed rows sorted
+  // already.
+  TestGraph(515);
+  TestGraph(519);
+}
+
+TEST_F(SnapshotTest, ClusterGraph) {
+  TestGraph(1027);
+  TestGraph(1031);
+}
+
+TEST_F(SnapshotTest, StringDictGraph) {
+  TestGraph(35);
+  TestGraph(99);
+}
+
+TEST_F(SnapshotTest, ReducedFloatGraph) {
+  info_.float_format = kFp16;
+  TestGraph(3);
+  info_.float_format = kInt8;
+  TestGraph(7);
+}
+
+TEST_F(SnapshotTest, StringDict) {
+  StringDict expected;
+  EXPECT_EQ(expected.Encode("b"), 0);
+  EXPECT_EQ(expected.Encode("a"), 1);
+  EXPECT_EQ(expected.Encode("b"), 0);
+  EXPECT_EQ(expected.Size(), 2);
+
+  SnapshotWriter writer;
+  ASSERT_TRUE(writer.Open(path_).ok());
+  ASSERT_TRUE(expected.Save(&writer, "dict").ok());
+  ASSERT_TRUE(writer.Close().ok());
+
+  // Loaded into a dictionary which is not empty
+  StringDict actual;
+  EXPECT_EQ(actual.Encode("a"), 0);
+  SnapshotReader reader;
+  ASSERT_TRUE(reader.Open(path_).ok());
+  std::vector<int32_t> codes;
+  ASSERT_TRUE(actual.Load(&reader, "dict", &codes).ok());
+  ASSERT_EQ(codes.size(), 2);
+  EXPECT_EQ(actual.Size(), 2);
+  EXPECT_EQ(actual.Decode(codes[0]), "b");
+  EXPECT_EQ(actual.Decode(codes[1]), "a");
+  EXPECT_EQ(codes[1], 0);
+}
+
+TEST_F(SnapshotTest, DenseNodes) {
+  TestNodes(1);
+}
+
+TEST_F(SnapshotTest, HashedNodes) {
+  TestNodes(3);
+}
+
+TEST_F(SnapshotTest, MemoryStorageUnsupported) {
+  GraphStorage* storage = NewMemoryGraphStorage();
+  storage->SetSideInfo(&info_);
+  storage->Build();
+  SnapshotWriter writer;
+  ASSERT_TRUE(writer.Open(path_).ok());
+  EXPECT_TRUE(error::IsUnimplemented(storage->Save(&writer, "edge")));
+  delete storage;
+}
@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "graphlearn/core/graph/storage/topo_statics.h"
 
+#include "graphlearn/common/base/errors.h"
+
 namespace graphlearn {
 namespace io {
 
@@ -56,6 +58,22 @@ void TopoStatics::Add(IdType src_id, IdType dst_id) {
   }
 }
 
+Status TopoStatics::Save(SnapshotWriter* writer,
+                         const std::string& prefix) const {
+  RETURN_IF_ERROR(writer->Write(prefix + ".src_ids", src_id_list_));
+  RETURN_IF_ERROR(writer->Write(prefix + ".dst_ids", dst_id_list_));
+  RETURN_IF_ERROR(writer->Write(prefix + ".out_degrees", out_degree_list_));
+  return writer->Write(prefix + ".in_degrees", in_degree_list_);
+}
+
+Status TopoStatics::Load(const SnapshotReader* reader,
+                         const std::string& prefix) {
+  RETURN_IF_ERROR(reader->Read(prefix + ".src_ids", &src_id_list_));
+  RETURN_IF_ERROR(reader->Read(prefix + ".dst_ids", &dst_id_list_));
+  RETURN_IF_ERROR(reader->Read(prefix + ".out_degrees", &out_degree_list_));
+  return reader->Read(prefix + ".in_degrees", &in_degree_list_);
+}
+
 IndexType TopoStatics::GetOutDegree(IdType src_id) const {
   IndexType src_index = src_indexing_->Get(src_id);
   if (src_index < out_degree_list_.size()) {
@@ -17,6 +17,7 @@ limitations under the License.
 #define GRAPHLEARN_CORE_GRAPH_STORAGE_TOPO_STATICS_H_
 
 #include <cstdint>
+#include <string>
 #include <vector>
 #include "graphlearn/core/graph/storage/auto_indexing.h"
 #include "graphlearn/core/graph/storage/types.h"
@@ -33,6 +34,9 @@ public:
 
   void Add(IdType src_id, IdType dst_id);
 
+  Status Save(SnapshotWriter* writer, const std::string& prefix) const;
+  Status Load(const SnapshotReader* reader, const std::string& prefix);
+
   const IdList* GetAllSrcIds() const {
     return &src_id_list_;
   }
@@ -20,6 +20,7 @@ limitations under the License.
 #include <string>
 #include <vector>
 #include "graphlearn/core/graph/storage/edge_storage.h"
+#include "graphlearn/core/graph/storage/snapshot.h"
 #include "graphlearn/core/graph/storage/types.h"
 
 namespace graphlearn {
@@ -32,6 +33,15 @@ public:
   /// Do some re-organization after data fixed.
   virtual void Build(EdgeStorage* edges) = 0;
 
+  /// Dump the built data into a snapshot, with section names under `prefix`.
+  virtual Status Save(SnapshotWriter* writer,
+                      const std::string& prefix) const = 0;
+  /// Restore the built data from a snapshot, instead of adding and building.
+  /// Large arrays may be served from the mapping, so the reader must live
+  /// longer than the storage.
+  virtual Status Load(const SnapshotReader* reader,
+                      const std::string& prefix) = 0;
+
   /// An EDGE is made up of [ src_id, attributes, dst_id ].
   /// Before inserted to the TopoStorage, it should be inserted to
   /// EdgeStorage to get an unique id. And then use the id and value here.
@@ -41,6 +51,27 @@ public:
   virtual Array<IdType> GetNeighbors(IdType src_id) const = 0;
   /// Get all the neighbor edge ids of a given id.
   virtual Array<IdType> GetOutEdges(IdType src_id) const = 0;
+  /// Get all the source node ids of the in-edges of a given id, which
+  /// needs IsInEdgeIndexEnabled(), otherwise empty.
+  virtual Array<IdType> GetInNeighbors(IdType dst_id) const = 0;
+  /// Get all the in-edge ids of a given id, in the same order as above.
+  virtual Array<IdType> GetInEdges(IdType dst_id) const = 0;
+  /// Get the cumulative edge weights of the out-edges of a given id, in
+  /// the same order as GetOutEdges(), which needs IsSamplingTableEnabled()
+  /// and weighted edges, otherwise empty.
+  virtual Array<double> GetEdgeWeightTable(IdType src_id) const = 0;
+  /// Get the cumulative in-degrees of the neighbors of a given id, in the
+  /// same order as GetNeighbors(), which needs IsSamplingTableEnabled()
+  /// and the in-degrees, otherwise empty.
+  virtual Array<double> GetInDegreeTable(IdType src_id) const = 0;
+  /// Get the neighbor node ids of a given id in ascending order, which
+  /// needs IsSortedNeighborEnabled(), otherwise empty.
+  virtual Array<IdType> GetSortedNeighbors(IdType src_id) const = 0;
+  /// Get the number of the clusters of the source ids, which needs
+  /// IsGraphClusterEnabled(), otherwise 0.
+  virtual IndexType GetClusterCount() const = 0;
+  /// Get the source ids in a given cluster of [0, GetClusterCount()).
+  virtual Array<IdType> GetCluster(IndexType cluster) const = 0;
   /// Get the out-degree value of a given id.
   virtual IndexType GetOutDegree(IdType src_id) const = 0;
   /// Get the in-degree value of a given id.
@@ -16,15 +16,13 @@ limitations under the License.
 #ifndef GRAPHLEARN_CORE_GRAPH_STORAGE_TYPES_H_
 #define GRAPHLEARN_CORE_GRAPH_STORAGE_TYPES_H_
 
+#include <atomic>
 #include <cstdint>
+#include <memory>
+#include <utility>
 #include <vector>
 
-#if __cplusplus >= 201103L
-#include <unordered_map>
-#else
-#include <tr1/unordered_map>  // NOLINT [build/c++tr1]
-#endif
-
+#include "graphlearn/common/threading/runner/parallel_for.h"
 #include "graphlearn/core/io/element_value.h"
 
 namespace graphlearn {
@@ -37,37 +35,61 @@ typedef std::vector<IdType> IdList;
 typedef std::vector<IndexType> IndexList;
 typedef std::vector<std::vector<IdType>> IdMatrix;
 
-#if __cplusplus >= 201103L
-typedef std::unordered_map<IdType, IndexType> MAP;
-#else
-typedef std::tr1::unordered_map<IdType, IndexType> MAP;
-#endif
+/// A process-wide increasing number. A storage takes a new one each time
+/// it is built or loaded, so that the tables derived from its data, such
+/// as the alias tables of the negative samplers, can tell they are stale.
+inline int64_t NewStorageVersion() {
+  static std::atomic<int64_t> version(0);
+  return ++version;
+}
 
 template <class T>
 class Array {
 public:
-  Array() : value_(nullptr), size_(0) {
+  Array() : value_(nullptr), size_(0), begin_(), ranged_(false) {
   }
 
   Array(const T* value, int32_t size)
-    : value_(value), size_(size) {
+    : value_(value), size_(size), begin_(), ranged_(false) {
   }
 
   explicit Array(const std::vector<T>& values)
-    : value_(values.data()), size_(values.size()) {
+    : value_(values.data()), size_(values.size()),
+      begin_(), ranged_(false) {
+  }
+
+  /// Share the ownership of values, which is used when the underlying
+  /// storage can not expose a contiguous buffer, such as bit-packed ids.
+  /// The values must not change while any array refers to them.
+  explicit Array(std::shared_ptr<const std::vector<T>> values)
+    : begin_(), ranged_(false), holder_(std::move(values)) {
+    value_ = holder_->data();
+    size_ = holder_->size();
   }
 
-  Array(Array&& rhs) {
+  Array(Array&& rhs) : holder_(std::move(rhs.holder_)) {
     value_ = rhs.value_;
     size_ = rhs.size_;
+    begin_ = rhs.begin_;
+    ranged_ = rhs.ranged_;
+  }
+
+  /// A view of the consecutive values [begin, begin + size) without any
+  /// buffer, such as the edge ids of a node when edges are in CSR order.
+  static Array<T> Range(T begin, int32_t size) {
+    Array<T> ret;
+    ret.size_ = size;
+    ret.begin_ = begin;
+    ret.ranged_ = true;
+    return ret;
   }
 
   operator bool () const {
-    return value_ != nullptr && size_ != 0;
+    return (value_ != nullptr || ranged_) && size_ != 0;
   }
 
   T operator[] (int32_t i) const {
-    return value_[i];
+    return ranged_ ? begin_ + i : value_[i];
   }
 
   int32_t Size() const {
@@ -77,10 +99,80 @@ public:
 private:
   const T* value_;
   int32_t size_;
+  T begin_;
+  bool ranged_;
+  std::shared_ptr<const std::vector<T>> holder_;
 };
 
 typedef Array<IdType> IdArray;
 
+/// Re-arrange the values so that the one at order[i] comes to position i,
+/// in parallel if a thread pool is given. Empty values are left untouched.
+template <class T>
+void Permute(const IdList& order, std::vector<T>* values,
+             ThreadPool* tp = nullptr) {
+  if (values->empty()) {
+    return;
+  }
+
+  std::vector<T> permuted(order.size());
+  ParallelFor(tp, order.size(), 4096,
+    [&order, values, &permuted] (int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        permuted[i] = std::move((*values)[order[i]]);
+      }
+    });
+  values->swap(permuted);
+}
+
+/// Batched lookups resolve ids to row indices in chunks of this size,
+/// so that the indices fit on the stack.
+const int32_t kGatherChunkSize = 256;
+
+template <class T>
+inline void GatherValue(const T& value, T* out) {
+  *out = value;
+}
+
+/// Refer to the value instead of copying, such as for strings.
+template <class T>
+inline void GatherValue(const T& value, const T** out) {
+  *out = &value;
+}
+
+/// Gather `num` values per row for the rows at `indices` from a row-major
+/// `column` with `rows` rows into `out`. An index out of [0, rows) gets the
+/// `defaults`, which has `num` values. All the cache lines of a row ahead
+/// are prefetched, since a wide row spans several of them.
+template <class T, class Out, class Index>
+void GatherRows(const T* column, int64_t rows, int32_t num,
+                const Index* indices, int32_t size,
+                const T* defaults, Out* out) {
+  const int32_t kPrefetchDistance = 8;
+  const int64_t kCacheLineSize = 64;
+  for (int32_t i = 0; i < size; ++i, out += num) {
+    if (i + kPrefetchDistance < size) {
+      Index next = indices[i + kPrefetchDistance];
+      if (next >= 0 && next < rows) {
+        const T* row = column + next * num;
+        const char* begin = reinterpret_cast<const char*>(row);
+        const char* end = reinterpret_cast<const char*>(row + num);
+        for (const char* line = begin; line < end; line += kCacheLineSize) {
+          __builtin_prefetch(line);
+        }
+        // The last line, if the row does not start at a line.
+        __builtin_prefetch(end - 1);
+      }
+    }
+    Index index = indices[i];
+    const T* row = (index >= 0 && index < rows) ? column + index * num
+                                                : defaults;
+    for (int32_t j = 0; j < num; ++j) {
+      GatherValue(row[j], out + j);
+    }
+  }
+}
+
 class Attribute {
 public:
   Attribute() : value_(nullptr), own_(false) {
@@ -97,6 +189,19 @@ public:
     rhs.own_ = false;
   }
 
+  Attribute& operator=(Attribute&& rhs) {
+    if (this != &rhs) {
+      if (own_) {
+        delete value_;
+      }
+      value_ = rhs.value_;
+      own_ = rhs.own_;
+      rhs.value_ = nullptr;
+      rhs.own_ = false;
+    }
+    return *this;
+  }
+
   ~Attribute() {
     if (own_) {
       delete value_;
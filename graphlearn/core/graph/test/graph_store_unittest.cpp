@@ -22,6 +22,7 @@ limitations under the License.
 #include "graphlearn/core/io/element_value.h"
 #include "graphlearn/core/operator/op_factory.h"
 #include "graphlearn/include/config.h"
+#include "graphlearn/include/graph_request.h"
 #include "graphlearn/platform/env.h"
 #include "gtest/gtest.h"
 
@@ -462,3 +463,76 @@ TEST_F(GraphStoreTest, EdgesAndNodes) {
     TestNoder(&store);
   }
 }
+
+TEST_F(GraphStoreTest, SaveAndRestore) {
+  const char* e_file = "snapshot_edge_file";
+  const char* n_file = "snapshot_node_file";
+  GenEdgeTestData(e_file, kWeighted);
+  GenNodeTestData(n_file, kWeighted);
+
+  std::vector<EdgeSource> edge_source(1);
+  GenEdgeSource(&edge_source[0], kWeighted, e_file, "click", "user", "item");
+  std::vector<NodeSource> node_source(1);
+  GenNodeSource(&node_source[0], kWeighted, n_file, "user");
+  edge_source[0].option.name = "sort";
+  node_source[0].option.name = "sort";
+
+  GLOBAL_FLAG(StorageMode) = 3;
+  GLOBAL_FLAG(SnapshotDir) = ".";
+  {
+    GraphStore store(Env::Default());
+    ::graphlearn::op::OpFactory::GetInstance()->Set(&store);
+    EXPECT_TRUE(store.Load(edge_source, node_source).ok());
+    EXPECT_TRUE(store.Build(edge_source, node_source).ok());
+    EXPECT_TRUE(store.Save(edge_source, node_source).ok());
+  }
+  {
+    GraphStore store(Env::Default());
+    EXPECT_TRUE(store.Restore(edge_source, node_source).ok());
+    GraphStorage* storage = store.GetGraph("click")->GetLocalStorage();
+    EXPECT_EQ(storage->GetEdgeCount(), 100);
+    EXPECT_EQ(store.GetNoder("user")->GetLocalStorage()->Size(), 100);
+
+    // The restored graphs are never updated, such as by a loading peer.
+    SideInfo info;
+    info.format = kWeighted;
+    info.type = "click";
+    UpdateEdgesRequest edge_req(&info, 1);
+    UpdateEdgesResponse edge_res;
+    Status s = store.GetGraph("click")->UpdateEdges(&edge_req, &edge_res);
+    EXPECT_TRUE(error::IsFailedPrecondition(s));
+    info.type = "user";
+    UpdateNodesRequest node_req(&info, 1);
+    UpdateNodesResponse node_res;
+    s = store.GetNoder("user")->UpdateNodes(&node_req, &node_res);
+    EXPECT_TRUE(error::IsFailedPrecondition(s));
+    EXPECT_EQ(storage->GetEdgeCount(), 100);
+  }
+  {
+    // Another partition of the data.
+    int32_t server_count = GLOBAL_FLAG(ServerCount);
+    GLOBAL_FLAG(ServerCount) = server_count + 1;
+    GraphStore store(Env::Default());
+    EXPECT_TRUE(error::IsNotFound(store.Restore(edge_source, node_source)));
+    GLOBAL_FLAG(ServerCount) = server_count;
+  }
+  {
+    // Other options of the same data.
+    std::vector<NodeSource> other_source(node_source);
+    other_source[0].attr_info.ignore_invalid = true;
+    GraphStore store(Env::Default());
+    EXPECT_TRUE(error::IsNotFound(store.Restore(edge_source, other_source)));
+  }
+  {
+    // The data changed since the snapshot.
+    std::ofstream out(e_file, std::ios::app);
+    out << "100\t100\t100.0\n";
+    out.close();
+    GraphStore store(Env::Default());
+    EXPECT_TRUE(error::IsNotFound(store.Restore(edge_source, node_source)));
+  }
+
+  ::unlink("./graph_0.snapshot");
+  GLOBAL_FLAG(SnapshotDir) = "";
+  GLOBAL_FLAG(StorageMode) = 2;
+}
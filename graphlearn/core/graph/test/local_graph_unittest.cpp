@@ -0,0 +1,132 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <memory>
+#include <thread>  // NOLINT [build/c++11]
+#include <vector>
+#include "graphlearn/common/base/log.h"
+#include "graphlearn/core/graph/graph.h"
+#include "graphlearn/core/graph/noder.h"
+#include "graphlearn/include/graph_request.h"
+#include "graphlearn/include/index_option.h"
+#include "gtest/gtest.h"
+
+using namespace graphlearn;  // NOLINT [build/namespaces]
+using namespace graphlearn::io;  // NOLINT [build/namespaces]
+
+class LocalGraphTest : public ::testing::Test {
+public:
+  LocalGraphTest() {
+    InitGoogleLogging();
+  }
+  ~LocalGraphTest() {
+    UninitGoogleLogging();
+  }
+
+protected:
+  void SetUp() override {
+    edge_info_.format = kWeighted | kAttributed;
+    edge_info_.f_num = 1;
+    edge_info_.type = "u-i";
+    edge_info_.src_type = "user";
+    edge_info_.dst_type = "item";
+
+    node_info_.format = kLabeled;
+    node_info_.type = "user";
+  }
+
+protected:
+  SideInfo edge_info_;
+  SideInfo node_info_;
+  const int32_t kThreadNum = 8;
+  const int32_t kBatchNum = 50;
+  const int32_t kBatchSize = 100;
+};
+
+TEST_F(LocalGraphTest, ConcurrentUpdateEdges) {
+  std::unique_ptr<Graph> graph(CreateLocalGraph());
+
+  std::vector<std::thread> threads;
+  for (int32_t t = 0; t < kThreadNum; ++t) {
+    threads.emplace_back([this, &graph, t] {
+      EdgeValue value;
+      for (int32_t b = 0; b < kBatchNum; ++b) {
+        UpdateEdgesRequest req(&edge_info_, kBatchSize);
+        for (int32_t i = 0; i < kBatchSize; ++i) {
+          value.src_id = (t * kBatchNum + b) * kBatchSize + i;
+          value.dst_id = value.src_id + 1;
+          value.weight = value.src_id;
+          value.attrs->Clear();
+          value.attrs->Add(static_cast<float>(value.src_id));
+          req.Append(&value);
+        }
+        UpdateEdgesResponse res;
+        EXPECT_TRUE(graph->UpdateEdges(&req, &res).ok());
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  IndexOption option;
+  option.name = "sort";
+  EXPECT_TRUE(graph->Build(option).ok());
+
+  GraphStorage* storage = graph->GetLocalStorage();
+  int64_t total = kThreadNum * kBatchNum * kBatchSize;
+  EXPECT_EQ(storage->GetEdgeCount(), total);
+  for (IdType src_id = 0; src_id < total; ++src_id) {
+    auto edges = storage->GetOutEdges(src_id);
+    ASSERT_EQ(edges.Size(), 1);
+    EXPECT_EQ(storage->GetDstId(edges[0]), src_id + 1);
+    EXPECT_FLOAT_EQ(storage->GetEdgeWeight(edges[0]), src_id);
+    auto attr = storage->GetEdgeAttribute(edges[0]);
+    EXPECT_FLOAT_EQ(attr->GetFloats(nullptr)[0], src_id);
+  }
+}
+
+TEST_F(LocalGraphTest, ConcurrentUpdateNodes) {
+  std::unique_ptr<Noder> noder(CreateLocalNoder());
+
+  std::vector<std::thread> threads;
+  for (int32_t t = 0; t < kThreadNum; ++t) {
+    threads.emplace_back([this, &noder, t] {
+      NodeValue value;
+      for (int32_t b = 0; b < kBatchNum; ++b) {
+        UpdateNodesRequest req(&node_info_, kBatchSize);
+        for (int32_t i = 0; i < kBatchSize; ++i) {
+          // Each node is added twice by different threads.
+          value.id = ((t / 2) * kBatchNum + b) * kBatchSize + i;
+          value.label = value.id;
+          req.Append(&value);
+        }
+        UpdateNodesResponse res;
+        EXPECT_TRUE(noder->UpdateNodes(&req, &res).ok());
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  // Visible without Build().
+  NodeStorage* storage = noder->GetLocalStorage();
+  int64_t total = kThreadNum / 2 * kBatchNum * kBatchSize;
+  EXPECT_EQ(storage->Size(), total);
+  for (IdType id = 0; id < total; ++id) {
+    EXPECT_EQ(storage->GetLabel(id), id);
+  }
+}
@@ -112,6 +112,11 @@ public:
     f_attrs_.assign(values, values + len);
   }
 
+  float* MutableFloats(int32_t len) override {
+    f_attrs_.resize(len);
+    return f_attrs_.data();
+  }
+
   const int64_t* GetInts(int32_t* len) const override {
     if (len) {
       *len = i_attrs_.size();
@@ -162,11 +167,13 @@ public:
     i_len_ = 0;
     f_attrs_ = nullptr;
     f_len_ = 0;
+    f_held_.clear();
     s_lites_.clear();
     s_attrs_.clear();
   }
 
   void Shrink() override {
+    f_held_.shrink_to_fit();
     s_lites_.shrink_to_fit();
   }
 
@@ -176,11 +183,13 @@ public:
     std::swap(i_len_, right->i_len_);
     std::swap(f_attrs_, right->f_attrs_);
     std::swap(f_len_, right->f_len_);
+    f_held_.swap(right->f_held_);
     s_lites_.swap(right->s_lites_);
     s_attrs_.swap(right->s_attrs_);
   }
 
   void Reserve(int32_t i_num, int32_t f_num, int32_t s_num) override {
+    f_held_.reserve(f_num);
     s_attrs_.reserve(s_num);
   }
 
@@ -189,7 +198,10 @@ public:
   }
 
   void Add(float value) override {
-    // Not hold the value, just unimplement
+    // Hold the floats decoded from a reduced precision column
+    f_held_.push_back(value);
+    f_attrs_ = f_held_.data();
+    f_len_ = f_held_.size();
   }
 
   void Add(std::string&& value) override {
@@ -214,6 +226,14 @@ public:
     f_len_ = len;
   }
 
+  float* MutableFloats(int32_t len) override {
+    // The buffer is kept across Clear() for the next row
+    f_held_.resize(len);
+    f_attrs_ = f_held_.data();
+    f_len_ = len;
+    return f_held_.data();
+  }
+
   const int64_t* GetInts(int32_t* len) const override {
     if (len) {
       *len = i_len_;
@@ -251,6 +271,7 @@ private:
   int32_t        i_len_;
   const float*   f_attrs_;
   int32_t        f_len_;
+  std::vector<float>      f_held_;
   std::vector<LiteString> s_lites_;
   mutable std::vector<std::string> s_attrs_;
 };
@@ -35,13 +35,15 @@ struct SideInfo {
   std::string src_type;
   std::string dst_type;
   Direction direction;
+  FloatFormat float_format;
 
   SideInfo()
       : i_num(0),
         f_num(0),
         s_num(0),
         format(0),
-        direction(kOrigin) {
+        direction(kOrigin),
+        float_format(kFp32) {
   }
 
   bool IsInitialized() const { return format != 0; }
@@ -67,6 +69,7 @@ struct SideInfo {
     src_type = info.src_type;
     dst_type = info.dst_type;
     direction = info.direction;
+    float_format = info.float_format;
   }
 };
 
@@ -86,6 +89,9 @@ public:
   virtual void Add(const char* value, int32_t len) = 0;
   virtual void Add(const int64_t* values, int32_t len) = 0;
   virtual void Add(const float* values, int32_t len) = 0;
+  /// Resize the floats to `len` and return them to be written in place,
+  /// such as decoded from a reduced precision column.
+  virtual float* MutableFloats(int32_t len) = 0;
   virtual const int64_t* GetInts(int32_t* len) const = 0;
   virtual const float* GetFloats(int32_t* len) const = 0;
   virtual const std::string* GetStrings(int32_t* len) const = 0;
@@ -39,6 +39,7 @@ void ParseSideInfo(const T* source, SideInfo* info) {
   info->format = source->format;
 
   const AttributeInfo& attr_info = source->attr_info;
+  info->float_format = attr_info.float_format;
   for (int32_t i = 0; i < attr_info.types.size(); ++i) {
     if (attr_info.types[i] == DataType::kInt32 ||
         attr_info.types[i] == DataType::kInt64) {
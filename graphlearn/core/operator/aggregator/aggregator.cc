@@ -15,13 +15,25 @@ limitations under the License.
 
 #include "graphlearn/core/operator/aggregator/aggregator.h"
 
+#include <algorithm>
+#include <vector>
+#include "graphlearn/common/threading/runner/parallel_for.h"
 #include "graphlearn/core/graph/storage/node_storage.h"
 #include "graphlearn/include/config.h"
 #include "graphlearn/common/base/log.h"
+#include "graphlearn/platform/env.h"
 
 namespace graphlearn {
 namespace op {
 
+namespace {
+
+// Aggregate the requests of at least so many ids in parallel.
+const int64_t kParallelThreshold = 4096;
+const int64_t kMinIdsPerBlock = 1024;
+
+}  // anonymous namespace
+
 Status Aggregator::Aggregate(const AggregatingRequest* req,
                              AggregatingResponse* res) {
   Noder* node = graph_store_->GetNoder(req->Type());
@@ -34,25 +46,70 @@ Status Aggregator::Aggregate(const AggregatingRequest* req,
   res->SetNumSegments(num_segments);
   res->SetName(req->Name());
 
-  // Initialize float attributes.
-  // Aggregator only takes effect on float attributes.
-  std::unique_ptr<float[]> emb(new float[dim]);
-
+  // Split the node ids into segments.
+  std::vector<int64_t> node_ids;
+  node_ids.reserve(req->NumIds());
+  std::vector<int32_t> offsets(num_segments + 1, 0);
   int64_t node_id = 0;
   int32_t segment_id = 0;
-  int32_t segment_size = 0;
   AggregatingRequest* request = const_cast<AggregatingRequest*>(req);
   for (int32_t idx = 0; idx < num_segments; idx++) {
-    segment_size = 0;
-    this->InitFunc(emb.get(), dim);
     while (!req->SegmentEnd(idx)) {
       request->Next(&node_id, &segment_id);
-      auto attr = storage->GetAttribute(node_id)->GetFloats(nullptr);
-      this->AggFunc(emb.get(), attr, dim);
-      segment_size++;
+      node_ids.push_back(node_id);
+    }
+    offsets[idx + 1] = node_ids.size();
+  }
+
+  // A partial request keeps the states for the merging on the client.
+  bool partial = req->IsPartial();
+
+  // Aggregator only takes effect on float attributes. The float attributes
+  // of a segment are gathered in one batch, which decodes the reduced
+  // precision columns together, and folded by ReduceFunc().
+  std::vector<float> embs(static_cast<int64_t>(num_segments) * dim);
+  auto aggregate = [this, storage, dim, partial, &node_ids, &offsets, &embs] (
+      int64_t begin, int64_t end) {
+    std::vector<float> attrs;
+    for (int64_t idx = begin; idx < end; ++idx) {
+      int32_t segment_size = offsets[idx + 1] - offsets[idx];
+      attrs.resize(static_cast<int64_t>(segment_size) * dim);
+      storage->GatherFloats(node_ids.data() + offsets[idx], segment_size,
+                            attrs.data());
+      float* emb = embs.data() + idx * dim;
+      this->InitFunc(emb, dim);
+      this->ReduceFunc(emb, attrs.data(), segment_size, dim);
+      if (!partial) {
+        this->FinalFunc(emb, dim, &segment_size, 1);
+      }
     }
-    this->FinalFunc(emb.get(), dim, &segment_size, 1);
-    res->AppendEmbedding(emb.get());
+  };
+
+  // The segments of large requests are aggregated in parallel, with about
+  // kMinIdsPerBlock ids per block.
+  int64_t num_ids = node_ids.size();
+  if (num_ids >= kParallelThreshold && num_segments > 1) {
+    int64_t grain = std::max(
+      static_cast<int64_t>(num_segments) * kMinIdsPerBlock / num_ids,
+      int64_t(1));
+    ParallelFor(Env::Default()->IntraThreadPool(), num_segments, grain,
+                aggregate);
+  } else {
+    aggregate(0, num_segments);
+  }
+
+  if (partial) {
+    res->SetPartial();
+  }
+  for (int32_t idx = 0; idx < num_segments; idx++) {
+    int32_t segment_size = offsets[idx + 1] - offsets[idx];
+    if (partial && segment_size == 0) {
+      continue;
+    }
+    if (partial) {
+      res->AppendSegmentId(idx);
+    }
+    res->AppendEmbedding(embs.data() + static_cast<int64_t>(idx) * dim);
     res->AppendSegment(segment_size);
   }
   return Status::OK();
@@ -71,6 +128,15 @@ void Aggregator::AggFunc(float* left,
                          int32_t num_segments) {
 }
 
+void Aggregator::ReduceFunc(float* value,
+                            const float* rows,
+                            int32_t num,
+                            int32_t dim) {
+  for (int32_t i = 0; i < num; ++i) {
+    this->AggFunc(value, rows + static_cast<int64_t>(i) * dim, dim);
+  }
+}
+
 void Aggregator::FinalFunc(float* values,
                            int32_t size,
                            const int32_t* segments,
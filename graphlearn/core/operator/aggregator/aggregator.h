@@ -62,6 +62,12 @@ public:
                        int32_t size,
                        const int32_t* segments = nullptr,
                        int32_t num_segments = 0);
+  /// Fold `num` rows of `dim` floats, one after another, into `value`,
+  /// by AggFunc() on each row unless overridden.
+  virtual void ReduceFunc(float* value,
+                          const float* rows,
+                          int32_t num,
+                          int32_t dim);
   virtual void FinalFunc(float* values,
                          int32_t size,
                          const int32_t* segments,
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include <float.h>
 #include "graphlearn/core/operator/aggregator/aggregator.h"
+#include "graphlearn/core/operator/aggregator/reduce_kernels.h"
 
 namespace graphlearn {
 namespace op {
@@ -34,9 +35,14 @@ public:
                int32_t size,
                const int32_t* segments,
                int32_t num_segments) override {
-    for (int32_t i = 0; i < size; ++i) {
-      left[i] = std::min(left[i], right[i]);
-    }
+    ReduceRows(kReduceMin, right, 1, size, left);
+  }
+
+  void ReduceFunc(float* value,
+                  const float* rows,
+                  int32_t num,
+                  int32_t dim) override {
+    ReduceRows(kReduceMin, rows, num, dim, value);
   }
 };
 
@@ -0,0 +1,222 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "graphlearn/core/operator/aggregator/reduce_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define GL_SIMD_DISPATCH 1
+#define GL_TARGET_AVX2 __attribute__((target("avx2")))
+#define GL_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+namespace graphlearn {
+namespace op {
+
+namespace {
+
+// Each op works on a float, or on the vectors of the kernel it is used in.
+// Max and min give NaN if either operand is, on a float and on the lanes
+// of a vector alike, so that the result does not depend on how the kernel
+// groups the rows. The max and min instructions alone give the second
+// operand if either is NaN, which drops a NaN of the first one.
+struct SumOp {
+  static float Apply(float a, float b) { return a + b; }
+#if defined(GL_SIMD_DISPATCH)
+  GL_TARGET_AVX2 static __m256 Apply(__m256 a, __m256 b) {
+    return _mm256_add_ps(a, b);
+  }
+  GL_TARGET_AVX512 static __m512 Apply(__m512 a, __m512 b) {
+    return _mm512_add_ps(a, b);
+  }
+#endif
+};
+
+struct MaxOp {
+  static float Apply(float a, float b) {
+    return (std::isnan(a) || a > b) ? a : b;
+  }
+#if defined(GL_SIMD_DISPATCH)
+  GL_TARGET_AVX2 static __m256 Apply(__m256 a, __m256 b) {
+    return _mm256_blendv_ps(_mm256_max_ps(a, b), a,
+                            _mm256_cmp_ps(a, a, _CMP_UNORD_Q));
+  }
+  GL_TARGET_AVX512 static __m512 Apply(__m512 a, __m512 b) {
+    return _mm512_mask_mov_ps(_mm512_max_ps(a, b),
+                              _mm512_cmp_ps_mask(a, a, _CMP_UNORD_Q), a);
+  }
+#endif
+};
+
+struct MinOp {
+  static float Apply(float a, float b) {
+    return (std::isnan(a) || a < b) ? a : b;
+  }
+#if defined(GL_SIMD_DISPATCH)
+  GL_TARGET_AVX2 static __m256 Apply(__m256 a, __m256 b) {
+    return _mm256_blendv_ps(_mm256_min_ps(a, b), a,
+                            _mm256_cmp_ps(a, a, _CMP_UNORD_Q));
+  }
+  GL_TARGET_AVX512 static __m512 Apply(__m512 a, __m512 b) {
+    return _mm512_mask_mov_ps(_mm512_min_ps(a, b),
+                              _mm512_cmp_ps_mask(a, a, _CMP_UNORD_Q), a);
+  }
+#endif
+};
+
+struct ProdOp {
+  static float Apply(float a, float b) { return a * b; }
+#if defined(GL_SIMD_DISPATCH)
+  GL_TARGET_AVX2 static __m256 Apply(__m256 a, __m256 b) {
+    return _mm256_mul_ps(a, b);
+  }
+  GL_TARGET_AVX512 static __m512 Apply(__m512 a, __m512 b) {
+    return _mm512_mul_ps(a, b);
+  }
+#endif
+};
+
+template <class Op>
+void ReduceScalar(const float* rows, int32_t num, int32_t dim, float* out) {
+  for (int32_t r = 0; r < num; ++r, rows += dim) {
+    for (int32_t j = 0; j < dim; ++j) {
+      out[j] = Op::Apply(out[j], rows[j]);
+    }
+  }
+}
+
+/// The columns of [begin, dim) only.
+template <class Op>
+void ReduceTail(const float* rows, int32_t num, int32_t dim,
+                int32_t begin, float* out) {
+  for (int32_t r = 0; r < num; ++r, rows += dim) {
+    for (int32_t j = begin; j < dim; ++j) {
+      out[j] = Op::Apply(out[j], rows[j]);
+    }
+  }
+}
+
+#if defined(GL_SIMD_DISPATCH)
+
+// The even and odd rows go to two accumulators, which hides the latency of
+// the op, and are merged at the end.
+template <class Op>
+GL_TARGET_AVX2
+void ReduceAvx2(const float* rows, int32_t num, int32_t dim, float* out) {
+  int32_t j = 0;
+  for (; j + 8 <= dim; j += 8) {
+    __m256 acc0 = _mm256_loadu_ps(out + j);
+    int32_t r = 0;
+    if (num >= 2) {
+      __m256 acc1 = _mm256_loadu_ps(rows + j);
+      for (r = 1; r + 1 < num; r += 2) {
+        acc0 = Op::Apply(acc0, _mm256_loadu_ps(rows + r * dim + j));
+        acc1 = Op::Apply(acc1, _mm256_loadu_ps(rows + (r + 1) * dim + j));
+      }
+      acc0 = Op::Apply(acc0, acc1);
+    }
+    for (; r < num; ++r) {
+      acc0 = Op::Apply(acc0, _mm256_loadu_ps(rows + r * dim + j));
+    }
+    _mm256_storeu_ps(out + j, acc0);
+  }
+  ReduceTail<Op>(rows, num, dim, j, out);
+}
+
+// The max and min intrinsics of GCC 12 merge into an undefined vector,
+// which it warns about as maybe uninitialized once they are inlined here.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+// A block of 16 floats is just a cache line, and the tail is masked.
+template <class Op>
+GL_TARGET_AVX512
+void ReduceAvx512(const float* rows, int32_t num, int32_t dim, float* out) {
+  for (int32_t j = 0; j < dim; j += 16) {
+    __mmask16 mask = (dim - j >= 16) ? 0xFFFF : ((1 << (dim - j)) - 1);
+    __m512 acc0 = _mm512_maskz_loadu_ps(mask, out + j);
+    int32_t r = 0;
+    if (num >= 2) {
+      __m512 acc1 = _mm512_maskz_loadu_ps(mask, rows + j);
+      for (r = 1; r + 1 < num; r += 2) {
+        acc0 = Op::Apply(acc0,
+          _mm512_maskz_loadu_ps(mask, rows + r * dim + j));
+        acc1 = Op::Apply(acc1,
+          _mm512_maskz_loadu_ps(mask, rows + (r + 1) * dim + j));
+      }
+      acc0 = Op::Apply(acc0, acc1);
+    }
+    for (; r < num; ++r) {
+      acc0 = Op::Apply(acc0,
+        _mm512_maskz_loadu_ps(mask, rows + r * dim + j));
+    }
+    _mm512_mask_storeu_ps(out + j, mask, acc0);
+  }
+}
+
+#pragma GCC diagnostic pop
+
+#endif
+
+typedef void (*ReduceKernel)(const float* rows, int32_t num,
+                             int32_t dim, float* out);
+
+// Indexed by SimdLevel and then by ReduceType.
+const ReduceKernel kKernels[][4] = {
+  {ReduceScalar<SumOp>, ReduceScalar<MaxOp>,
+   ReduceScalar<MinOp>, ReduceScalar<ProdOp>},
+#if defined(GL_SIMD_DISPATCH)
+  {ReduceAvx2<SumOp>, ReduceAvx2<MaxOp>,
+   ReduceAvx2<MinOp>, ReduceAvx2<ProdOp>},
+  {ReduceAvx512<SumOp>, ReduceAvx512<MaxOp>,
+   ReduceAvx512<MinOp>, ReduceAvx512<ProdOp>}
+#endif
+};
+
+SimdLevel DetectSimdLevel() {
+#if defined(GL_SIMD_DISPATCH)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return kSimdAvx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return kSimdAvx2;
+  }
+#endif
+  return kSimdScalar;
+}
+
+}  // anonymous namespace
+
+SimdLevel SupportedSimdLevel() {
+  static const SimdLevel level = DetectSimdLevel();
+  return level;
+}
+
+void ReduceRows(ReduceType type, const float* rows, int32_t num,
+                int32_t dim, float* out) {
+  ReduceRows(type, rows, num, dim, out, SupportedSimdLevel());
+}
+
+void ReduceRows(ReduceType type, const float* rows, int32_t num,
+                int32_t dim, float* out, SimdLevel level) {
+  level = std::min(level, SupportedSimdLevel());
+  kKernels[level][type](rows, num, dim, out);
+}
+
+}  // namespace op
+}  // namespace graphlearn
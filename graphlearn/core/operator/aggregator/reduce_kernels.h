@@ -0,0 +1,57 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef GRAPHLEARN_CORE_OPERATOR_AGGREGATOR_REDUCE_KERNELS_H_
+#define GRAPHLEARN_CORE_OPERATOR_AGGREGATOR_REDUCE_KERNELS_H_
+
+#include <cstdint>
+
+namespace graphlearn {
+namespace op {
+
+enum ReduceType {
+  kReduceSum = 0,
+  kReduceMax = 1,
+  kReduceMin = 2,
+  kReduceProd = 3
+};
+
+/// The instruction sets of the kernels, in the ascending order.
+enum SimdLevel {
+  kSimdScalar = 0,
+  kSimdAvx2 = 1,
+  kSimdAvx512 = 2
+};
+
+/// The highest level the CPU supports, detected once at runtime.
+SimdLevel SupportedSimdLevel();
+
+/// Fold `num` rows of `dim` floats, laid out one after another, into `out`
+/// element-wise, which holds the initial values. Each block of columns is
+/// accumulated in registers across the rows, so `out` is only read and
+/// written once. The rows may be folded in any order. Max and min are NaN
+/// where any of the values is.
+void ReduceRows(ReduceType type, const float* rows, int32_t num,
+                int32_t dim, float* out);
+
+/// The same with the kernels of a given level. A level the CPU or the build
+/// does not support falls back to SupportedSimdLevel().
+void ReduceRows(ReduceType type, const float* rows, int32_t num,
+                int32_t dim, float* out, SimdLevel level);
+
+}  // namespace op
+}  // namespace graphlearn
+
+#endif  // GRAPHLEARN_CORE_OPERATOR_AGGREGATOR_REDUCE_KERNELS_H_
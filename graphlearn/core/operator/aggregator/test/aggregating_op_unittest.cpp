@@ -13,6 +13,8 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <float.h>
+#include <algorithm>
 #include <fstream>
 #include <unordered_set>
 #include "graphlearn/common/base/errors.h"
@@ -362,3 +364,97 @@ TEST_F(AggregationOpTest, Aggregator) {
     delete req;
   }
 }
+
+TEST_F(AggregationOpTest, LargeRequest) {
+  const char* a_file = "a_node_file";
+  GenNodeTestData(a_file, kAttributed);
+
+  std::vector<NodeSource> node_source(1);
+  GenNodeSource(&node_source[0], kAttributed, a_file, "movie");
+
+  std::vector<EdgeSource> edge_source;
+  GraphStore store(Env::Default());
+  ::graphlearn::op::OpFactory::GetInstance()->Set(&store);
+
+  Status s = store.Load(edge_source, node_source);
+  EXPECT_TRUE(s.ok());
+
+  // Enough ids to aggregate the segments in parallel, with some empty
+  // segments and some ids not existing.
+  int32_t num_segments = 1000;
+  std::vector<int64_t> ids;
+  std::vector<int32_t> segment_ids;
+  for (int32_t j = 0; j < num_segments; ++j) {
+    for (int32_t i = 0; i < j % 20; ++i) {
+      ids.push_back((j * 7 + i * 13) % 110);
+      segment_ids.push_back(j);
+    }
+  }
+
+  const char* strategies[] = {"SumAggregator", "MaxAggregator"};
+  for (const char* strategy : strategies) {
+    AggregatingRequest req("movie", strategy);
+    AggregatingResponse res;
+    req.Set(ids.data(), segment_ids.data(), ids.size(), num_segments);
+
+    Operator* op = OpFactory::GetInstance()->Create(req.Name());
+    EXPECT_TRUE(op != nullptr);
+    EXPECT_TRUE(op->Process(&req, &res).ok());
+    ASSERT_EQ(res.NumSegments(), num_segments);
+
+    const float* embs = res.Embeddings();
+    const int32_t* segments = res.Segments();
+    bool is_sum = std::string(strategy) == "SumAggregator";
+    for (int32_t j = 0; j < num_segments; ++j) {
+      EXPECT_EQ(segments[j], j % 20);
+      float expected = is_sum ? 0.0 : FLT_MIN_10_EXP;
+      for (int32_t i = 0; i < j % 20; ++i) {
+        int64_t id = (j * 7 + i * 13) % 110;
+        float value = id < 100 ? float(id) : 0.0;
+        expected = is_sum ? expected + value : std::max(expected, value);
+      }
+      if (j % 20 == 0) {
+        expected = GLOBAL_FLAG(DefaultFloatAttribute);
+      }
+      EXPECT_FLOAT_EQ(embs[j], expected);
+    }
+  }
+}
+
+TEST_F(AggregationOpTest, PartialRequest) {
+  const char* a_file = "a_node_file";
+  GenNodeTestData(a_file, kAttributed);
+
+  std::vector<NodeSource> node_source(1);
+  GenNodeSource(&node_source[0], kAttributed, a_file, "movie");
+
+  std::vector<EdgeSource> edge_source;
+  GraphStore store(Env::Default());
+  ::graphlearn::op::OpFactory::GetInstance()->Set(&store);
+
+  Status s = store.Load(edge_source, node_source);
+  EXPECT_TRUE(s.ok());
+
+  // Segments 1 and 3 are empty.
+  int64_t ids[5] = {1, 2, 3, 4, 5};
+  int32_t segment_ids[5] = {0, 0, 2, 2, 2};
+  AggregatingRequest req("movie", "MeanAggregator");
+  req.Set(ids, segment_ids, 5, 4);
+  req.SetPartial();
+
+  // A shard returns the sums of the non-empty segments, not the means.
+  AggregatingResponse res;
+  Operator* op = OpFactory::GetInstance()->Create(req.Name());
+  EXPECT_TRUE(op != nullptr);
+  EXPECT_TRUE(op->Process(&req, &res).ok());
+
+  EXPECT_TRUE(res.IsPartial());
+  EXPECT_EQ(res.NumSegments(), 4);
+  ASSERT_EQ(res.NumPartials(), 2);
+  EXPECT_EQ(res.SegmentIds()[0], 0);
+  EXPECT_EQ(res.SegmentIds()[1], 2);
+  EXPECT_EQ(res.Segments()[0], 2);
+  EXPECT_EQ(res.Segments()[1], 3);
+  EXPECT_FLOAT_EQ(res.Embeddings()[0], 3.0);
+  EXPECT_FLOAT_EQ(res.Embeddings()[1], 12.0);
+}
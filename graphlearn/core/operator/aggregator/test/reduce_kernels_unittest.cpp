@@ -0,0 +1,133 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "graphlearn/core/operator/aggregator/reduce_kernels.h"
+#include "gtest/gtest.h"
+
+using namespace graphlearn::op;  // NOLINT [build/namespaces]
+
+namespace {
+
+float Apply(ReduceType type, float a, float b) {
+  switch (type) {
+  case kReduceSum:
+    return a + b;
+  case kReduceMax:
+    return std::max(a, b);
+  case kReduceMin:
+    return std::min(a, b);
+  default:
+    return a * b;
+  }
+}
+
+}  // anonymous namespace
+
+TEST(ReduceKernelsTest, AllLevels) {
+  ReduceType types[] = {kReduceSum, kReduceMax, kReduceMin, kReduceProd};
+  int32_t dims[] = {1, 7, 8, 15, 16, 17, 33, 100};
+  int32_t nums[] = {0, 1, 2, 3, 5, 64};
+  // The levels beyond the supported one fall back to it.
+  for (int32_t level = kSimdScalar; level <= kSimdAvx512; ++level) {
+    for (ReduceType type : types) {
+      for (int32_t dim : dims) {
+        for (int32_t num : nums) {
+          // Values around 1, so that the products stay in range.
+          std::vector<float> rows(num * dim);
+          for (size_t i = 0; i < rows.size(); ++i) {
+            rows[i] = 1.0 + (static_cast<int32_t>(i * 37 % 11) - 5) / 64.0;
+          }
+          std::vector<float> expected(dim);
+          for (int32_t j = 0; j < dim; ++j) {
+            expected[j] = 0.5 + j;
+          }
+          std::vector<float> out(expected);
+          // A guard after the output, which must not be touched.
+          out.push_back(-1.0);
+          for (int32_t r = 0; r < num; ++r) {
+            for (int32_t j = 0; j < dim; ++j) {
+              expected[j] = Apply(type, expected[j], rows[r * dim + j]);
+            }
+          }
+
+          ReduceRows(type, rows.data(), num, dim, out.data(),
+                     static_cast<SimdLevel>(level));
+          for (int32_t j = 0; j < dim; ++j) {
+            EXPECT_NEAR(out[j], expected[j], 1e-4 * std::abs(expected[j]))
+              << "level " << level << " type " << type
+              << " dim " << dim << " num " << num;
+          }
+          EXPECT_EQ(out[dim], -1.0);
+        }
+      }
+    }
+  }
+}
+
+TEST(ReduceKernelsTest, NaN) {
+  ReduceType types[] = {kReduceMax, kReduceMin};
+  int32_t dims[] = {1, 8, 17, 33};
+  int32_t nums[] = {1, 2, 3, 5};
+  float nan = std::numeric_limits<float>::quiet_NaN();
+  for (int32_t level = kSimdScalar; level <= SupportedSimdLevel(); ++level) {
+    for (ReduceType type : types) {
+      for (int32_t dim : dims) {
+        for (int32_t num : nums) {
+          // A NaN in each of the rows, or in the initial values, is kept
+          // whichever accumulator it goes to.
+          for (int32_t k = -1; k < num; ++k) {
+            std::vector<float> rows(num * dim);
+            for (size_t i = 0; i < rows.size(); ++i) {
+              rows[i] = static_cast<float>(i % 7);
+            }
+            std::vector<float> out(dim, 3.0);
+            int32_t col = dim / 2;
+            if (k < 0) {
+              out[col] = nan;
+            } else {
+              rows[k * dim + col] = nan;
+            }
+
+            ReduceRows(type, rows.data(), num, dim, out.data(),
+                       static_cast<SimdLevel>(level));
+            for (int32_t j = 0; j < dim; ++j) {
+              EXPECT_EQ(std::isnan(out[j]), j == col)
+                << "level " << level << " type " << type
+                << " dim " << dim << " num " << num << " row " << k;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(ReduceKernelsTest, Default) {
+  float rows[] = {1, 5, 3, 2, 4, 6};
+  float out[] = {0, 0};
+  ReduceRows(kReduceSum, rows, 3, 2, out);
+  EXPECT_FLOAT_EQ(out[0], 8);
+  EXPECT_FLOAT_EQ(out[1], 13);
+  ReduceRows(kReduceMax, rows, 3, 2, out);
+  EXPECT_FLOAT_EQ(out[0], 8);
+  EXPECT_FLOAT_EQ(out[1], 13);
+  ReduceRows(kReduceMin, rows, 3, 2, out);
+  EXPECT_FLOAT_EQ(out[0], 1);
+  EXPECT_FLOAT_EQ(out[1], 2);
+}
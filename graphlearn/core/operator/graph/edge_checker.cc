@@ -0,0 +1,89 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <memory>
+#include "graphlearn/common/base/errors.h"
+#include "graphlearn/common/base/log.h"
+#include "graphlearn/core/graph/graph_store.h"
+#include "graphlearn/core/graph/storage/graph_storage.h"
+#include "graphlearn/core/graph/storage/sorted_neighbors.h"
+#include "graphlearn/core/operator/operator.h"
+#include "graphlearn/core/operator/op_registry.h"
+#include "graphlearn/include/graph_request.h"
+#include "graphlearn/include/client.h"
+
+namespace graphlearn {
+namespace op {
+
+class EdgeChecker : public RemoteOperator {
+public:
+  virtual ~EdgeChecker() = default;
+
+  Status Process(const OpRequest* req,
+                 OpResponse* res) override {
+    const CheckEdgesRequest* request =
+      static_cast<const CheckEdgesRequest*>(req);
+    CheckEdgesResponse* response =
+      static_cast<CheckEdgesResponse*>(res);
+
+    Graph* graph = graph_store_->GetGraph(request->EdgeType());
+    if (!graph) {
+      LOG(ERROR) << "Edge type " << request->EdgeType() << " not existed.";
+      return error::NotFound("Edge type not found.");
+    }
+
+    ::graphlearn::io::GraphStorage* storage = graph->GetLocalStorage();
+    const int64_t* src_ids = request->GetSrcIds();
+    const int64_t* dst_ids = request->GetDstIds();
+    int32_t batch_size = request->BatchSize();
+    response->InitExists(batch_size);
+    for (int32_t i = 0; i < batch_size; ++i) {
+      response->AppendExists(Exists(storage, src_ids[i], dst_ids[i]));
+    }
+    return Status::OK();
+  }
+
+  Status Call(int32_t remote_id,
+              const OpRequest* req,
+              OpResponse* res) override {
+    const CheckEdgesRequest* request =
+      static_cast<const CheckEdgesRequest*>(req);
+    CheckEdgesResponse* response =
+      static_cast<CheckEdgesResponse*>(res);
+    std::unique_ptr<Client> client(NewRpcClient(remote_id));
+    return client->CheckEdges(request, response);
+  }
+
+private:
+  bool Exists(::graphlearn::io::GraphStorage* storage,
+              int64_t src_id, int64_t dst_id) {
+    auto sorted = storage->GetSortedNeighbors(src_id);
+    if (sorted) {
+      return ::graphlearn::io::ContainsSorted(sorted, dst_id);
+    }
+    auto nbr_ids = storage->GetNeighbors(src_id);
+    for (int32_t i = 0; i < nbr_ids.Size(); ++i) {
+      if (nbr_ids[i] == dst_id) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+REGISTER_OPERATOR("CheckEdges", EdgeChecker);
+
+}  // namespace op
+}  // namespace graphlearn
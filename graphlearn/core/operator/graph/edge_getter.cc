@@ -15,9 +15,9 @@ limitations under the License.
 
 #include <algorithm>
 #include <memory>
-#include <random>
 #include <unordered_map>
 #include "graphlearn/common/base/errors.h"
+#include "graphlearn/common/base/random.h"
 #include "graphlearn/common/threading/sync/lock.h"
 #include "graphlearn/core/graph/graph_store.h"
 #include "graphlearn/core/graph/storage/graph_storage.h"
@@ -100,23 +100,18 @@ protected:
 class RandomGenerator : public Generator {
 public:
   explicit RandomGenerator(::graphlearn::io::GraphStorage* storage)
-      : Generator(storage), dist_(0, edge_count_ - 1) {
+      : Generator(storage) {
   }
   virtual ~RandomGenerator() = default;
 
   bool Next(::graphlearn::io::IdType* src_id,
             ::graphlearn::io::IdType* dst_id,
             ::graphlearn::io::IdType* edge_id) override {
-    thread_local static std::random_device rd;
-    thread_local static std::mt19937 engine(rd());
-    *edge_id = dist_(engine);
+    *edge_id = ThreadLocalRandom()->Uniform64(edge_count_);
     *src_id = storage_->GetSrcId(*edge_id);
     *dst_id = storage_->GetDstId(*edge_id);
     return true;
   }
-
-private:
-  std::uniform_int_distribution<::graphlearn::io::IdType> dist_;
 };
 
 class OrderedGenerator : public Generator {
@@ -194,9 +189,7 @@ public:
       buffer_.emplace_back(start + i);
     }
 
-    thread_local static std::random_device rd;
-    thread_local static std::default_random_engine rng(rd());
-    std::shuffle(buffer_.begin(), buffer_.end(), rng);
+    std::shuffle(buffer_.begin(), buffer_.end(), *ThreadLocalRandom());
   }
 
 private:
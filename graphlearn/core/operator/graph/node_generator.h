@@ -18,9 +18,9 @@ limitations under the License.
 
 #include <algorithm>
 #include <memory>
-#include <random>
 #include <unordered_map>
 
+#include "graphlearn/common/base/random.h"
 #include "graphlearn/common/threading/sync/lock.h"
 #include "graphlearn/core/operator/utils/storage_wrapper.h"
 #include "graphlearn/include/config.h"
@@ -110,20 +110,14 @@ protected:
 class RandomGenerator : public Generator {
 public:
   explicit RandomGenerator(StorageWrapper* storage)
-      : Generator(storage), dist_(0, ids_->size() - 1) {
+      : Generator(storage) {
   }
   virtual ~RandomGenerator() = default;
 
   bool Next(::graphlearn::io::IdType* ret) override {
-    thread_local static std::random_device rd;
-    thread_local static std::mt19937 engine(rd());
-    int32_t rand = dist_(engine);
-    *ret = (*ids_)[rand];
+    *ret = (*ids_)[ThreadLocalRandom()->Uniform64(ids_->size())];
     return true;
   }
-
-private:
-  std::uniform_int_distribution<int32_t> dist_;
 };
 
 class OrderedGenerator : public Generator {
@@ -192,9 +186,7 @@ public:
       buffer_.emplace_back((*ids)[start + i]);
     }
 
-    thread_local static std::random_device rd;
-    thread_local static std::default_random_engine rng(rd());
-    std::shuffle(buffer_.begin(), buffer_.end(), rng);
+    std::shuffle(buffer_.begin(), buffer_.end(), *ThreadLocalRandom());
   }
 
 private:
@@ -18,7 +18,6 @@ limitations under the License.
 #include <algorithm>
 #include <cstdlib>
 #include <numeric>
-#include <random>
 #include <unordered_set>
 
 namespace graphlearn {
@@ -106,22 +105,88 @@ void AliasMethod::Build(const std::vector<float>* dist) {
   }
 }
 
-bool AliasMethod::Sample(int32_t num, int32_t* ret) {
+bool AliasMethod::Sample(int32_t num, int32_t* ret, PhiloxRandom* rng) {
   if (range_ == 0) {
     return false;
   }
 
-  thread_local static std::random_device rd;
-  thread_local static std::mt19937 engine(rd());
-
-  std::uniform_real_distribution<> generator(0, range_ - 1);
+  if (rng == nullptr) {
+    rng = ThreadLocalRandom();
+  }
   for (int32_t i = 0; i < num; i++) {
-    float rand = generator(engine);
-    int32_t idx = static_cast<int32_t>(rand);
-    ret[i] = (probs_[idx] <= (rand - idx)) ? alias_[idx] : idx;
+    int32_t idx = rng->Uniform(range_);
+    ret[i] = (probs_[idx] <= rng->UniformFloat()) ? alias_[idx] : idx;
+  }
+  return true;
+}
+
+bool SampleFromCdf(const io::Array<double>& cdf, int32_t num, int32_t* ret,
+                   PhiloxRandom* rng) {
+  int32_t size = cdf.Size();
+  if (size == 0) {
+    return false;
+  }
+
+  if (rng == nullptr) {
+    rng = ThreadLocalRandom();
+  }
+  double total = cdf[size - 1];
+  if (total <= 0) {
+    rng->Uniform(size, num, ret);
+    return true;
+  }
+
+  for (int32_t i = 0; i < num; ++i) {
+    double rand = rng->UniformDouble() * total;
+    // The first one whose cumulative weight is greater than rand, which
+    // skips the zero weights.
+    int32_t low = 0;
+    int32_t high = size - 1;
+    while (low < high) {
+      int32_t mid = low + (high - low) / 2;
+      if (cdf[mid] > rand) {
+        high = mid;
+      } else {
+        low = mid + 1;
+      }
+    }
+    ret[i] = low;
   }
   return true;
 }
 
+AliasMethodFactory::AliasMethodFactory()
+    : registry_(new Registry(kKindNum)) {
+}
+
+std::shared_ptr<AliasMethod> AliasMethodFactory::Lookup(
+    Kind kind, const std::string& type, int64_t version) const {
+  std::shared_ptr<const Registry> registry = std::atomic_load(&registry_);
+  const auto& tables = (*registry)[kind];
+  auto it = tables.find(type);
+  if (it != tables.end() && it->second.version == version) {
+    return it->second.am;
+  }
+  return nullptr;
+}
+
+std::shared_ptr<AliasMethod> AliasMethodFactory::Create(
+    Kind kind, const std::string& type, int64_t version,
+    const std::function<AliasMethod*()>& build) {
+  ScopedLocker<std::mutex> _(&mtx_);
+  // Another thread may have built it while waiting for the lock.
+  std::shared_ptr<AliasMethod> am = Lookup(kind, type, version);
+  if (am) {
+    return am;
+  }
+
+  am.reset(build());
+  std::shared_ptr<Registry> registry(
+    new Registry(*std::atomic_load(&registry_)));
+  (*registry)[kind][type] = Entry{version, am};
+  std::atomic_store(&registry_, std::shared_ptr<const Registry>(registry));
+  return am;
+}
+
 }  // namespace op
 }  // namespace graphlearn
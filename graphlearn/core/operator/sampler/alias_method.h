@@ -16,10 +16,13 @@ limitations under the License.
 #ifndef GRAPHLEARN_CORE_OPERATOR_SAMPLER_ALIAS_METHOD_H_
 #define GRAPHLEARN_CORE_OPERATOR_SAMPLER_ALIAS_METHOD_H_
 
+#include <functional>
+#include <memory>
 #include <mutex>  // NOLINT [build/c++11]
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include "graphlearn/common/base/random.h"
 #include "graphlearn/common/threading/sync/lock.h"
 #include "graphlearn/core/graph/storage/types.h"
 
@@ -35,7 +38,8 @@ public:
   AliasMethod(const AliasMethod& rhs);
   AliasMethod& operator=(const AliasMethod& rhs);
 
-  bool Sample(int32_t num, int32_t* ret);
+  /// Draw with the generator of the current thread if `rng` is null.
+  bool Sample(int32_t num, int32_t* ret, PhiloxRandom* rng = nullptr);
 
 private:
   void Build(const std::vector<float>* dist);
@@ -46,60 +50,93 @@ private:
   std::vector<float>   probs_;
 };
 
+/// Draw `num` indices from the cumulative weights of a distribution, such
+/// as a row of io::SamplingTable, by binary searching. Draw uniformly if
+/// all the weights are 0. Return false for an empty distribution.
+bool SampleFromCdf(const io::Array<double>& cdf, int32_t num, int32_t* ret,
+                   PhiloxRandom* rng = nullptr);
+
+/// A registry of the alias tables of the distributions over all the nodes
+/// of a type, such as the in-degrees for negative sampling. Lookups are
+/// lock-free on an immutable snapshot of the registry, and only building a
+/// table takes the lock and publishes a new snapshot. A table is rebuilt
+/// once the storage it comes from gets a new version, while the requests
+/// still holding the old one keep it alive.
 class AliasMethodFactory {
 public:
+  /// The namespaces of the keys, so that the different distributions over
+  /// the same type never share a table.
+  enum Kind {
+    kInDegree = 0,
+    kNodeWeight = 1,
+    kUniform = 2,
+    kKindNum = 3
+  };
+
   static AliasMethodFactory* GetInstance() {
     static AliasMethodFactory factory;
     return &factory;
   }
-  
+
+  /// `version` is from GetVersion() of the storage that `weights` belong to.
   template<class T>
-  AliasMethod* LookupOrCreate(const std::string& type, 
+  std::shared_ptr<AliasMethod> LookupOrCreate(Kind kind,
+      const std::string& type, int64_t version,
       const std::vector<T>* weights) {
-    ScopedLocker<std::mutex> _(&mtx_);
-    auto it = map_.find(type);
-    if (it == map_.end()) {
-      std::vector<float> tmp_w(weights->begin(), weights->end());
-      auto am = new AliasMethod(&tmp_w);
-      map_[type] = am;
-      return am;
-    } else {
-      return it->second;
-    }                          
+    std::shared_ptr<AliasMethod> am = Lookup(kind, type, version);
+    if (!am) {
+      am = Create(kind, type, version, [weights] {
+        std::vector<float> tmp_w(weights->begin(), weights->end());
+        return new AliasMethod(&tmp_w);
+      });
+    }
+    return am;
   }
 
-  inline AliasMethod* LookupOrCreate(const std::string& type, 
+  std::shared_ptr<AliasMethod> LookupOrCreate(Kind kind,
+      const std::string& type, int64_t version,
       const std::vector<float>* weights) {
-    ScopedLocker<std::mutex> _(&mtx_);
-    auto it = map_.find(type);
-    if (it == map_.end()) {
-      auto am = new AliasMethod(weights);
-      map_[type] = am;
-      return am;
-    } else {
-      return it->second;
-    }   
+    std::shared_ptr<AliasMethod> am = Lookup(kind, type, version);
+    if (!am) {
+      am = Create(kind, type, version, [weights] {
+        return new AliasMethod(weights);
+      });
+    }
+    return am;
   }
 
-  inline AliasMethod* LookupOrCreate(const std::string& type, 
+  std::shared_ptr<AliasMethod> LookupOrCreate(Kind kind,
+      const std::string& type, int64_t version,
       int32_t uniform_max) {
-    ScopedLocker<std::mutex> _(&mtx_);
-    auto it = map_.find(type);
-    if (it == map_.end()) {
-      auto am = new AliasMethod(uniform_max);
-      map_[type] = am;
-      return am;
-    } else {
-      return it->second;
-    }   
+    std::shared_ptr<AliasMethod> am = Lookup(kind, type, version);
+    if (!am) {
+      am = Create(kind, type, version, [uniform_max] {
+        return new AliasMethod(uniform_max);
+      });
+    }
+    return am;
   }
 
 private:
-  AliasMethodFactory() {}
+  struct Entry {
+    int64_t version;
+    std::shared_ptr<AliasMethod> am;
+  };
+  typedef std::vector<std::unordered_map<std::string, Entry>> Registry;
+
+  AliasMethodFactory();
+
+  /// Null if missing or stale.
+  std::shared_ptr<AliasMethod> Lookup(Kind kind, const std::string& type,
+                                      int64_t version) const;
+  std::shared_ptr<AliasMethod> Create(Kind kind, const std::string& type,
+      int64_t version, const std::function<AliasMethod*()>& build);
 
 private:
+  // Read by std::atomic_load(), and replaced by std::atomic_store() with
+  // a modified copy under mtx_.
+  std::shared_ptr<const Registry> registry_;
   std::mutex mtx_;
-  std::unordered_map<std::string, AliasMethod*> map_;
 };
 
 }  // namespace op
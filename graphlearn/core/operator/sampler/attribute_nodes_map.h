@@ -17,7 +17,6 @@ limitations under the License.
 #define GRAPHLEARN_CORE_OPERATOR_SAMPLER_ATTRIBUTE_NODES_MAP_H_
 
 #include <mutex>
-#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -32,13 +31,6 @@ limitations under the License.
 namespace graphlearn {
 namespace op {
 
-template<class T>
-std::string ToString(const T& item) {
-  std::stringstream ss;
-  ss << item;
-  return ss.str();
-};
-
 struct IdWeight{
   IdWeight() {}
   IdWeight(std::vector<int64_t>&& ids, std::vector<float>&& weights):
@@ -60,7 +52,9 @@ public:
               SamplingResponse* res);
 private:
   std::unordered_map<AttrType, IdWeight> attr_id_weights_;
-  std::unordered_map<AttrType, AliasMethod*> attr_am_;
+  // Owned by each map, since the same attribute value of another column
+  // or type has its own distribution.
+  std::unordered_map<AttrType, AliasMethod> attr_am_;
 };
 
 template<class AttrType>
@@ -80,11 +74,8 @@ void AttributeNodesMap<AttrType>::Insert(
 template<class AttrType>
 void AttributeNodesMap<AttrType>::CreateAM() {
   for (const auto& item : attr_id_weights_) {
-    AliasMethodFactory* factory = AliasMethodFactory::GetInstance();
-    const std::string& name = ToString<>(item.first);
-    AliasMethod* am = factory->LookupOrCreate(name, &(item.second.weights_));
     if (attr_am_.find(item.first) == attr_am_.end()) {
-      attr_am_.emplace(item.first, am);
+      attr_am_.emplace(item.first, AliasMethod(&(item.second.weights_)));
     }
   }
 }
@@ -101,7 +92,7 @@ void AttributeNodesMap<AttrType>::Sample(
   auto iter = attr_am_.find(attr);
   // when there is no this attr at all, just skip
   if (iter == attr_am_.end()) return;
-  AliasMethod* am = iter->second;
+  AliasMethod* am = &(iter->second);
   int32_t count = 0;
   int32_t cursor = 0;
   while (count < num && retry_times > 0) {
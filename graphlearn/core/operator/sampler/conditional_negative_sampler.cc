@@ -58,14 +58,14 @@ public:
         (strategy == "node_weight") ? NodeFrom::kNode : NodeFrom::kEdgeDst;
     StorageWrapper storage = StorageWrapper(node_from, type, graph_store_);
     ConditionTable* ct = nullptr;
-    AliasMethod* am = nullptr;  // default method.
+    std::shared_ptr<AliasMethod> am;  // default method.
     CreateConditionTable(type, dst_node_type, selected_cols,
         strategy, &storage, &ct, &am);
     RETURN_IF_NOT_OK(ct->GetStatus())
     // Get attributes of input dst ids as sampling condition.
     GetNodeAttributesWrapper attr_wrapper(dst_node_type, dst_ids, batch_size);
     RETURN_IF_NOT_OK(attr_wrapper.GetStatus())
-    SampleAndFill(request, &storage, &attr_wrapper, ct, am, res);
+    SampleAndFill(request, &storage, &attr_wrapper, ct, am.get(), res);
     return Status::OK();
   }
 
@@ -76,23 +76,27 @@ private:
       const std::string& strategy,
       StorageWrapper* storage,
       ConditionTable** ct,
-      AliasMethod** am) {
+      std::shared_ptr<AliasMethod>* am) {
     auto ids = storage->GetIds();
     ConditionTableFactory* ct_factory = ConditionTableFactory::GetInstance();
     AliasMethodFactory* am_factory = AliasMethodFactory::GetInstance();
+    int64_t version = storage->GetVersion();
     if (strategy == "in_degree") {
       auto weights = storage->GetAllInDegrees();
       *ct = ct_factory->LookupOrCreate(type, id_type, selected_cols,
                                        *ids, *weights);
-      *am = am_factory->LookupOrCreate(type, weights);
+      *am = am_factory->LookupOrCreate(AliasMethodFactory::kInDegree, type,
+                                       version, weights);
     } else if (strategy == "node_weight"){
       auto weights = storage->GetNodeWeights();
       *ct = ct_factory->LookupOrCreate(type, id_type, selected_cols,
                                        *ids, *weights);
-      *am = am_factory->LookupOrCreate(type, weights);
+      *am = am_factory->LookupOrCreate(AliasMethodFactory::kNodeWeight, type,
+                                       version, weights);
     } else {  // random as default.
       *ct = ct_factory->LookupOrCreate(type, id_type, selected_cols, *ids);
-      *am = am_factory->LookupOrCreate(type, ids->size());
+      *am = am_factory->LookupOrCreate(AliasMethodFactory::kUniform, type,
+                                       version, ids->size());
     }
   }
 
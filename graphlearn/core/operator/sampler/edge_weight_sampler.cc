@@ -29,8 +29,15 @@ public:
 
   Status Sample(const SamplingRequest* req,
                 SamplingResponse* res) override {
+    return ParallelSample(req, res);
+  }
+
+protected:
+  Status SampleRange(const SamplingRequest* req,
+                     int32_t begin, int32_t end,
+                     SamplingResponse* res) override {
     int32_t count = req->NeighborCount();
-    int32_t batch_size = req->BatchSize();
+    int32_t batch_size = end - begin;
 
     res->SetBatchSize(batch_size);
     res->SetNeighborCount(count);
@@ -46,14 +53,21 @@ public:
     const int64_t* src_ids = req->GetSrcIds();
     const int64_t* filters = req->GetFilters();
     Status s;
-    for (int32_t i = 0; i < batch_size; ++i) {
+    for (int32_t i = begin; i < end; ++i) {
       int64_t src_id = src_ids[i];
-      auto neighbor_ids = storage->GetNeighbors(src_id);
+      auto neighbor_ids = GetNeighbors(req, storage, src_id);
       if (!neighbor_ids) {
         res->FillWith(GLOBAL_FLAG(DefaultNeighborId), -1);
       } else {
-        auto edge_ids = storage->GetOutEdges(src_id);
-        SampleFrom(edge_ids, storage, count, indices.data());
+        auto edge_ids = GetEdges(req, storage, src_id);
+        auto table = req->IsReversed() ? ::graphlearn::io::Array<double>()
+                                       : storage->GetEdgeWeightTable(src_id);
+        PhiloxRandom rng = GetRandom(req, i);
+        if (table) {
+          SampleFromCdf(table, count, indices.data(), &rng);
+        } else {
+          SampleFrom(edge_ids, storage, count, indices.data(), &rng);
+        }
         auto padder = GetPadder(neighbor_ids, edge_ids);
         padder->SetIndex(indices);
         if (filters) {
@@ -71,7 +85,7 @@ public:
 private:
   void SampleFrom(const ::graphlearn::io::IdArray& edge_ids,
                   ::graphlearn::io::GraphStorage* storage,
-                  int32_t n, int32_t* indices) {
+                  int32_t n, int32_t* indices, PhiloxRandom* rng) {
     std::vector<float> edge_weights;
     edge_weights.reserve(edge_ids.Size());
     for (size_t i = 0; i < edge_ids.Size(); ++i) {
@@ -80,7 +94,7 @@ private:
     }
 
     AliasMethod am(&edge_weights);
-    am.Sample(n, indices);
+    am.Sample(n, indices, rng);
   }
 };
 
@@ -28,7 +28,14 @@ public:
 
   Status Sample(const SamplingRequest* req,
                 SamplingResponse* res) override {
-    int32_t batch_size = req->BatchSize();
+    return ParallelSample(req, res);
+  }
+
+protected:
+  Status SampleRange(const SamplingRequest* req,
+                     int32_t begin, int32_t end,
+                     SamplingResponse* res) override {
+    int32_t batch_size = end - begin;
     int32_t max_limit_size = req->NeighborCount();
 
     res->SetSparseFlag();
@@ -42,10 +49,10 @@ public:
 
     int32_t sum_degree = 0;
     const int64_t* src_ids = req->GetSrcIds();
-    for (int64_t i = 0; i < batch_size; ++i) {
+    for (int64_t i = begin; i < end; ++i) {
       int64_t src_id = src_ids[i];
-      auto neighbor_ids = storage->GetNeighbors(src_id);
-      auto edge_ids = storage->GetOutEdges(src_id);
+      auto neighbor_ids = GetNeighbors(req, storage, src_id);
+      auto edge_ids = GetEdges(req, storage, src_id);
       if (neighbor_ids && edge_ids) {
         if (neighbor_ids.Size() != edge_ids.Size()) {
           LOG(FATAL) << "Inconsistent size of neighbors and edges.";
@@ -66,10 +73,10 @@ public:
 
     Status s;
     const int64_t* filters = req->GetFilters();
-    for (int32_t i = 0; i < batch_size; ++i) {
+    for (int32_t i = begin; i < end; ++i) {
       int64_t src_id = src_ids[i];
-      auto neighbor_ids = storage->GetNeighbors(src_id);
-      auto edge_ids = storage->GetOutEdges(src_id);
+      auto neighbor_ids = GetNeighbors(req, storage, src_id);
+      auto edge_ids = GetEdges(req, storage, src_id);
       if (neighbor_ids) {
         auto padder = GetPadder(neighbor_ids, edge_ids);
         if (filters) {
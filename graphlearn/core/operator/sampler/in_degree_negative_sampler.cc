@@ -13,9 +13,10 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <memory>
-#include <unordered_set>
 #include "graphlearn/common/base/log.h"
+#include "graphlearn/core/graph/storage/sorted_neighbors.h"
 #include "graphlearn/core/operator/sampler/alias_method.h"
 #include "graphlearn/core/operator/sampler/sampler.h"
 #include "graphlearn/include/config.h"
@@ -25,6 +26,26 @@ namespace op {
 
 namespace {
 const int32_t kRetryTimes = 3;
+
+// The neighbors in ascending order, from the sorted copy of the storage
+// if any, otherwise sorted into the buffer reused for each source node.
+::graphlearn::io::IdArray GetSortedNeighbors(
+    ::graphlearn::io::GraphStorage* storage,
+    int64_t src_id,
+    ::graphlearn::io::IdList* buffer) {
+  auto sorted = storage->GetSortedNeighbors(src_id);
+  if (sorted) {
+    return sorted;
+  }
+  auto nbr_ids = storage->GetNeighbors(src_id);
+  buffer->clear();
+  for (int32_t k = 0; k < nbr_ids.Size(); ++k) {
+    buffer->push_back(nbr_ids[k]);
+  }
+  std::sort(buffer->begin(), buffer->end());
+  return ::graphlearn::io::IdArray(*buffer);
+}
+
 }  // anonymous space
 
 class InDegreeNegativeSampler : public Sampler {
@@ -33,32 +54,39 @@ public:
 
   Status Sample(const SamplingRequest* req,
                 SamplingResponse* res) override {
+    return ParallelSample(req, res);
+  }
+
+protected:
+  Status SampleRange(const SamplingRequest* req,
+                     int32_t begin, int32_t end,
+                     SamplingResponse* res) override {
     int32_t count = req->NeighborCount();
-    int32_t batch_size = req->BatchSize();
+    int32_t batch_size = end - begin;
 
     res->SetBatchSize(batch_size);
     res->SetNeighborCount(count);
     res->InitEdgeIds(batch_size * count);
     res->InitNeighborIds(batch_size * count);
 
-    const int64_t* src_ids = req->GetSrcIds();
     const std::string& edge_type = req->Type();
     Graph* graph = graph_store_->GetGraph(edge_type);
     auto storage = graph->GetLocalStorage();
 
-    AliasMethod* am = CreateAM(edge_type, storage);
-    SampleAndFill(storage, src_ids, batch_size, count, am, res);
+    std::shared_ptr<AliasMethod> am = CreateAM(edge_type, storage);
+    SampleAndFill(req, storage, begin, end, count, am.get(), res);
 
     return Status::OK();
   }
 
-protected:
-  virtual void SampleAndFill(::graphlearn::io::GraphStorage* storage,
-                             const int64_t* src_ids,
-                             int32_t batch_size,
+  virtual void SampleAndFill(const SamplingRequest* req,
+                             ::graphlearn::io::GraphStorage* storage,
+                             int32_t begin,
+                             int32_t end,
                              int32_t n,
                              AliasMethod* am,
                              SamplingResponse* res) {
+    const int64_t* src_ids = req->GetSrcIds();
     std::unique_ptr<int32_t[]> indices(new int32_t[n]);
     auto dst_ids = storage->GetAllDstIds();
     if (!dst_ids) {
@@ -66,32 +94,30 @@ protected:
       res->FillWith(GLOBAL_FLAG(DefaultNeighborId), -1);
       return;
     }
-    for (int32_t i = 0; i < batch_size; ++i) {
-      auto nbr_ids = storage->GetNeighbors(src_ids[i]);
-
-      std::unordered_set<int64_t> sets;
-      for (int32_t k = 0; k < nbr_ids.Size(); ++k) {
-        sets.insert(nbr_ids[k]);
-      }
+    ::graphlearn::io::IdList buffer;
+    for (int32_t i = begin; i < end; ++i) {
+      auto nbr_ids = GetSortedNeighbors(storage, src_ids[i], &buffer);
+      PhiloxRandom rng = GetRandom(req, i);
 
+      bool strict = true;
       int32_t count = 0;
       int32_t cursor = 0;
       int32_t retry_times = kRetryTimes + 1;
       while (count < n && retry_times >= 0) {
         cursor %= n;
         if (cursor == 0) {
-          am->Sample(n, indices.get());
+          am->Sample(n, indices.get(), &rng);
           if (--retry_times <= 0) {
             // After trying RetryTimes, the nbr_ids' size is still
             // less than nbr_count, we should fill nbr_ids with random dst
             // node ids and no longer strictly guarantee the negative ids
             // are true negative.
-            sets.clear();
+            strict = false;
           }
         }
 
         int64_t item = dst_ids->at(indices[cursor++]);
-        if (sets.find(item) == sets.end()) {
+        if (!strict || !::graphlearn::io::ContainsSorted(nbr_ids, item)) {
           res->AppendNeighborId(item);
           ++count;
         }
@@ -100,11 +126,13 @@ protected:
   }
 
 private:
-  AliasMethod* CreateAM(const std::string& type,
-                        ::graphlearn::io::GraphStorage* storage) {
+  std::shared_ptr<AliasMethod> CreateAM(
+      const std::string& type,
+      ::graphlearn::io::GraphStorage* storage) {
     AliasMethodFactory* factory = AliasMethodFactory::GetInstance();
     auto in_degrees = storage->GetAllInDegrees();
-    return factory->LookupOrCreate(type, in_degrees);
+    return factory->LookupOrCreate(AliasMethodFactory::kInDegree, type,
+                                   storage->GetVersion(), in_degrees);
   }
 };
 
@@ -113,16 +141,18 @@ public:
   virtual ~SoftInDegreeNegativeSampler() = default;
 
 protected:
-  void SampleAndFill(::graphlearn::io::GraphStorage* storage,
-                     const int64_t* src_ids,
-                     int32_t batch_size,
+  void SampleAndFill(const SamplingRequest* req,
+                     ::graphlearn::io::GraphStorage* storage,
+                     int32_t begin,
+                     int32_t end,
                      int32_t count,
                      AliasMethod* am,
                      SamplingResponse* res) override {
     std::unique_ptr<int32_t[]> indices(new int32_t[count]);
     auto dst_ids = storage->GetAllDstIds();
-    for (int32_t i = 0; i < batch_size; ++i) {
-      am->Sample(count, indices.get());
+    for (int32_t i = begin; i < end; ++i) {
+      PhiloxRandom rng = GetRandom(req, i);
+      am->Sample(count, indices.get(), &rng);
       for (int32_t j = 0; j < count; ++j) {
         int32_t idx = indices[j];
         res->AppendNeighborId((*dst_ids)[idx]);
@@ -0,0 +1,165 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "graphlearn/common/base/errors.h"
+#include "graphlearn/common/base/log.h"
+#include "graphlearn/common/base/random.h"
+#include "graphlearn/core/graph/graph_store.h"
+#include "graphlearn/core/graph/storage/graph_storage.h"
+#include "graphlearn/core/graph/storage/id_hash_map.h"
+#include "graphlearn/core/operator/operator.h"
+#include "graphlearn/core/operator/op_registry.h"
+#include "graphlearn/core/operator/sampler/alias_method.h"
+#include "graphlearn/include/client.h"
+#include "graphlearn/include/sampling_request.h"
+
+namespace graphlearn {
+namespace op {
+
+class LayerwiseSampler : public RemoteOperator {
+public:
+  virtual ~LayerwiseSampler() {}
+
+  Status Process(const OpRequest* req,
+                 OpResponse* res) override {
+    const LayerSamplingRequest* request =
+      static_cast<const LayerSamplingRequest*>(req);
+    LayerSamplingResponse* response =
+      static_cast<LayerSamplingResponse*>(res);
+
+    Graph* graph = graph_store_->GetGraph(request->Type());
+    if (!graph) {
+      LOG(ERROR) << "Edge type " << request->Type() << " not existed.";
+      return error::NotFound("Edge type not found.");
+    }
+    ::graphlearn::io::GraphStorage* storage = graph->GetLocalStorage();
+    bool weighted = storage->GetSideInfo()->IsWeighted();
+
+    int32_t batch_size = request->BatchSize();
+    const int64_t* src_ids = request->GetSrcIds();
+    response->Init(batch_size);
+
+    // Gather the candidates with their importance, and the normalized
+    // weight of each edge to them.
+    ::graphlearn::io::IdHashMap index;
+    std::vector<int64_t> candidates;
+    std::vector<float> importance;
+    std::vector<Edge> edges;
+    std::vector<float> row_weights;
+    for (int32_t i = 0; i < batch_size; ++i) {
+      auto nbr_ids = storage->GetNeighbors(src_ids[i]);
+      auto edge_ids = storage->GetOutEdges(src_ids[i]);
+      int32_t degree = nbr_ids.Size();
+      if (degree == 0) {
+        continue;
+      }
+
+      row_weights.assign(degree, 1.0);
+      if (weighted) {
+        for (int32_t k = 0; k < degree; ++k) {
+          row_weights[k] = storage->GetEdgeWeight(edge_ids[k]);
+        }
+      }
+      float row_sum = 0.0;
+      for (int32_t k = 0; k < degree; ++k) {
+        row_sum += row_weights[k];
+      }
+      if (row_sum <= 0.0) {
+        continue;
+      }
+
+      for (int32_t k = 0; k < degree; ++k) {
+        if (index.Insert(nbr_ids[k], candidates.size())) {
+          candidates.push_back(nbr_ids[k]);
+          importance.push_back(0.0);
+        }
+        int32_t col = index.Find(nbr_ids[k]);
+        float a = row_weights[k] / row_sum;
+        importance[col] += a * a;
+        edges.push_back(Edge{i, col, edge_ids[k], a});
+      }
+    }
+
+    int32_t size = LayerShare(request);
+    if (candidates.empty() || size <= 0) {
+      return Status::OK();
+    }
+
+    // Draw the layer with replacement, and keep the distinct nodes.
+    std::vector<int32_t> draws(size);
+    PhiloxRandom rng(request->HasSeed() ? request->Seed() : NewRandomSeed());
+    AliasMethod am(&importance);
+    am.Sample(size, draws.data(), &rng);
+
+    float total = 0.0;
+    for (float w : importance) {
+      total += w;
+    }
+    std::vector<int32_t> layer_cols(candidates.size(), -1);
+    for (int32_t c : draws) {
+      if (layer_cols[c] == -1) {
+        layer_cols[c] = response->NodeCount();
+        response->AppendNode(candidates[c]);
+      }
+    }
+
+    for (const Edge& e : edges) {
+      int32_t col = layer_cols[e.col];
+      if (col != -1) {
+        float prob = importance[e.col] / total;
+        response->AppendEdge(e.row, col, e.edge_id, e.weight / prob);
+      }
+    }
+    return Status::OK();
+  }
+
+  Status Call(int32_t remote_id,
+              const OpRequest* req,
+              OpResponse* res) override {
+    const LayerSamplingRequest* request =
+      static_cast<const LayerSamplingRequest*>(req);
+    LayerSamplingResponse* response =
+      static_cast<LayerSamplingResponse*>(res);
+    std::unique_ptr<Client> client(NewRpcClient(remote_id));
+    return client->LayerSampling(request, response);
+  }
+
+private:
+  struct Edge {
+    int32_t row;
+    int32_t col;
+    int64_t edge_id;
+    float weight;
+  };
+
+  // The share of the layer size of a shard, in proportion to its number of
+  // the source ids.
+  int32_t LayerShare(const LayerSamplingRequest* req) const {
+    int32_t total = req->TotalSize();
+    if (total <= 0 || req->BatchSize() >= total) {
+      return req->LayerSize();
+    }
+    int64_t share = static_cast<int64_t>(req->LayerSize()) * req->BatchSize();
+    return static_cast<int32_t>((share + total - 1) / total);
+  }
+};
+
+REGISTER_OPERATOR("LayerwiseSampler", LayerwiseSampler);
+
+}  // namespace op
+}  // namespace graphlearn
@@ -0,0 +1,149 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <memory>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+#include "graphlearn/common/base/errors.h"
+#include "graphlearn/common/base/log.h"
+#include "graphlearn/common/base/macros.h"
+#include "graphlearn/core/operator/op_factory.h"
+#include "graphlearn/core/operator/operator.h"
+#include "graphlearn/core/operator/op_registry.h"
+#include "graphlearn/core/runner/op_runner.h"
+#include "graphlearn/include/constants.h"
+#include "graphlearn/include/sampling_request.h"
+#include "graphlearn/platform/env.h"
+
+namespace graphlearn {
+namespace op {
+
+/// Expand all the hops of a MultiHopSamplingRequest on the server which
+/// receives it. The op runner sends the sources of each hop to the servers
+/// owning them. If the request dedups, each hop samples the distinct ids
+/// of its sources only once, and copies the samples back to every
+/// position of them.
+class MultiHopSampler : public RemoteOperator {
+public:
+  virtual ~MultiHopSampler() {}
+
+  Status Process(const OpRequest* req,
+                 OpResponse* res) override {
+    const MultiHopSamplingRequest* request =
+      static_cast<const MultiHopSamplingRequest*>(req);
+    MultiHopSamplingResponse* response =
+      static_cast<MultiHopSamplingResponse*>(res);
+
+    int32_t batch_size = request->BatchSize();
+    int32_t hop_num = request->HopNum();
+    response->Init(batch_size, hop_num);
+
+    const int64_t* src_ids = request->GetSrcIds();
+    std::vector<int64_t> frontier(src_ids, src_ids + batch_size);
+    for (int32_t hop = 0; hop < hop_num; ++hop) {
+      Status s = SampleHop(request, hop, frontier, response);
+      RETURN_IF_NOT_OK(s);
+      response->FinishHop();
+
+      const int64_t* nbr_ids = response->GetNeighborIds(hop);
+      frontier.assign(nbr_ids, nbr_ids + response->NeighborCount(hop));
+    }
+    return Status::OK();
+  }
+
+  Status Call(int32_t remote_id,
+              const OpRequest* req,
+              OpResponse* res) override {
+    return Process(req, res);
+  }
+
+private:
+  Status SampleHop(const MultiHopSamplingRequest* req,
+                   int32_t hop,
+                   const std::vector<int64_t>& src_ids,
+                   MultiHopSamplingResponse* res) {
+    if (src_ids.empty()) {
+      return Status::OK();
+    }
+
+    // Each source is sampled at its own position, unless the request
+    // shares the samples of a distinct source among its positions.
+    const std::vector<int64_t>* sample_ids = &src_ids;
+    std::vector<int64_t> unique_ids;
+    std::vector<int32_t> positions(src_ids.size());
+    if (req->IsDedup()) {
+      unique_ids.reserve(src_ids.size());
+      std::unordered_map<int64_t, int32_t> index(src_ids.size());
+      for (size_t i = 0; i < src_ids.size(); ++i) {
+        auto it = index.emplace(src_ids[i], unique_ids.size());
+        if (it.second) {
+          unique_ids.push_back(src_ids[i]);
+        }
+        positions[i] = it.first->second;
+      }
+      sample_ids = &unique_ids;
+    } else {
+      std::iota(positions.begin(), positions.end(), 0);
+    }
+
+    const std::string& strategy = req->HopStrategy(hop);
+    SamplingRequest sampling_req(
+      req->HopType(hop), strategy, req->HopNeighborCount(hop));
+    if (req->HasSeed()) {
+      sampling_req.SetSeed(req->Seed() + hop);
+    }
+    sampling_req.Set(sample_ids->data(), sample_ids->size());
+    SamplingResponse sampling_res;
+
+    Operator* op = OpFactory::GetInstance()->Create(strategy);
+    if (op == nullptr) {
+      LOG(ERROR) << "No supported sampler: " << strategy;
+      return error::InvalidArgument("No supported sampler: %s",
+                                    strategy.c_str());
+    }
+    std::unique_ptr<OpRunner> runner = GetOpRunner(Env::Default(), op);
+    Status s = runner->Run(&sampling_req, &sampling_res);
+    RETURN_IF_NOT_OK(s);
+
+    // Where the samples of each sampled source start.
+    int32_t sample_num = sample_ids->size();
+    std::vector<int32_t> offsets(sample_num + 1, 0);
+    const int32_t* degrees = sampling_res.GetDegrees();
+    for (int32_t i = 0; i < sample_num; ++i) {
+      offsets[i + 1] = offsets[i] + (sampling_res.IsSparse() ?
+        degrees[i] : sampling_res.NeighborCount());
+    }
+
+    const int64_t* nbr_ids = sampling_res.GetNeighborIds();
+    const int64_t* edge_ids = nullptr;
+    auto it = sampling_res.tensors_.find(kEdgeIds);
+    if (it != sampling_res.tensors_.end() &&
+        it->second.Size() == offsets.back()) {
+      edge_ids = sampling_res.GetEdgeIds();
+    }
+    for (int32_t pos : positions) {
+      res->AppendNeighbors(nbr_ids + offsets[pos],
+                           edge_ids ? edge_ids + offsets[pos] : nullptr,
+                           offsets[pos + 1] - offsets[pos]);
+    }
+    return Status::OK();
+  }
+};
+
+REGISTER_OPERATOR("MultiHopSampler", MultiHopSampler);
+
+}  // namespace op
+}  // namespace graphlearn
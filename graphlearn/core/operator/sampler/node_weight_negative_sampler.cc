@@ -13,9 +13,10 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <memory>
-#include <unordered_set>
 #include "graphlearn/common/base/log.h"
+#include "graphlearn/core/graph/storage/sorted_neighbors.h"
 #include "graphlearn/core/operator/sampler/alias_method.h"
 #include "graphlearn/core/operator/sampler/sampler.h"
 #include "graphlearn/include/config.h"
@@ -33,32 +34,39 @@ public:
 
   Status Sample(const SamplingRequest* req,
                 SamplingResponse* res) override {
+    return ParallelSample(req, res);
+  }
+
+protected:
+  Status SampleRange(const SamplingRequest* req,
+                     int32_t begin, int32_t end,
+                     SamplingResponse* res) override {
     int32_t count = req->NeighborCount();
-    int32_t batch_size = req->BatchSize();
+    int32_t batch_size = end - begin;
 
     res->SetBatchSize(batch_size);
     res->SetNeighborCount(count);
     res->InitEdgeIds(batch_size * count);
     res->InitNeighborIds(batch_size * count);
 
-    const int64_t* src_ids = req->GetSrcIds();
     const std::string& node_type = req->Type();
     Noder* noder = graph_store_->GetNoder(node_type);
     auto storage = noder->GetLocalStorage();
 
-    AliasMethod* am = CreateAM(node_type, storage);
-    SampleAndFill(storage, src_ids, batch_size, count, am, res);
+    std::shared_ptr<AliasMethod> am = CreateAM(node_type, storage);
+    SampleAndFill(req, storage, begin, end, count, am.get(), res);
 
     return Status::OK();
   }
 
-protected:
-  virtual void SampleAndFill(::graphlearn::io::NodeStorage* storage,
-                             const int64_t* src_ids,
-                             int32_t batch_size,
+  virtual void SampleAndFill(const SamplingRequest* req,
+                             ::graphlearn::io::NodeStorage* storage,
+                             int32_t begin,
+                             int32_t end,
                              int32_t n,
                              AliasMethod* am,
                              SamplingResponse* res) {
+    const int64_t* src_ids = req->GetSrcIds();
     std::unique_ptr<int32_t[]> indices(new int32_t[n]);
     auto ids = storage->GetIds();
     if (!ids) {
@@ -66,26 +74,31 @@ protected:
       res->FillWith(GLOBAL_FLAG(DefaultNeighborId), -1);
       return;
     }
-    std::unordered_set<int64_t> sets(src_ids, src_ids + batch_size);
-    for (int32_t i = 0; i < batch_size; ++i) {
+    // Exclude the ids of the whole batch, whichever chunk it is.
+    ::graphlearn::io::IdList batch(src_ids, src_ids + req->BatchSize());
+    std::sort(batch.begin(), batch.end());
+    ::graphlearn::io::IdArray excluded(batch);
+    for (int32_t i = begin; i < end; ++i) {
+      PhiloxRandom rng = GetRandom(req, i);
+      bool strict = true;
       int32_t count = 0;
       int32_t cursor = 0;
       int32_t retry_times = kRetryTimes + 1;
       while (count < n && retry_times >= 0) {
         cursor %= n;
         if (cursor == 0) {
-          am->Sample(n, indices.get());
+          am->Sample(n, indices.get(), &rng);
           if (--retry_times <= 0) {
             // After trying RetryTimes, the nbr_ids' size is still
             // less than nbr_count, we should fill nbr_ids with random dst
             // node ids and no longer strictly guarantee the negative ids
             // are true negative.
-            sets.clear();
+            strict = false;
           }
         }
 
         int64_t item = ids->at(indices[cursor++]);
-        if (sets.find(item) == sets.end()) {
+        if (!strict || !::graphlearn::io::ContainsSorted(excluded, item)) {
           res->AppendNeighborId(item);
           ++count;
         }
@@ -94,11 +107,13 @@ protected:
   }
 
 private:
-  AliasMethod* CreateAM(const std::string& type,
-                        ::graphlearn::io::NodeStorage* storage) {
+  std::shared_ptr<AliasMethod> CreateAM(
+      const std::string& type,
+      ::graphlearn::io::NodeStorage* storage) {
     AliasMethodFactory* factory = AliasMethodFactory::GetInstance();
     auto weights = storage->GetWeights();
-    return factory->LookupOrCreate(type, weights);
+    return factory->LookupOrCreate(AliasMethodFactory::kNodeWeight, type,
+                                   storage->GetVersion(), weights);
   }
 };
 
@@ -43,7 +43,7 @@ public:
     }
 
     int32_t got = 0;
-    for (int32_t idx = 0; idx < size; idx++) {
+    for (int32_t idx = 0; idx < size && got < target_size; idx++) {
       int32_t cursor = idx;
       if (indices_ == nullptr) {
         // just use the cursor directly
@@ -29,8 +29,15 @@ public:
 
   Status Sample(const SamplingRequest* req,
                 SamplingResponse* res) override {
+    return ParallelSample(req, res);
+  }
+
+protected:
+  Status SampleRange(const SamplingRequest* req,
+                     int32_t begin, int32_t end,
+                     SamplingResponse* res) override {
     int32_t count = req->NeighborCount();
-    int32_t batch_size = req->BatchSize();
+    int32_t batch_size = end - begin;
 
     res->SetBatchSize(batch_size);
     res->SetNeighborCount(count);
@@ -41,19 +48,16 @@ public:
     Graph* graph = graph_store_->GetGraph(edge_type);
     auto storage = graph->GetLocalStorage();
 
-    thread_local static std::random_device rd;
-    thread_local static std::mt19937 engine(rd());
-
     auto dst_ids = storage->GetAllDstIds();
     if (!dst_ids) {
       LOG(ERROR) << "Sample negatively on not existed edge_type: "
                  << edge_type;
       res->FillWith(GLOBAL_FLAG(DefaultNeighborId), -1);
     }
-    std::uniform_int_distribution<> dist(0, dst_ids->size() - 1);
-    for (int32_t i = 0; i < batch_size; ++i) {
+    for (int32_t i = begin; i < end; ++i) {
+      PhiloxRandom rng = GetRandom(req, i);
       for (int32_t j = 0; j < count; ++j) {
-        int32_t idx = dist(engine);
+        int32_t idx = rng.Uniform(dst_ids->size());
         res->AppendNeighborId((*dst_ids)[idx]);
       }
     }
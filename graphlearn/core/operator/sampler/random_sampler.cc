@@ -14,7 +14,6 @@ limitations under the License.
 ==============================================================================*/
 
 #include <cmath>
-#include <random>
 #include "graphlearn/core/operator/sampler/sampler.h"
 #include "graphlearn/include/config.h"
 
@@ -27,8 +26,15 @@ public:
 
   Status Sample(const SamplingRequest* req,
                 SamplingResponse* res) override {
+    return ParallelSample(req, res);
+  }
+
+protected:
+  Status SampleRange(const SamplingRequest* req,
+                     int32_t begin, int32_t end,
+                     SamplingResponse* res) override {
     int32_t count = req->NeighborCount();
-    int32_t batch_size = req->BatchSize();
+    int32_t batch_size = end - begin;
 
     res->SetBatchSize(batch_size);
     res->SetNeighborCount(count);
@@ -39,23 +45,20 @@ public:
     Graph* graph = graph_store_->GetGraph(edge_type);
     auto storage = graph->GetLocalStorage();
 
-    thread_local static std::random_device rd;
-    thread_local static std::mt19937 engine(rd());
-
     const int64_t* src_ids = req->GetSrcIds();
     const int64_t* filters = req->GetFilters();
 
-    for (int32_t i = 0; i < batch_size; ++i) {
+    for (int32_t i = begin; i < end; ++i) {
       int64_t src_id = src_ids[i];
-      auto neighbor_ids = storage->GetNeighbors(src_id);
+      auto neighbor_ids = GetNeighbors(req, storage, src_id);
       if (!neighbor_ids || (filters && neighbor_ids.Size() == 1
           && neighbor_ids[0] == filters[i])) {
         res->FillWith(GLOBAL_FLAG(DefaultNeighborId), -1);
       } else {
-        auto edge_ids = storage->GetOutEdges(src_id);
-        std::uniform_int_distribution<> dist(0, neighbor_ids.Size() - 1);
+        auto edge_ids = GetEdges(req, storage, src_id);
+        PhiloxRandom rng = GetRandom(req, i);
         for (int32_t j = 0; j < count;) {
-          int32_t idx = dist(engine);
+          int32_t idx = rng.Uniform(neighbor_ids.Size());
           if (!filters || filters[i] != neighbor_ids[idx]) {
             res->AppendNeighborId(neighbor_ids[idx]);
             res->AppendEdgeId(edge_ids[idx]);
@@ -0,0 +1,216 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "graphlearn/common/base/errors.h"
+#include "graphlearn/common/base/log.h"
+#include "graphlearn/common/base/macros.h"
+#include "graphlearn/common/base/random.h"
+#include "graphlearn/core/operator/op_factory.h"
+#include "graphlearn/core/operator/operator.h"
+#include "graphlearn/core/operator/op_registry.h"
+#include "graphlearn/core/runner/op_runner.h"
+#include "graphlearn/include/config.h"
+#include "graphlearn/include/graph_request.h"
+#include "graphlearn/include/sampling_request.h"
+#include "graphlearn/platform/env.h"
+
+namespace graphlearn {
+namespace op {
+
+namespace {
+
+// The rounds of proposals a walker makes in a step at most, after which
+// it takes the last one, so that a step never takes unbounded requests.
+const int32_t kMaxProposalRounds = 32;
+
+Status RunOp(const OpRequest* req, OpResponse* res) {
+  std::string op_name = req->Name();
+  Operator* op = OpFactory::GetInstance()->Create(op_name);
+  if (op == nullptr) {
+    LOG(ERROR) << "No supported op: " << op_name;
+    return error::InvalidArgument("No supported op: %s", op_name.c_str());
+  }
+  std::unique_ptr<OpRunner> runner = GetOpRunner(Env::Default(), op);
+  return runner->Run(req, res);
+}
+
+}  // anonymous namespace
+
+/// Drive the walks of a RandomWalkRequest step by step. In each step, the
+/// walkers propose a uniform neighbor of their current nodes by a
+/// RandomSampler request, which the op runner sends to the servers owning
+/// the nodes. For node2vec, a proposal x from the current node v with the
+/// previous node t is accepted with the probability of its bias over the
+/// largest bias, where the bias is 1/p if x is t, 1 if x is a neighbor of
+/// t, and 1/q otherwise. Only the proposals the random number does not
+/// decide alone are sent to the owners of t, which test x against the
+/// sorted neighbors of t. The rejected walkers propose again, up to
+/// kMaxProposalRounds times.
+class RandomWalkSampler : public RemoteOperator {
+public:
+  virtual ~RandomWalkSampler() {}
+
+  Status Process(const OpRequest* req,
+                 OpResponse* res) override {
+    const RandomWalkRequest* request =
+      static_cast<const RandomWalkRequest*>(req);
+    RandomWalkResponse* response =
+      static_cast<RandomWalkResponse*>(res);
+
+    if (request->P() <= 0 || request->Q() <= 0) {
+      return error::InvalidArgument("p and q of a walk must be positive.");
+    }
+
+    int32_t batch_size = request->BatchSize();
+    int32_t length = std::max(request->WalkLength(), 0);
+    response->Init(batch_size, length);
+    if (length == 0) {
+      return Status::OK();
+    }
+
+    int64_t* walks = response->GetWalks();
+    std::fill(walks, walks + batch_size * length,
+              GLOBAL_FLAG(DefaultNeighborId));
+    const int64_t* src_ids = request->GetSrcIds();
+    std::vector<int32_t> walkers(batch_size);
+    for (int32_t i = 0; i < batch_size; ++i) {
+      walks[i * length] = src_ids[i];
+      walkers[i] = i;
+    }
+
+    PhiloxRandom rng(request->HasSeed() ? request->Seed() : NewRandomSeed());
+    for (int32_t step = 1; step < length && !walkers.empty(); ++step) {
+      Status s = Step(request, step, &rng, &walkers, walks);
+      RETURN_IF_NOT_OK(s);
+    }
+    return Status::OK();
+  }
+
+  Status Call(int32_t remote_id,
+              const OpRequest* req,
+              OpResponse* res) override {
+    return Process(req, res);
+  }
+
+private:
+  // Move the walkers to their next nodes at `step`, and keep only the ones
+  // which moved in `walkers`.
+  Status Step(const RandomWalkRequest* req,
+              int32_t step,
+              PhiloxRandom* rng,
+              std::vector<int32_t>* walkers,
+              int64_t* walks) {
+    int32_t length = req->WalkLength();
+    float return_bias = 1.0 / req->P();
+    float in_out_bias = 1.0 / req->Q();
+    float max_bias = std::max({return_bias, 1.0f, in_out_bias});
+    bool biased = step > 1 && (return_bias != 1.0 || in_out_bias != 1.0);
+
+    std::vector<int32_t> moved;
+    std::vector<int32_t> pending(*walkers);
+    std::vector<int64_t> ids;
+    for (int32_t round = 1; !pending.empty(); ++round) {
+      // Accept all the proposals of the last round.
+      bool rejectable = biased && round < kMaxProposalRounds;
+      int32_t size = pending.size();
+      ids.resize(size);
+      for (int32_t i = 0; i < size; ++i) {
+        ids[i] = walks[pending[i] * length + step - 1];
+      }
+
+      SamplingRequest propose_req(req->Type(), "RandomSampler", 1);
+      propose_req.SetSeed(rng->Next64());
+      propose_req.Set(ids.data(), size);
+      SamplingResponse propose_res;
+      Status s = RunOp(&propose_req, &propose_res);
+      RETURN_IF_NOT_OK(s);
+      const int64_t* proposals = propose_res.GetNeighborIds();
+      const int64_t* edge_ids = propose_res.GetEdgeIds();
+
+      // The proposals to test against the neighbors of the previous nodes,
+      // with the random numbers that decide them.
+      std::vector<int32_t> checks;
+      std::vector<int64_t> prev_ids;
+      std::vector<int64_t> check_ids;
+      std::vector<float> thresholds;
+      std::vector<int32_t> rejected;
+      for (int32_t i = 0; i < size; ++i) {
+        int32_t w = pending[i];
+        if (edge_ids[i] == -1) {
+          // A dead end stops the walk.
+          continue;
+        }
+        if (!rejectable) {
+          walks[w * length + step] = proposals[i];
+          moved.push_back(w);
+          continue;
+        }
+
+        int64_t prev_id = walks[w * length + step - 2];
+        float u = rng->UniformFloat() * max_bias;
+        bool accepted = false;
+        if (proposals[i] == prev_id) {
+          accepted = u < return_bias;
+        } else if (u < std::min(1.0f, in_out_bias)) {
+          accepted = true;
+        } else if (u < std::max(1.0f, in_out_bias)) {
+          checks.push_back(i);
+          prev_ids.push_back(prev_id);
+          check_ids.push_back(proposals[i]);
+          thresholds.push_back(u);
+          continue;
+        }
+        if (accepted) {
+          walks[w * length + step] = proposals[i];
+          moved.push_back(w);
+        } else {
+          rejected.push_back(w);
+        }
+      }
+
+      if (!checks.empty()) {
+        CheckEdgesRequest check_req(req->Type());
+        check_req.Set(prev_ids.data(), check_ids.data(), checks.size());
+        CheckEdgesResponse check_res;
+        s = RunOp(&check_req, &check_res);
+        RETURN_IF_NOT_OK(s);
+
+        const int32_t* exists = check_res.GetExists();
+        for (size_t k = 0; k < checks.size(); ++k) {
+          int32_t w = pending[checks[k]];
+          float bias = exists[k] ? 1.0 : in_out_bias;
+          if (thresholds[k] < bias) {
+            walks[w * length + step] = check_ids[k];
+            moved.push_back(w);
+          } else {
+            rejected.push_back(w);
+          }
+        }
+      }
+      pending.swap(rejected);
+    }
+
+    walkers->swap(moved);
+    return Status::OK();
+  }
+};
+
+REGISTER_OPERATOR("RandomWalk", RandomWalkSampler);
+
+}  // namespace op
+}  // namespace graphlearn
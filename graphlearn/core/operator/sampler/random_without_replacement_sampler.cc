@@ -13,10 +13,10 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
-#include <cmath>
-#include <random>
-#include <numeric>
 #include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
 #include "graphlearn/core/operator/sampler/padder/padder.h"
 #include "graphlearn/core/operator/sampler/sampler.h"
 #include "graphlearn/include/config.h"
@@ -24,14 +24,73 @@ limitations under the License.
 namespace graphlearn {
 namespace op {
 
+namespace {
+
+/// Draw `k` distinct indices of [0, n) in random order into `indices`,
+/// with O(k) work. All of [0, n) are shuffled if k >= n, otherwise by
+/// Floyd's algorithm, which marks the drawn ones in a bitmap of the
+/// thread, and then unmarks them.
+void SampleDistinct(int32_t n, int32_t k, PhiloxRandom* rng,
+                    std::vector<int32_t>* indices) {
+  if (k >= n) {
+    indices->resize(n);
+    std::iota(indices->begin(), indices->end(), 0);
+    for (int32_t i = n - 1; i > 0; --i) {
+      std::swap((*indices)[i], (*indices)[rng->Uniform(i + 1)]);
+    }
+    return;
+  }
+
+  thread_local static std::vector<uint64_t> marks;
+  if (marks.size() * 64 < static_cast<size_t>(n)) {
+    marks.resize((n + 63) / 64, 0);
+  }
+  indices->clear();
+  for (int32_t j = n - k; j < n; ++j) {
+    int32_t t = rng->Uniform(j + 1);
+    if (marks[t >> 6] & (1ULL << (t & 63))) {
+      t = j;
+    }
+    marks[t >> 6] |= 1ULL << (t & 63);
+    indices->push_back(t);
+  }
+  for (int32_t t : *indices) {
+    marks[t >> 6] &= ~(1ULL << (t & 63));
+  }
+  // Floyd's algorithm draws a uniform set, but not in a uniform order.
+  for (int32_t i = k - 1; i > 0; --i) {
+    std::swap((*indices)[i], (*indices)[rng->Uniform(i + 1)]);
+  }
+}
+
+bool HitFilter(const io::Array<io::IdType>& neighbor_ids,
+               const std::vector<int32_t>& indices,
+               int64_t filter) {
+  for (int32_t index : indices) {
+    if (neighbor_ids[index] == filter) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // anonymous namespace
+
 class RandomWithoutReplacementSampler : public Sampler {
 public:
   virtual ~RandomWithoutReplacementSampler() {}
 
   Status Sample(const SamplingRequest* req,
                 SamplingResponse* res) override {
+    return ParallelSample(req, res);
+  }
+
+protected:
+  Status SampleRange(const SamplingRequest* req,
+                     int32_t begin, int32_t end,
+                     SamplingResponse* res) override {
     int32_t count = req->NeighborCount();
-    int32_t batch_size = req->BatchSize();
+    int32_t batch_size = end - begin;
 
     res->SetBatchSize(batch_size);
     res->SetNeighborCount(count);
@@ -44,22 +103,26 @@ public:
 
     const int64_t* src_ids = req->GetSrcIds();
     const int64_t* filters = req->GetFilters();
+    std::vector<int32_t> indices;
+    indices.reserve(count);
     Status s;
-    for (int32_t i = 0; i < batch_size; ++i) {
+    for (int32_t i = begin; i < end; ++i) {
       int64_t src_id = src_ids[i];
-      auto neighbor_ids = storage->GetNeighbors(src_id);
+      auto neighbor_ids = GetNeighbors(req, storage, src_id);
       if (!neighbor_ids) {
         res->FillWith(GLOBAL_FLAG(DefaultNeighborId), -1);
       } else {
-        thread_local static std::random_device rd;
-        thread_local static std::mt19937 engine(rd());
-
         int32_t neighbor_size = neighbor_ids.Size();
-        auto edge_ids = storage->GetOutEdges(src_id);
+        auto edge_ids = GetEdges(req, storage, src_id);
 
-        std::vector<int32_t> indices(neighbor_size);
-        std::iota(indices.begin(), indices.end(), 0);
-        std::shuffle(indices.begin(), indices.end(), engine);
+        PhiloxRandom rng = GetRandom(req, i);
+        SampleDistinct(neighbor_size, count, &rng, &indices);
+        // The filtered id may be drawn, even more than once with multiple
+        // edges to it, so shuffle all the neighbors for the padder to skip
+        // it, which keeps the rest uniform.
+        if (filters && HitFilter(neighbor_ids, indices, filters[i])) {
+          SampleDistinct(neighbor_size, neighbor_size, &rng, &indices);
+        }
 
         auto padder = GetPadder(neighbor_ids, edge_ids);
         padder->SetIndex(indices);
@@ -0,0 +1,81 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "graphlearn/core/operator/sampler/sampler.h"
+
+#include <algorithm>
+#include <vector>
+#include "graphlearn/common/base/errors.h"
+#include "graphlearn/common/threading/runner/parallel_for.h"
+#include "graphlearn/include/config.h"
+#include "graphlearn/platform/env.h"
+
+namespace graphlearn {
+namespace op {
+
+namespace {
+
+// Each chunk has at least so many ids, to pay for the copying.
+const int32_t kMinChunkSize = 256;
+
+}  // anonymous namespace
+
+Status Sampler::SampleRange(const SamplingRequest* req,
+                            int32_t begin, int32_t end,
+                            SamplingResponse* res) {
+  return error::Unimplemented("SampleRange is not supported by " +
+                              req->Strategy());
+}
+
+Status Sampler::ParallelSample(const SamplingRequest* req,
+                               SamplingResponse* res) {
+  int32_t batch_size = req->BatchSize();
+  int32_t threshold = GLOBAL_FLAG(ParallelSamplingThreshold);
+  ThreadPool* tp = Env::Default()->IntraThreadPool();
+  if (threshold <= 0 || batch_size < threshold || tp == nullptr) {
+    return SampleRange(req, 0, batch_size, res);
+  }
+
+  int32_t chunk_num = std::min(
+    static_cast<int64_t>(tp->GetThreadNum()) * kBlocksPerThread,
+    static_cast<int64_t>(batch_size / kMinChunkSize));
+  chunk_num = std::max(chunk_num, 1);
+  int32_t chunk_size = (batch_size + chunk_num - 1) / chunk_num;
+  chunk_num = (batch_size + chunk_size - 1) / chunk_size;
+
+  std::vector<std::unique_ptr<SamplingResponse>> chunks(chunk_num);
+  std::vector<Status> status(chunk_num);
+  ParallelFor(tp, chunk_num, 1, [&] (int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      chunks[i].reset(new SamplingResponse);
+      status[i] = SampleRange(
+        req, i * chunk_size, std::min((i + 1) * chunk_size,
+                                      static_cast<int64_t>(batch_size)),
+        chunks[i].get());
+    }
+  });
+
+  std::vector<SamplingResponse*> pieces;
+  pieces.reserve(chunk_num);
+  for (int32_t i = 0; i < chunk_num; ++i) {
+    RETURN_IF_ERROR(status[i]);
+    pieces.push_back(chunks[i].get());
+  }
+  res->Concat(pieces, tp);
+  return Status::OK();
+}
+
+}  // namespace op
+}  // namespace graphlearn
@@ -18,8 +18,11 @@ limitations under the License.
 
 #include <memory>
 #include <string>
+#include "graphlearn/common/base/errors.h"
+#include "graphlearn/common/base/random.h"
 #include "graphlearn/core/operator/operator.h"
 #include "graphlearn/core/operator/op_registry.h"
+#include "graphlearn/include/config.h"
 #include "graphlearn/include/sampling_request.h"
 #include "graphlearn/include/status.h"
 #include "graphlearn/include/client.h"
@@ -40,7 +43,18 @@ public:
     SamplingResponse* response =
       static_cast<SamplingResponse*>(res);
 
-    return this->Sample(request, response);
+    // The edges are partitioned by their src ids, so a server only has
+    // part of the in-edges of an id when there are more servers.
+    if (request->IsReversed() && GLOBAL_FLAG(ServerCount) > 1) {
+      return error::Unimplemented(
+        "Reversed sampling is not supported with multiple servers.");
+    }
+
+    Status s = this->Sample(request, response);
+    if (s.ok() && request->IsCompact()) {
+      response->Compact();
+    }
+    return s;
   }
 
   Status Call(int32_t remote_id,
@@ -57,6 +71,52 @@ public:
 protected:
   virtual Status Sample(const SamplingRequest* req,
                         SamplingResponse* res) = 0;
+
+  /// Sample for the source ids in [begin, end) of `req` into `res` as a
+  /// batch of its own, where `begin` is the offset of the filters and the
+  /// generators. Samplers that implement it call ParallelSample() in
+  /// Sample().
+  virtual Status SampleRange(const SamplingRequest* req,
+                             int32_t begin, int32_t end,
+                             SamplingResponse* res);
+
+  /// Split a batch of at least GLOBAL_FLAG(ParallelSamplingThreshold) ids
+  /// into chunks, and run SampleRange() for them on the intra thread pool.
+  /// Each chunk is then copied into its own region of `res`. Smaller
+  /// batches are sampled into `res` directly.
+  Status ParallelSample(const SamplingRequest* req, SamplingResponse* res);
+
+  /// Get the neighbors of `src_id` to sample from, along the in-edges if
+  /// the request is reversed.
+  io::Array<io::IdType> GetNeighbors(const SamplingRequest* req,
+                                     const io::GraphStorage* storage,
+                                     io::IdType src_id) const {
+    return req->IsReversed() ? storage->GetInNeighbors(src_id)
+                             : storage->GetNeighbors(src_id);
+  }
+
+  /// Get the generator for the `index`th source id of a request. With a
+  /// seed, the stream is the source id and the key mixes the seed with the
+  /// occurrence of the id in the request, so that an id gets the same
+  /// samples wherever it is in the batch and however many servers it is
+  /// sharded to, while a repeated id gets fresh ones.
+  PhiloxRandom GetRandom(const SamplingRequest* req, int32_t index) const {
+    if (req->HasSeed()) {
+      uint64_t occurrence = req->Occurrence(index);
+      return PhiloxRandom(req->Seed() ^ (occurrence * 0x9E3779B97F4A7C15ULL),
+                          req->GetSrcIds()[index]);
+    } else {
+      return PhiloxRandom(NewRandomSeed());
+    }
+  }
+
+  /// Get the edges in the same order of GetNeighbors().
+  io::Array<io::IdType> GetEdges(const SamplingRequest* req,
+                                 const io::GraphStorage* storage,
+                                 io::IdType src_id) const {
+    return req->IsReversed() ? storage->GetInEdges(src_id)
+                             : storage->GetOutEdges(src_id);
+  }
 };
 
 }  // namespace op
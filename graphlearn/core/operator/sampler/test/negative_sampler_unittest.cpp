@@ -15,7 +15,9 @@ limitations under the License.
 
 #include <cstdlib>
 #include <unordered_set>
+#include <vector>
 #include "graphlearn/core/graph/graph_store.h"
+#include "graphlearn/core/operator/sampler/alias_method.h"
 #include "graphlearn/core/operator/sampler/sampler.h"
 #include "graphlearn/core/operator/op_factory.h"
 #include "graphlearn/platform/env.h"
@@ -149,6 +151,61 @@ TEST_F(NegativeSamplerTest, InDegree) {
   delete req;
 }
 
+TEST_F(NegativeSamplerTest, InDegreeWithSortedNeighbors) {
+  // Rebuild the graph with the id-sorted copy of the neighbors
+  TearDown();
+  GLOBAL_FLAG(StorageMode) = 514;
+  SetUp();
+  Graph* graph = graph_store_->GetGraph("u-i");
+  IndexOption option;
+  option.name = "sort";
+  graph->Build(option);
+  GLOBAL_FLAG(StorageMode) = 2;
+
+  auto storage = graph->GetLocalStorage();
+  auto sorted = storage->GetSortedNeighbors(1);
+  ASSERT_EQ(sorted.Size(), 6);
+  EXPECT_EQ(sorted[0], 10);
+  EXPECT_EQ(sorted[5], 31);
+
+  int32_t nbr_count = 5;
+  SamplingRequest* req =
+    new SamplingRequest("u-i", "InDegreeNegativeSampler", nbr_count);
+  SamplingResponse* res = new SamplingResponse();
+
+  int32_t batch_size = 3;
+  int64_t ids[3] = {0, 1, 2};
+  req->Set(ids, batch_size);
+  // The sampler gives up rejecting the positives after a few retries,
+  // so fix the draw to keep the check below deterministic.
+  req->SetSeed(7);
+
+  OpFactory::GetInstance()->Set(graph_store_);
+  Operator* op = OpFactory::GetInstance()->Create(req->Name());
+  EXPECT_TRUE(op != nullptr);
+
+  Status s = op->Process(req, res);
+  EXPECT_TRUE(s.ok());
+  EXPECT_EQ(res->BatchSize(), batch_size);
+  EXPECT_EQ(res->NeighborCount(), nbr_count);
+
+  // None of the negative neighbors is a neighbor of the source
+  const int64_t* neighbor_ids = res->GetNeighborIds();
+  for (int32_t i = 0; i < batch_size; ++i) {
+    auto nbrs = storage->GetNeighbors(ids[i]);
+    std::unordered_set<int64_t> pos_set;
+    for (int32_t j = 0; j < nbrs.Size(); ++j) {
+      pos_set.insert(nbrs[j]);
+    }
+    for (int32_t j = i * nbr_count; j < (i + 1) * nbr_count; ++j) {
+      EXPECT_TRUE(pos_set.find(neighbor_ids[j]) == pos_set.end());
+    }
+  }
+
+  delete res;
+  delete req;
+}
+
 TEST_F(NegativeSamplerTest, SoftInDegree) {
   int32_t nbr_count = 5;
   SamplingRequest* req =
@@ -185,3 +242,42 @@ TEST_F(NegativeSamplerTest, SoftInDegree) {
   delete res;
   delete req;
 }
+
+TEST_F(NegativeSamplerTest, AliasMethodFactory) {
+  AliasMethodFactory* factory = AliasMethodFactory::GetInstance();
+  std::vector<int32_t> in_degrees = {1, 2, 3};
+  std::vector<float> weights = {1.0, 2.0};
+
+  auto am = factory->LookupOrCreate(
+    AliasMethodFactory::kInDegree, "factory", 1, &in_degrees);
+  EXPECT_EQ(factory->LookupOrCreate(
+    AliasMethodFactory::kInDegree, "factory", 1, &in_degrees), am);
+
+  // The same type in another namespace has its own table
+  auto weight_am = factory->LookupOrCreate(
+    AliasMethodFactory::kNodeWeight, "factory", 1, &weights);
+  auto uniform_am = factory->LookupOrCreate(
+    AliasMethodFactory::kUniform, "factory", 1, 5);
+  EXPECT_NE(weight_am, am);
+  EXPECT_NE(uniform_am, am);
+  EXPECT_NE(uniform_am, weight_am);
+
+  // Rebuilt for a new version, while the old one is still usable
+  auto rebuilt = factory->LookupOrCreate(
+    AliasMethodFactory::kInDegree, "factory", 2, &in_degrees);
+  EXPECT_NE(rebuilt, am);
+  EXPECT_EQ(factory->LookupOrCreate(
+    AliasMethodFactory::kInDegree, "factory", 2, &in_degrees), rebuilt);
+  int32_t indices[4];
+  EXPECT_TRUE(am->Sample(4, indices));
+  for (int32_t i = 0; i < 4; ++i) {
+    EXPECT_GE(indices[i], 0);
+    EXPECT_LT(indices[i], 3);
+  }
+
+  // A rebuilt graph gets a new version
+  auto storage = graph_store_->GetGraph("u-i")->GetLocalStorage();
+  int64_t version = storage->GetVersion();
+  storage->Build();
+  EXPECT_GT(storage->GetVersion(), version);
+}
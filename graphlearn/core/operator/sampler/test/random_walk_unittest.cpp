@@ -0,0 +1,219 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "graphlearn/core/graph/graph_store.h"
+#include "graphlearn/core/operator/op_factory.h"
+#include "graphlearn/include/config.h"
+#include "graphlearn/include/graph_request.h"
+#include "graphlearn/include/index_option.h"
+#include "graphlearn/include/sampling_request.h"
+#include "graphlearn/platform/env.h"
+#include "gtest/gtest.h"
+
+using namespace graphlearn;  // NOLINT [build/namespaces]
+using namespace graphlearn::op;  // NOLINT [build/namespaces]
+
+class RandomWalkTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    // A triangle 1-2-3, a square 3-4-5-6 and a pair 8-9 both ways, and
+    // 6 -> 7 that ends the walks at 7.
+    std::vector<std::pair<int64_t, int64_t>> undirected(
+      {{1, 2}, {2, 3}, {3, 1}, {3, 4}, {4, 5}, {5, 6}, {6, 3}, {8, 9}});
+    for (auto& e : undirected) {
+      edges_.insert(e);
+      edges_.insert(std::make_pair(e.second, e.first));
+    }
+    edges_.insert(std::make_pair(6, 7));
+
+    ::graphlearn::io::SideInfo info;
+    info.format = ::graphlearn::io::kWeighted;
+    info.type = "u-u";
+    info.src_type = "user";
+    info.dst_type = "user";
+    std::unique_ptr<UpdateEdgesRequest> req(
+      new UpdateEdgesRequest(&info, edges_.size()));
+    std::unique_ptr<UpdateEdgesResponse> res(new UpdateEdgesResponse);
+
+    ::graphlearn::io::EdgeValue value;
+    for (auto& e : edges_) {
+      value.src_id = e.first;
+      value.dst_id = e.second;
+      value.weight = 1.0;
+      req->Append(&value);
+    }
+
+    graph_store_ = new GraphStore(Env::Default());
+    Graph* graph = graph_store_->GetGraph("u-u");
+    graph->UpdateEdges(req.get(), res.get());
+
+    IndexOption option;
+    option.name = "sort";
+    graph->Build(option);
+    OpFactory::GetInstance()->Set(graph_store_);
+  }
+
+  void TearDown() override {
+    delete graph_store_;
+  }
+
+  bool IsEdge(int64_t src_id, int64_t dst_id) const {
+    return edges_.count(std::make_pair(src_id, dst_id)) > 0;
+  }
+
+  void Walk(RandomWalkRequest* req, RandomWalkResponse* res) {
+    Operator* op = OpFactory::GetInstance()->Create(req->Name());
+    EXPECT_TRUE(op != nullptr);
+    Status s = op->Process(req, res);
+    EXPECT_TRUE(s.ok());
+  }
+
+protected:
+  GraphStore* graph_store_;
+  std::set<std::pair<int64_t, int64_t>> edges_;
+};
+
+TEST_F(RandomWalkTest, CheckEdges) {
+  CheckEdgesRequest req("u-u");
+  int64_t src_ids[4] = {1, 3, 6, 7};
+  int64_t dst_ids[4] = {2, 5, 7, 6};
+  req.Set(src_ids, dst_ids, 4);
+  CheckEdgesResponse res;
+
+  Operator* op = OpFactory::GetInstance()->Create(req.Name());
+  EXPECT_TRUE(op != nullptr);
+  EXPECT_TRUE(op->Process(&req, &res).ok());
+  EXPECT_EQ(res.Size(), 4);
+  for (int32_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(res.GetExists()[i], IsEdge(src_ids[i], dst_ids[i]) ? 1 : 0);
+  }
+}
+
+TEST_F(RandomWalkTest, Uniform) {
+  int32_t length = 8;
+  RandomWalkRequest req("u-u", length);
+  int64_t ids[4] = {1, 4, 7, 100};
+  req.Set(ids, 4);
+  RandomWalkResponse res;
+  Walk(&req, &res);
+
+  EXPECT_EQ(res.BatchSize(), 4);
+  EXPECT_EQ(res.WalkLength(), length);
+  const int64_t* walks = res.GetWalks();
+  for (int32_t i = 0; i < 4; ++i) {
+    const int64_t* walk = walks + i * length;
+    EXPECT_EQ(walk[0], ids[i]);
+    int32_t k = 1;
+    for (; k < length && IsEdge(walk[k - 1], walk[k]); ++k) {
+    }
+    // A walk stops only at a node without neighbors.
+    if (k < length) {
+      EXPECT_TRUE(walk[k - 1] == 7 || walk[k - 1] == 100);
+    }
+    for (; k < length; ++k) {
+      EXPECT_EQ(walk[k], GLOBAL_FLAG(DefaultNeighborId));
+    }
+  }
+  // 7 and 100 have no neighbors.
+  EXPECT_EQ(walks[2 * length + 1], GLOBAL_FLAG(DefaultNeighborId));
+  EXPECT_EQ(walks[3 * length + 1], GLOBAL_FLAG(DefaultNeighborId));
+}
+
+TEST_F(RandomWalkTest, Seeded) {
+  int32_t length = 10;
+  RandomWalkRequest req("u-u", length, 0.5, 2.0);
+  req.SetSeed(11);
+  int64_t ids[3] = {1, 3, 5};
+  req.Set(ids, 3);
+
+  std::unique_ptr<OpRequest> clone(req.Clone());
+  RandomWalkRequest* cloned = static_cast<RandomWalkRequest*>(clone.get());
+  EXPECT_EQ(cloned->WalkLength(), length);
+  EXPECT_FLOAT_EQ(cloned->P(), 0.5);
+  EXPECT_FLOAT_EQ(cloned->Q(), 2.0);
+  EXPECT_EQ(cloned->Seed(), 11);
+
+  RandomWalkResponse res1;
+  RandomWalkResponse res2;
+  Walk(&req, &res1);
+  Walk(&req, &res2);
+  for (int32_t i = 0; i < 3 * length; ++i) {
+    EXPECT_EQ(res1.GetWalks()[i], res2.GetWalks()[i]);
+  }
+}
+
+TEST_F(RandomWalkTest, Return) {
+  // A tiny p makes the walks go back and forth.
+  int32_t length = 8;
+  RandomWalkRequest req("u-u", length, 1e-4, 1.0);
+  req.SetSeed(5);
+  int64_t ids[3] = {1, 2, 4};
+  req.Set(ids, 3);
+  RandomWalkResponse res;
+  Walk(&req, &res);
+
+  for (int32_t i = 0; i < 3; ++i) {
+    const int64_t* walk = res.GetWalks() + i * length;
+    EXPECT_TRUE(IsEdge(walk[0], walk[1]));
+    for (int32_t k = 2; k < length; ++k) {
+      EXPECT_EQ(walk[k], walk[k - 2]);
+    }
+  }
+}
+
+TEST_F(RandomWalkTest, RejectedReturn) {
+  // A huge p rejects going back, which is the only way on from 8 and 9,
+  // until the walkers give up rejecting.
+  int32_t length = 6;
+  RandomWalkRequest req("u-u", length, 1e9, 1.0);
+  req.SetSeed(5);
+  int64_t ids[2] = {8, 9};
+  req.Set(ids, 2);
+  RandomWalkResponse res;
+  Walk(&req, &res);
+
+  for (int32_t i = 0; i < 2; ++i) {
+    const int64_t* walk = res.GetWalks() + i * length;
+    for (int32_t k = 2; k < length; ++k) {
+      EXPECT_EQ(walk[k], walk[k - 2]);
+    }
+  }
+}
+
+TEST_F(RandomWalkTest, InOut) {
+  // A large q keeps the walks within the neighbors of the last node,
+  // which needs to check the proposals against the rows of them.
+  int32_t length = 8;
+  RandomWalkRequest req("u-u", length, 1.0, 1e4);
+  req.SetSeed(3);
+  int64_t ids[3] = {1, 2, 3};
+  req.Set(ids, 3);
+  RandomWalkResponse res;
+  Walk(&req, &res);
+
+  for (int32_t i = 0; i < 3; ++i) {
+    const int64_t* walk = res.GetWalks() + i * length;
+    EXPECT_TRUE(IsEdge(walk[0], walk[1]));
+    for (int32_t k = 2; k < length; ++k) {
+      EXPECT_TRUE(IsEdge(walk[k - 1], walk[k]));
+      EXPECT_TRUE(walk[k] == walk[k - 2] || IsEdge(walk[k - 2], walk[k]));
+    }
+  }
+}
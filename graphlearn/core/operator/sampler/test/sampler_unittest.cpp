@@ -13,8 +13,13 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
+#include "graphlearn/common/base/errors.h"
 #include "graphlearn/core/graph/graph_store.h"
 #include "graphlearn/core/operator/sampler/sampler.h"
 #include "graphlearn/core/operator/op_factory.h"
@@ -24,6 +29,7 @@ limitations under the License.
 #include "graphlearn/platform/env.h"
 #include "gtest/gtest.h"
 #include "graphlearn/include/config.h"
+#include "graphlearn/include/constants.h"
 
 using namespace graphlearn;  // NOLINT [build/namespaces]
 using namespace graphlearn::op;  // NOLINT [build/namespaces]
@@ -170,6 +176,111 @@ TEST_F(SamplerTest, RandomWithoutReplacement) {
   delete req;
 }
 
+TEST_F(SamplerTest, RandomWithoutReplacementPartial) {
+  OpFactory::GetInstance()->Set(graph_store_);
+  Operator* op = OpFactory::GetInstance()->Create(
+    "RandomWithoutReplacementSampler");
+  EXPECT_TRUE(op != nullptr);
+
+  // 0 has neighbors {10, 20, 30}, from which 2 distinct ones are drawn
+  int32_t nbr_count = 2;
+  int32_t batch_size = 300;
+  std::vector<int64_t> ids(batch_size, 0);
+  std::unordered_map<int64_t, int32_t> counts;
+  {
+    SamplingRequest req("u-i", "RandomWithoutReplacementSampler", nbr_count);
+    req.Set(ids.data(), batch_size);
+    SamplingResponse res;
+    EXPECT_TRUE(op->Process(&req, &res).ok());
+    ASSERT_EQ(res.TotalNeighborCount(), batch_size * nbr_count);
+    const int64_t* neighbor_ids = res.GetNeighborIds();
+    for (int32_t i = 0; i < batch_size; ++i) {
+      EXPECT_NE(neighbor_ids[i * 2], neighbor_ids[i * 2 + 1]);
+      ++counts[neighbor_ids[i * 2]];
+      ++counts[neighbor_ids[i * 2 + 1]];
+    }
+  }
+  EXPECT_EQ(counts.size(), 3);
+  for (auto& it : counts) {
+    EXPECT_TRUE(it.first == 10 || it.first == 20 || it.first == 30);
+    EXPECT_GT(it.second, 100);
+  }
+
+  // The filtered one is never drawn, with either padding mode
+  int32_t modes[2] = {kReplicate, kCircular};
+  for (int32_t mode : modes) {
+    GLOBAL_FLAG(PaddingMode) = mode;
+    SamplingRequest req(
+      "u-i", "RandomWithoutReplacementSampler", nbr_count, 1);
+    std::vector<int64_t> filters(batch_size, 20);
+    req.Set(ids.data(), batch_size);
+    req.SetFilters(filters.data(), batch_size);
+    SamplingResponse res;
+    EXPECT_TRUE(op->Process(&req, &res).ok());
+    ASSERT_EQ(res.TotalNeighborCount(), batch_size * nbr_count);
+    const int64_t* neighbor_ids = res.GetNeighborIds();
+    for (int32_t i = 0; i < batch_size; ++i) {
+      std::unordered_set<int64_t> row(
+        {neighbor_ids[i * 2], neighbor_ids[i * 2 + 1]});
+      EXPECT_EQ(row, std::unordered_set<int64_t>({10, 30}));
+    }
+  }
+  GLOBAL_FLAG(PaddingMode) = kReplicate;
+}
+
+TEST_F(SamplerTest, RandomWithoutReplacementMultiEdges) {
+  // 5 has two edges to the filtered 50
+  ::graphlearn::io::SideInfo info;
+  info.format = ::graphlearn::io::kWeighted;
+  info.type = "u-i";
+  info.src_type = "user";
+  info.dst_type = "item";
+  ::graphlearn::io::IdType dst_ids[6] = {40, 50, 60, 50, 70, 80};
+  std::unique_ptr<UpdateEdgesRequest> req_edge(
+    new UpdateEdgesRequest(&info, 6));
+  UpdateEdgesResponse res_edge;
+  ::graphlearn::io::EdgeValue value;
+  for (int32_t i = 0; i < 6; ++i) {
+    value.src_id = 5;
+    value.dst_id = dst_ids[i];
+    value.weight = 1.0;
+    req_edge->Append(&value);
+  }
+  GraphStore store(Env::Default());
+  Graph* graph = store.GetGraph("u-i");
+  graph->UpdateEdges(req_edge.get(), &res_edge);
+  IndexOption option;
+  option.name = "sort";
+  graph->Build(option);
+
+  OpFactory::GetInstance()->Set(&store);
+  Operator* op = OpFactory::GetInstance()->Create(
+    "RandomWithoutReplacementSampler");
+  EXPECT_TRUE(op != nullptr);
+
+  int32_t nbr_count = 3;
+  int32_t batch_size = 1000;
+  std::vector<int64_t> ids(batch_size, 5);
+  std::vector<int64_t> filters(batch_size, 50);
+  int32_t modes[2] = {kReplicate, kCircular};
+  for (int32_t mode : modes) {
+    GLOBAL_FLAG(PaddingMode) = mode;
+    SamplingRequest req(
+      "u-i", "RandomWithoutReplacementSampler", nbr_count, 1);
+    req.Set(ids.data(), batch_size);
+    req.SetFilters(filters.data(), batch_size);
+    SamplingResponse res;
+    EXPECT_TRUE(op->Process(&req, &res).ok());
+    ASSERT_EQ(res.TotalNeighborCount(), batch_size * nbr_count);
+    const int64_t* neighbor_ids = res.GetNeighborIds();
+    for (int32_t i = 0; i < batch_size * nbr_count; ++i) {
+      EXPECT_NE(neighbor_ids[i], 50);
+      EXPECT_NE(neighbor_ids[i], GLOBAL_FLAG(DefaultNeighborId));
+    }
+  }
+  GLOBAL_FLAG(PaddingMode) = kReplicate;
+}
+
 TEST_F(SamplerTest, Topk) {
   int32_t nbr_count = 2;
   SamplingRequest* req = new SamplingRequest("u-i", "TopkSampler", nbr_count);
@@ -319,6 +430,495 @@ TEST_F(SamplerTest, Full) {
   delete req;
 }
 
+TEST_F(SamplerTest, RandomReversed) {
+  // Rebuild the graph with the reverse index of in-edges
+  TearDown();
+  GLOBAL_FLAG(StorageMode) = 130;
+  SetUp();
+  GLOBAL_FLAG(StorageMode) = 2;
+
+  int32_t nbr_count = 2;
+  SamplingRequest* req = new SamplingRequest("u-i", "RandomSampler", nbr_count);
+  req->SetReversed();
+  SamplingResponse* res = new SamplingResponse();
+
+  // 21 has the in-neighbor 1 by edge 4, 1 has no in-neighbors
+  int32_t batch_size = 2;
+  int64_t ids[2] = {21, 1};
+  req->Set(ids, batch_size);
+
+  // The direction is kept when sharding
+  std::unique_ptr<OpRequest> clone(req->Clone());
+  EXPECT_TRUE(static_cast<SamplingRequest*>(clone.get())->IsReversed());
+
+  OpFactory::GetInstance()->Set(graph_store_);
+  Operator* op = OpFactory::GetInstance()->Create(req->Name());
+  EXPECT_TRUE(op != nullptr);
+
+  // The in-edges of an id are spread over the servers
+  GLOBAL_FLAG(ServerCount) = 2;
+  EXPECT_TRUE(error::IsUnimplemented(op->Process(req, res)));
+  GLOBAL_FLAG(ServerCount) = 1;
+
+  Status s = op->Process(req, res);
+  EXPECT_TRUE(s.ok());
+
+  EXPECT_EQ(res->BatchSize(), batch_size);
+  EXPECT_EQ(res->NeighborCount(), nbr_count);
+
+  const int64_t* neighbor_ids = res->GetNeighborIds();
+  const int64_t* edge_ids = res->GetEdgeIds();
+  for (int32_t i = 0; i < nbr_count; ++i) {
+    EXPECT_EQ(neighbor_ids[i], 1);
+    EXPECT_EQ(edge_ids[i], 4);
+  }
+  for (int32_t i = nbr_count; i < batch_size * nbr_count; ++i) {
+    EXPECT_EQ(neighbor_ids[i], GLOBAL_FLAG(DefaultNeighborId));
+    EXPECT_EQ(edge_ids[i], -1);
+  }
+
+  delete res;
+  delete req;
+}
+
+TEST_F(SamplerTest, WeightedWithSamplingTable) {
+  // Rebuild the graph with the precomputed sampling tables
+  TearDown();
+  GLOBAL_FLAG(StorageMode) = 258;
+  SetUp();
+  GLOBAL_FLAG(StorageMode) = 2;
+
+  auto storage = graph_store_->GetGraph("u-i")->GetLocalStorage();
+  EXPECT_EQ(storage->GetEdgeWeightTable(0).Size(), 3);
+  EXPECT_EQ(storage->GetInDegreeTable(1).Size(), 2);
+
+  OpFactory::GetInstance()->Set(graph_store_);
+  std::string names[2] = {"EdgeWeightSampler", "InDegreeSampler"};
+  for (const std::string& name : names) {
+    int32_t nbr_count = 20;
+    SamplingRequest* req = new SamplingRequest("u-i", name, nbr_count);
+    SamplingResponse* res = new SamplingResponse();
+
+    int32_t batch_size = 2;
+    int64_t ids[2] = {0, 1};
+    req->Set(ids, batch_size);
+
+    Operator* op = OpFactory::GetInstance()->Create(req->Name());
+    EXPECT_TRUE(op != nullptr);
+
+    Status s = op->Process(req, res);
+    EXPECT_TRUE(s.ok());
+    EXPECT_EQ(res->BatchSize(), batch_size);
+    EXPECT_EQ(res->NeighborCount(), nbr_count);
+
+    // The neighbors match the sampled edges
+    const int64_t* neighbor_ids = res->GetNeighborIds();
+    const int64_t* edge_ids = res->GetEdgeIds();
+    for (int32_t i = 0; i < batch_size * nbr_count; ++i) {
+      EXPECT_EQ(storage->GetSrcId(edge_ids[i]), ids[i / nbr_count]);
+      EXPECT_EQ(storage->GetDstId(edge_ids[i]), neighbor_ids[i]);
+    }
+
+    delete res;
+    delete req;
+  }
+}
+
+TEST_F(SamplerTest, Seeded) {
+  OpFactory::GetInstance()->Set(graph_store_);
+  std::string names[4] = {"RandomSampler", "RandomWithoutReplacementSampler",
+                          "EdgeWeightSampler", "InDegreeSampler"};
+  for (const std::string& name : names) {
+    int32_t nbr_count = 10;
+    int32_t batch_size = 4;
+    int64_t ids[4] = {0, 1, 0, 1};
+    std::vector<int64_t> results[2];
+    for (int32_t k = 0; k < 2; ++k) {
+      SamplingRequest* req = new SamplingRequest("u-i", name, nbr_count);
+      req->SetSeed(7);
+      req->Set(ids, batch_size);
+      SamplingResponse* res = new SamplingResponse();
+
+      // The seed is kept when sharding
+      std::unique_ptr<OpRequest> clone(req->Clone());
+      auto cloned = static_cast<SamplingRequest*>(clone.get());
+      EXPECT_TRUE(cloned->HasSeed());
+      EXPECT_EQ(cloned->Seed(), 7);
+
+      Operator* op = OpFactory::GetInstance()->Create(req->Name());
+      EXPECT_TRUE(op != nullptr);
+      Status s = op->Process(req, res);
+      EXPECT_TRUE(s.ok());
+
+      const int64_t* neighbor_ids = res->GetNeighborIds();
+      results[k].assign(neighbor_ids, neighbor_ids + batch_size * nbr_count);
+      delete res;
+      delete req;
+    }
+    // The same request gives the same samples
+    EXPECT_EQ(results[0], results[1]);
+  }
+
+  // From the int32 params of a dag node
+  Tensor::Map params;
+  ADD_TENSOR(params, kEdgeType, kString, 1);
+  params[kEdgeType].AddString("u-i");
+  ADD_TENSOR(params, kStrategy, kString, 1);
+  params[kStrategy].AddString("RandomSampler");
+  ADD_TENSOR(params, kNeighborCount, kInt32, 1);
+  params[kNeighborCount].AddInt32(2);
+  SamplingRequest req;
+  req.Init(params);
+  EXPECT_FALSE(req.HasSeed());
+  ADD_TENSOR(params, kSeed, kInt32, 1);
+  params[kSeed].AddInt32(3);
+  SamplingRequest seeded;
+  seeded.Init(params);
+  EXPECT_TRUE(seeded.HasSeed());
+  EXPECT_EQ(seeded.Seed(), 3);
+}
+
+TEST_F(SamplerTest, SeededShards) {
+  OpFactory::GetInstance()->Set(graph_store_);
+  std::string names[4] = {"RandomSampler", "RandomWithoutReplacementSampler",
+                          "EdgeWeightSampler", "InDegreeSampler"};
+  for (const std::string& name : names) {
+    int32_t nbr_count = 10;
+    // The whole batch, and the shards of it on two servers
+    std::vector<int64_t> batches[3] = {{0, 1, 0, 1}, {0, 0}, {1, 1}};
+    std::vector<int64_t> results[3];
+    for (int32_t k = 0; k < 3; ++k) {
+      SamplingRequest* req = new SamplingRequest("u-i", name, nbr_count);
+      req->SetSeed(7);
+      req->Set(batches[k].data(), batches[k].size());
+      SamplingResponse* res = new SamplingResponse();
+
+      Operator* op = OpFactory::GetInstance()->Create(req->Name());
+      EXPECT_TRUE(op != nullptr);
+      Status s = op->Process(req, res);
+      EXPECT_TRUE(s.ok());
+
+      const int64_t* neighbor_ids = res->GetNeighborIds();
+      results[k].assign(neighbor_ids,
+                        neighbor_ids + batches[k].size() * nbr_count);
+      delete res;
+      delete req;
+    }
+
+    // Each occurrence of an id gets the same samples wherever it is
+    int32_t rows[4][2] = {{1, 0}, {2, 0}, {1, 1}, {2, 1}};
+    for (int32_t i = 0; i < 4; ++i) {
+      auto whole = results[0].begin() + i * nbr_count;
+      auto shard = results[rows[i][0]].begin() + rows[i][1] * nbr_count;
+      EXPECT_TRUE(std::equal(whole, whole + nbr_count, shard));
+    }
+
+    // While a repeated id is sampled afresh
+    if (name == "RandomSampler") {
+      EXPECT_FALSE(std::equal(results[0].begin(),
+                              results[0].begin() + nbr_count,
+                              results[0].begin() + 2 * nbr_count));
+    }
+  }
+}
+
+TEST_F(SamplerTest, Parallel) {
+  OpFactory::GetInstance()->Set(graph_store_);
+  std::string names[8] = {
+    "RandomSampler", "RandomWithoutReplacementSampler", "TopkSampler",
+    "EdgeWeightSampler", "InDegreeSampler", "FullSampler",
+    "RandomNegativeSampler", "InDegreeNegativeSampler"};
+
+  // 2 has no neighbors
+  int32_t batch_size = 2000;
+  std::vector<int64_t> ids(batch_size);
+  for (int32_t i = 0; i < batch_size; ++i) {
+    ids[i] = i % 3;
+  }
+
+  for (const std::string& name : names) {
+    int32_t nbr_count = 3;
+    std::vector<int64_t> neighbors[2];
+    std::vector<int64_t> edges[2];
+    std::vector<int32_t> degrees[2];
+    // Serially and in chunks, with the same seed
+    int32_t thresholds[2] = {0, 100};
+    for (int32_t k = 0; k < 2; ++k) {
+      GLOBAL_FLAG(ParallelSamplingThreshold) = thresholds[k];
+      SamplingRequest* req = new SamplingRequest("u-i", name, nbr_count);
+      req->SetSeed(11);
+      req->Set(ids.data(), batch_size);
+      SamplingResponse* res = new SamplingResponse();
+
+      Operator* op = OpFactory::GetInstance()->Create(req->Name());
+      EXPECT_TRUE(op != nullptr);
+      Status s = op->Process(req, res);
+      EXPECT_TRUE(s.ok());
+      EXPECT_EQ(res->BatchSize(), batch_size);
+      if (!res->IsSparse()) {
+        EXPECT_EQ(res->TotalNeighborCount(), batch_size * nbr_count);
+      }
+
+      int32_t total = res->TotalNeighborCount();
+      neighbors[k].assign(res->GetNeighborIds(),
+                          res->GetNeighborIds() + total);
+      if (name.find("Negative") == std::string::npos) {
+        edges[k].assign(res->GetEdgeIds(), res->GetEdgeIds() + total);
+      }
+      if (res->IsSparse()) {
+        degrees[k].assign(res->GetDegrees(),
+                          res->GetDegrees() + batch_size);
+      }
+      delete res;
+      delete req;
+    }
+    EXPECT_EQ(neighbors[0].size(), neighbors[1].size());
+    EXPECT_EQ(neighbors[0], neighbors[1]);
+    EXPECT_EQ(edges[0], edges[1]);
+    EXPECT_EQ(degrees[0], degrees[1]);
+  }
+  GLOBAL_FLAG(ParallelSamplingThreshold) = 1024;
+}
+
+TEST_F(SamplerTest, MultiHop) {
+  MultiHopSamplingRequest* req = new MultiHopSamplingRequest();
+  req->AddHop("u-i", "RandomSampler", 2);
+  // Items have no out-neighbors, so each of them gets an empty row.
+  req->AddHop("u-i", "FullSampler", 3);
+  req->SetSeed(7);
+  req->SetDedup();
+  MultiHopSamplingResponse* res = new MultiHopSamplingResponse();
+
+  int32_t batch_size = 3;
+  int64_t ids[3] = {0, 1, 0};
+  req->Set(ids, batch_size);
+
+  // The hops, the seed and dedup are kept when cloning
+  std::unique_ptr<OpRequest> clone(req->Clone());
+  MultiHopSamplingRequest* cloned =
+    static_cast<MultiHopSamplingRequest*>(clone.get());
+  EXPECT_EQ(cloned->HopNum(), 2);
+  EXPECT_EQ(cloned->HopStrategy(1), "FullSampler");
+  EXPECT_EQ(cloned->HopNeighborCount(0), 2);
+  EXPECT_EQ(cloned->Seed(), 7);
+  EXPECT_TRUE(cloned->IsDedup());
+
+  OpFactory::GetInstance()->Set(graph_store_);
+  Operator* op = OpFactory::GetInstance()->Create(req->Name());
+  EXPECT_TRUE(op != nullptr);
+
+  Status s = op->Process(req, res);
+  EXPECT_TRUE(s.ok());
+  EXPECT_EQ(res->HopNum(), 2);
+
+  EXPECT_EQ(res->SourceCount(0), batch_size);
+  EXPECT_EQ(res->NeighborCount(0), batch_size * 2);
+  const int32_t* degrees = res->GetDegrees(0);
+  const int64_t* nbr_ids = res->GetNeighborIds(0);
+  const int64_t* edge_ids = res->GetEdgeIds(0);
+  std::unordered_set<int64_t> nbrs_of_0({10, 20, 30});
+  std::unordered_set<int64_t> nbrs_of_1({11, 21});
+  for (int32_t i = 0; i < batch_size; ++i) {
+    EXPECT_EQ(degrees[i], 2);
+  }
+  for (int32_t i = 0; i < 2; ++i) {
+    EXPECT_TRUE(nbrs_of_0.find(nbr_ids[i]) != nbrs_of_0.end());
+    EXPECT_TRUE(nbrs_of_1.find(nbr_ids[2 + i]) != nbrs_of_1.end());
+    // The same seed is sampled only once.
+    EXPECT_EQ(nbr_ids[4 + i], nbr_ids[i]);
+    EXPECT_EQ(edge_ids[4 + i], edge_ids[i]);
+    EXPECT_GE(edge_ids[i], 0);
+  }
+
+  EXPECT_EQ(res->SourceCount(1), batch_size * 2);
+  EXPECT_EQ(res->NeighborCount(1), 0);
+  degrees = res->GetDegrees(1);
+  for (int32_t i = 0; i < res->SourceCount(1); ++i) {
+    EXPECT_EQ(degrees[i], 0);
+  }
+
+  // A seeded request gives the same samples again.
+  MultiHopSamplingResponse* again = new MultiHopSamplingResponse();
+  s = op->Process(req, again);
+  EXPECT_TRUE(s.ok());
+  for (int32_t i = 0; i < res->NeighborCount(0); ++i) {
+    EXPECT_EQ(again->GetNeighborIds(0)[i], nbr_ids[i]);
+  }
+
+  delete again;
+  delete res;
+  delete req;
+}
+
+TEST_F(SamplerTest, MultiHopRepeatedSources) {
+  int32_t nbr_count = 10;
+  MultiHopSamplingRequest req;
+  req.AddHop("u-i", "RandomSampler", nbr_count);
+  req.SetSeed(7);
+  EXPECT_FALSE(req.IsDedup());
+  int64_t ids[2] = {0, 0};
+  req.Set(ids, 2);
+
+  OpFactory::GetInstance()->Set(graph_store_);
+  Operator* op = OpFactory::GetInstance()->Create(req.Name());
+  EXPECT_TRUE(op != nullptr);
+  MultiHopSamplingResponse res;
+  EXPECT_TRUE(op->Process(&req, &res).ok());
+  ASSERT_EQ(res.NeighborCount(0), 2 * nbr_count);
+
+  // A repeated source is sampled independently without dedup
+  const int64_t* nbr_ids = res.GetNeighborIds(0);
+  EXPECT_FALSE(std::equal(nbr_ids, nbr_ids + nbr_count,
+                          nbr_ids + nbr_count));
+}
+
+TEST_F(SamplerTest, Compact) {
+  int32_t nbr_count = 2;
+  SamplingRequest* req = new SamplingRequest("u-i", "RandomSampler", nbr_count);
+  req->SetCompact();
+  std::unique_ptr<OpRequest> clone(req->Clone());
+  EXPECT_TRUE(static_cast<SamplingRequest*>(clone.get())->IsCompact());
+
+  // 0 and 1 have disjoint neighbors, and 0 comes twice.
+  int32_t batch_size = 3;
+  int64_t ids[3] = {0, 1, 0};
+  req->Set(ids, batch_size);
+  SamplingResponse* res = new SamplingResponse();
+
+  OpFactory::GetInstance()->Set(graph_store_);
+  Operator* op = OpFactory::GetInstance()->Create(req->Name());
+  Status s = op->Process(req, res);
+  EXPECT_TRUE(s.ok());
+
+  EXPECT_TRUE(res->IsCompacted());
+  EXPECT_TRUE(res->GetNeighborIds() == nullptr);
+  EXPECT_EQ(res->TotalNeighborCount(), batch_size * nbr_count);
+  EXPECT_LE(res->UniqueNodeCount(), 5);
+
+  std::unordered_set<int64_t> unique_ids(
+    res->GetUniqueIds(), res->GetUniqueIds() + res->UniqueNodeCount());
+  EXPECT_EQ(static_cast<int32_t>(unique_ids.size()), res->UniqueNodeCount());
+
+  std::vector<std::unordered_set<int64_t>> nbr_sets(
+    {{10, 20, 30}, {11, 21}, {10, 20, 30}});
+  const int32_t* index = res->GetUniqueIndex();
+  for (int32_t i = 0; i < batch_size * nbr_count; ++i) {
+    EXPECT_GE(index[i], 0);
+    EXPECT_LT(index[i], res->UniqueNodeCount());
+    int64_t nbr_id = res->GetUniqueIds()[index[i]];
+    EXPECT_TRUE(nbr_sets[i / nbr_count].count(nbr_id) == 1);
+  }
+
+  // Stitch the compacted shards of {0, 0} and {1} back into {0, 1, 0}.
+  int64_t shard_ids[2][2] = {{0, 0}, {1, 1}};
+  SamplingResponse shard_res[2];
+  for (int32_t i = 0; i < 2; ++i) {
+    SamplingRequest shard_req("u-i", "RandomSampler", nbr_count);
+    shard_req.SetCompact();
+    shard_req.Set(shard_ids[i], 2 - i);
+    EXPECT_TRUE(op->Process(&shard_req, &shard_res[i]).ok());
+  }
+  ShardsPtr<OpResponse> shards(new Shards<OpResponse>(2));
+  shards->Add(0, &shard_res[0], false);
+  shards->AddSticker(0, 0);
+  shards->AddSticker(0, 2);
+  shards->Add(1, &shard_res[1], false);
+  shards->AddSticker(1, 1);
+
+  SamplingResponse stitched;
+  stitched.Stitch(shards);
+  EXPECT_TRUE(stitched.IsCompacted());
+  EXPECT_EQ(stitched.BatchSize(), batch_size);
+  EXPECT_EQ(stitched.TotalNeighborCount(), batch_size * nbr_count);
+  index = stitched.GetUniqueIndex();
+  for (int32_t i = 0; i < batch_size * nbr_count; ++i) {
+    EXPECT_LT(index[i], stitched.UniqueNodeCount());
+    int64_t nbr_id = stitched.GetUniqueIds()[index[i]];
+    EXPECT_TRUE(nbr_sets[i / nbr_count].count(nbr_id) == 1);
+  }
+
+  delete res;
+  delete req;
+}
+
+TEST_F(SamplerTest, Layerwise) {
+  std::unordered_map<int64_t, std::unordered_set<int64_t>> nbrs(
+    {{0, {10, 20, 30}}, {1, {11, 21}}, {2, {}}});
+  int32_t layer_size = 3;
+  LayerSamplingRequest* req = new LayerSamplingRequest("u-i", layer_size);
+  req->SetSeed(9);
+  int64_t ids[3] = {0, 1, 2};
+  req->Set(ids, 3);
+  EXPECT_EQ(req->TotalSize(), 3);
+
+  std::unique_ptr<OpRequest> clone(req->Clone());
+  LayerSamplingRequest* cloned = static_cast<LayerSamplingRequest*>(clone.get());
+  EXPECT_EQ(cloned->LayerSize(), layer_size);
+  EXPECT_EQ(cloned->TotalSize(), 3);
+  EXPECT_EQ(cloned->Seed(), 9);
+
+  LayerSamplingResponse* res = new LayerSamplingResponse();
+  OpFactory::GetInstance()->Set(graph_store_);
+  Operator* op = OpFactory::GetInstance()->Create(req->Name());
+  EXPECT_TRUE(op != nullptr);
+  Status s = op->Process(req, res);
+  EXPECT_TRUE(s.ok());
+
+  auto check = [&nbrs, &ids] (const LayerSamplingResponse* res,
+                              int32_t max_size) {
+    EXPECT_GT(res->NodeCount(), 0);
+    EXPECT_LE(res->NodeCount(), max_size);
+    std::unordered_set<int64_t> layer(
+      res->NodeIds(), res->NodeIds() + res->NodeCount());
+    EXPECT_EQ(static_cast<int32_t>(layer.size()), res->NodeCount());
+
+    // All the edges from the sources to the layer, and only them.
+    int32_t edge_count = 0;
+    for (int32_t i = 0; i < 3; ++i) {
+      for (int64_t id : layer) {
+        edge_count += nbrs[ids[i]].count(id);
+      }
+    }
+    EXPECT_EQ(res->EdgeCount(), edge_count);
+    for (int32_t i = 0; i < res->EdgeCount(); ++i) {
+      int64_t src_id = ids[res->RowIndices()[i]];
+      int64_t dst_id = res->NodeIds()[res->ColIndices()[i]];
+      EXPECT_EQ(nbrs[src_id].count(dst_id), 1);
+      EXPECT_GE(res->EdgeIds()[i], 0);
+      EXPECT_GT(res->EdgeWeights()[i], 0.0);
+    }
+  };
+  check(res, layer_size);
+
+  // Stitch the layers of the shards {0, 2} and {1}, where each one
+  // samples its share of the layer size.
+  int64_t shard_ids[2][2] = {{0, 2}, {1, 1}};
+  LayerSamplingResponse shard_res[2];
+  for (int32_t i = 0; i < 2; ++i) {
+    std::unique_ptr<OpRequest> shard_req(req->Clone());
+    static_cast<LayerSamplingRequest*>(shard_req.get())->Set(
+      shard_ids[i], 2 - i);
+    static_cast<LayerSamplingRequest*>(shard_req.get())->params_[
+      kTotalSize].SetInt32(0, 3);
+    EXPECT_TRUE(op->Process(shard_req.get(), &shard_res[i]).ok());
+  }
+  ShardsPtr<OpResponse> shards(new Shards<OpResponse>(2));
+  shards->Add(0, &shard_res[0], false);
+  shards->AddSticker(0, 0);
+  shards->AddSticker(0, 2);
+  shards->Add(1, &shard_res[1], false);
+  shards->AddSticker(1, 1);
+
+  LayerSamplingResponse stitched;
+  stitched.Stitch(shards);
+  EXPECT_EQ(stitched.BatchSize(), 3);
+  // The shares of 2 and 1 sources are 2 and 1 nodes.
+  check(&stitched, layer_size);
+
+  delete res;
+  delete req;
+}
+
 TEST_F(SamplerTest, DISABLED_NodeWeightNegative) {
   int32_t nbr_count = 2;
   SamplingRequest* req = new SamplingRequest("user", "NodeWeightNegativeSampler", nbr_count);
@@ -27,8 +27,15 @@ public:
 
   Status Sample(const SamplingRequest* req,
                 SamplingResponse* res) override {
+    return ParallelSample(req, res);
+  }
+
+protected:
+  Status SampleRange(const SamplingRequest* req,
+                     int32_t begin, int32_t end,
+                     SamplingResponse* res) override {
     int32_t count = req->NeighborCount();
-    int32_t batch_size = req->BatchSize();
+    int32_t batch_size = end - begin;
 
     res->SetBatchSize(batch_size);
     res->SetNeighborCount(count);
@@ -42,14 +49,14 @@ public:
     Status s;
     const int64_t* src_ids = req->GetSrcIds();
     const int64_t* filters = req->GetFilters();
-    for (int32_t i = 0; i < batch_size; ++i) {
+    for (int32_t i = begin; i < end; ++i) {
       int64_t src_id = src_ids[i];
-      auto neighbor_ids = storage->GetNeighbors(src_id);
+      auto neighbor_ids = GetNeighbors(req, storage, src_id);
       if (!neighbor_ids) {
         res->FillWith(GLOBAL_FLAG(DefaultNeighborId), -1);
       } else {
         int32_t neighbor_size = neighbor_ids.Size();
-        auto edge_ids = storage->GetOutEdges(src_id);
+        auto edge_ids = GetEdges(req, storage, src_id);
         auto padder = GetPadder(neighbor_ids, edge_ids);
         if (filters) {
           padder->SetFilter(filters[i]);
@@ -0,0 +1,95 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <unordered_set>
+#include "graphlearn/common/base/random.h"
+#include "graphlearn/core/graph/graph_store.h"
+#include "graphlearn/core/graph/storage/graph_storage.h"
+#include "graphlearn/core/operator/subgraph/subgraph_sampler.h"
+
+namespace graphlearn {
+namespace op {
+
+/// Sample the nodes as a union of random clusters, which are built over
+/// the edges with the storage mode 1024. The nodes of a cluster link to
+/// each other densely, so the induced subgraph keeps most of the edges.
+class ClusterSubGraphSampler : public SubGraphSampler {
+public:
+  Status Process(const OpRequest* req,
+                 OpResponse* res) override {
+    const SubGraphRequest* request =
+      static_cast<const SubGraphRequest*>(req);
+    SubGraphResponse* response =
+      static_cast<SubGraphResponse*>(res);
+
+    // The clusters belong to the edges of the neighbor type, so the seeds
+    // come from there instead of the nodes of the seed type.
+    std::set<int64_t> nodes_set;
+    Status s = SampleSeed(&nodes_set,
+                          graph_store_,
+                          request->NbrType(),
+                          request->BatchSize(),
+                          request->Epoch());
+    RETURN_IF_NOT_OK(s);
+    return InduceSubGraph(nodes_set, request, response);
+  }
+
+  /// Add the clusters in a random order, until the first one that does not
+  /// fit in the batch. A first cluster larger than the batch is truncated.
+  Status SampleSeed(std::set<int64_t>* nodes,
+                    GraphStore* graph_store,
+                    const std::string& type,
+                    int32_t batch_size,
+                    int32_t epoch) override {
+    Graph* graph = graph_store->GetGraph(type);
+    if (!graph) {
+      LOG(ERROR) << "Edge type " << type << " not existed.";
+      return error::NotFound("Edge type not found.");
+    }
+    ::graphlearn::io::GraphStorage* storage = graph->GetLocalStorage();
+    ::graphlearn::io::IndexType cluster_count = storage->GetClusterCount();
+    if (cluster_count == 0) {
+      return error::InvalidArgument(
+        "No clusters of " + type + ", which needs the storage mode 1024.");
+    }
+
+    PhiloxRandom rng(NewRandomSeed());
+    std::unordered_set<::graphlearn::io::IndexType> picked;
+    while (nodes->size() < static_cast<size_t>(batch_size) &&
+           picked.size() < static_cast<size_t>(cluster_count)) {
+      ::graphlearn::io::IndexType cluster = rng.Uniform(cluster_count);
+      if (!picked.insert(cluster).second) {
+        continue;
+      }
+      auto ids = storage->GetCluster(cluster);
+      int32_t size = ids.Size();
+      if (nodes->size() + size > static_cast<size_t>(batch_size)) {
+        if (!nodes->empty()) {
+          break;
+        }
+        size = batch_size;
+      }
+      for (int32_t i = 0; i < size; ++i) {
+        nodes->insert(ids[i]);
+      }
+    }
+    return Status::OK();
+  }
+};
+
+REGISTER_OPERATOR("ClusterSubGraphSampler", ClusterSubGraphSampler);
+
+}  // namespace op
+}  // namespace graphlearn
@@ -0,0 +1,175 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "graphlearn/common/base/errors.h"
+#include "graphlearn/common/base/log.h"
+#include "graphlearn/common/threading/runner/parallel_for.h"
+#include "graphlearn/core/graph/graph_store.h"
+#include "graphlearn/core/graph/storage/graph_storage.h"
+#include "graphlearn/core/graph/storage/id_hash_map.h"
+#include "graphlearn/core/operator/operator.h"
+#include "graphlearn/core/operator/op_registry.h"
+#include "graphlearn/include/client.h"
+#include "graphlearn/include/subgraph_request.h"
+#include "graphlearn/platform/env.h"
+
+namespace graphlearn {
+namespace op {
+
+namespace {
+
+// Each chunk has at least so many rows.
+const int32_t kMinChunkSize = 256;
+
+struct Edge {
+  int32_t row;
+  int32_t col;
+  int64_t edge_id;
+};
+
+}  // anonymous namespace
+
+/// Map all the nodes to their columns in one flat hash table, and then
+/// look up the neighbors of the rows in it by chunks in parallel, which
+/// costs O(the neighbors of the rows) instead of O(n^2).
+class SubGraphInducer : public RemoteOperator {
+public:
+  virtual ~SubGraphInducer() {}
+
+  Status Process(const OpRequest* req,
+                 OpResponse* res) override {
+    const InduceSubGraphRequest* request =
+      static_cast<const InduceSubGraphRequest*>(req);
+    InduceSubGraphResponse* response =
+      static_cast<InduceSubGraphResponse*>(res);
+
+    Graph* graph = graph_store_->GetGraph(request->NbrType());
+    if (!graph) {
+      LOG(ERROR) << "Edge type " << request->NbrType() << " not existed.";
+      return error::NotFound("Edge type not found.");
+    }
+    ::graphlearn::io::GraphStorage* storage = graph->GetLocalStorage();
+
+    int32_t node_count = request->NodeCount();
+    const int64_t* node_ids = request->NodeIds();
+    ::graphlearn::io::IdHashMap columns;
+    columns.Reserve(node_count);
+    for (int32_t i = 0; i < node_count; ++i) {
+      columns.Insert(node_ids[i], i);
+    }
+
+    int32_t row_count = request->RowCount();
+    const int64_t* row_ids = request->RowIds();
+    ThreadPool* tp = Env::Default()->IntraThreadPool();
+    int32_t chunk_num = 1;
+    if (tp != nullptr) {
+      chunk_num = std::min(
+        static_cast<int64_t>(tp->GetThreadNum()) * kBlocksPerThread,
+        static_cast<int64_t>(row_count / kMinChunkSize));
+      chunk_num = std::max(chunk_num, 1);
+    }
+    int32_t chunk_size = (row_count + chunk_num - 1) / chunk_num;
+
+    std::vector<std::vector<Edge>> chunks(chunk_num);
+    auto induce = [&] (int64_t begin, int64_t end) {
+      std::vector<int64_t> nbrs;
+      std::vector<int32_t> cols;
+      for (int64_t c = begin; c < end; ++c) {
+        int32_t row_end = std::min((c + 1) * chunk_size,
+                                   static_cast<int64_t>(row_count));
+        for (int32_t i = c * chunk_size; i < row_end; ++i) {
+          InduceRow(storage, columns, i, row_ids[i], &nbrs, &cols,
+                    &chunks[c]);
+        }
+      }
+    };
+    if (tp != nullptr && chunk_num > 1) {
+      ParallelFor(tp, chunk_num, 1, induce);
+    } else {
+      induce(0, chunk_num);
+    }
+
+    int32_t edge_count = 0;
+    for (auto& chunk : chunks) {
+      edge_count += chunk.size();
+    }
+    response->Init(row_count, edge_count);
+    for (auto& chunk : chunks) {
+      for (const Edge& e : chunk) {
+        response->AppendEdge(e.row, e.col, e.edge_id);
+      }
+    }
+    return Status::OK();
+  }
+
+  Status Call(int32_t remote_id,
+              const OpRequest* req,
+              OpResponse* res) override {
+    const InduceSubGraphRequest* request =
+      static_cast<const InduceSubGraphRequest*>(req);
+    InduceSubGraphResponse* response =
+      static_cast<InduceSubGraphResponse*>(res);
+    std::unique_ptr<Client> client(NewRpcClient(remote_id));
+    return client->InduceSubGraph(request, response);
+  }
+
+private:
+  void InduceRow(::graphlearn::io::GraphStorage* storage,
+                 const ::graphlearn::io::IdHashMap& columns,
+                 int32_t row, int64_t row_id,
+                 std::vector<int64_t>* nbrs,
+                 std::vector<int32_t>* cols,
+                 std::vector<Edge>* edges) {
+    auto nbr_ids = storage->GetNeighbors(row_id);
+    if (!nbr_ids) {
+      return;
+    }
+    auto edge_ids = storage->GetOutEdges(row_id);
+    int32_t degree = nbr_ids.Size();
+    nbrs->resize(degree);
+    for (int32_t k = 0; k < degree; ++k) {
+      (*nbrs)[k] = nbr_ids[k];
+    }
+    cols->resize(degree);
+    columns.FindBatch(nbrs->data(), degree, cols->data());
+
+    // Order the edges of the row by the columns, and keep the last edge of
+    // the neighbors that appear more than once.
+    size_t begin = edges->size();
+    for (int32_t k = 0; k < degree; ++k) {
+      if ((*cols)[k] != -1) {
+        edges->push_back(Edge{row, (*cols)[k], edge_ids[k]});
+      }
+    }
+    std::stable_sort(edges->begin() + begin, edges->end(),
+      [] (const Edge& a, const Edge& b) { return a.col < b.col; });
+    size_t last = begin;
+    for (size_t k = begin; k < edges->size(); ++k) {
+      if (k + 1 < edges->size() && (*edges)[k + 1].col == (*edges)[k].col) {
+        continue;
+      }
+      (*edges)[last++] = (*edges)[k];
+    }
+    edges->resize(last);
+  }
+};
+
+REGISTER_OPERATOR("InduceSubGraph", SubGraphInducer);
+
+}  // namespace op
+}  // namespace graphlearn
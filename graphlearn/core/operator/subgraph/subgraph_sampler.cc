@@ -13,63 +13,45 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
-#include <unordered_map>
-
 #include "graphlearn/core/operator/subgraph/subgraph_sampler.h"
 
-#include "graphlearn/include/client.h"
-#include "graphlearn/include/config.h"
+#include <memory>
+#include <vector>
+#include "graphlearn/core/operator/op_factory.h"
+#include "graphlearn/core/runner/op_runner.h"
+#include "graphlearn/platform/env.h"
 
 namespace graphlearn {
 namespace op {
 
-Status SampleNeighors(const SamplingRequest* req,
-                      SamplingResponse* res) {
-  std::unique_ptr<Client> client;
-  if (GLOBAL_FLAG(DeployMode) != kLocal) {
-    client.reset(NewRpcClient());
-  } else {
-    client.reset(NewInMemoryClient());
-  }
-  return client->Sampling(req, res);
-}
-
 Status SubGraphSampler::InduceSubGraph(
     const std::set<int64_t>& nodes_set,
     const SubGraphRequest* request,
     SubGraphResponse* response) {
   std::vector<int64_t> nodes(nodes_set.begin(), nodes_set.end());
-
   int32_t node_size = nodes.size();
-  SamplingRequest req(request->NbrType(), "FullSampler", node_size);
-  req.Set(nodes.data(), node_size);
-  SamplingResponse res;
-  Status s = SampleNeighors(&req, &res);
-  RETURN_IF_NOT_OK(s);
-
-  const int64_t* nbrs = res.GetNeighborIds();
-  const int32_t* degrees = res.GetDegrees();
-  const int64_t* edge_ids = res.GetEdgeIds();
-
   response->Init(node_size);
-  response->SetNodeIds(nodes.data(), nodes.size());
+  response->SetNodeIds(nodes.data(), node_size);
+  if (node_size == 0) {
+    return Status::OK();
+  }
 
-  int32_t offset = 0;
-  for (int32_t i = 0; i < node_size; ++i) {
-    std::unordered_map<int64_t, int64_t> nbr_node_edge_map;
-    for (int32_t k = offset; k < offset + degrees[i]; ++k) {
-      nbr_node_edge_map[nbrs[k]] = edge_ids[k];
-    }
-    offset += degrees[i];
+  // The rows are sent to the servers owning them, which find the edges
+  // of their own rows.
+  InduceSubGraphRequest req(request->NbrType());
+  req.Set(nodes.data(), node_size);
+  InduceSubGraphResponse res;
+  Operator* op = OpFactory::GetInstance()->Create(req.Name());
+  std::unique_ptr<OpRunner> runner = GetOpRunner(Env::Default(), op);
+  Status s = runner->Run(&req, &res);
+  RETURN_IF_NOT_OK(s);
 
-    for (int32_t j = 0; j < node_size; ++j) {
-      auto iter = nbr_node_edge_map.find(nodes[j]);
-      if (iter != nbr_node_edge_map.end()) {
-        response->AppendEdge(i, j, iter->second);
-      }
-    }
+  const int32_t* rows = res.RowIndices();
+  const int32_t* cols = res.ColIndices();
+  const int64_t* edge_ids = res.EdgeIds();
+  for (int32_t i = 0; i < res.EdgeCount(); ++i) {
+    response->AppendEdge(rows[i], cols[i], edge_ids[i]);
   }
-
   return Status::OK();
 }
 
@@ -0,0 +1,200 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <map>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "graphlearn/core/graph/graph_store.h"
+#include "graphlearn/core/operator/op_factory.h"
+#include "graphlearn/include/config.h"
+#include "graphlearn/include/graph_request.h"
+#include "graphlearn/include/index_option.h"
+#include "graphlearn/include/subgraph_request.h"
+#include "graphlearn/platform/env.h"
+#include "gtest/gtest.h"
+
+using namespace graphlearn;  // NOLINT [build/namespaces]
+using namespace graphlearn::op;  // NOLINT [build/namespaces]
+
+class SubGraphOpTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    // Cluster the nodes for the cluster sampler.
+    GLOBAL_FLAG(StorageMode) = 1026;
+
+    // Each node i links to (i * 7 + k * 13) % kNodeNum for k in [0, 8),
+    // and to i + 1 twice.
+    std::vector<std::pair<int64_t, int64_t>> edges;
+    for (int64_t i = 0; i < kNodeNum; ++i) {
+      for (int64_t k = 0; k < 8; ++k) {
+        edges.emplace_back(i, (i * 7 + k * 13) % kNodeNum);
+      }
+      edges.emplace_back(i, (i + 1) % kNodeNum);
+      edges.emplace_back(i, (i + 1) % kNodeNum);
+    }
+
+    ::graphlearn::io::SideInfo info;
+    info.format = ::graphlearn::io::kWeighted;
+    info.type = "u-u";
+    info.src_type = "user";
+    info.dst_type = "user";
+    std::unique_ptr<UpdateEdgesRequest> req(
+      new UpdateEdgesRequest(&info, edges.size()));
+    std::unique_ptr<UpdateEdgesResponse> res(new UpdateEdgesResponse);
+
+    ::graphlearn::io::EdgeValue value;
+    for (auto& e : edges) {
+      value.src_id = e.first;
+      value.dst_id = e.second;
+      value.weight = 1.0;
+      req->Append(&value);
+    }
+
+    graph_store_ = new GraphStore(Env::Default());
+    Graph* graph = graph_store_->GetGraph("u-u");
+    graph->UpdateEdges(req.get(), res.get());
+
+    IndexOption option;
+    option.name = "sort";
+    graph->Build(option);
+    OpFactory::GetInstance()->Set(graph_store_);
+  }
+
+  void TearDown() override {
+    delete graph_store_;
+    GLOBAL_FLAG(StorageMode) = 2;
+  }
+
+  // The expected edges of the nodes by the nested loop, with the last edge
+  // of each pair.
+  std::map<std::pair<int32_t, int32_t>, int64_t> Expected(
+      const std::vector<int64_t>& nodes) {
+    std::map<std::pair<int32_t, int32_t>, int64_t> ret;
+    auto storage = graph_store_->GetGraph("u-u")->GetLocalStorage();
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      auto nbr_ids = storage->GetNeighbors(nodes[i]);
+      auto edge_ids = storage->GetOutEdges(nodes[i]);
+      for (int32_t k = 0; k < nbr_ids.Size(); ++k) {
+        for (size_t j = 0; j < nodes.size(); ++j) {
+          if (nbr_ids[k] == nodes[j]) {
+            ret[std::make_pair(i, j)] = edge_ids[k];
+          }
+        }
+      }
+    }
+    return ret;
+  }
+
+  void CheckEdges(const std::vector<int64_t>& nodes,
+                  const InduceSubGraphResponse* res) {
+    auto expected = Expected(nodes);
+    EXPECT_EQ(res->EdgeCount(), static_cast<int32_t>(expected.size()));
+    int32_t i = 0;
+    for (auto& it : expected) {
+      if (i >= res->EdgeCount()) {
+        break;
+      }
+      EXPECT_EQ(res->RowIndices()[i], it.first.first);
+      EXPECT_EQ(res->ColIndices()[i], it.first.second);
+      EXPECT_EQ(res->EdgeIds()[i], it.second);
+      ++i;
+    }
+  }
+
+protected:
+  static const int64_t kNodeNum = 2000;
+  GraphStore* graph_store_;
+};
+
+const int64_t SubGraphOpTest::kNodeNum;
+
+TEST_F(SubGraphOpTest, InduceSubGraph) {
+  // Enough nodes to induce by chunks in parallel.
+  std::vector<int64_t> nodes;
+  for (int64_t i = 0; i < kNodeNum; i += 2) {
+    nodes.push_back(i);
+  }
+  nodes.push_back(kNodeNum + 1);
+
+  InduceSubGraphRequest req("u-u");
+  req.Set(nodes.data(), nodes.size());
+  InduceSubGraphResponse res;
+  Operator* op = OpFactory::GetInstance()->Create(req.Name());
+  EXPECT_TRUE(op != nullptr);
+  EXPECT_TRUE(op->Process(&req, &res).ok());
+  CheckEdges(nodes, &res);
+}
+
+TEST_F(SubGraphOpTest, Stitch) {
+  std::vector<int64_t> nodes({0, 1, 7, 13, 14, 20, 21, 26});
+  InduceSubGraphRequest req("u-u");
+  req.Set(nodes.data(), nodes.size());
+
+  // Shard the rows by odd and even positions.
+  ShardsPtr<OpResponse> shards(new Shards<OpResponse>(2));
+  InduceSubGraphResponse shard_res[2];
+  Operator* op = OpFactory::GetInstance()->Create(req.Name());
+  for (int32_t p = 0; p < 2; ++p) {
+    std::unique_ptr<OpRequest> shard_req(req.Clone());
+    for (size_t i = p; i < nodes.size(); i += 2) {
+      shard_req->tensors_[kSrcIds].AddInt64(nodes[i]);
+      shards->AddSticker(p, i);
+    }
+    EXPECT_EQ(static_cast<InduceSubGraphRequest*>(
+      shard_req.get())->NodeCount(), 8);
+    EXPECT_TRUE(op->Process(shard_req.get(), &shard_res[p]).ok());
+  }
+  // Add the later shard first, which the stitching should not rely on.
+  shards->Add(1, &shard_res[1], false);
+  shards->Add(0, &shard_res[0], false);
+
+  InduceSubGraphResponse res;
+  res.Stitch(shards);
+  CheckEdges(nodes, &res);
+}
+
+TEST_F(SubGraphOpTest, ClusterSubGraphSampler) {
+  auto storage = graph_store_->GetGraph("u-u")->GetLocalStorage();
+  ASSERT_GT(storage->GetClusterCount(), 0);
+
+  SubGraphRequest req("user", "u-u", "ClusterSubGraphSampler", 600);
+  SubGraphResponse res;
+  Operator* op = OpFactory::GetInstance()->Create(req.Name());
+  EXPECT_TRUE(op != nullptr);
+  EXPECT_TRUE(op->Process(&req, &res).ok());
+  EXPECT_GT(res.NodeCount(), 0);
+  EXPECT_LE(res.NodeCount(), 600);
+
+  // Whole clusters only, which are smaller than the batch.
+  std::set<int64_t> nodes(res.NodeIds(), res.NodeIds() + res.NodeCount());
+  int32_t covered = 0;
+  for (int32_t c = 0; c < storage->GetClusterCount(); ++c) {
+    auto ids = storage->GetCluster(c);
+    int32_t count = 0;
+    for (int32_t i = 0; i < ids.Size(); ++i) {
+      count += nodes.count(ids[i]);
+    }
+    EXPECT_TRUE(count == 0 || count == ids.Size());
+    covered += count;
+  }
+  EXPECT_EQ(covered, res.NodeCount());
+
+  std::vector<int64_t> node_list(nodes.begin(), nodes.end());
+  EXPECT_EQ(res.EdgeCount(),
+            static_cast<int32_t>(Expected(node_list).size()));
+}
@@ -67,6 +67,14 @@ const std::vector<int32_t>* StorageWrapper::GetAllInDegrees() const {
   }
 }
 
+int64_t StorageWrapper::GetVersion() const {
+  if (node_storage_ != nullptr) {
+    return node_storage_->GetVersion();
+  } else {
+    return graph_storage_->GetVersion();
+  }
+}
+
 void StorageWrapper::Lock() {
   if (node_storage_ != nullptr) {
     node_storage_->Lock();
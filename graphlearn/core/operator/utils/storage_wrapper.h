@@ -34,6 +34,7 @@ public:
   const std::vector<float>* GetNodeWeights() const;
   const std::vector<int32_t>* GetAllInDegrees() const;
   ::graphlearn::io::Array<int64_t> GetNeighbors(int64_t src_id) const;
+  int64_t GetVersion() const;
   void Lock(); 
   void Unlock();
   const std::string& Type() const;
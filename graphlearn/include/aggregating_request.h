@@ -35,9 +35,14 @@ public:
            const int32_t* segment_ids,
            int32_t num_ids,
            int32_t num_segments);
+  /// Return the partial states of the non-empty segments, which are merged
+  /// by AggregatingResponse::Stitch(). Each shard of a partitioned request
+  /// is partial.
+  void SetPartial();
 
   const std::string& Type() const;
   const std::string& Strategy() const;
+  bool IsPartial() const { return partial_; }
   bool Next(int64_t* node_id, int32_t* segment_id);
   int32_t NumIds() const { return node_ids_->Size(); }
   bool SegmentEnd(int32_t segment_id) const;
@@ -51,6 +56,7 @@ private:
   Tensor* node_ids_;
   Tensor* segment_ids_;
   int32_t num_segments_;
+  bool    partial_;
 };
 
 class AggregatingResponse : public OpResponse {
@@ -78,6 +84,18 @@ public:
   void AppendSegment(int32_t size);
   const int32_t* Segments() const;
 
+  /// For a partial request, each embedding is the state of a non-empty
+  /// segment before FinalFunc(), such as the sum for the mean, and each
+  /// segment is the count of it. The ids of the segments are appended
+  /// along with them.
+  void SetPartial();
+  bool IsPartial() const { return segment_ids_ != nullptr; }
+  void AppendSegmentId(int32_t segment_id);
+  int32_t NumPartials() const;
+  const int32_t* SegmentIds() const;
+
+  /// Merge the partial states of the shards, so that only the states cross
+  /// the network, whatever the sizes of the segments are.
   void Stitch(ShardsPtr<OpResponse> shards) override;
 
 protected:
@@ -88,6 +106,7 @@ private:
   int32_t emb_dim_;
   Tensor* embs_;
   Tensor* segments_;
+  Tensor* segment_ids_;
 };
 
 }  // namespace graphlearn
@@ -45,10 +45,15 @@ public:
   DECLARE_METHOD(LookupNodes);
   DECLARE_METHOD(GetTopology);
   DECLARE_METHOD(Sampling);
+  DECLARE_METHOD(MultiHopSampling);
+  DECLARE_METHOD(RandomWalk);
+  DECLARE_METHOD(LayerSampling);
   DECLARE_METHOD(Aggregating);
   DECLARE_METHOD(SubGraph);
+  DECLARE_METHOD(InduceSubGraph);
   DECLARE_METHOD(GetCount);
   DECLARE_METHOD(GetDegree);
+  DECLARE_METHOD(CheckEdges);
 
   Status RunOp(const OpRequest* request, OpResponse* response);
 
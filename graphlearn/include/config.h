@@ -101,8 +101,11 @@ DECLARE_FLOAT_GLOBAL_FLAG(DefaultFloatAttribute)
 DECLARE_STRING_GLOBAL_FLAG(DefaultStringAttribute)
 DECLARE_STRING_GLOBAL_FLAG(Tracker)
 DECLARE_STRING_GLOBAL_FLAG(ServerHosts)
+DECLARE_STRING_GLOBAL_FLAG(SnapshotDir)
 DECLARE_INT32_GLOBAL_FLAG(NegativeSamplingRetryTimes)
 DECLARE_INT32_GLOBAL_FLAG(IgnoreInvalid)
+DECLARE_INT32_GLOBAL_FLAG(ParallelSamplingThreshold)
+DECLARE_INT32_GLOBAL_FLAG(MaxClusterSize)
 
 // Declare the setters
 DECLARE_SET_INT32_GLOBAL_FLAG(DeployMode)
@@ -132,8 +135,11 @@ DECLARE_SET_FLOAT_GLOBAL_FLAG(DefaultFloatAttribute)
 DECLARE_SET_STRING_GLOBAL_FLAG(DefaultStringAttribute)
 DECLARE_SET_STRING_GLOBAL_FLAG(Tracker)
 DECLARE_SET_STRING_GLOBAL_FLAG(ServerHosts)
+DECLARE_SET_STRING_GLOBAL_FLAG(SnapshotDir)
 DECLARE_SET_INT32_GLOBAL_FLAG(NegativeSamplingRetryTimes)
 DECLARE_SET_INT32_GLOBAL_FLAG(IgnoreInvalid)
+DECLARE_SET_INT32_GLOBAL_FLAG(ParallelSamplingThreshold)
+DECLARE_SET_INT32_GLOBAL_FLAG(MaxClusterSize)
 
 // Declare the getters
 DECLARE_GET_INT32_GLOBAL_FLAG(TrackerMode)
@@ -64,6 +64,22 @@ extern const char* kFilterIds;
 extern const char* kDegrees;
 extern const char* kEpoch;
 extern const char* kNodeFrom;
+extern const char* kSeed;
+extern const char* kHopTypes;
+extern const char* kHopStrategies;
+extern const char* kHopCounts;
+extern const char* kHopOffsets;
+extern const char* kCompact;
+extern const char* kUniqueIds;
+extern const char* kUniqueIndex;
+extern const char* kExists;
+extern const char* kWalkLength;
+extern const char* kReturnParam;
+extern const char* kInOutParam;
+extern const char* kLayerSize;
+extern const char* kTotalSize;
+extern const char* kPartial;
+extern const char* kDedup;
 
 enum SystemState {
   kBlank = 0,
@@ -87,6 +103,15 @@ enum Direction {
   kReversed
 };
 
+// How the float attributes are held in a column mode storage.
+// kInt8 is quantized symmetrically with a float scale per row.
+enum FloatFormat {
+  kFp32 = 0,
+  kFp16 = 1,
+  kBf16 = 2,
+  kInt8 = 3
+};
+
 }  // namespace io
 
 enum DataType {
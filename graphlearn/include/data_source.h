@@ -43,13 +43,19 @@ struct AttributeInfo {
   // Ignore the invalid attributes or not.
   bool ignore_invalid;
 
-  AttributeInfo() : ignore_invalid(GLOBAL_FLAG(IgnoreInvalid)) {}
+  // Hold the float attributes in reduced precision to save memory, which
+  // only takes effect in column mode. Default is kFp32.
+  FloatFormat float_format;
+
+  AttributeInfo()
+      : ignore_invalid(GLOBAL_FLAG(IgnoreInvalid)), float_format(kFp32) {}
 
   AttributeInfo(const AttributeInfo& right) {
     delimiter = right.delimiter;
     types = right.types;
     hash_buckets = right.hash_buckets;
     ignore_invalid = right.ignore_invalid;
+    float_format = right.float_format;
   }
 
   void AppendType(DataType type) {
@@ -63,6 +69,7 @@ struct AttributeInfo {
   void Serialize(std::stringstream* ss) const {
     *ss << " delimiter:" << delimiter
         << " ignore_invalid:" << ignore_invalid
+        << " float_format:" << static_cast<int32_t>(float_format)
         << " types:";
     for (size_t i = 0; i < types.size(); ++i) {
       *ss << static_cast<int32_t>(types[i]) << ',';
@@ -223,6 +223,7 @@ public:
   const std::string& EdgeType() const;
   int32_t Size() const;
   bool Next(int64_t* edge_id, int64_t* src_id);
+  const int64_t* EdgeIds() const;
 
 protected:
   void SetMembers() override;
@@ -249,6 +250,7 @@ public:
   const std::string& NodeType() const;
   int32_t Size() const;
   bool Next(int64_t* node_id);
+  const int64_t* NodeIds() const;
 
 protected:
   void SetMembers() override;
@@ -270,6 +272,14 @@ public:
   void AppendLabel(int32_t label);
   void AppendAttribute(const io::AttributeValue* value);
 
+  /// Columns sized for the whole batch, to be filled in place instead of
+  /// appending one by one. Only for the existed columns.
+  float* MutableWeights();
+  int32_t* MutableLabels();
+  int64_t* MutableIntAttrs();
+  float* MutableFloatAttrs();
+  void AppendStringAttrs(const std::string* const* values, int32_t size);
+
   int32_t Size() const { return batch_size_; }
   int32_t Format() const;
   int32_t IntAttrNum() const;
@@ -394,6 +404,57 @@ private:
   Tensor* degrees_;
 };
 
+/// Check whether each (src, dst) pair is an edge, by the sorted neighbors
+/// of the src if the storage has them.
+class CheckEdgesRequest : public OpRequest {
+public:
+  CheckEdgesRequest();
+  explicit CheckEdgesRequest(const std::string& edge_type);
+  virtual ~CheckEdgesRequest() = default;
+
+  OpRequest* Clone() const;
+
+  void Set(const int64_t* src_ids, const int64_t* dst_ids,
+           int32_t batch_size);
+
+  const std::string& EdgeType() const;
+  const int64_t* GetSrcIds() const;
+  const int64_t* GetDstIds() const;
+  int32_t BatchSize() const;
+
+protected:
+  void SetMembers() override;
+
+private:
+  Tensor* src_ids_;
+  Tensor* dst_ids_;
+};
+
+class CheckEdgesResponse : public OpResponse {
+public:
+  CheckEdgesResponse();
+  virtual ~CheckEdgesResponse() = default;
+
+  OpResponse* New() const override {
+    return new CheckEdgesResponse;
+  }
+
+  void Swap(OpResponse& right) override;
+
+  void InitExists(int32_t count);
+  void AppendExists(bool exists);
+  int32_t Size() const { return batch_size_; }
+
+  /// 1 for each pair that is an edge, otherwise 0.
+  const int32_t* GetExists() const;
+
+protected:
+  void SetMembers() override;
+
+private:
+  Tensor* exists_;
+};
+
 class GetTopologyRequest : public OpRequest {
 public:
   GetTopologyRequest() {}
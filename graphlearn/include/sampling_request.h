@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef GRAPHLEARN_INCLUDE_SAMPLING_REQUEST_H_
 #define GRAPHLEARN_INCLUDE_SAMPLING_REQUEST_H_
 
+#include <mutex>  // NOLINT [build/c++11]
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -23,6 +24,8 @@ limitations under the License.
 
 namespace graphlearn {
 
+class ThreadPool;
+
 class SamplingRequest : public OpRequest {
 public:
   SamplingRequest();
@@ -38,20 +41,46 @@ public:
   void Set(const Tensor::Map& tensors) override;
   void Set(const int64_t* src_ids, int32_t batch_size);
   void SetFilters(const int64_t* filter_ids, int32_t batch_size);
+  /// Sample the neighbors along the in-edges of the ids instead of the
+  /// out-edges, which needs the reverse index of in-edges built. Only a
+  /// single server is supported for now.
+  void SetReversed();
+  /// Make the samples of the request deterministic, whichever threads
+  /// run it.
+  void SetSeed(int64_t seed);
+  /// Return the distinct neighbor ids with the index of each neighbor in
+  /// them, instead of the id of each neighbor.
+  void SetCompact();
 
   const std::string& Type() const;
   const std::string& Strategy() const;
   int32_t BatchSize() const;
   int32_t NeighborCount() const { return neighbor_count_; }
+  bool IsReversed() const { return reversed_; }
+  bool HasSeed() const { return has_seed_; }
+  int64_t Seed() const { return seed_; }
+  bool IsCompact() const { return compact_; }
   const int64_t* GetSrcIds() const;
   const int64_t* GetFilters() const;
+  /// How many times the `index`th source id appears before it. The count
+  /// is the same in each shard as in the whole request, because sharding
+  /// keeps the order of the ids.
+  int32_t Occurrence(int32_t index) const;
 
 protected:
   void SetMembers() override;
   int32_t neighbor_count_;
   int32_t filter_type_;
+  bool    reversed_;
+  bool    has_seed_;
+  int64_t seed_;
+  bool    compact_;
   Tensor* src_ids_;
   Tensor* filter_ids_;
+
+private:
+  mutable std::once_flag occurrences_once_;
+  mutable std::vector<int32_t> occurrences_;
 };
 
 class SamplingResponse : public OpResponse {
@@ -77,6 +106,18 @@ public:
   void AppendEdgeId(int64_t id);
   void AppendDegree(int32_t degree);
   void FillWith(int64_t neighbor_id, int64_t edge_id = -1);
+  /// Gather the responses of the consecutive chunks of a batch into this
+  /// empty one, copying the chunks into their own regions in parallel.
+  void Concat(const std::vector<SamplingResponse*>& chunks, ThreadPool* tp);
+  /// Replace the neighbor ids with the distinct ones and the index of each
+  /// neighbor in them, for a compact request.
+  void Compact();
+
+  /// The neighbor ids are null if the response is compacted.
+  bool IsCompacted() const { return unique_index_ != nullptr; }
+  int32_t UniqueNodeCount() const;
+  const int64_t* GetUniqueIds() const;
+  const int32_t* GetUniqueIndex() const;
 
   int32_t BatchSize() const { return batch_size_; }
   int32_t NeighborCount() const { return neighbor_count_; }
@@ -91,12 +132,17 @@ public:
 protected:
   void SetMembers() override;
 
+private:
+  void MergeUniqueIds(ShardsPtr<OpResponse> shards, Tensor* unique_ids);
+
 private:
   int32_t neighbor_count_;
   int32_t total_neighbor_count_;
   Tensor* neighbors_;
   Tensor* edges_;
   Tensor* degrees_;
+  Tensor* unique_ids_;
+  Tensor* unique_index_;
 };
 
 
@@ -152,6 +198,238 @@ private:
   Tensor* str_props_;
 };
 
+/// Sample one layer of a fixed size for all the source ids together,
+/// instead of a number of neighbors for each of them, like LADIES. The
+/// layer is drawn with replacement from the union of the neighbors of the
+/// sources, where a neighbor v has the importance of the sum of a(u, v)^2
+/// over the sources u, and a(u, v) is the weight of the edge (1 if the
+/// edges have no weights) normalized by the sum of the row of u.
+///
+/// The sources are sharded to the servers owning them, and each server
+/// samples its share of the layer size, in proportion to its number of
+/// sources, from the neighbors of its own sources.
+class LayerSamplingRequest : public OpRequest {
+public:
+  LayerSamplingRequest();
+  LayerSamplingRequest(const std::string& type, int32_t layer_size);
+  ~LayerSamplingRequest() = default;
+
+  OpRequest* Clone() const override;
+
+  void Set(const int64_t* src_ids, int32_t batch_size);
+  /// Make the layers deterministic.
+  void SetSeed(int64_t seed);
+
+  const std::string& Type() const;
+  int32_t LayerSize() const;
+  /// The number of the source ids before sharding.
+  int32_t TotalSize() const;
+  int32_t BatchSize() const;
+  bool HasSeed() const;
+  int64_t Seed() const;
+  const int64_t* GetSrcIds() const;
+
+protected:
+  void SetMembers() override;
+
+private:
+  Tensor* src_ids_;
+};
+
+/// The distinct node ids of a sampled layer, and the edges from the source
+/// ids to them in COO. The weight of an edge is a(u, v) over the
+/// probability of v, which a GCN layer normalizes by rows.
+class LayerSamplingResponse : public OpResponse {
+public:
+  LayerSamplingResponse();
+  ~LayerSamplingResponse() = default;
+
+  OpResponse* New() const override {
+    return new LayerSamplingResponse;
+  }
+
+  void Swap(OpResponse& right) override;
+  /// Merge the layers of the shards, and point the rows of the edges to
+  /// the source ids before sharding.
+  void Stitch(ShardsPtr<OpResponse> shards) override;
+
+  void Init(int32_t batch_size);
+  void AppendNode(int64_t node_id);
+  void AppendEdge(int32_t row_idx, int32_t col_idx,
+                  int64_t edge_id, float weight);
+
+  int32_t BatchSize() const { return batch_size_; }
+  int32_t NodeCount() const;
+  int32_t EdgeCount() const;
+  const int64_t* NodeIds() const;
+  const int32_t* RowIndices() const;
+  const int32_t* ColIndices() const;
+  const int64_t* EdgeIds() const;
+  const float* EdgeWeights() const;
+
+protected:
+  void SetMembers() override;
+
+private:
+  Tensor* node_ids_;
+  Tensor* row_indices_;
+  Tensor* col_indices_;
+  Tensor* edge_ids_;
+  Tensor* weights_;
+};
+
+/// Sample the neighborhood of the seeds by several hops in one request.
+/// Each hop samples the neighbors of the last hop, or of the seeds for the
+/// first one, along an edge type by a strategy. The hops are expanded on
+/// the server receiving the request, which only sends the distinct ids of
+/// each hop to the servers owning them.
+class MultiHopSamplingRequest : public OpRequest {
+public:
+  MultiHopSamplingRequest();
+  ~MultiHopSamplingRequest() = default;
+
+  OpRequest* Clone() const override;
+
+  void Set(const int64_t* src_ids, int32_t batch_size);
+  void AddHop(const std::string& type,
+              const std::string& strategy,
+              int32_t neighbor_count);
+  /// Make the samples of all the hops deterministic.
+  void SetSeed(int64_t seed);
+  /// Sample each distinct source of a hop only once, and give every
+  /// occurrence of it the same neighbors. It saves sampling the repeated
+  /// sources, but they are no longer sampled independently.
+  void SetDedup();
+
+  int32_t BatchSize() const;
+  int32_t HopNum() const;
+  const std::string& HopType(int32_t hop) const;
+  const std::string& HopStrategy(int32_t hop) const;
+  int32_t HopNeighborCount(int32_t hop) const;
+  bool HasSeed() const;
+  int64_t Seed() const;
+  bool IsDedup() const;
+  const int64_t* GetSrcIds() const;
+
+protected:
+  void SetMembers() override;
+
+private:
+  Tensor* src_ids_;
+};
+
+/// The layers of a MultiHopSamplingRequest. The sources of a hop are the
+/// neighbors of the last hop in order, or the seeds for the first one, and
+/// the neighbors of each source are consecutive. A source has just the
+/// neighbor count of the hop unless the strategy is sparse, such as full.
+class MultiHopSamplingResponse : public OpResponse {
+public:
+  MultiHopSamplingResponse();
+  ~MultiHopSamplingResponse() = default;
+
+  OpResponse* New() const override {
+    return new MultiHopSamplingResponse;
+  }
+
+  void Swap(OpResponse& right) override;
+
+  void Init(int32_t batch_size, int32_t hop_num);
+  /// Append the neighbors of a source of the current hop. Edge ids are -1
+  /// if `edge_ids` is null, such as for negative sampling.
+  void AppendNeighbors(const int64_t* nbr_ids,
+                       const int64_t* edge_ids,
+                       int32_t size);
+  /// Close the current hop after all of its sources are appended.
+  void FinishHop();
+
+  int32_t HopNum() const;
+  /// The number of the sources of a hop.
+  int32_t SourceCount(int32_t hop) const;
+  /// The total number of the neighbors of a hop.
+  int32_t NeighborCount(int32_t hop) const;
+  const int64_t* GetNeighborIds(int32_t hop) const;
+  const int64_t* GetEdgeIds(int32_t hop) const;
+  /// The number of the neighbors of each source of a hop.
+  const int32_t* GetDegrees(int32_t hop) const;
+
+protected:
+  void SetMembers() override;
+
+private:
+  int32_t DegreeOffset(int32_t hop) const;
+
+private:
+  Tensor* neighbors_;
+  Tensor* edges_;
+  Tensor* degrees_;
+  // Where each hop starts in the neighbors.
+  Tensor* hop_offsets_;
+};
+
+/// Walk from each seed along an edge type for a number of nodes, with the
+/// node2vec bias of the return parameter p and the in-out parameter q.
+/// p = q = 1 makes the uniform walks of DeepWalk. Like the multi-hop
+/// sampling, the server receiving the request drives the walks, and sends
+/// the walkers of each step to the servers owning their nodes in batches.
+class RandomWalkRequest : public OpRequest {
+public:
+  RandomWalkRequest();
+  RandomWalkRequest(const std::string& type,
+                    int32_t walk_length,
+                    float p = 1.0,
+                    float q = 1.0);
+  ~RandomWalkRequest() = default;
+
+  OpRequest* Clone() const override;
+
+  void Set(const int64_t* src_ids, int32_t batch_size);
+  /// Make the walks deterministic.
+  void SetSeed(int64_t seed);
+
+  const std::string& Type() const;
+  /// The number of nodes of each walk, including the seed.
+  int32_t WalkLength() const;
+  float P() const;
+  float Q() const;
+  int32_t BatchSize() const;
+  bool HasSeed() const;
+  int64_t Seed() const;
+  const int64_t* GetSrcIds() const;
+
+protected:
+  void SetMembers() override;
+
+private:
+  Tensor* src_ids_;
+};
+
+/// The walks in a [batch_size, walk_length] matrix. A walk stopping at a
+/// node without neighbors is filled with GLOBAL_FLAG(DefaultNeighborId).
+class RandomWalkResponse : public OpResponse {
+public:
+  RandomWalkResponse();
+  ~RandomWalkResponse() = default;
+
+  OpResponse* New() const override {
+    return new RandomWalkResponse;
+  }
+
+  void Swap(OpResponse& right) override;
+
+  void Init(int32_t batch_size, int32_t walk_length);
+
+  int32_t BatchSize() const { return batch_size_; }
+  int32_t WalkLength() const;
+  int64_t* GetWalks();
+  const int64_t* GetWalks() const;
+
+protected:
+  void SetMembers() override;
+
+private:
+  Tensor* walks_;
+};
+
 }  // namespace graphlearn
 
 #endif  // GRAPHLEARN_INCLUDE_SAMPLING_REQUEST_H_
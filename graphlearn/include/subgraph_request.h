@@ -70,6 +70,65 @@ private:
   Tensor* edge_ids_;
 };
 
+/// Find the edges among a set of nodes. The nodes are sharded as the rows
+/// to the servers owning them, and each server finds the edges of its own
+/// rows by looking up the neighbors in a hash table of all the nodes.
+class InduceSubGraphRequest : public OpRequest {
+public:
+  InduceSubGraphRequest();
+  explicit InduceSubGraphRequest(const std::string& nbr_type);
+  virtual ~InduceSubGraphRequest() = default;
+
+  OpRequest* Clone() const override;
+
+  /// The nodes should be distinct.
+  void Set(const int64_t* node_ids, int32_t size);
+
+  const std::string& NbrType() const;
+  /// All the nodes of the subgraph, which the columns index.
+  int32_t NodeCount() const;
+  const int64_t* NodeIds() const;
+  /// The nodes of the rows to find the edges of on this server.
+  int32_t RowCount() const;
+  const int64_t* RowIds() const;
+
+protected:
+  void SetMembers() override;
+
+private:
+  Tensor* row_ids_;
+};
+
+/// The edges of the subgraph in COO, ordered by the rows and then by the
+/// columns. Each pair of nodes has at most one edge.
+class InduceSubGraphResponse : public OpResponse {
+public:
+  InduceSubGraphResponse();
+  virtual ~InduceSubGraphResponse() = default;
+
+  OpResponse* New() const override {
+    return new InduceSubGraphResponse;
+  }
+
+  void Swap(OpResponse& right) override;
+  /// Point the rows of each shard to the nodes before sharding.
+  void Stitch(ShardsPtr<OpResponse> shards) override;
+
+  void Init(int32_t row_count, int32_t edge_count);
+  void AppendEdge(int32_t row_idx, int32_t col_idx, int64_t e_id);
+  int32_t EdgeCount() const;
+  const int32_t* RowIndices() const;
+  const int32_t* ColIndices() const;
+  const int64_t* EdgeIds() const;
+
+protected:
+  void SetMembers() override;
+
+private:
+  Tensor* row_indices_;
+  Tensor* col_indices_;
+  Tensor* edge_ids_;
+};
 
 }  // namespace graphlearn
 
@@ -55,9 +55,13 @@ PYBIND11_MODULE(pywrap_graphlearn, m) {
   m.def("set_server_count", &SetGlobalFlagServerCount);
   m.def("set_tracker", &SetGlobalFlagTracker);
   m.def("set_server_hosts", &SetGlobalFlagServerHosts);
+  m.def("set_snapshot_dir", &SetGlobalFlagSnapshotDir);
   m.def("set_tape_capacity", &SetGlobalFlagTapeCapacity);
   m.def("set_dataset_capacity", &SetGlobalFlagDatasetCapacity);
   m.def("set_ignore_invalid", &SetGlobalFlagIgnoreInvalid);
+  m.def("set_parallel_sampling_threshold",
+        &SetGlobalFlagParallelSamplingThreshold);
+  m.def("set_max_cluster_size", &SetGlobalFlagMaxClusterSize);
 
   // Constants
   m.attr("kPartitionKey") = kPartitionKey;
@@ -106,6 +110,7 @@ PYBIND11_MODULE(pywrap_graphlearn, m) {
   m.attr("kDegrees") = kDegrees;
   m.attr("kEpoch") = kEpoch;
   m.attr("kNodeFrom") = kNodeFrom;
+  m.attr("kSeed") = kSeed;
 
   // getters
   m.def("get_tracker_mode", &GetGlobalFlagTrackerMode);
@@ -178,10 +183,17 @@ PYBIND11_MODULE(pywrap_graphlearn, m) {
     .value("ORIGIN", io::Direction::kOrigin)
     .value("REVERSED", io::Direction::kReversed);
 
+  py::enum_<io::FloatFormat>(m, "FloatFormat")
+    .value("FP32", io::FloatFormat::kFp32)
+    .value("FP16", io::FloatFormat::kFp16)
+    .value("BF16", io::FloatFormat::kBf16)
+    .value("INT8", io::FloatFormat::kInt8);
+
   py::class_<io::AttributeInfo>(m, "AttributeInfo")
     .def(py::init<>())
     .def_readwrite("delimiter", &io::AttributeInfo::delimiter)
     .def_readwrite("ignore_invalid", &io::AttributeInfo::ignore_invalid)
+    .def_readwrite("float_format", &io::AttributeInfo::float_format)
     .def("append_type", &io::AttributeInfo::AppendType)
     .def("append_hash_bucket", &io::AttributeInfo::AppendHashBucket);
 
@@ -72,6 +72,12 @@ def set_padding_mode(mode):
 def set_storage_mode(mode):
   pywrap.set_storage_mode(mode)
 
+def set_snapshot_dir(path):
+  """ Dump the built graph of each server into `path`, and restore from
+  there instead of loading and building again when restarted.
+  """
+  pywrap.set_snapshot_dir(str(path))
+
 def set_default_int_attribute(value=0):
   """ Set default global int attribute.
   """
@@ -129,3 +135,17 @@ def set_eager_mode(flag):
 def set_ignore_invalid(value):
   pywrap.set_ignore_invalid(value)
 
+def set_parallel_sampling_threshold(size):
+  """ Split the sampling batches of at least `size` ids into chunks, and
+  sample them with the intra threads. 0 means never.
+  """
+  assert size >= 0, "Parallel sampling threshold should be >= 0."
+  pywrap.set_parallel_sampling_threshold(size)
+
+def set_max_cluster_size(size):
+  """ Cluster the source nodes of each edge type into clusters of no more
+  than `size` nodes when building, which needs the storage mode 1024.
+  """
+  assert size > 0, "Max cluster size should be > 0."
+  pywrap.set_max_cluster_size(size)
+
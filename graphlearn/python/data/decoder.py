@@ -28,7 +28,8 @@ class Decoder(object):
                labeled=False,
                attr_types=None,
                attr_delimiter=":",
-               attr_dims=None):
+               attr_dims=None,
+               float_format="fp32"):
     """ Initialize a data source decoder.
 
     Args:
@@ -80,12 +81,21 @@ class Decoder(object):
         |      "float"     |None|           Continues numeric tensor           |
         Note that dynamic bucket embedding variable is only supported in tfra.
         For continues numeric attribute, attr_dim should be either None or 0.
+      float_format (string, Optional): How the float attributes are held in
+        the column mode storages, one of "fp32", "fp16", "bf16" and "int8".
+        "int8" is quantized with a scale per node or edge. The reduced formats
+        save memory by losing precision, and are decoded back into float32
+        when looked up. Default is "fp32".
     """
     self._weighted = weighted
     self._labeled = labeled
     self._attr_types = attr_types
     self._attr_delimiter = attr_delimiter
     self._attr_dims = attr_dims
+    if float_format not in ("fp32", "fp16", "bf16", "int8"):
+      raise ValueError("float_format for Decoder must be one of fp32, fp16, "
+                       "bf16 and int8, got {}.".format(float_format))
+    self._float_format = float_format
 
     self._int_attr_num = 0
     self._float_attr_num = 0
@@ -179,6 +189,10 @@ class Decoder(object):
   def attr_delimiter(self):
     return self._attr_delimiter
 
+  @property
+  def float_format(self):
+    return self._float_format
+
   @property
   def data_format(self):
     # attributed << 3 | labeled << 2 | weighted << 1
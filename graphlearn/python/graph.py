@@ -735,6 +735,8 @@ class Graph(object):
 
     if decoder.attributed:
       source.attr_info.delimiter = decoder.attr_delimiter
+      source.attr_info.float_format = getattr(
+          pywrap.FloatFormat, decoder.float_format.upper())
       for t in decoder.attr_types:
         type_str, bucket_size, is_multival = decoder.parse(t)
         if is_multival:
@@ -838,7 +840,8 @@ class Graph(object):
       seed_type (string): Sample seed type, either node type or edge type.
       nbr_type (string): Neighbor type of seeds nodes/edges.
       batch_size (int): How many nodes will be returned for `get()`.
-      strategy (string, Optional): Sampling strategy. "random_node".
+      strategy (string, Optional): Sampling strategy. "random_node",
+        "in_order_node" or "cluster".
     Return:
       An `SubGraphSampler` object.
 
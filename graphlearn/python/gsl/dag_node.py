@@ -176,9 +176,17 @@ class DagNode(object):
     self._add_param(pywrap.kStrategy, strategy_map.get(traverse, False))
     return self
 
-  def sample(self, count):
+  def sample(self, count, seed=None):
+    """ Sample `count` neighbors for each id. With an int32 `seed`, the same
+    ids always get the same samples, wherever they are in the batch and
+    however many servers there are, which helps to reproduce the results.
+    An id repeated in a batch gets different samples for each occurrence.
+    """
     assert isinstance(count, int)
     self._add_param(pywrap.kNeighborCount, count)
+    if seed is not None:
+      assert isinstance(seed, int)
+      self._add_param(pywrap.kSeed, seed)
     self._add_param(pywrap.kPartitionKey, pywrap.kSrcIds)
     self._shape = (np.prod(self._shape), count)
     return self
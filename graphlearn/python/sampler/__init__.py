@@ -30,6 +30,7 @@ from graphlearn.python.sampler.negative_sampler import NodeWeightNegativeSampler
 from graphlearn.python.sampler.negative_sampler import ConditionalNegativeSampler
 from graphlearn.python.sampler.subgraph_sampler import RandomNodeSubGraphSampler
 from graphlearn.python.sampler.subgraph_sampler import InOrderNodeSubGraphSampler
+from graphlearn.python.sampler.subgraph_sampler import ClusterSubGraphSampler
 
 __all__ = [
     "RandomNodeSampler",
@@ -49,5 +50,6 @@ __all__ = [
     "NodeWeightNegativeSampler",
     "ConditionalNegativeSampler",
     "RandomNodeSubGraphSampler",
-    "InOrderNodeSubGraphSampler"
+    "InOrderNodeSubGraphSampler",
+    "ClusterSubGraphSampler"
 ]
@@ -38,8 +38,10 @@ class SubGraphSampler(object):
       seed_type (string): Sample seed type, either node type or edge type.
       nbr_type (string): Neighbor type of seeds nodes/edges.
       batch_size (int): How many nodes will be returned for `get()`.
-      strategy (string, Optional): Sampling strategy, "random_node" and
-        "in_order_node" are supported.
+      strategy (string, Optional): Sampling strategy, "random_node",
+        "in_order_node" and "cluster" are supported. "cluster" samples the
+        nodes as random clusters of `nbr_type`, which needs the storage
+        mode 1024.
     """
     self._graph = graph
     self._seed_type = seed_type
@@ -91,3 +93,7 @@ class RandomNodeSubGraphSampler(SubGraphSampler):
 
 class InOrderNodeSubGraphSampler(SubGraphSampler):
   pass
+
+
+class ClusterSubGraphSampler(SubGraphSampler):
+  pass
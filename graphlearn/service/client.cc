@@ -48,10 +48,15 @@ DEFINE_METHOD(GetNodes);
 DEFINE_METHOD(LookupNodes);
 DEFINE_METHOD(GetTopology);
 DEFINE_METHOD(Sampling);
+DEFINE_METHOD(MultiHopSampling);
+DEFINE_METHOD(RandomWalk);
+DEFINE_METHOD(LayerSampling);
 DEFINE_METHOD(Aggregating);
 DEFINE_METHOD(SubGraph);
+DEFINE_METHOD(InduceSubGraph);
 DEFINE_METHOD(GetCount);
 DEFINE_METHOD(GetDegree);
+DEFINE_METHOD(CheckEdges);
 
 #undef DEFINE_METHOD
 
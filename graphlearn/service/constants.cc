@@ -63,5 +63,21 @@ const char* kFilterIds = "filt";
 const char* kDegrees = "dg";
 const char* kEpoch = "ep";
 const char* kNodeFrom = "nf";
+const char* kSeed = "seed";
+const char* kHopTypes = "hopt";
+const char* kHopStrategies = "hops";
+const char* kHopCounts = "hopc";
+const char* kHopOffsets = "hopo";
+const char* kCompact = "cpt";
+const char* kUniqueIds = "uid";
+const char* kUniqueIndex = "uidx";
+const char* kExists = "ex";
+const char* kWalkLength = "wl";
+const char* kReturnParam = "wp";
+const char* kInOutParam = "wq";
+const char* kLayerSize = "lsz";
+const char* kTotalSize = "tsz";
+const char* kPartial = "ptl";
+const char* kDedup = "ddp";
 
 }  // namespace graphlearn
@@ -43,6 +43,10 @@ public:
   bool IsMaster() const;
 
   virtual Status Sync(const std::string& barrier) = 0;
+  /// Sync on `barrier` with whether the current server agrees, and then
+  /// `agreed` tells whether all the servers agree.
+  virtual Status Vote(const std::string& barrier, bool agree,
+                      bool* agreed) = 0;
 
   /// Do tell that the current server started.
   virtual Status Start() = 0;
@@ -97,6 +101,8 @@ public:
   void Finallize() override;
 
   Status Sync(const std::string& barrier) override;
+  Status Vote(const std::string& barrier, bool agree,
+              bool* agreed) override;
 
   Status Start() override;
   Status SetStarted(int32_t server_id = -1) override;
@@ -121,6 +127,7 @@ private:
   void CheckStopped() override;
 
   bool IsReady(const std::string& barrier);
+  bool HasFileEndWith(const std::string& sub_dir, const std::string& suffix);
   bool FileExist(const std::string& file_name);
   int32_t Counting(const std::string& sub_dir);
   Status Sink(const std::string& sub_dir, const std::string& file_name);
@@ -136,6 +143,8 @@ public:
   ~RPCCoordinator() = default;
 
   Status Sync(const std::string& barrier) override;
+  Status Vote(const std::string& barrier, bool agree,
+              bool* agreed) override;
 
   Status Start() override;
   Status SetStarted(int32_t server_id = -1) override;
@@ -161,6 +170,7 @@ private:
   Status SetState(SystemState state, int32_t id);
   void CheckState(SystemState state, int32_t count);
   void CheckState(int32_t state, int32_t count);
+  void CheckVote(int32_t state);
   Status ReportState(int32_t target, int32_t state,
                      int32_t id = -1, int32_t count = -1);
 
@@ -61,6 +61,21 @@ Status FSCoordinator::Sync(const std::string& barrier) {
   return s;
 }
 
+Status FSCoordinator::Vote(const std::string& barrier, bool agree,
+                           bool* agreed) {
+  // A server against it sinks its id with a suffix, which is counted in
+  // the barrier all the same.
+  std::string name = std::to_string(server_id_) + (agree ? "" : "_no");
+  Status s = Sink(barrier + "/", name);
+  LOG_RETURN_IF_NOT_OK(s)
+
+  while (!IsReady(barrier)) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  }
+  *agreed = !HasFileEndWith(barrier + "/", "_no");
+  return s;
+}
+
 bool FSCoordinator::IsReady(const std::string& barrier) {
   if (IsMaster()) {
     if (Counting(barrier + "/") == server_count_) {
@@ -207,6 +222,24 @@ bool FSCoordinator::FileExist(const std::string& file_name) {
   return false;
 }
 
+bool FSCoordinator::HasFileEndWith(const std::string& sub_dir,
+                                   const std::string& suffix) {
+  std::vector<std::string> file_names;
+  Status s = fs_->ListDir(tracker_ + sub_dir, &file_names);
+  if (!s.ok()) {
+    // Taken as a disagreement rather than a silent agreement.
+    LOG(WARNING) << "List states failed: " << sub_dir
+                 << ", " << s.ToString();
+    return true;
+  }
+  for (const auto& file_name : file_names) {
+    if (strings::EndWith(file_name, suffix)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 int32_t FSCoordinator::Counting(const std::string& sub_dir) {
   std::vector<std::string> file_names;
   Status s = fs_->ListDir(tracker_ + sub_dir, &file_names);
@@ -52,6 +52,28 @@ Status RPCCoordinator::Sync(const std::string& barrier) {
   return Status::OK();
 }
 
+Status RPCCoordinator::Vote(const std::string& barrier, bool agree,
+                            bool* agreed) {
+  // A server against it reports its id plus the server count, and then
+  // the master moves all the servers past the state of the vote.
+  int32_t state = reserved_state_ + 1;
+  int32_t id = agree ? server_id_ : server_id_ + server_count_;
+  Status s;
+  if (IsMaster()) {
+    s = SetState(state, id);
+  } else {
+    s = ReportState(0, state, id);
+  }
+  LOG_RETURN_IF_NOT_OK(s)
+
+  while (state > reserved_state_) {
+    CheckVote(state);
+    sleep(1);
+  }
+  *agreed = reserved_state_ == state;
+  return Status::OK();
+}
+
 Status RPCCoordinator::Start() {
   if (IsMaster()) {
     return SetStarted(0);
@@ -165,6 +187,19 @@ void RPCCoordinator::CheckState(int32_t state, int32_t count) {
   }
 }
 
+void RPCCoordinator::CheckVote(int32_t state) {
+  ScopedLocker<std::mutex> _(&mtx_);
+  if (IsMaster() &&
+      state_map_[state].size() == static_cast<size_t>(server_count_)) {
+    // The ids are ordered, so the last one tells if any is against.
+    bool agreed = *state_map_[state].rbegin() < server_count_;
+    reserved_state_ = agreed ? state : state + 1;
+    for (int32_t remote_id = 1; remote_id < server_count_; ++remote_id) {
+      ReportState(remote_id, reserved_state_);
+    }
+  }
+}
+
 Status RPCCoordinator::ReportState(int32_t target, int32_t state,
                                    int32_t id, int32_t count) {
   std::unique_ptr<Client> client(NewRpcClient(target));
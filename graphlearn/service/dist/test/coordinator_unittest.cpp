@@ -13,6 +13,8 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <string>
+#include <thread>  // NOLINT [build/c++11]
 #include "graphlearn/common/base/log.h"
 #include "graphlearn/include/config.h"
 #include "graphlearn/platform/env.h"
@@ -138,3 +140,30 @@ TEST_F(CoordinatorTest, StartReadyStop) {
   delete coord_0;
   delete coord_1;
 }
+
+TEST_F(CoordinatorTest, Vote) {
+  Coordinator* coord_0 = GetCoordinator(0, 2, Env::Default());
+  Coordinator* coord_1 = GetCoordinator(1, 2, Env::Default());
+
+  // All or none of the servers agree, whichever is against
+  bool votes[3][2] = {{true, true}, {true, false}, {false, true}};
+  for (int32_t i = 0; i < 3; ++i) {
+    std::string barrier = "vote_" + std::to_string(i);
+    bool agreed_0 = false;
+    bool agreed_1 = false;
+    std::thread peer([&] {
+      EXPECT_TRUE(coord_1->Vote(barrier, votes[i][1], &agreed_1).ok());
+    });
+    EXPECT_TRUE(coord_0->Vote(barrier, votes[i][0], &agreed_0).ok());
+    peer.join();
+    EXPECT_EQ(agreed_0, votes[i][0] && votes[i][1]);
+    EXPECT_EQ(agreed_1, agreed_0);
+  }
+
+  coord_0->SetStopped();
+  coord_1->SetStopped();
+  // waiting for refresh
+  sleep(2);
+  delete coord_0;
+  delete coord_1;
+}
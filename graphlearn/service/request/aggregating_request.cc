@@ -28,13 +28,13 @@ int32_t kReservedSize = 64;
 
 AggregatingRequest::AggregatingRequest()
     : OpRequest(), cursor_(0), num_segments_(0),
-      node_ids_(nullptr), segment_ids_(nullptr) {
+      node_ids_(nullptr), segment_ids_(nullptr), partial_(false) {
 }
 
 AggregatingRequest::AggregatingRequest(const std::string& type,
                                        const std::string& strategy)
     : OpRequest(), cursor_(0), num_segments_(0),
-      node_ids_(nullptr), segment_ids_(nullptr) {
+      node_ids_(nullptr), segment_ids_(nullptr), partial_(false) {
   ADD_TENSOR(params_, kOpName, kString, 1);
   params_[kOpName].AddString(strategy);
 
@@ -54,6 +54,9 @@ AggregatingRequest::AggregatingRequest(const std::string& type,
 OpRequest* AggregatingRequest::Clone() const {
   AggregatingRequest* req = new AggregatingRequest(Type(), Strategy());
   req->num_segments_ = num_segments_;
+  // Only the partitioner clones a request, and the shards return partial
+  // states to be merged.
+  req->SetPartial();
   return req;
 }
 
@@ -67,6 +70,15 @@ void AggregatingRequest::SetMembers() {
   num_segments_ = params_[kNumSegments].GetInt32(0);
   node_ids_ = &(tensors_[kNodeIds]);
   segment_ids_ = &(tensors_[kSegmentIds]);
+  partial_ = params_.find(kPartial) != params_.end();
+}
+
+void AggregatingRequest::SetPartial() {
+  if (!partial_) {
+    ADD_TENSOR(params_, kPartial, kInt32, 1);
+    params_[kPartial].AddInt32(1);
+    partial_ = true;
+  }
 }
 
 void AggregatingRequest::Set(const int64_t* node_ids,
@@ -112,7 +124,8 @@ AggregatingResponse::AggregatingResponse()
       name_(""),
       emb_dim_(0),
       embs_(nullptr),
-      segments_(nullptr) {
+      segments_(nullptr),
+      segment_ids_(nullptr) {
 }
 
 void AggregatingResponse::Swap(OpResponse& right) {
@@ -122,6 +135,7 @@ void AggregatingResponse::Swap(OpResponse& right) {
   std::swap(emb_dim_, res.emb_dim_);
   std::swap(embs_, res.embs_);
   std::swap(segments_, res.segments_);
+  std::swap(segment_ids_, res.segment_ids_);
 }
 
 void AggregatingResponse::SetName(const std::string& name) {
@@ -148,9 +162,7 @@ void AggregatingResponse::SetNumSegments(int32_t num_segments) {
 }
 
 void AggregatingResponse::AppendEmbedding(const float* value) {
-  for (int32_t i = 0; i < emb_dim_; ++i) {
-    embs_->AddFloat(value[i]);
-  }
+  embs_->AddFloat(value, value + emb_dim_);
 }
 
 const float* AggregatingResponse::Embeddings() const {
@@ -165,9 +177,28 @@ const int32_t* AggregatingResponse::Segments() const {
   return segments_->GetInt32();
 }
 
+void AggregatingResponse::SetPartial() {
+  ADD_TENSOR(tensors_, kSegmentIds, kInt32, kReservedSize);
+  segment_ids_ = &(tensors_[kSegmentIds]);
+}
+
+void AggregatingResponse::AppendSegmentId(int32_t segment_id) {
+  segment_ids_->AddInt32(segment_id);
+}
+
+int32_t AggregatingResponse::NumPartials() const {
+  return segment_ids_ ? segment_ids_->Size() : 0;
+}
+
+const int32_t* AggregatingResponse::SegmentIds() const {
+  return segment_ids_ ? segment_ids_->GetInt32() : nullptr;
+}
+
 void AggregatingResponse::SetMembers() {
   embs_ = &(tensors_[kFloatAttrKey]);
   segments_ = &(tensors_[kSegments]);
+  auto it = tensors_.find(kSegmentIds);
+  segment_ids_ = (it == tensors_.end()) ? nullptr : &(it->second);
   emb_dim_ = params_[kSideInfo].GetInt32(0);
   name_ = params_[kOpName].GetString(0);
 }
@@ -201,14 +232,19 @@ void AggregatingResponse::Stitch(ShardsPtr<OpResponse> shards) {
   op::Aggregator* agg_op = static_cast<op::Aggregator*>(op);
   agg_op->InitFunc(embs, size);
 
+  // Merging two states is the same as folding one into the other, and the
+  // empty segments of a shard are not shipped at all.
   shards->ResetNext();
   while (shards->Next(&shard_id, &tmp)) {
     shard = static_cast<AggregatingResponse*>(tmp);
-    float* shard_embs = const_cast<float*>(shard->Embeddings());
-    const int32_t* shard_segments = shard->Segments();
-    agg_op->AggFunc(embs, shard_embs, size, shard_segments, batch_size_);
-    for (int32_t i = 0; i < batch_size_; ++i) {
-      segments[i] += shard_segments[i];
+    const float* states = shard->Embeddings();
+    const int32_t* counts = shard->Segments();
+    const int32_t* segment_ids = shard->SegmentIds();
+    for (int32_t i = 0; i < shard->NumPartials(); ++i) {
+      int32_t idx = segment_ids[i];
+      agg_op->ReduceFunc(embs + idx * emb_dim, states + i * emb_dim,
+                         1, emb_dim);
+      segments[idx] += counts[i];
     }
   }
   agg_op->FinalFunc(embs, size, segments, batch_size_);
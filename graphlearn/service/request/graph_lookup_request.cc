@@ -283,6 +283,10 @@ bool LookupEdgesRequest::Next(int64_t* edge_id, int64_t* src_id) {
   return true;
 }
 
+const int64_t* LookupEdgesRequest::EdgeIds() const {
+  return edge_ids_->GetInt64();
+}
+
 LookupNodesRequest::LookupNodesRequest()
     : OpRequest(), cursor_(0) {
 }
@@ -352,6 +356,10 @@ bool LookupNodesRequest::Next(int64_t* node_id) {
   return true;
 }
 
+const int64_t* LookupNodesRequest::NodeIds() const {
+  return node_ids_->GetInt64();
+}
+
 LookupResponse::LookupResponse()
     : OpResponse(), info_(nullptr) {
 }
@@ -464,6 +472,33 @@ void LookupResponse::AppendAttribute(const io::AttributeValue* value) {
   }
 }
 
+float* LookupResponse::MutableWeights() {
+  weights_->Resize(batch_size_);
+  return const_cast<float*>(weights_->GetFloat());
+}
+
+int32_t* LookupResponse::MutableLabels() {
+  labels_->Resize(batch_size_);
+  return const_cast<int32_t*>(labels_->GetInt32());
+}
+
+int64_t* LookupResponse::MutableIntAttrs() {
+  i_attrs_->Resize(batch_size_ * info_->i_num);
+  return const_cast<int64_t*>(i_attrs_->GetInt64());
+}
+
+float* LookupResponse::MutableFloatAttrs() {
+  f_attrs_->Resize(batch_size_ * info_->f_num);
+  return const_cast<float*>(f_attrs_->GetFloat());
+}
+
+void LookupResponse::AppendStringAttrs(const std::string* const* values,
+                                       int32_t size) {
+  for (int32_t i = 0; i < size; ++i) {
+    s_attrs_->AddString(*values[i]);
+  }
+}
+
 int32_t LookupResponse::Format() const {
   return infos_->GetInt32(0);
 }
@@ -665,6 +700,100 @@ int32_t* GetDegreeResponse::GetDegrees() {
   return const_cast<int32_t*>(degrees_->GetInt32());
 }
 
+CheckEdgesRequest::CheckEdgesRequest()
+    : OpRequest(), src_ids_(nullptr), dst_ids_(nullptr) {
+}
+
+CheckEdgesRequest::CheckEdgesRequest(const std::string& edge_type)
+    : OpRequest(),
+      src_ids_(nullptr),
+      dst_ids_(nullptr) {
+  params_.reserve(3);
+  ADD_TENSOR(params_, kOpName, kString, 1);
+  params_[kOpName].AddString("CheckEdges");
+
+  ADD_TENSOR(params_, kPartitionKey, kString, 1);
+  params_[kPartitionKey].AddString(kSrcIds);
+
+  ADD_TENSOR(params_, kEdgeType, kString, 1);
+  params_[kEdgeType].AddString(edge_type);
+
+  ADD_TENSOR(tensors_, kSrcIds, kInt64, kReservedSize);
+  src_ids_ = &(tensors_[kSrcIds]);
+  ADD_TENSOR(tensors_, kDstIds, kInt64, kReservedSize);
+  dst_ids_ = &(tensors_[kDstIds]);
+}
+
+OpRequest* CheckEdgesRequest::Clone() const {
+  CheckEdgesRequest* req = new CheckEdgesRequest(EdgeType());
+  return req;
+}
+
+void CheckEdgesRequest::SetMembers() {
+  src_ids_ = &(tensors_[kSrcIds]);
+  dst_ids_ = &(tensors_[kDstIds]);
+}
+
+void CheckEdgesRequest::Set(const int64_t* src_ids,
+                            const int64_t* dst_ids,
+                            int32_t batch_size) {
+  src_ids_->AddInt64(src_ids, src_ids + batch_size);
+  dst_ids_->AddInt64(dst_ids, dst_ids + batch_size);
+}
+
+const std::string& CheckEdgesRequest::EdgeType() const {
+  return params_.at(kEdgeType).GetString(0);
+}
+
+const int64_t* CheckEdgesRequest::GetSrcIds() const {
+  if (src_ids_) {
+    return src_ids_->GetInt64();
+  } else {
+    return nullptr;
+  }
+}
+
+const int64_t* CheckEdgesRequest::GetDstIds() const {
+  if (dst_ids_) {
+    return dst_ids_->GetInt64();
+  } else {
+    return nullptr;
+  }
+}
+
+int32_t CheckEdgesRequest::BatchSize() const {
+  return src_ids_->Size();
+}
+
+CheckEdgesResponse::CheckEdgesResponse()
+    : OpResponse(),
+      exists_(nullptr) {
+}
+
+void CheckEdgesResponse::Swap(OpResponse& right) {
+  OpResponse::Swap(right);
+  CheckEdgesResponse& res = static_cast<CheckEdgesResponse&>(right);
+  std::swap(exists_, res.exists_);
+}
+
+void CheckEdgesResponse::SetMembers() {
+  exists_ = &(tensors_[kExists]);
+}
+
+void CheckEdgesResponse::InitExists(int32_t count) {
+  ADD_TENSOR(tensors_, kExists, kInt32, count);
+  exists_ = &(tensors_[kExists]);
+  batch_size_ = count;
+}
+
+void CheckEdgesResponse::AppendExists(bool exists) {
+  exists_->AddInt32(exists ? 1 : 0);
+}
+
+const int32_t* CheckEdgesResponse::GetExists() const {
+  return exists_->GetInt32();
+}
+
 REGISTER_REQUEST(GetEdges, GetEdgesRequest, GetEdgesResponse);
 REGISTER_REQUEST(GetNodes, GetNodesRequest, GetNodesResponse);
 REGISTER_REQUEST(LookupEdges, LookupEdgesRequest, LookupEdgesResponse);
@@ -672,4 +801,5 @@ REGISTER_REQUEST(LookupNodes, LookupNodesRequest, LookupNodesResponse);
 REGISTER_REQUEST(GetNodeCount, GetCountRequest, GetCountResponse);
 REGISTER_REQUEST(GetEdgeCount, GetCountRequest, GetCountResponse);
 REGISTER_REQUEST(GetDegree, GetDegreeRequest, GetDegreeResponse);
+REGISTER_REQUEST(CheckEdges, CheckEdgesRequest, CheckEdgesResponse);
 }  // namespace graphlearn
@@ -37,12 +37,13 @@ UpdateRequest::UpdateRequest(const io::SideInfo* info, int32_t batch_size)
     : OpRequest(),
       info_(const_cast<io::SideInfo*>(info)),
       cursor_(0) {
-  ADD_TENSOR(params_, kSideInfo, kInt32, 4);
+  ADD_TENSOR(params_, kSideInfo, kInt32, 5);
   infos_ = &(params_[kSideInfo]);
   infos_->AddInt32(info_->format);
   infos_->AddInt32(info_->i_num);
   infos_->AddInt32(info_->f_num);
   infos_->AddInt32(info_->s_num);
+  infos_->AddInt32(info_->float_format);
 
   if (info_->IsWeighted()) {
     ADD_TENSOR(tensors_, kWeightKey, kFloat, batch_size);
@@ -74,6 +75,9 @@ void UpdateRequest::SetMembers() {
   info_->i_num = infos_->GetInt32(1);
   info_->f_num = infos_->GetInt32(2);
   info_->s_num = infos_->GetInt32(3);
+  if (infos_->Size() > 4) {
+    info_->float_format = static_cast<io::FloatFormat>(infos_->GetInt32(4));
+  }
 
   if (info_->IsWeighted()) {
     weights_ = &(tensors_[kWeightKey]);
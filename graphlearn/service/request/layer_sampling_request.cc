@@ -0,0 +1,226 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "graphlearn/include/sampling_request.h"
+
+#include <utility>
+#include <vector>
+#include "graphlearn/core/graph/storage/id_hash_map.h"
+#include "graphlearn/include/constants.h"
+
+namespace graphlearn {
+
+namespace {
+int32_t kReservedSize = 64;
+}  // anonymous namespace
+
+LayerSamplingRequest::LayerSamplingRequest()
+    : OpRequest(), src_ids_(nullptr) {
+}
+
+LayerSamplingRequest::LayerSamplingRequest(const std::string& type,
+                                           int32_t layer_size)
+    : OpRequest(), src_ids_(nullptr) {
+  params_.reserve(kReservedSize);
+
+  ADD_TENSOR(params_, kOpName, kString, 1);
+  params_[kOpName].AddString("LayerwiseSampler");
+
+  ADD_TENSOR(params_, kPartitionKey, kString, 1);
+  params_[kPartitionKey].AddString(kSrcIds);
+
+  ADD_TENSOR(params_, kType, kString, 1);
+  params_[kType].AddString(type);
+
+  ADD_TENSOR(params_, kLayerSize, kInt32, 1);
+  params_[kLayerSize].AddInt32(layer_size);
+
+  ADD_TENSOR(params_, kTotalSize, kInt32, 1);
+  params_[kTotalSize].AddInt32(0);
+
+  ADD_TENSOR(tensors_, kSrcIds, kInt64, kReservedSize);
+  src_ids_ = &(tensors_[kSrcIds]);
+}
+
+OpRequest* LayerSamplingRequest::Clone() const {
+  LayerSamplingRequest* req = new LayerSamplingRequest(Type(), LayerSize());
+  req->params_[kTotalSize].SetInt32(0, TotalSize());
+  if (HasSeed()) {
+    req->SetSeed(Seed());
+  }
+  return req;
+}
+
+void LayerSamplingRequest::SetMembers() {
+  src_ids_ = &(tensors_[kSrcIds]);
+}
+
+void LayerSamplingRequest::Set(const int64_t* src_ids, int32_t batch_size) {
+  src_ids_->AddInt64(src_ids, src_ids + batch_size);
+  params_[kTotalSize].SetInt32(0, src_ids_->Size());
+}
+
+void LayerSamplingRequest::SetSeed(int64_t seed) {
+  if (!HasSeed()) {
+    ADD_TENSOR(params_, kSeed, kInt64, 1);
+    params_[kSeed].AddInt64(seed);
+  }
+}
+
+const std::string& LayerSamplingRequest::Type() const {
+  return params_.at(kType).GetString(0);
+}
+
+int32_t LayerSamplingRequest::LayerSize() const {
+  return params_.at(kLayerSize).GetInt32(0);
+}
+
+int32_t LayerSamplingRequest::TotalSize() const {
+  return params_.at(kTotalSize).GetInt32(0);
+}
+
+int32_t LayerSamplingRequest::BatchSize() const {
+  return src_ids_->Size();
+}
+
+bool LayerSamplingRequest::HasSeed() const {
+  return params_.find(kSeed) != params_.end();
+}
+
+int64_t LayerSamplingRequest::Seed() const {
+  return HasSeed() ? params_.at(kSeed).GetInt64(0) : 0;
+}
+
+const int64_t* LayerSamplingRequest::GetSrcIds() const {
+  if (src_ids_) {
+    return src_ids_->GetInt64();
+  } else {
+    return nullptr;
+  }
+}
+
+LayerSamplingResponse::LayerSamplingResponse()
+    : OpResponse(),
+      node_ids_(nullptr),
+      row_indices_(nullptr),
+      col_indices_(nullptr),
+      edge_ids_(nullptr),
+      weights_(nullptr) {
+}
+
+void LayerSamplingResponse::Swap(OpResponse& right) {
+  OpResponse::Swap(right);
+  LayerSamplingResponse& res = static_cast<LayerSamplingResponse&>(right);
+  std::swap(node_ids_, res.node_ids_);
+  std::swap(row_indices_, res.row_indices_);
+  std::swap(col_indices_, res.col_indices_);
+  std::swap(edge_ids_, res.edge_ids_);
+  std::swap(weights_, res.weights_);
+}
+
+void LayerSamplingResponse::SetMembers() {
+  node_ids_ = &(tensors_[kNodeIds]);
+  row_indices_ = &(tensors_[kRowIndices]);
+  col_indices_ = &(tensors_[kColIndices]);
+  edge_ids_ = &(tensors_[kEdgeIds]);
+  weights_ = &(tensors_[kWeightKey]);
+}
+
+void LayerSamplingResponse::Stitch(ShardsPtr<OpResponse> shards) {
+  Init(shards->StickerPtr()->Size());
+
+  // The shards may sample the same nodes.
+  io::IdHashMap layer;
+  int32_t shard_id = 0;
+  OpResponse* tmp = nullptr;
+  while (shards->Next(&shard_id, &tmp)) {
+    const LayerSamplingResponse* res =
+      static_cast<const LayerSamplingResponse*>(tmp);
+    const std::vector<int32_t>& sticker = shards->StickerPtr()->At(shard_id);
+
+    std::vector<int32_t> cols(res->NodeCount());
+    for (int32_t i = 0; i < res->NodeCount(); ++i) {
+      int64_t id = res->NodeIds()[i];
+      if (layer.Insert(id, NodeCount())) {
+        AppendNode(id);
+      }
+      cols[i] = layer.Find(id);
+    }
+
+    for (int32_t i = 0; i < res->EdgeCount(); ++i) {
+      AppendEdge(sticker[res->RowIndices()[i]],
+                 cols[res->ColIndices()[i]],
+                 res->EdgeIds()[i],
+                 res->EdgeWeights()[i]);
+    }
+  }
+  shards->ResetNext();
+}
+
+void LayerSamplingResponse::Init(int32_t batch_size) {
+  batch_size_ = batch_size;
+  ADD_TENSOR(tensors_, kNodeIds, kInt64, kReservedSize);
+  ADD_TENSOR(tensors_, kRowIndices, kInt32, kReservedSize);
+  ADD_TENSOR(tensors_, kColIndices, kInt32, kReservedSize);
+  ADD_TENSOR(tensors_, kEdgeIds, kInt64, kReservedSize);
+  ADD_TENSOR(tensors_, kWeightKey, kFloat, kReservedSize);
+  SetMembers();
+}
+
+void LayerSamplingResponse::AppendNode(int64_t node_id) {
+  node_ids_->AddInt64(node_id);
+}
+
+void LayerSamplingResponse::AppendEdge(int32_t row_idx, int32_t col_idx,
+                                       int64_t edge_id, float weight) {
+  row_indices_->AddInt32(row_idx);
+  col_indices_->AddInt32(col_idx);
+  edge_ids_->AddInt64(edge_id);
+  weights_->AddFloat(weight);
+}
+
+int32_t LayerSamplingResponse::NodeCount() const {
+  return node_ids_ ? node_ids_->Size() : 0;
+}
+
+int32_t LayerSamplingResponse::EdgeCount() const {
+  return edge_ids_ ? edge_ids_->Size() : 0;
+}
+
+const int64_t* LayerSamplingResponse::NodeIds() const {
+  return node_ids_->GetInt64();
+}
+
+const int32_t* LayerSamplingResponse::RowIndices() const {
+  return row_indices_->GetInt32();
+}
+
+const int32_t* LayerSamplingResponse::ColIndices() const {
+  return col_indices_->GetInt32();
+}
+
+const int64_t* LayerSamplingResponse::EdgeIds() const {
+  return edge_ids_->GetInt64();
+}
+
+const float* LayerSamplingResponse::EdgeWeights() const {
+  return weights_->GetFloat();
+}
+
+REGISTER_REQUEST(LayerwiseSampler,
+                 LayerSamplingRequest,
+                 LayerSamplingResponse)
+
+}  // namespace graphlearn
@@ -0,0 +1,214 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "graphlearn/include/sampling_request.h"
+
+#include <utility>
+#include "graphlearn/include/constants.h"
+
+namespace graphlearn {
+
+namespace {
+int32_t kReservedSize = 64;
+}  // anonymous namespace
+
+MultiHopSamplingRequest::MultiHopSamplingRequest()
+    : OpRequest(), src_ids_(nullptr) {
+  params_.reserve(kReservedSize);
+
+  ADD_TENSOR(params_, kOpName, kString, 1);
+  params_[kOpName].AddString("MultiHopSampler");
+
+  ADD_TENSOR(params_, kHopTypes, kString, 2);
+  ADD_TENSOR(params_, kHopStrategies, kString, 2);
+  ADD_TENSOR(params_, kHopCounts, kInt32, 2);
+
+  ADD_TENSOR(tensors_, kSrcIds, kInt64, kReservedSize);
+  src_ids_ = &(tensors_[kSrcIds]);
+}
+
+OpRequest* MultiHopSamplingRequest::Clone() const {
+  MultiHopSamplingRequest* req = new MultiHopSamplingRequest;
+  for (int32_t i = 0; i < HopNum(); ++i) {
+    req->AddHop(HopType(i), HopStrategy(i), HopNeighborCount(i));
+  }
+  if (HasSeed()) {
+    req->SetSeed(Seed());
+  }
+  if (IsDedup()) {
+    req->SetDedup();
+  }
+  return req;
+}
+
+void MultiHopSamplingRequest::SetMembers() {
+  src_ids_ = &(tensors_[kSrcIds]);
+}
+
+void MultiHopSamplingRequest::Set(const int64_t* src_ids,
+                                  int32_t batch_size) {
+  src_ids_->AddInt64(src_ids, src_ids + batch_size);
+}
+
+void MultiHopSamplingRequest::AddHop(const std::string& type,
+                                     const std::string& strategy,
+                                     int32_t neighbor_count) {
+  params_[kHopTypes].AddString(type);
+  params_[kHopStrategies].AddString(strategy);
+  params_[kHopCounts].AddInt32(neighbor_count);
+}
+
+void MultiHopSamplingRequest::SetSeed(int64_t seed) {
+  if (!HasSeed()) {
+    ADD_TENSOR(params_, kSeed, kInt64, 1);
+    params_[kSeed].AddInt64(seed);
+  }
+}
+
+void MultiHopSamplingRequest::SetDedup() {
+  if (!IsDedup()) {
+    ADD_TENSOR(params_, kDedup, kInt32, 1);
+    params_[kDedup].AddInt32(1);
+  }
+}
+
+int32_t MultiHopSamplingRequest::BatchSize() const {
+  return src_ids_->Size();
+}
+
+int32_t MultiHopSamplingRequest::HopNum() const {
+  return params_.at(kHopCounts).Size();
+}
+
+const std::string& MultiHopSamplingRequest::HopType(int32_t hop) const {
+  return params_.at(kHopTypes).GetString(hop);
+}
+
+const std::string& MultiHopSamplingRequest::HopStrategy(int32_t hop) const {
+  return params_.at(kHopStrategies).GetString(hop);
+}
+
+int32_t MultiHopSamplingRequest::HopNeighborCount(int32_t hop) const {
+  return params_.at(kHopCounts).GetInt32(hop);
+}
+
+bool MultiHopSamplingRequest::HasSeed() const {
+  return params_.find(kSeed) != params_.end();
+}
+
+int64_t MultiHopSamplingRequest::Seed() const {
+  return HasSeed() ? params_.at(kSeed).GetInt64(0) : 0;
+}
+
+bool MultiHopSamplingRequest::IsDedup() const {
+  return params_.find(kDedup) != params_.end();
+}
+
+const int64_t* MultiHopSamplingRequest::GetSrcIds() const {
+  if (src_ids_) {
+    return src_ids_->GetInt64();
+  } else {
+    return nullptr;
+  }
+}
+
+MultiHopSamplingResponse::MultiHopSamplingResponse()
+    : OpResponse(),
+      neighbors_(nullptr),
+      edges_(nullptr),
+      degrees_(nullptr),
+      hop_offsets_(nullptr) {
+}
+
+void MultiHopSamplingResponse::Swap(OpResponse& right) {
+  OpResponse::Swap(right);
+  MultiHopSamplingResponse& res =
+    static_cast<MultiHopSamplingResponse&>(right);
+  std::swap(neighbors_, res.neighbors_);
+  std::swap(edges_, res.edges_);
+  std::swap(degrees_, res.degrees_);
+  std::swap(hop_offsets_, res.hop_offsets_);
+}
+
+void MultiHopSamplingResponse::SetMembers() {
+  neighbors_ = &(tensors_[kNodeIds]);
+  edges_ = &(tensors_[kEdgeIds]);
+  degrees_ = &(tensors_[kDegreeKey]);
+  hop_offsets_ = &(tensors_[kHopOffsets]);
+}
+
+void MultiHopSamplingResponse::Init(int32_t batch_size, int32_t hop_num) {
+  batch_size_ = batch_size;
+  ADD_TENSOR(tensors_, kNodeIds, kInt64, kReservedSize);
+  ADD_TENSOR(tensors_, kEdgeIds, kInt64, kReservedSize);
+  ADD_TENSOR(tensors_, kDegreeKey, kInt32, kReservedSize);
+  ADD_TENSOR(tensors_, kHopOffsets, kInt32, hop_num + 1);
+  SetMembers();
+  hop_offsets_->AddInt32(0);
+}
+
+void MultiHopSamplingResponse::AppendNeighbors(const int64_t* nbr_ids,
+                                               const int64_t* edge_ids,
+                                               int32_t size) {
+  neighbors_->AddInt64(nbr_ids, nbr_ids + size);
+  if (edge_ids != nullptr) {
+    edges_->AddInt64(edge_ids, edge_ids + size);
+  } else {
+    for (int32_t i = 0; i < size; ++i) {
+      edges_->AddInt64(-1);
+    }
+  }
+  degrees_->AddInt32(size);
+}
+
+void MultiHopSamplingResponse::FinishHop() {
+  hop_offsets_->AddInt32(neighbors_->Size());
+}
+
+int32_t MultiHopSamplingResponse::HopNum() const {
+  return hop_offsets_ ? hop_offsets_->Size() - 1 : 0;
+}
+
+int32_t MultiHopSamplingResponse::SourceCount(int32_t hop) const {
+  return hop == 0 ? batch_size_ : NeighborCount(hop - 1);
+}
+
+int32_t MultiHopSamplingResponse::NeighborCount(int32_t hop) const {
+  return hop_offsets_->GetInt32(hop + 1) - hop_offsets_->GetInt32(hop);
+}
+
+const int64_t* MultiHopSamplingResponse::GetNeighborIds(int32_t hop) const {
+  return neighbors_->GetInt64() + hop_offsets_->GetInt32(hop);
+}
+
+const int64_t* MultiHopSamplingResponse::GetEdgeIds(int32_t hop) const {
+  return edges_->GetInt64() + hop_offsets_->GetInt32(hop);
+}
+
+const int32_t* MultiHopSamplingResponse::GetDegrees(int32_t hop) const {
+  return degrees_->GetInt32() + DegreeOffset(hop);
+}
+
+int32_t MultiHopSamplingResponse::DegreeOffset(int32_t hop) const {
+  // One degree for each source, and the sources of a hop are the
+  // neighbors of the last one.
+  return hop == 0 ? 0 : batch_size_ + hop_offsets_->GetInt32(hop - 1);
+}
+
+REGISTER_REQUEST(MultiHopSampler,
+                 MultiHopSamplingRequest,
+                 MultiHopSamplingResponse)
+
+}  // namespace graphlearn
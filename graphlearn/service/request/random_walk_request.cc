@@ -0,0 +1,155 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "graphlearn/include/sampling_request.h"
+
+#include <utility>
+#include "graphlearn/include/constants.h"
+
+namespace graphlearn {
+
+namespace {
+int32_t kReservedSize = 64;
+}  // anonymous namespace
+
+RandomWalkRequest::RandomWalkRequest()
+    : OpRequest(), src_ids_(nullptr) {
+}
+
+RandomWalkRequest::RandomWalkRequest(const std::string& type,
+                                     int32_t walk_length,
+                                     float p,
+                                     float q)
+    : OpRequest(), src_ids_(nullptr) {
+  params_.reserve(kReservedSize);
+
+  ADD_TENSOR(params_, kOpName, kString, 1);
+  params_[kOpName].AddString("RandomWalk");
+
+  ADD_TENSOR(params_, kType, kString, 1);
+  params_[kType].AddString(type);
+
+  ADD_TENSOR(params_, kWalkLength, kInt32, 1);
+  params_[kWalkLength].AddInt32(walk_length);
+
+  ADD_TENSOR(params_, kReturnParam, kFloat, 1);
+  params_[kReturnParam].AddFloat(p);
+
+  ADD_TENSOR(params_, kInOutParam, kFloat, 1);
+  params_[kInOutParam].AddFloat(q);
+
+  ADD_TENSOR(tensors_, kSrcIds, kInt64, kReservedSize);
+  src_ids_ = &(tensors_[kSrcIds]);
+}
+
+OpRequest* RandomWalkRequest::Clone() const {
+  RandomWalkRequest* req = new RandomWalkRequest(
+    Type(), WalkLength(), P(), Q());
+  if (HasSeed()) {
+    req->SetSeed(Seed());
+  }
+  return req;
+}
+
+void RandomWalkRequest::SetMembers() {
+  src_ids_ = &(tensors_[kSrcIds]);
+}
+
+void RandomWalkRequest::Set(const int64_t* src_ids, int32_t batch_size) {
+  src_ids_->AddInt64(src_ids, src_ids + batch_size);
+}
+
+void RandomWalkRequest::SetSeed(int64_t seed) {
+  if (!HasSeed()) {
+    ADD_TENSOR(params_, kSeed, kInt64, 1);
+    params_[kSeed].AddInt64(seed);
+  }
+}
+
+const std::string& RandomWalkRequest::Type() const {
+  return params_.at(kType).GetString(0);
+}
+
+int32_t RandomWalkRequest::WalkLength() const {
+  return params_.at(kWalkLength).GetInt32(0);
+}
+
+float RandomWalkRequest::P() const {
+  return params_.at(kReturnParam).GetFloat(0);
+}
+
+float RandomWalkRequest::Q() const {
+  return params_.at(kInOutParam).GetFloat(0);
+}
+
+int32_t RandomWalkRequest::BatchSize() const {
+  return src_ids_->Size();
+}
+
+bool RandomWalkRequest::HasSeed() const {
+  return params_.find(kSeed) != params_.end();
+}
+
+int64_t RandomWalkRequest::Seed() const {
+  return HasSeed() ? params_.at(kSeed).GetInt64(0) : 0;
+}
+
+const int64_t* RandomWalkRequest::GetSrcIds() const {
+  if (src_ids_) {
+    return src_ids_->GetInt64();
+  } else {
+    return nullptr;
+  }
+}
+
+RandomWalkResponse::RandomWalkResponse()
+    : OpResponse(), walks_(nullptr) {
+}
+
+void RandomWalkResponse::Swap(OpResponse& right) {
+  OpResponse::Swap(right);
+  RandomWalkResponse& res = static_cast<RandomWalkResponse&>(right);
+  std::swap(walks_, res.walks_);
+}
+
+void RandomWalkResponse::SetMembers() {
+  walks_ = &(tensors_[kNodeIds]);
+}
+
+void RandomWalkResponse::Init(int32_t batch_size, int32_t walk_length) {
+  batch_size_ = batch_size;
+  ADD_TENSOR(params_, kWalkLength, kInt32, 1);
+  params_[kWalkLength].AddInt32(walk_length);
+  ADD_TENSOR(tensors_, kNodeIds, kInt64, batch_size * walk_length);
+  walks_ = &(tensors_[kNodeIds]);
+  walks_->Resize(batch_size * walk_length);
+}
+
+int32_t RandomWalkResponse::WalkLength() const {
+  auto it = params_.find(kWalkLength);
+  return it == params_.end() ? 0 : it->second.GetInt32(0);
+}
+
+int64_t* RandomWalkResponse::GetWalks() {
+  return walks_ ? const_cast<int64_t*>(walks_->GetInt64()) : nullptr;
+}
+
+const int64_t* RandomWalkResponse::GetWalks() const {
+  return walks_ ? walks_->GetInt64() : nullptr;
+}
+
+REGISTER_REQUEST(RandomWalk, RandomWalkRequest, RandomWalkResponse)
+
+}  // namespace graphlearn
@@ -15,6 +15,9 @@ limitations under the License.
 
 #include "graphlearn/include/sampling_request.h"
 
+#include <algorithm>
+#include "graphlearn/common/threading/runner/parallel_for.h"
+#include "graphlearn/core/graph/storage/id_hash_map.h"
 #include "graphlearn/include/constants.h"
 
 namespace graphlearn {
@@ -27,6 +30,10 @@ SamplingRequest::SamplingRequest()
     : OpRequest(),
       neighbor_count_(0),
       filter_type_(0),
+      reversed_(false),
+      has_seed_(false),
+      seed_(0),
+      compact_(false),
       src_ids_(nullptr),
       filter_ids_(nullptr) {
 }
@@ -38,6 +45,10 @@ SamplingRequest::SamplingRequest(const std::string& type,
     : OpRequest(),
       neighbor_count_(neighbor_count),
       filter_type_(filter_type),
+      reversed_(false),
+      has_seed_(false),
+      seed_(0),
+      compact_(false),
       src_ids_(nullptr),
       filter_ids_(nullptr) {
   params_.reserve(kReservedSize);
@@ -70,12 +81,27 @@ SamplingRequest::SamplingRequest(const std::string& type,
 OpRequest* SamplingRequest::Clone() const {
   SamplingRequest* req = new SamplingRequest(
     Type(), Strategy(), neighbor_count_);
+  if (reversed_) {
+    req->SetReversed();
+  }
+  if (has_seed_) {
+    req->SetSeed(seed_);
+  }
+  if (compact_) {
+    req->SetCompact();
+  }
   return req;
 }
 
 void SamplingRequest::SetMembers() {
   neighbor_count_ = params_[kNeighborCount].GetInt32(0);
   filter_type_ = params_[kFilterType].GetInt32(0);
+  auto it = params_.find(kDirection);
+  reversed_ = it != params_.end() && it->second.GetInt32(0) == io::kReversed;
+  it = params_.find(kSeed);
+  has_seed_ = it != params_.end();
+  seed_ = has_seed_ ? it->second.GetInt64(0) : 0;
+  compact_ = params_.find(kCompact) != params_.end();
   src_ids_ = &(tensors_[kSrcIds]);
   if (filter_type_ > 0) {
     filter_ids_ = &(tensors_[kFilterIds]);
@@ -103,6 +129,17 @@ void SamplingRequest::Init(const Tensor::Map& params) {
   neighbor_count_ = params_[kNeighborCount].GetInt32(0);
   filter_type_ = params_[kFilterType].GetInt32(0);
 
+  auto it = params.find(kDirection);
+  if (it != params.end() && it->second.GetInt32(0) == io::kReversed) {
+    SetReversed();
+  }
+  // The int params of a dag node are int32.
+  it = params.find(kSeed);
+  if (it != params.end()) {
+    SetSeed(it->second.DType() == kInt32 ? it->second.GetInt32(0)
+                                         : it->second.GetInt64(0));
+  }
+
   ADD_TENSOR(tensors_, kSrcIds, kInt64, kReservedSize);
   src_ids_ = &(tensors_[kSrcIds]);
 
@@ -117,6 +154,31 @@ void SamplingRequest::Set(const int64_t* src_ids,
   src_ids_->AddInt64(src_ids, src_ids + batch_size);
 }
 
+void SamplingRequest::SetReversed() {
+  if (!reversed_) {
+    ADD_TENSOR(params_, kDirection, kInt32, 1);
+    params_[kDirection].AddInt32(io::kReversed);
+    reversed_ = true;
+  }
+}
+
+void SamplingRequest::SetSeed(int64_t seed) {
+  if (!has_seed_) {
+    ADD_TENSOR(params_, kSeed, kInt64, 1);
+    params_[kSeed].AddInt64(seed);
+    has_seed_ = true;
+    seed_ = seed;
+  }
+}
+
+void SamplingRequest::SetCompact() {
+  if (!compact_) {
+    ADD_TENSOR(params_, kCompact, kInt32, 1);
+    params_[kCompact].AddInt32(1);
+    compact_ = true;
+  }
+}
+
 void SamplingRequest::SetFilters(const int64_t* filter_ids,
                                  int32_t batch_size) {
   filter_ids_->AddInt64(filter_ids, filter_ids + batch_size);
@@ -162,13 +224,30 @@ const int64_t* SamplingRequest::GetFilters() const {
   }
 }
 
+int32_t SamplingRequest::Occurrence(int32_t index) const {
+  // Counted once for all the chunks sampling the request in parallel.
+  std::call_once(occurrences_once_, [this] {
+    int32_t batch_size = BatchSize();
+    const int64_t* src_ids = GetSrcIds();
+    std::unordered_map<int64_t, int32_t> counts;
+    counts.reserve(batch_size);
+    occurrences_.resize(batch_size);
+    for (int32_t i = 0; i < batch_size; ++i) {
+      occurrences_[i] = counts[src_ids[i]]++;
+    }
+  });
+  return occurrences_[index];
+}
+
 SamplingResponse::SamplingResponse()
     : OpResponse(),
       neighbor_count_(0),
       total_neighbor_count_(0),
       neighbors_(nullptr),
       edges_(nullptr),
-      degrees_(nullptr) {
+      degrees_(nullptr),
+      unique_ids_(nullptr),
+      unique_index_(nullptr) {
 }
 
 void SamplingResponse::Swap(OpResponse& right) {
@@ -179,6 +258,8 @@ void SamplingResponse::Swap(OpResponse& right) {
   std::swap(neighbors_, res.neighbors_);
   std::swap(edges_, res.edges_);
   std::swap(degrees_, res.degrees_);
+  std::swap(unique_ids_, res.unique_ids_);
+  std::swap(unique_index_, res.unique_index_);
 }
 
 void SamplingResponse::SerializeTo(void* response) {
@@ -193,7 +274,13 @@ void SamplingResponse::SetMembers() {
     total_neighbor_count_ = cnt->GetInt32(1);
   }
 
-  neighbors_ = &(tensors_[kNodeIds]);
+  if (tensors_.find(kUniqueIndex) != tensors_.end()) {
+    neighbors_ = nullptr;
+    unique_ids_ = &(tensors_[kUniqueIds]);
+    unique_index_ = &(tensors_[kUniqueIndex]);
+  } else {
+    neighbors_ = &(tensors_[kNodeIds]);
+  }
   edges_ = &(tensors_[kEdgeIds]);
   if (tensors_.find(kDegreeKey) != tensors_.end()) {
     degrees_ = &(tensors_[kDegreeKey]);
@@ -211,12 +298,50 @@ void SamplingResponse::Stitch(ShardsPtr<OpResponse> shards) {
   }
 
   shards->ResetNext();
+  bool compacted = tmp != nullptr &&
+    tmp->tensors_.find(kUniqueIndex) != tmp->tensors_.end();
+  Tensor unique_ids(kInt64);
+  if (compacted) {
+    MergeUniqueIds(shards, &unique_ids);
+  }
   OpResponse::Stitch(shards);
 
   params_[kNeighborCount].SetInt32(1, total_neighbor_count);
+  if (compacted) {
+    ADD_TENSOR(tensors_, kUniqueIds, kInt64, 0);
+    tensors_[kUniqueIds].Swap(unique_ids);
+  }
   this->SetMembers();
 }
 
+void SamplingResponse::MergeUniqueIds(ShardsPtr<OpResponse> shards,
+                                      Tensor* unique_ids) {
+  // The shards may share neighbors, so merge their distinct ids and point
+  // the index of each shard to the merged ones. The index is then stitched
+  // as the neighbor ids are.
+  io::IdHashMap merged;
+  int32_t shard_id = 0;
+  OpResponse* tmp = nullptr;
+  while (shards->Next(&shard_id, &tmp)) {
+    Tensor& from_ids = tmp->tensors_[kUniqueIds];
+    Tensor& from_index = tmp->tensors_[kUniqueIndex];
+    std::vector<int32_t> remap(from_ids.Size());
+    for (int32_t i = 0; i < from_ids.Size(); ++i) {
+      int64_t id = from_ids.GetInt64(i);
+      if (merged.Insert(id, unique_ids->Size())) {
+        unique_ids->AddInt64(id);
+      }
+      remap[i] = merged.Find(id);
+    }
+    int32_t* index = const_cast<int32_t*>(from_index.GetInt32());
+    for (int32_t i = 0; i < from_index.Size(); ++i) {
+      index[i] = remap[index[i]];
+    }
+    tmp->tensors_.erase(kUniqueIds);
+  }
+  shards->ResetNext();
+}
+
 void SamplingResponse::InitNeighborIds(int32_t count) {
   ADD_TENSOR(tensors_, kNodeIds, kInt64, count);
   neighbors_ = &(tensors_[kNodeIds]);
@@ -271,6 +396,111 @@ void SamplingResponse::FillWith(int64_t neighbor_id, int64_t edge_id) {
   total_neighbor_count_ += neighbor_count_;
 }
 
+void SamplingResponse::Concat(const std::vector<SamplingResponse*>& chunks,
+                              ThreadPool* tp) {
+  if (chunks.empty()) {
+    return;
+  }
+
+  // Where each chunk starts in the neighbors, edges and degrees.
+  int32_t chunk_num = chunks.size();
+  std::vector<int32_t> neighbor_offsets(chunk_num + 1, 0);
+  std::vector<int32_t> edge_offsets(chunk_num + 1, 0);
+  std::vector<int32_t> degree_offsets(chunk_num + 1, 0);
+  int32_t batch_size = 0;
+  for (int32_t i = 0; i < chunk_num; ++i) {
+    const SamplingResponse* chunk = chunks[i];
+    neighbor_offsets[i + 1] = neighbor_offsets[i] +
+      (chunk->neighbors_ ? chunk->neighbors_->Size() : 0);
+    edge_offsets[i + 1] = edge_offsets[i] +
+      (chunk->edges_ ? chunk->edges_->Size() : 0);
+    degree_offsets[i + 1] = degree_offsets[i] +
+      (chunk->degrees_ ? chunk->degrees_->Size() : 0);
+    batch_size += chunk->BatchSize();
+  }
+
+  const SamplingResponse* first = chunks[0];
+  if (first->IsSparse()) {
+    SetSparseFlag();
+  }
+  SetBatchSize(batch_size);
+  SetNeighborCount(first->NeighborCount());
+  InitNeighborIds(neighbor_offsets.back());
+  neighbors_->Resize(neighbor_offsets.back());
+  total_neighbor_count_ = neighbor_offsets.back();
+  if (first->edges_) {
+    InitEdgeIds(edge_offsets.back());
+    edges_->Resize(edge_offsets.back());
+  }
+  if (first->degrees_) {
+    InitDegrees(degree_offsets.back());
+    degrees_->Resize(degree_offsets.back());
+  }
+
+  int64_t* neighbors = GetNeighborIds();
+  int64_t* edges = GetEdgeIds();
+  int32_t* degrees = GetDegrees();
+  ParallelFor(tp, chunk_num, 1, [&] (int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const SamplingResponse* chunk = chunks[i];
+      if (neighbor_offsets[i + 1] > neighbor_offsets[i]) {
+        const int64_t* from = chunk->GetNeighborIds();
+        std::copy(from, from + chunk->neighbors_->Size(),
+                  neighbors + neighbor_offsets[i]);
+      }
+      if (edge_offsets[i + 1] > edge_offsets[i]) {
+        const int64_t* from = chunk->GetEdgeIds();
+        std::copy(from, from + chunk->edges_->Size(),
+                  edges + edge_offsets[i]);
+      }
+      if (degree_offsets[i + 1] > degree_offsets[i]) {
+        const int32_t* from = chunk->GetDegrees();
+        std::copy(from, from + chunk->degrees_->Size(),
+                  degrees + degree_offsets[i]);
+      }
+    }
+  });
+}
+
+void SamplingResponse::Compact() {
+  if (IsCompacted() || neighbors_ == nullptr) {
+    return;
+  }
+
+  int32_t size = neighbors_->Size();
+  const int64_t* nbr_ids = neighbors_->GetInt64();
+  ADD_TENSOR(tensors_, kUniqueIds, kInt64, size);
+  ADD_TENSOR(tensors_, kUniqueIndex, kInt32, size);
+  unique_ids_ = &(tensors_[kUniqueIds]);
+  unique_index_ = &(tensors_[kUniqueIndex]);
+
+  io::IdHashMap index;
+  index.Reserve(size);
+  for (int32_t i = 0; i < size; ++i) {
+    if (index.Insert(nbr_ids[i], unique_ids_->Size())) {
+      unique_index_->AddInt32(unique_ids_->Size());
+      unique_ids_->AddInt64(nbr_ids[i]);
+    } else {
+      unique_index_->AddInt32(index.Find(nbr_ids[i]));
+    }
+  }
+
+  tensors_.erase(kNodeIds);
+  neighbors_ = nullptr;
+}
+
+int32_t SamplingResponse::UniqueNodeCount() const {
+  return unique_ids_ ? unique_ids_->Size() : 0;
+}
+
+const int64_t* SamplingResponse::GetUniqueIds() const {
+  return unique_ids_ ? unique_ids_->GetInt64() : nullptr;
+}
+
+const int32_t* SamplingResponse::GetUniqueIndex() const {
+  return unique_index_ ? unique_index_->GetInt32() : nullptr;
+}
+
 int64_t* SamplingResponse::GetNeighborIds() {
   if (neighbors_) {
     return const_cast<int64_t*>(neighbors_->GetInt64());
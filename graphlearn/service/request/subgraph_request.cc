@@ -15,6 +15,9 @@ limitations under the License.
 
 #include "graphlearn/include/subgraph_request.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
 #include "graphlearn/include/constants.h"
 
 namespace graphlearn {
@@ -75,12 +78,14 @@ void SubGraphResponse::Init(int32_t batch_size) {
   ADD_TENSOR(tensors_, kNodeIds, kInt64, batch_size);
   node_ids_ = &(tensors_[kNodeIds]);
 
-  ADD_TENSOR(tensors_, kRowIndices, kInt32, batch_size * batch_size);
+  // The edges grow as appended, since reserving for all the pairs of a
+  // large subgraph runs out of memory.
+  ADD_TENSOR(tensors_, kRowIndices, kInt32, batch_size);
   row_indices_ = &(tensors_[kRowIndices]);
 
-  ADD_TENSOR(tensors_, kColIndices, kInt32, batch_size * batch_size);
+  ADD_TENSOR(tensors_, kColIndices, kInt32, batch_size);
   col_indices_ = &(tensors_[kColIndices]);
-  ADD_TENSOR(tensors_, kEdgeIds, kInt64, batch_size * batch_size);
+  ADD_TENSOR(tensors_, kEdgeIds, kInt64, batch_size);
   edge_ids_ = &(tensors_[kEdgeIds]);
 }
 
@@ -124,7 +129,163 @@ void SubGraphResponse::SetMembers() {
   edge_ids_ = &(tensors_[kEdgeIds]);
 }
 
+InduceSubGraphRequest::InduceSubGraphRequest()
+    : OpRequest(), row_ids_(nullptr) {
+}
+
+InduceSubGraphRequest::InduceSubGraphRequest(const std::string& nbr_type)
+    : OpRequest(), row_ids_(nullptr) {
+  ADD_TENSOR(params_, kOpName, kString, 1);
+  params_[kOpName].AddString("InduceSubGraph");
+
+  ADD_TENSOR(params_, kPartitionKey, kString, 1);
+  params_[kPartitionKey].AddString(kSrcIds);
+
+  ADD_TENSOR(params_, kNbrType, kString, 1);
+  params_[kNbrType].AddString(nbr_type);
+
+  // Each shard looks up the columns in all the nodes.
+  ADD_TENSOR(params_, kNodeIds, kInt64, 0);
+
+  ADD_TENSOR(tensors_, kSrcIds, kInt64, 0);
+  row_ids_ = &(tensors_[kSrcIds]);
+}
+
+OpRequest* InduceSubGraphRequest::Clone() const {
+  InduceSubGraphRequest* req = new InduceSubGraphRequest(NbrType());
+  req->params_[kNodeIds] = params_.at(kNodeIds);
+  return req;
+}
+
+void InduceSubGraphRequest::SetMembers() {
+  row_ids_ = &(tensors_[kSrcIds]);
+}
+
+void InduceSubGraphRequest::Set(const int64_t* node_ids, int32_t size) {
+  params_[kNodeIds].AddInt64(node_ids, node_ids + size);
+  row_ids_->AddInt64(node_ids, node_ids + size);
+}
+
+const std::string& InduceSubGraphRequest::NbrType() const {
+  return params_.at(kNbrType).GetString(0);
+}
+
+int32_t InduceSubGraphRequest::NodeCount() const {
+  return params_.at(kNodeIds).Size();
+}
+
+const int64_t* InduceSubGraphRequest::NodeIds() const {
+  return params_.at(kNodeIds).GetInt64();
+}
+
+int32_t InduceSubGraphRequest::RowCount() const {
+  return row_ids_->Size();
+}
+
+const int64_t* InduceSubGraphRequest::RowIds() const {
+  return row_ids_->GetInt64();
+}
+
+InduceSubGraphResponse::InduceSubGraphResponse()
+    : OpResponse(),
+      row_indices_(nullptr),
+      col_indices_(nullptr),
+      edge_ids_(nullptr) {
+}
+
+void InduceSubGraphResponse::Swap(OpResponse& right) {
+  OpResponse::Swap(right);
+  InduceSubGraphResponse& res = static_cast<InduceSubGraphResponse&>(right);
+  std::swap(row_indices_, res.row_indices_);
+  std::swap(col_indices_, res.col_indices_);
+  std::swap(edge_ids_, res.edge_ids_);
+}
+
+void InduceSubGraphResponse::Stitch(ShardsPtr<OpResponse> shards) {
+  // The consecutive edges of a row in a shard.
+  struct Run {
+    int32_t row;
+    const InduceSubGraphResponse* shard;
+    int32_t begin;
+    int32_t end;
+  };
+
+  // Each row belongs to one shard, so the runs only need moving back to
+  // the positions of their rows.
+  std::vector<Run> runs;
+  int32_t edge_count = 0;
+  int32_t shard_id = 0;
+  OpResponse* tmp = nullptr;
+  while (shards->Next(&shard_id, &tmp)) {
+    const InduceSubGraphResponse* res =
+      static_cast<const InduceSubGraphResponse*>(tmp);
+    const std::vector<int32_t>& sticker = shards->StickerPtr()->At(shard_id);
+    const int32_t* rows = res->RowIndices();
+    int32_t size = res->EdgeCount();
+    for (int32_t begin = 0, end = 0; begin < size; begin = end) {
+      while (end < size && rows[end] == rows[begin]) {
+        ++end;
+      }
+      runs.push_back(Run{sticker[rows[begin]], res, begin, end});
+    }
+    edge_count += size;
+  }
+  shards->ResetNext();
+
+  std::sort(runs.begin(), runs.end(), [] (const Run& a, const Run& b) {
+    return a.row < b.row;
+  });
+  Init(shards->StickerPtr()->Size(), edge_count);
+  for (const Run& run : runs) {
+    for (int32_t k = run.begin; k < run.end; ++k) {
+      AppendEdge(run.row, run.shard->ColIndices()[k],
+                 run.shard->EdgeIds()[k]);
+    }
+  }
+}
+
+void InduceSubGraphResponse::Init(int32_t row_count, int32_t edge_count) {
+  batch_size_ = row_count;
+  ADD_TENSOR(tensors_, kRowIndices, kInt32, edge_count);
+  row_indices_ = &(tensors_[kRowIndices]);
+  ADD_TENSOR(tensors_, kColIndices, kInt32, edge_count);
+  col_indices_ = &(tensors_[kColIndices]);
+  ADD_TENSOR(tensors_, kEdgeIds, kInt64, edge_count);
+  edge_ids_ = &(tensors_[kEdgeIds]);
+}
+
+void InduceSubGraphResponse::AppendEdge(int32_t row_idx,
+                                        int32_t col_idx,
+                                        int64_t e_id) {
+  row_indices_->AddInt32(row_idx);
+  col_indices_->AddInt32(col_idx);
+  edge_ids_->AddInt64(e_id);
+}
+
+int32_t InduceSubGraphResponse::EdgeCount() const {
+  return row_indices_ ? row_indices_->Size() : 0;
+}
+
+const int32_t* InduceSubGraphResponse::RowIndices() const {
+  return row_indices_->GetInt32();
+}
+
+const int32_t* InduceSubGraphResponse::ColIndices() const {
+  return col_indices_->GetInt32();
+}
+
+const int64_t* InduceSubGraphResponse::EdgeIds() const {
+  return edge_ids_->GetInt64();
+}
+
+void InduceSubGraphResponse::SetMembers() {
+  row_indices_ = &(tensors_[kRowIndices]);
+  col_indices_ = &(tensors_[kColIndices]);
+  edge_ids_ = &(tensors_[kEdgeIds]);
+}
+
 REGISTER_REQUEST(RandomNodeSubGraphSampler, SubGraphRequest, SubGraphResponse);
 REGISTER_REQUEST(InOrderNodeSubGraphSampler, SubGraphRequest, SubGraphResponse);
+REGISTER_REQUEST(InduceSubGraph, InduceSubGraphRequest, InduceSubGraphResponse);
 
 }  // namespace graphlearn
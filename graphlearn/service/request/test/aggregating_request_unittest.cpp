@@ -17,6 +17,7 @@ limitations under the License.
 #include "graphlearn/core/io/element_value.h"
 #include "graphlearn/include/aggregating_request.h"
 #include "graphlearn/include/graph_request.h"
+#include "graphlearn/proto/service.pb.h"
 #include "gtest/gtest.h"
 
 using namespace graphlearn;  // NOLINT [build/namespaces]
@@ -56,6 +57,52 @@ protected:
     }
   }
 
+  // Two shards of a 3-segment request with 2 floats per node, where
+  // segment 1 lives only on shard 0 and segment 2 is empty on both.
+  void StitchPartials(const std::string& name, AggregatingResponse* res) {
+    float states0[4] = {1.0, -2.0, 3.0, 4.0};
+    int32_t segment_ids0[2] = {0, 1};
+    int32_t counts0[2] = {1, 2};
+    float states1[2] = {5.0, -6.0};
+    int32_t segment_ids1[1] = {0};
+    int32_t counts1[1] = {3};
+
+    AggregatingResponse* shard0 = new AggregatingResponse();
+    AggregatingResponse* shard1 = new AggregatingResponse();
+    FillPartials(name, states0, segment_ids0, counts0, 2, shard0);
+    FillPartials(name, states1, segment_ids1, counts1, 1, shard1);
+
+    ShardsPtr<OpResponse> shards(new Shards<OpResponse>(2));
+    shards->Add(0, shard0, true);
+    shards->Add(1, shard1, true);
+    res->Stitch(shards);
+
+    EXPECT_EQ(res->NumSegments(), 3);
+    EXPECT_EQ(res->EmbeddingDim(), 2);
+    EXPECT_FALSE(res->IsPartial());
+    const int32_t* segs = res->Segments();
+    EXPECT_EQ(segs[0], 4);
+    EXPECT_EQ(segs[1], 2);
+    EXPECT_EQ(segs[2], 0);
+  }
+
+  void FillPartials(const std::string& name,
+                    const float* states,
+                    const int32_t* segment_ids,
+                    const int32_t* counts,
+                    int32_t size,
+                    AggregatingResponse* res) {
+    res->SetName(name);
+    res->SetEmbeddingDim(2);
+    res->SetNumSegments(3);
+    res->SetPartial();
+    for (int32_t i = 0; i < size; ++i) {
+      res->AppendSegmentId(segment_ids[i]);
+      res->AppendEmbedding(states + i * 2);
+      res->AppendSegment(counts[i]);
+    }
+  }
+
   void GenNodeValue(NodeValue* value, int32_t index) {
     value->id = index;
     if (info_.IsWeighted()) {
@@ -130,3 +177,70 @@ TEST_F(AggregatingRequestTest, AggregateNodes) {
     CheckSegments(segs, 10);
   }
 }
+
+TEST_F(AggregatingRequestTest, PartialRequest) {
+  AggregatingRequest req("node_type", "MinAggregator");
+  int64_t node_ids[4] = {0, 1, 2, 3};
+  int32_t segment_ids[4] = {0, 0, 2, 2};
+  req.Set(node_ids, segment_ids, 4, 3);
+  EXPECT_FALSE(req.IsPartial());
+
+  // Only the shards cut by the partitioner return partial states.
+  AggregatingRequest* shard = static_cast<AggregatingRequest*>(req.Clone());
+  EXPECT_TRUE(shard->IsPartial());
+
+  OpRequestPb pb;
+  shard->SerializeTo(&pb);
+  AggregatingRequest received;
+  received.ParseFrom(&pb);
+  EXPECT_TRUE(received.IsPartial());
+  delete shard;
+
+  AggregatingResponse res;
+  float states[4] = {1.0, 2.0, 3.0, 4.0};
+  int32_t partial_ids[2] = {0, 2};
+  int32_t counts[2] = {2, 2};
+  FillPartials("MinAggregator", states, partial_ids, counts, 2, &res);
+
+  OpResponsePb res_pb;
+  res.SerializeTo(&res_pb);
+  AggregatingResponse received_res;
+  received_res.ParseFrom(&res_pb);
+  EXPECT_TRUE(received_res.IsPartial());
+  EXPECT_EQ(received_res.NumSegments(), 3);
+  EXPECT_EQ(received_res.NumPartials(), 2);
+  EXPECT_EQ(received_res.SegmentIds()[0], 0);
+  EXPECT_EQ(received_res.SegmentIds()[1], 2);
+  EXPECT_FLOAT_EQ(received_res.Embeddings()[3], 4.0);
+}
+
+TEST_F(AggregatingRequestTest, StitchPartials) {
+  {
+    AggregatingResponse res;
+    StitchPartials("MeanAggregator", &res);
+    const float* embs = res.Embeddings();
+    EXPECT_FLOAT_EQ(embs[0], 1.5);
+    EXPECT_FLOAT_EQ(embs[1], -2.0);
+    EXPECT_FLOAT_EQ(embs[2], 1.5);
+    EXPECT_FLOAT_EQ(embs[3], 2.0);
+  }
+  {
+    // Segment 1 is absent on shard 1 and must not be pulled to zero.
+    AggregatingResponse res;
+    StitchPartials("MinAggregator", &res);
+    const float* embs = res.Embeddings();
+    EXPECT_FLOAT_EQ(embs[0], 1.0);
+    EXPECT_FLOAT_EQ(embs[1], -6.0);
+    EXPECT_FLOAT_EQ(embs[2], 3.0);
+    EXPECT_FLOAT_EQ(embs[3], 4.0);
+  }
+  {
+    AggregatingResponse res;
+    StitchPartials("ProdAggregator", &res);
+    const float* embs = res.Embeddings();
+    EXPECT_FLOAT_EQ(embs[0], 5.0);
+    EXPECT_FLOAT_EQ(embs[1], 12.0);
+    EXPECT_FLOAT_EQ(embs[2], 3.0);
+    EXPECT_FLOAT_EQ(embs[3], 4.0);
+  }
+}
@@ -18,9 +18,12 @@ limitations under the License.
 #include <unistd.h>
 #include <cstdlib>
 #include <memory>
+#include <utility>
 #include <vector>
+#include "graphlearn/common/base/errors.h"
 #include "graphlearn/common/base/log.h"
 #include "graphlearn/core/graph/graph_store.h"
+#include "graphlearn/core/graph/storage/snapshot.h"
 #include "graphlearn/include/config.h"
 #include "graphlearn/platform/env.h"
 #include "graphlearn/service/dist/coordinator.h"
@@ -156,7 +159,41 @@ void DefaultServerImpl::Start() {
 
 void DefaultServerImpl::Init(const std::vector<io::EdgeSource>& edges,
                              const std::vector<io::NodeSource>& nodes) {
-  Status s = graph_store_->Load(edges, nodes);
+  std::unique_ptr<io::SnapshotReader> snapshot;
+  Status s = graph_store_->OpenSnapshot(edges, nodes, &snapshot);
+  if (!s.ok()) {
+    LOG(INFO) << "Not restore from snapshot: " << s.ToString();
+  }
+  // All the servers restore or none of them, because a loading server
+  // sends the data of the other partitions to their servers.
+  bool restore = s.ok();
+  if (coordinator_ != nullptr) {
+    s = coordinator_->Vote("restore", restore, &restore);
+    if (!s.ok()) {
+      USER_LOG("Server vote on restoring failed and exit now.");
+      USER_LOG(s.ToString());
+      LOG(FATAL) << "Server vote on restoring failed: " << s.ToString();
+      ::exit(-1);
+    }
+  }
+
+  if (restore) {
+    s = graph_store_->Restore(edges, nodes, std::move(snapshot));
+    if (!s.ok()) {
+      USER_LOG("Server restore data failed and exit now.");
+      USER_LOG(s.ToString());
+      LOG(FATAL) << "Server restore data failed: " << s.ToString();
+      ::exit(-1);
+    }
+    InitBasicService();
+    BuildBasicService();
+    LOG(INFO) << "Data is restored from snapshot and ready for serving.";
+    USER_LOG("Data is restored from snapshot and ready for serving.");
+    return;
+  }
+  snapshot.reset();
+
+  s = graph_store_->Load(edges, nodes);
   if (!s.ok()) {
     USER_LOG("Server load data failed and exit now.");
     USER_LOG(s.ToString());
@@ -174,6 +211,12 @@ void DefaultServerImpl::Init(const std::vector<io::EdgeSource>& edges,
     LOG(FATAL) << "Server build data failed: " << s.ToString();
     ::exit(-1);
   }
+  if (!GLOBAL_FLAG(SnapshotDir).empty()) {
+    s = graph_store_->Save(edges, nodes);
+    if (!s.ok()) {
+      LOG(WARNING) << "Save snapshot failed: " << s.ToString();
+    }
+  }
   BuildBasicService();
   LOG(INFO) << "Data is ready for serving.";
   USER_LOG("Data is ready for serving.");